@@ -264,6 +264,31 @@ typedef struct cm_traceWork_s {
 	idVec3 polygonRotationOriginCache[CM_MAX_POLYGON_EDGES];
 } cm_traceWork_t;
 
+// max number of point traces going through the tree together
+#define CM_MAX_RAY_PACKET	8
+
+typedef struct cm_pointRay_s {
+	idVec3 start;									// start of trace in model space
+	idVec3 end;										// end of trace in model space
+	idVec3 dir;										// trace direction
+	idBounds bounds;								// bounds of trace (shrinks on collision)
+	idPluecker pl;									// pluecker coordinate for point movement
+	idPlane heartPlane1;							// polygons should be within epsilon from both heart planes
+	idPlane heartPlane2;
+	int checkCount;									// unique for every ray of packet
+	trace_t trace;									// collision detection result
+} cm_pointRay_t;
+
+typedef struct cm_rayPacket_s {
+	cm_model_t *model;								// model colliding with
+	int contents;									// ignore polygons that do not have any of these contents flags
+	int numRays;
+	cm_pointRay_t rays[CM_MAX_RAY_PACKET];
+	// structure of arrays for tree traversal
+	float start[3][CM_MAX_RAY_PACKET];
+	float dir[3][CM_MAX_RAY_PACKET];
+} cm_rayPacket_t;
+
 /*
 ===============================================================================
 
@@ -308,6 +333,9 @@ public:
 	void			Translation( trace_t *results, const idVec3 &start, const idVec3 &end,
 								const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
 								cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis );
+	// translates points along many rays
+	void			TranslationPoints( trace_t *results, const idVec3 *starts, const idVec3 *ends, int numRays, int contentMask,
+								cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis );
 	// rotates a trm and reports the first collision if any
 	void			Rotation( trace_t *results, const idVec3 &start, const idRotation &rotation,
 								const idTraceModel *trm, const idMat3 &trmAxis, int contentMask,
@@ -341,6 +369,9 @@ private:			// CollisionMap_translate.cpp
 	bool			TranslateTrmThroughPolygon( cm_traceWork_t *tw, cm_polygon_t *p );
 	void			SetupTranslationHeartPlanes( cm_traceWork_t *tw );
 	void			SetupTrm( cm_traceWork_t *tw, const idTraceModel *trm );
+	bool			TranslatePointRayThroughPolygon( cm_rayPacket_t *packet, cm_pointRay_t *ray, cm_polygon_t *p );
+	void			TranslationPacket( trace_t *results, const idVec3 *starts, const idVec3 *ends, int numRays, int contentMask,
+								cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis );
 
 private:			// CollisionMap_rotate.cpp
 	int				CollisionBetweenEdgeBounds( cm_traceWork_t *tw, const idVec3 &va, const idVec3 &vb,
@@ -383,6 +414,8 @@ private:			// CollisionMap_trace.cpp
 	void			TraceTrmThroughNode( cm_traceWork_t *tw, cm_node_t *node );
 	void			TraceThroughAxialBSPTree_r( cm_traceWork_t *tw, cm_node_t *node, float p1f, float p2f, idVec3 &p1, idVec3 &p2);
 	void			TraceThroughModel( cm_traceWork_t *tw );
+	void			TraceRayThroughAxialBSPTree_r( cm_rayPacket_t *packet, cm_pointRay_t *ray, cm_node_t *node, float p1f, float p2f );
+	void			TraceRayPacketThroughAxialBSPTree_r( cm_rayPacket_t *packet, cm_node_t *node, int activeMask, const float *p1f, const float *p2f );
 	void			RecurseProcBSP_r( trace_t *results, int parentNodeNum, int nodeNum, float p1f, float p2f, const idVec3 &p1, const idVec3 &p2 );
 
 private:			// CollisionMap_load.cpp
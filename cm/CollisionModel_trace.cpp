@@ -197,6 +197,195 @@ void idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( cm_traceWork_t *t
 	idCollisionModelManagerLocal::TraceThroughAxialBSPTree_r( tw, node->children[side^1], midf, p2f, mid, p2 );
 }
 
+/*
+================
+idCollisionModelManagerLocal::TraceRayThroughAxialBSPTree_r
+
+  single ray of packet, used when rays of packet have diverged
+================
+*/
+void idCollisionModelManagerLocal::TraceRayThroughAxialBSPTree_r( cm_rayPacket_t *packet, cm_pointRay_t *ray, cm_node_t *node, float p1f, float p2f ) {
+	int side;
+	float t1, t2, frac, frac2, idist, midf;
+	const float offset = CM_BOX_EPSILON;
+
+	if ( !node ) {
+		return;
+	}
+
+	if ( ray->trace.fraction <= p1f ) {
+		return;
+	}
+
+	for ( cm_polygonRef_t *pref = node->polygons; pref; pref = pref->next ) {
+		if ( idCollisionModelManagerLocal::TranslatePointRayThroughPolygon( packet, ray, pref->p ) ) {
+			return;
+		}
+	}
+	// if this is a leaf node
+	if ( node->planeType == -1 ) {
+		return;
+	}
+
+	t1 = ray->start[node->planeType] + p1f * ray->dir[node->planeType] - node->planeDist;
+	t2 = ray->start[node->planeType] + p2f * ray->dir[node->planeType] - node->planeDist;
+
+	if ( t1 >= offset && t2 >= offset ) {
+		idCollisionModelManagerLocal::TraceRayThroughAxialBSPTree_r( packet, ray, node->children[0], p1f, p2f );
+		return;
+	}
+	if ( t1 < -offset && t2 < -offset ) {
+		idCollisionModelManagerLocal::TraceRayThroughAxialBSPTree_r( packet, ray, node->children[1], p1f, p2f );
+		return;
+	}
+
+	if ( t1 < t2 ) {
+		idist = 1.0f / ( t1 - t2 );
+		side = 1;
+		frac2 = ( t1 + offset ) * idist;
+		frac = ( t1 - offset ) * idist;
+	} else if ( t1 > t2 ) {
+		idist = 1.0f / ( t1 - t2 );
+		side = 0;
+		frac2 = ( t1 - offset ) * idist;
+		frac = ( t1 + offset ) * idist;
+	} else {
+		side = 0;
+		frac = 1.0f;
+		frac2 = 0.0f;
+	}
+	frac = idMath::ClampFloat( 0.0f, 1.0f, frac );
+	frac2 = idMath::ClampFloat( 0.0f, 1.0f, frac2 );
+
+	midf = p1f + ( p2f - p1f ) * frac;
+	idCollisionModelManagerLocal::TraceRayThroughAxialBSPTree_r( packet, ray, node->children[side], p1f, midf );
+	midf = p1f + ( p2f - p1f ) * frac2;
+	idCollisionModelManagerLocal::TraceRayThroughAxialBSPTree_r( packet, ray, node->children[side^1], midf, p2f );
+}
+
+/*
+================
+idCollisionModelManagerLocal::TraceRayPacketThroughAxialBSPTree_r
+
+  same as TraceThroughAxialBSPTree_r for a packet of point traces
+  every ray has its own range of fractions [p1f, p2f] inside the node
+================
+*/
+void idCollisionModelManagerLocal::TraceRayPacketThroughAxialBSPTree_r( cm_rayPacket_t *packet, cm_node_t *node, int activeMask, const float *p1f, const float *p2f ) {
+	int i, side;
+	float t1[CM_MAX_RAY_PACKET], t2[CM_MAX_RAY_PACKET];
+	float childP1f[2][CM_MAX_RAY_PACKET], childP2f[2][CM_MAX_RAY_PACKET];
+	int nearMask[2], farMask[2];
+	float frac, frac2, idist;
+	const float offset = CM_BOX_EPSILON;
+
+	if ( !node ) {
+		return;
+	}
+
+	// drop rays which already hit something nearer
+	for ( i = 0; i < packet->numRays; i++ ) {
+		if ( packet->rays[i].trace.fraction <= p1f[i] ) {
+			activeMask &= ~( 1 << i );
+		}
+	}
+	if ( !activeMask ) {
+		return;
+	}
+	if ( !( activeMask & ( activeMask - 1 ) ) ) {
+		// only one ray left
+		i = idMath::ILog2( activeMask );
+		idCollisionModelManagerLocal::TraceRayThroughAxialBSPTree_r( packet, &packet->rays[i], node, p1f[i], p2f[i] );
+		return;
+	}
+
+	// trace every ray through all polygons in this node
+	if ( node->polygons ) {
+		for ( i = 0; i < packet->numRays; i++ ) {
+			if ( !( activeMask & ( 1 << i ) ) ) {
+				continue;
+			}
+			for ( cm_polygonRef_t *pref = node->polygons; pref; pref = pref->next ) {
+				if ( idCollisionModelManagerLocal::TranslatePointRayThroughPolygon( packet, &packet->rays[i], pref->p ) ) {
+					break;
+				}
+			}
+		}
+	}
+	// if this is a leaf node
+	if ( node->planeType == -1 ) {
+		return;
+	}
+
+	// distance from plane for range start and end
+	const float *start = packet->start[node->planeType];
+	const float *dir = packet->dir[node->planeType];
+	for ( i = 0; i < packet->numRays; i++ ) {
+		t1[i] = start[i] + p1f[i] * dir[i] - node->planeDist;
+		t2[i] = start[i] + p2f[i] * dir[i] - node->planeDist;
+		// rays which don't cross the plane keep parent range
+		childP1f[0][i] = childP1f[1][i] = p1f[i];
+		childP2f[0][i] = childP2f[1][i] = p2f[i];
+	}
+
+	// nearMask: rays which start at this side, farMask: rays which cross the plane to this side
+	nearMask[0] = nearMask[1] = 0;
+	farMask[0] = farMask[1] = 0;
+	for ( i = 0; i < packet->numRays; i++ ) {
+		int bit = 1 << i;
+		if ( !( activeMask & bit ) ) {
+			continue;
+		}
+		if ( t1[i] >= offset && t2[i] >= offset ) {
+			nearMask[0] |= bit;
+			continue;
+		}
+		if ( t1[i] < -offset && t2[i] < -offset ) {
+			nearMask[1] |= bit;
+			continue;
+		}
+
+		if ( t1[i] < t2[i] ) {
+			idist = 1.0f / ( t1[i] - t2[i] );
+			side = 1;
+			frac2 = ( t1[i] + offset ) * idist;
+			frac = ( t1[i] - offset ) * idist;
+		} else if ( t1[i] > t2[i] ) {
+			idist = 1.0f / ( t1[i] - t2[i] );
+			side = 0;
+			frac2 = ( t1[i] - offset ) * idist;
+			frac = ( t1[i] + offset ) * idist;
+		} else {
+			side = 0;
+			frac = 1.0f;
+			frac2 = 0.0f;
+		}
+		frac = idMath::ClampFloat( 0.0f, 1.0f, frac );
+		frac2 = idMath::ClampFloat( 0.0f, 1.0f, frac2 );
+
+		// near side up to the node, far side past the node
+		nearMask[side] |= bit;
+		childP1f[side][i] = p1f[i];
+		childP2f[side][i] = p1f[i] + ( p2f[i] - p1f[i] ) * frac;
+		farMask[side^1] |= bit;
+		childP1f[side^1][i] = p1f[i] + ( p2f[i] - p1f[i] ) * frac2;
+		childP2f[side^1][i] = p2f[i];
+	}
+
+	// every ray must visit its near side first, so that it stops as early as single trace does:
+	// the side with more near rays is visited first, and again afterwards for rays which reach it last
+	side = ( idMath::BitCount( nearMask[1] ) > idMath::BitCount( nearMask[0] ) ? 1 : 0 );
+	if ( nearMask[side] ) {
+		idCollisionModelManagerLocal::TraceRayPacketThroughAxialBSPTree_r( packet, node->children[side], nearMask[side], childP1f[side], childP2f[side] );
+	}
+	if ( nearMask[side^1] | farMask[side^1] ) {
+		idCollisionModelManagerLocal::TraceRayPacketThroughAxialBSPTree_r( packet, node->children[side^1], nearMask[side^1] | farMask[side^1], childP1f[side^1], childP2f[side^1] );
+	}
+	if ( farMask[side] ) {
+		idCollisionModelManagerLocal::TraceRayPacketThroughAxialBSPTree_r( packet, node->children[side], farMask[side], childP1f[side], childP2f[side] );
+	}
+}
+
 /*
 ================
 idCollisionModelManagerLocal::TraceThroughModel
@@ -1103,3 +1103,245 @@ void idCollisionModelManagerLocal::Translation( trace_t *results, const idVec3 &
     }
 #endif
 }
+
+/*
+===============================================================================
+
+Batched point traces
+
+===============================================================================
+*/
+
+/*
+================
+idCollisionModelManagerLocal::TranslatePointRayThroughPolygon
+
+  same as TranslateTrmThroughPolygon for a point trace
+  returns true if the polygon blocks the complete translation
+================
+*/
+bool idCollisionModelManagerLocal::TranslatePointRayThroughPolygon( cm_rayPacket_t *packet, cm_pointRay_t *ray, cm_polygon_t *p ) {
+	int i, edgeNum;
+	float f;
+	cm_edge_t *edge;
+	idPluecker pl;
+
+	// if already checked this polygon
+	if ( p->checkcount == ray->checkCount ) {
+		return false;
+	}
+	p->checkcount = ray->checkCount;
+
+	// if this polygon does not have the right contents behind it
+	if ( !(p->contents & packet->contents) ) {
+		return false;
+	}
+
+	// if the the trace bounds do not intersect the polygon bounds
+	if ( !ray->bounds.IntersectsBounds( p->bounds ) ) {
+		return false;
+	}
+
+	// only collide with the polygon if approaching at the front
+	if ( ( p->plane.Normal() * ray->dir ) > 0.0f ) {
+		return false;
+	}
+
+	// if the polygon is too far from the heart planes
+	if ( idMath::Fabs( p->bounds.PlaneDistance( ray->heartPlane1 ) ) > CM_BOX_EPSILON ) {
+		return false;
+	}
+	if ( idMath::Fabs( p->bounds.PlaneDistance( ray->heartPlane2 ) ) > CM_BOX_EPSILON ) {
+		return false;
+	}
+
+	f = CM_TranslationPlaneFraction( p->plane, ray->start, ray->end );
+	if ( f >= ray->trace.fraction ) {
+		return false;
+	}
+
+	for ( i = 0; i < p->numEdges; i++ ) {
+		edgeNum = p->edges[i];
+		edge = packet->model->edges + abs(edgeNum);
+		// sidedness cache is valid for one ray only
+		if ( edge->checkcount != ray->checkCount ) {
+			edge->checkcount = ray->checkCount;
+			pl.FromLine( packet->model->vertices[edge->vertexNum[0]].p, packet->model->vertices[edge->vertexNum[1]].p );
+			float fl = ray->pl.PermutedInnerProduct( pl );
+			edge->side = FLOATSIGNBITSET( fl );
+		}
+		// if the point passes the edge at the wrong side
+		if ( INTSIGNBITSET(edgeNum) ^ edge->side ) {
+			return false;
+		}
+	}
+	if ( f < 0.0f ) {
+		f = 0.0f;
+	}
+	ray->trace.fraction = f;
+	// collision plane is the polygon plane
+	ray->trace.c.normal = p->plane.Normal();
+	ray->trace.c.dist = p->plane.Dist();
+	ray->trace.c.contents = p->contents;
+	ray->trace.c.material = p->material;
+	ray->trace.c.type = CONTACT_TRMVERTEX;
+	ray->trace.c.modelFeature = *reinterpret_cast<int *>(&p);
+	ray->trace.c.trmFeature = 0;
+	ray->trace.c.point = ray->start + f * ray->dir;
+
+	// decrease bounds
+	for ( i = 0; i < 3; i++ ) {
+		if ( ray->start[i] < ray->trace.c.point[i] ) {
+			ray->bounds[0][i] = ray->start[i] - CM_BOX_EPSILON;
+			ray->bounds[1][i] = ray->trace.c.point[i] + CM_BOX_EPSILON;
+		}
+		else {
+			ray->bounds[0][i] = ray->trace.c.point[i] - CM_BOX_EPSILON;
+			ray->bounds[1][i] = ray->start[i] + CM_BOX_EPSILON;
+		}
+	}
+
+	return ( f == 0.0f );
+}
+
+/*
+================
+idCollisionModelManagerLocal::TranslationPacket
+
+  at most CM_MAX_RAY_PACKET point traces with nonzero length
+================
+*/
+void idCollisionModelManagerLocal::TranslationPacket( trace_t *results, const idVec3 *starts, const idVec3 *ends, int numRays, int contentMask,
+										cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) {
+	int i, j;
+	idVec3 normal1, normal2;
+	idMat3 invModelAxis;
+	cm_rayPacket_t packet;
+	float p1f[CM_MAX_RAY_PACKET], p2f[CM_MAX_RAY_PACKET];
+
+	assert( numRays > 0 && numRays <= CM_MAX_RAY_PACKET );
+	assert( !idCollisionModelManagerLocal::getContacts );
+
+	bool model_rotated = modelAxis.IsRotated();
+	if ( model_rotated ) {
+		invModelAxis = modelAxis.Transpose();
+	}
+
+	packet.model = idCollisionModelManagerLocal::models[model];
+	packet.contents = contentMask;
+	packet.numRays = numRays;
+
+	for ( i = 0; i < numRays; i++ ) {
+		cm_pointRay_t &ray = packet.rays[i];
+
+		ray.start = starts[i] - modelOrigin;
+		ray.end = ends[i] - modelOrigin;
+		ray.dir = ends[i] - starts[i];
+		if ( model_rotated ) {
+			// rotate trace instead of model
+			ray.start *= invModelAxis;
+			ray.end *= invModelAxis;
+			ray.dir *= invModelAxis;
+		}
+
+		for ( j = 0; j < 3; j++ ) {
+			if ( ray.start[j] < ray.end[j] ) {
+				ray.bounds[0][j] = ray.start[j] - CM_BOX_EPSILON;
+				ray.bounds[1][j] = ray.end[j] + CM_BOX_EPSILON;
+			}
+			else {
+				ray.bounds[0][j] = ray.end[j] - CM_BOX_EPSILON;
+				ray.bounds[1][j] = ray.start[j] + CM_BOX_EPSILON;
+			}
+			packet.start[j][i] = ray.start[j];
+			packet.dir[j][i] = ray.dir[j];
+		}
+
+		// trace heart planes
+		idVec3 dir = ray.dir;
+		dir.Normalize();
+		dir.NormalVectors( normal1, normal2 );
+		ray.heartPlane1.SetNormal( normal1 );
+		ray.heartPlane1.FitThroughPoint( ray.start );
+		ray.heartPlane2.SetNormal( normal2 );
+		ray.heartPlane2.FitThroughPoint( ray.start );
+
+		ray.pl.FromRay( ray.start, ray.dir );
+		// polygon and edge caches are per ray
+		ray.checkCount = ++idCollisionModelManagerLocal::checkCount;
+
+		memset( &ray.trace, 0, sizeof( ray.trace ) );
+		ray.trace.fraction = 1.0f;
+		ray.trace.c.type = CONTACT_NONE;
+
+		p1f[i] = 0.0f;
+		p2f[i] = 1.0f;
+	}
+
+	idCollisionModelManagerLocal::TraceRayPacketThroughAxialBSPTree_r( &packet, packet.model->node, ( 1 << numRays ) - 1, p1f, p2f );
+
+	for ( i = 0; i < numRays; i++ ) {
+		trace_t &result = results[i];
+		result = packet.rays[i].trace;
+		result.endpos = starts[i] + result.fraction * ( ends[i] - starts[i] );
+		result.endAxis = mat3_identity;
+
+		if ( result.fraction < 1.0f ) {
+			// rotate trace plane normal if there was a collision with a rotated model
+			if ( model_rotated ) {
+				result.c.normal *= modelAxis;
+				result.c.point *= modelAxis;
+			}
+			result.c.point += modelOrigin;
+			result.c.dist += modelOrigin * result.c.normal;
+		}
+	}
+	idCollisionModelManagerLocal::numContacts = 0;
+}
+
+/*
+================
+idCollisionModelManagerLocal::TranslationPoints
+================
+*/
+void idCollisionModelManagerLocal::TranslationPoints( trace_t *results, const idVec3 *starts, const idVec3 *ends, int numRays, int contentMask,
+										cmHandle_t model, const idVec3 &modelOrigin, const idMat3 &modelAxis ) {
+	int indices[CM_MAX_RAY_PACKET];
+	idVec3 packetStarts[CM_MAX_RAY_PACKET], packetEnds[CM_MAX_RAY_PACKET];
+	trace_t packetResults[CM_MAX_RAY_PACKET];
+
+	if ( model < 0 || model > MAX_SUBMODELS || model > idCollisionModelManagerLocal::maxModels || !idCollisionModelManagerLocal::models[model] ) {
+		for ( int i = 0; i < numRays; i++ ) {
+			Translation( &results[i], starts[i], ends[i], NULL, mat3_identity, contentMask, model, modelOrigin, modelAxis );
+		}
+		return;
+	}
+
+	int num = 0;
+	for ( int i = 0; i < numRays; i++ ) {
+		if ( starts[i] == ends[i] ) {
+			// special position test
+			Translation( &results[i], starts[i], ends[i], NULL, mat3_identity, contentMask, model, modelOrigin, modelAxis );
+			continue;
+		}
+		indices[num] = i;
+		packetStarts[num] = starts[i];
+		packetEnds[num] = ends[i];
+		num++;
+
+		if ( num == CM_MAX_RAY_PACKET || i == numRays - 1 ) {
+			TranslationPacket( packetResults, packetStarts, packetEnds, num, contentMask, model, modelOrigin, modelAxis );
+			for ( int j = 0; j < num; j++ ) {
+				results[indices[j]] = packetResults[j];
+			}
+			num = 0;
+		}
+	}
+	if ( num > 0 ) {
+		// last ray was a position test
+		TranslationPacket( packetResults, packetStarts, packetEnds, num, contentMask, model, modelOrigin, modelAxis );
+		for ( int j = 0; j < num; j++ ) {
+			results[indices[j]] = packetResults[j];
+		}
+	}
+}
@@ -130,6 +130,7 @@ int				time_frontend;			// renderSystem frontend time
 int				time_backend;			// renderSystem backend time
 int				time_frontendLast;
 int				time_backendLast;
+frameTimings_t	com_frameTimings;
 
 int				com_frameTime;			// time moment of the current frame in milliseconds
 int				com_frameDelta;			// time elapsed since previous frame in milliseconds
@@ -2413,6 +2414,8 @@ void idCommonLocal::InitCommands( void ) {
 	cmdSystem->AddCommand( "showLoadStackMemory", LoadStack::ShowMemoryUsage_f, CMD_FL_SYSTEM, "shows memory used by load stack strings (see decl_stack)" );
 	cmdSystem->AddCommand( "listLoadStackStrings", LoadStack::ListStrings_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "lists all strings stored in load stacks (see decl_stack)" );
 	cmdSystem->AddCommand( "testSIMD", idSIMD::Test_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "test SIMD code" );
+	cmdSystem->AddCommand( "benchmarkSIMD", idSIMD::Benchmark_f, CMD_FL_SYSTEM, "verify and benchmark all SIMD processors supported by CPU, optionally write JSON/CSV report" );
+	cmdSystem->AddCommand( "benchmarkTaskScheduler", idTaskScheduler::Benchmark_f, CMD_FL_SYSTEM, "measure overhead and scaling of task scheduler" );
 
 	// localization
 	cmdSystem->AddCommand( "localizeGuis", Com_LocalizeGuis_f, CMD_FL_SYSTEM|CMD_FL_CHEAT, "localize guis" );
@@ -2543,9 +2546,14 @@ void idCommonLocal::Frame( void ) {
 		// report timing information
 		if ( com_speeds.GetBool() ) {
 			Printf("frame:%i all:%3i gfr:%3i fr:%3i(%d) br:%3i(%d)\n", com_frameNumber, com_frameDelta, time_gameFrame, time_frontend, time_frontendLast, time_backend, time_backendLast);
-			time_gameFrame = 0;
-			time_gameDraw = 0;
-		}	
+		}
+		com_frameTimings.frames++;
+		com_frameTimings.gameFrame += time_gameFrame;
+		com_frameTimings.gameDraw += time_gameDraw;
+		com_frameTimings.frontend += time_frontend;
+		com_frameTimings.backend += time_backend;
+		time_gameFrame = 0;
+		time_gameDraw = 0;
 
 		com_frameNumber++;
 
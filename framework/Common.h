@@ -74,6 +74,16 @@ extern int			time_frontendLast;		// renderer frontend time
 extern int			time_backend;			// renderer backend time
 extern int			time_backendLast;		// renderer backend time
 
+// per-subsystem times summed over frames, reported by timedemo and automation "timings" query
+typedef struct {
+	int				frames;
+	int64			gameFrame;
+	int64			gameDraw;
+	int64			frontend;
+	int64			backend;
+} frameTimings_t;
+extern frameTimings_t	com_frameTimings;
+
 extern int			com_frameTime;			// time moment of the current frame in milliseconds
 extern int			com_frameDelta;			// time elapsed since previous frame in milliseconds
 extern std::atomic<int>	com_ticNumber;		// 60 hz tics, incremented by async function
@@ -799,6 +799,12 @@ void idSessionLocal::StopPlayingRenderDemo() {
 		idStr	message = va( "%i frames rendered in %3.1f seconds = %3.1f fps\n", numDemoFrames, demoSeconds, demoFPS );
 
 		common->Printf( message );
+		const frameTimings_t &t = com_frameTimings;
+		if ( t.frames > 0 ) {
+			common->Printf( "average msec per frame: game %.2f, draw %.2f, frontend %.2f, backend %.2f (%d frames)\n",
+				t.gameFrame / float( t.frames ), t.gameDraw / float( t.frames ),
+				t.frontend / float( t.frames ), t.backend / float( t.frames ), t.frames );
+		}
 		if ( timeDemo == TD_YES_THEN_QUIT ) {
 			cmdSystem->BufferCommandText( CMD_EXEC_APPEND, "quit\n" );
 		} else {
@@ -881,6 +887,7 @@ void idSessionLocal::StartPlayingRenderDemo( idStr demoName ) {
 
 	lastDemoTic = -1;
 	timeDemoStartTime = Sys_Milliseconds();
+	memset( &com_frameTimings, 0, sizeof( com_frameTimings ) );
 }
 
 /*
@@ -2727,13 +2734,10 @@ void idSessionLocal::UpdateScreen( bool outOfSequence ) {
 	
 	renderSystem->BeginFrame( renderSystem->GetScreenWidth(), renderSystem->GetScreenHeight() );
 
-	if (com_speeds.GetBool()) {
-		time_backendLast = backEnd.pc.msecLast;
-		time_frontendLast = tr.pc.frontEndMsecLast;
-		renderSystem->EndFrame(&time_frontend, &time_backend);
-	} else {
-		renderSystem->EndFrame( NULL, NULL );
-	}
+	// times are always collected for com_frameTimings
+	time_backendLast = backEnd.pc.msecLast;
+	time_frontendLast = tr.pc.frontEndMsecLast;
+	renderSystem->EndFrame(&time_frontend, &time_backend);
 
 	insideUpdateScreen = false;
 }
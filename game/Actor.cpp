@@ -2182,9 +2182,6 @@ bool idActor::CanSee( idEntity *ent, bool useFov ) const
 		}
 
 		bool fovEyeOK;
-		bool fovOriginOK;
-		bool fovShoulder1OK;
-		bool fovShoulder2OK;
 
 		idActor* actor = static_cast<idActor*>(ent);
 
@@ -2203,23 +2200,10 @@ bool idActor::CanSee( idEntity *ent, bool useFov ) const
 			}
 		}
 
-		// Check origin
+		// Check origin and both shoulders
+		// these are only needed if eye trace failed, so they are traced together in one batch
 
 		const idVec3& actorOrigin = actor->GetPhysics()->GetOrigin();
-		fovOriginOK = useFov ? CheckFOV(actorOrigin) : true;
-
-		if ( fovOriginOK )
-		{
-			if ( !gameLocal.clip.TracePoint(result, eye, actorOrigin, MASK_OPAQUE, this) ||
-				gameLocal.GetTraceEntity(result) == actor )
-			{
-				// Eye to origin trace succeeded
-				// gameRenderWorld->DebugArrow(colorGreen,eye, actorOrigin, 1, 32);
-				return true;
-			}
-		}
-
-		// Check one shoulder
 
 		idVec3 dir;
 		if ( actor->AI_DEAD || actor->IsKnockedOut() )
@@ -2241,32 +2225,31 @@ bool idActor::CanSee( idEntity *ent, bool useFov ) const
 
 		float dist = 8;
 
-		const idVec3& shoulder1 = actorOrigin + (actorEyePos - actorOrigin)*0.7f + dir * dist;
-		fovShoulder1OK = useFov ? CheckFOV(shoulder1) : true;
+		const idVec3 shoulder1 = actorOrigin + (actorEyePos - actorOrigin)*0.7f + dir * dist;
+		const idVec3 shoulder2 = actorOrigin + (actorEyePos - actorOrigin)*0.7f - dir * dist;
 
-		if ( fovShoulder1OK )
+		const idVec3 *targets[3] = { &actorOrigin, &shoulder1, &shoulder2 };
+		idVec3 starts[3], ends[3];
+		trace_t results[3];
+		int numRays = 0;
+		for ( int i = 0; i < 3; i++ )
 		{
-			if ( !gameLocal.clip.TracePoint(result, eye, shoulder1, MASK_OPAQUE, this) ||
-				gameLocal.GetTraceEntity(result) == actor )
+			if ( useFov && !CheckFOV(*targets[i]) )
 			{
-				// Eye to shoulder1 trace succeeded
-				// gameRenderWorld->DebugArrow(colorGreen,eye, shoulder1, 1, 32);
-				return true;
+				continue;
 			}
+			starts[numRays] = eye;
+			ends[numRays] = *targets[i];
+			numRays++;
 		}
 
-		// Check other shoulder
-
-		const idVec3& shoulder2 = actorOrigin + (actorEyePos - actorOrigin)*0.7f - dir * dist;
-		fovShoulder2OK = useFov ? CheckFOV(shoulder2) : true;
-
-		if ( fovShoulder2OK )
+		gameLocal.clip.TracePoints(results, starts, ends, numRays, MASK_OPAQUE, this);
+		for ( int i = 0; i < numRays; i++ )
 		{
-			if ( !gameLocal.clip.TracePoint(result, eye, shoulder2, MASK_OPAQUE, this) ||
-				gameLocal.GetTraceEntity(result) == actor )
+			if ( results[i].fraction == 1.0f || gameLocal.GetTraceEntity(results[i]) == actor )
 			{
-				// Eye to shoulder2 trace succeeded
-				// gameRenderWorld->DebugArrow(colorGreen,eye, shoulder2, 1, 32);
+				// Eye to origin/shoulder trace succeeded
+				// gameRenderWorld->DebugArrow(colorGreen, eye, ends[i], 1, 32);
 				return true;
 			}
 		}
@@ -23,8 +23,6 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 #include "darkModLAS.h"
 #include "../sys/sys_public.h"
 
-#define HIDE_GRID_SPACING 40.0
-
 // Quality of a hiding spot ranges from 0.0 (HIDING_SPOT_MAX_LIGHT_QUOTIENT) to 1.0 (pitch black)
 #define OCCLUSION_HIDING_SPOT_QUALITY 1.0
 
@@ -38,10 +36,6 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 // greebo: Maximum number of AAS areas to test per findMoreHidingSpot call.
 #define MAX_AREAS_PER_PASS 20
 
-// This is the distance inward from an AAS edge to move test points, so that
-// we don't test inside objects or other walls
-#define WALL_MARGIN_SIZE 1.0f
-
 // Static member for debugging hiding spot results
 idList<darkModHidingSpot> CDarkmodAASHidingSpotFinder::DebugDrawList;
 
@@ -590,7 +584,23 @@ bool CDarkmodAASHidingSpotFinder::testingAASAreas_InVisiblePVSArea
 			// Initialize grid search for inside visible AAS area
 			idBounds currentAASAreaBounds = p_aas->GetAreaBounds (aasAreaIndex);
 
-			if (searchLimits.IntersectsBounds(currentAASAreaBounds)) // grayman #2603
+			if (searchLimits.IntersectsBounds(currentAASAreaBounds) && UseHidingSpotDatabase())
+			{
+				// Precomputed candidates are cheap to rate, do the whole area right away
+				if (!testDatabaseCandidatesInAASArea(inout_hidingSpots, aasAreaIndex, inout_numPointsTestedThisPass))
+				{
+					return false;
+				}
+
+				areasTestedThisPass++;
+				if (areasTestedThisPass >= MAX_AREAS_PER_PASS)
+				{
+					// Continue with the next AAS area next time
+					numAASAreaIndicesSearched++;
+					return true;
+				}
+			}
+			else if (searchLimits.IntersectsBounds(currentAASAreaBounds)) // grayman #2603
 			{
 				currentGridSearchBounds = searchLimits.Intersect (currentAASAreaBounds);
 				currentGridSearchAASAreaNum = aasAreaIndex;
@@ -838,6 +848,171 @@ bool CDarkmodAASHidingSpotFinder::testingInsideVisibleAASArea
 	return true;
 }
 
+//-------------------------------------------------------------------------------------------------------
+
+bool CDarkmodAASHidingSpotFinder::testDatabaseCandidatesInAASArea
+(
+	CDarkmodHidingSpotTree& inout_hidingSpots,
+	int aasAreaIndex,
+	int& inout_numPointsTestedThisPass
+)
+{
+	// Make sure we have a valid PVS handle for the PVS membership tests
+	EnsurePVS();
+
+	const CHidingSpotDatabase::candidate_t* areaCandidates = LAS.hidingSpotDatabase.getCandidates(aasAreaIndex);
+	int numCandidates = LAS.hidingSpotDatabase.getNumCandidates(aasAreaIndex);
+
+	// No hiding spot area node yet used
+	TDarkmodHidingSpotAreaNode* p_hidingAreaNode = NULL;
+
+	for (int i = 0; i < numCandidates; i++)
+	{
+		const CHidingSpotDatabase::candidate_t& candidate = areaCandidates[i];
+
+		// The grid search only covers the part of the area within the search limits
+		if (candidate.origin.x < searchLimits[0].x || candidate.origin.x > searchLimits[1].x ||
+			candidate.origin.y < searchLimits[0].y || candidate.origin.y > searchLimits[1].y)
+		{
+			continue;
+		}
+
+		// Test if it is inside the exclusion bounds
+		if (searchIgnoreLimits.ContainsPoint(candidate.origin))
+		{
+			continue;
+		}
+
+		darkModHidingSpot hidingSpot;
+		hidingSpot.hidingSpotTypes = TestHidingCandidate
+		(
+			candidate,
+			inout_numPointsTestedThisPass,
+			hidingSpot.lightQuotient,
+			hidingSpot.qualityWithoutDistanceFactor,
+			hidingSpot.quality
+		);
+
+		if (hidingSpot.hidingSpotTypes == NONE_HIDING_SPOT_TYPE || hidingSpot.quality <= 0.0)
+		{
+			continue;
+		}
+
+		hidingSpot.goal.areaNum = aasAreaIndex;
+		hidingSpot.goal.origin = candidate.origin;
+
+		// ensure area index is in hiding spot tree
+		if (p_hidingAreaNode == NULL)
+		{
+			p_hidingAreaNode = inout_hidingSpots.getArea(aasAreaIndex);
+
+			if (p_hidingAreaNode == NULL)
+			{
+				p_hidingAreaNode = inout_hidingSpots.insertArea(aasAreaIndex);
+				if (p_hidingAreaNode == NULL)
+				{
+					return false;
+				}
+			}
+		}
+
+		// Add spot under this index in the hiding spot tree
+		inout_hidingSpots.insertHidingSpot
+		(
+			p_hidingAreaNode,
+			hidingSpot.goal,
+			hidingSpot.hidingSpotTypes,
+			hidingSpot.lightQuotient,
+			hidingSpot.qualityWithoutDistanceFactor,
+			hidingSpot.quality,
+			hidingSpotRedundancyDistance
+		);
+	}
+
+	return true;
+}
+
+//----------------------------------------------------------------------------
+
+bool CDarkmodAASHidingSpotFinder::UseHidingSpotDatabase()
+{
+	if (!cv_ai_hiding_spot_database.GetBool() || p_aas == NULL)
+	{
+		return false;
+	}
+
+	// This returns right away if loading was already attempted
+	if (!LAS.hidingSpotDatabase.load(LAS.getAASName()))
+	{
+		return false;
+	}
+
+	// The stored lighting is only valid for hiders of the height it was tested for
+	return idMath::Fabs(LAS.hidingSpotDatabase.getHidingHeight() - hidingHeight) < 1.0f;
+}
+
+//----------------------------------------------------------------------------
+
+int CDarkmodAASHidingSpotFinder::TestHidingCandidate
+(
+	const CHidingSpotDatabase::candidate_t& candidate,
+	int& inout_numPointsTestedThisPass,
+	float& out_lightQuotient,
+	float& out_qualityWithoutDistance,
+	float& out_quality
+)
+{
+	float lightQuotient = -1.0f;
+	int occlusionTypes = NONE_HIDING_SPOT_TYPE;
+	float occlusionQuality = OCCLUSION_HIDING_SPOT_QUALITY;
+
+	out_lightQuotient = candidate.lightQuotient;
+
+	if ((hidingSpotTypesAllowed & DARKNESS_HIDING_SPOT_TYPE) != 0)
+	{
+		bool requeried = false;
+		out_lightQuotient = LAS.hidingSpotDatabase.getLightQuotient(candidate, p_ignoreEntity.GetEntity(), requeried);
+		lightQuotient = out_lightQuotient;
+
+		// A lighting query is as expensive as testing a grid point
+		if (requeried)
+		{
+			inout_numPointsTestedThisPass++;
+		}
+	}
+
+	if ((hidingSpotTypesAllowed & PVS_AREA_HIDING_SPOT_TYPE) != 0 &&
+		!gameLocal.pvs.InCurrentPVS(h_hideFromPVS, candidate.pvsArea))
+	{
+		// This part of the AAS area lies in a PVS area which can't be seen at all
+		occlusionTypes = PVS_AREA_HIDING_SPOT_TYPE;
+	}
+	else if ((hidingSpotTypesAllowed & VISUAL_OCCLUSION_HIDING_SPOT_TYPE) != 0)
+	{
+		trace_t rayResult;
+		if (gameLocal.clip.TracePoint(rayResult, hideFromPosition, candidate.origin, MASK_SOLID, NULL))
+		{
+			occlusionTypes = VISUAL_OCCLUSION_HIDING_SPOT_TYPE;
+
+			// Spots right next to something to hide behind are better than ones just out of sight
+			occlusionQuality *= 0.5f + 0.5f * candidate.cover;
+		}
+	}
+
+	return RateHidingPoint
+	(
+		candidate.origin,
+		searchCenter,
+		searchRadius,
+		hidingSpotTypesAllowed,
+		lightQuotient,
+		occlusionTypes,
+		occlusionQuality,
+		out_qualityWithoutDistance,
+		out_quality
+	);
+}
+
 //----------------------------------------------------------------------------
 
 // Internal helper
@@ -854,8 +1029,8 @@ int CDarkmodAASHidingSpotFinder::TestHidingPoint
 	float& out_quality
 )
 {
-	int out_hidingSpotTypesThatApply = NONE_HIDING_SPOT_TYPE;
-	out_quality = 0.0f; // none found yet
+	float lightQuotient = -1.0f;
+	int occlusionTypes = NONE_HIDING_SPOT_TYPE;
 
 	idVec3 testLineTop = testPoint;
 	testLineTop.z += hidingHeight;
@@ -867,24 +1042,9 @@ int CDarkmodAASHidingSpotFinder::TestHidingPoint
 		//DM_LOG(LC_AI, LT_DEBUG)LOGSTRING("Testing hiding-spot lighting at point %f,%f,%f\n", testPoint.x, testPoint.y, testPoint.z);
 
 		out_lightQuotient = LAS.queryLightingAlongLine(testPoint, testLineTop, p_ignoreEntity, true);
-
-		float maxLightQuotient = cv_ai_hiding_spot_max_light_quotient.GetFloat();
+		lightQuotient = out_lightQuotient;
 
 		//DM_LOG(LC_AI, LT_DEBUG)LOGSTRING("Done testing hiding-spot lighting at point %f,%f,%f\n", testPoint.x, testPoint.y, testPoint.z);
-		if (out_lightQuotient < maxLightQuotient && out_lightQuotient >= 0.0)
-		{
-			//DM_LOG(LC_AI, LT_DEBUG)LOGSTRING("Found hidable darkness of %f at point %f,%f,%f\n", LightQuotient, testPoint.x, testPoint.y, testPoint.z);
-			out_hidingSpotTypesThatApply |= DARKNESS_HIDING_SPOT_TYPE;
-
-			float darknessQuality = 0.0;
-			darknessQuality = (maxLightQuotient - out_lightQuotient) / maxLightQuotient;
-			darknessQuality *= 2.0; // Experimental tweak to make it really focus on dark spots
-
-			if (darknessQuality > out_quality)
-			{
-				out_quality = darknessQuality;
-			}
-		}
 	}
 
 	// Does a ray to the test point from the hide from point get occluded?
@@ -914,15 +1074,72 @@ int CDarkmodAASHidingSpotFinder::TestHidingPoint
 		{
 			// Some sort of occlusion
 			//DM_LOG(LC_AI, LT_DEBUG)LOGSTRING("Found hiding-spot occlusion at point %f,%f,%f, fraction of %f\n", testPoint.x, testPoint.y, testPoint.z, rayResult.fraction);
-			out_hidingSpotTypesThatApply |= VISUAL_OCCLUSION_HIDING_SPOT_TYPE;
+			occlusionTypes = VISUAL_OCCLUSION_HIDING_SPOT_TYPE;
+		}
+		//DM_LOG(LC_AI, LT_DEBUG)LOGSTRING("Done testing hiding-spot occlusion at point %f,%f,%f\n", testPoint.x, testPoint.y, testPoint.z);
+	}
+
+	return RateHidingPoint
+	(
+		testPoint,
+		searchCenter,
+		searchRadius,
+		hidingSpotTypesAllowed,
+		lightQuotient,
+		occlusionTypes,
+		OCCLUSION_HIDING_SPOT_QUALITY,
+		out_qualityWithoutDistance,
+		out_quality
+	);
+}
+
+//----------------------------------------------------------------------------
+
+int CDarkmodAASHidingSpotFinder::RateHidingPoint
+(
+	idVec3 testPoint,
+	idVec3 searchCenter,
+	float searchRadius,
+	int hidingSpotTypesAllowed,
+	float lightQuotient,
+	int occlusionTypes,
+	float occlusionQuality,
+	float& out_qualityWithoutDistance,
+	float& out_quality
+)
+{
+	int out_hidingSpotTypesThatApply = NONE_HIDING_SPOT_TYPE;
+	out_quality = 0.0f; // none found yet
+
+	if ((hidingSpotTypesAllowed & DARKNESS_HIDING_SPOT_TYPE) != 0)
+	{
+		float maxLightQuotient = cv_ai_hiding_spot_max_light_quotient.GetFloat();
+
+		if (lightQuotient < maxLightQuotient && lightQuotient >= 0.0)
+		{
+			//DM_LOG(LC_AI, LT_DEBUG)LOGSTRING("Found hidable darkness of %f at point %f,%f,%f\n", LightQuotient, testPoint.x, testPoint.y, testPoint.z);
+			out_hidingSpotTypesThatApply |= DARKNESS_HIDING_SPOT_TYPE;
+
+			float darknessQuality = 0.0;
+			darknessQuality = (maxLightQuotient - lightQuotient) / maxLightQuotient;
+			darknessQuality *= 2.0; // Experimental tweak to make it really focus on dark spots
 
-			// Occlusions are 50% good
-			if (out_quality < OCCLUSION_HIDING_SPOT_QUALITY)
+			if (darknessQuality > out_quality)
 			{
-				out_quality = OCCLUSION_HIDING_SPOT_QUALITY;
+				out_quality = darknessQuality;
 			}
 		}
-		//DM_LOG(LC_AI, LT_DEBUG)LOGSTRING("Done testing hiding-spot occlusion at point %f,%f,%f\n", testPoint.x, testPoint.y, testPoint.z);
+	}
+
+	if (occlusionTypes != NONE_HIDING_SPOT_TYPE)
+	{
+		out_hidingSpotTypesThatApply |= occlusionTypes;
+
+		// Occlusions are 50% good
+		if (out_quality < occlusionQuality)
+		{
+			out_quality = occlusionQuality;
+		}
 	}
 
 
@@ -23,6 +23,14 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 #include "../game/Entity.h"
 #include "PVSToAASMapping.h"
 #include "darkmodHidingSpotTree.h"
+#include "HidingSpotDatabase.h"
+
+// Spacing of the grid of points tested inside visible AAS areas
+#define HIDE_GRID_SPACING 40.0
+
+// This is the distance inward from an AAS edge to move test points, so that
+// we don't test inside objects or other walls
+#define WALL_MARGIN_SIZE 1.0f
 
 /*!
 * This defines hiding spot characteristics as bit flags
@@ -185,6 +193,53 @@ protected:
 		float& out_quality
 	);
 
+	/*!
+	* This internal method rates a point once its lighting and occlusion are known.
+	* It is shared by TestHidingPoint and TestHidingCandidate.
+	*
+	* @param lightQuotient The light quotient of the point, negative if not known
+	* @param occlusionTypes The hiding spot types due to which the point can't be seen
+	*	from the hide from position, NONE_HIDING_SPOT_TYPE if it can be seen
+	* @param occlusionQuality The quality of the point if it can't be seen
+	*
+	* @return An integer with the bit flags for the allowed hiding spot characteristics
+	*   that were found to be true
+	*/
+	int RateHidingPoint
+	(
+		idVec3 testPoint,
+		idVec3 searchCenter,
+		float searchRadius,
+		int hidingSpotTypesAllowed,
+		float lightQuotient,
+		int occlusionTypes,
+		float occlusionQuality,
+		float& out_qualityWithoutDistance,
+		float& out_quality
+	);
+
+	/*!
+	* Like TestHidingPoint, but for a candidate from the hiding spot database,
+	* whose lighting only needs to be queried if lights have changed since
+	* the database was built.
+	*
+	* @param inout_numPointsTestedThisPass Increased if the candidate needed a lighting query
+	*/
+	int TestHidingCandidate
+	(
+		const CHidingSpotDatabase::candidate_t& candidate,
+		int& inout_numPointsTestedThisPass,
+		float& out_lightQuotient,
+		float& out_qualityWithoutDistance,
+		float& out_quality
+	);
+
+	/*!
+	* Returns true if searches can use the precomputed candidates
+	* of the hiding spot database instead of testing a grid of points
+	*/
+	bool UseHidingSpotDatabase();
+
 	/*!
 	* The following static variables are used for rendering a debug display of
 	* hiding spot find results
@@ -265,6 +320,18 @@ protected:
 		int& inout_numPointsTestedThisPass
 	);
 
+	/*!
+	* Rates the database candidates of a visible AAS area, all at once
+	*
+	* @return false if the hiding spot tree couldn't take the spots
+	*/
+	bool testDatabaseCandidatesInAASArea
+	(
+		CDarkmodHidingSpotTree& inout_hidingSpots,
+		int aasAreaIndex,
+		int& inout_numPointsTestedThisPass
+	);
+
 	/*!
 	* This method resumes the hiding spot test where it
 	* left off and tests up to numPointsToTestThisPass
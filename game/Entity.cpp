@@ -6244,6 +6244,21 @@ void idEntity::RestorePhysics( idPhysics *phys ) {
 	physics = phys;
 }
 
+/*
+================
+idEntity::GetPhysicsStartTime
+================
+*/
+int idEntity::GetPhysicsStartTime( void ) const {
+	// angua: since the AI are not thinking every frame, we need to rescale 
+	// their velocities with the corrected time length to prevent them from dying.
+	if (IsType(idAI::Type))
+	{
+		return static_cast<const idAI*>(this)->m_lastThinkTime;
+	}
+	return gameLocal.previousTime;
+}
+
 /*
 ================
 idEntity::RunPhysics
@@ -6269,16 +6284,7 @@ bool idEntity::RunPhysics( void ) {
 		return false;
 	}
 
-	// angua: since the AI are not thinking every frame, we need to rescale 
-	// their velocities with the corrected time length to prevent them from dying.
-	if (IsType(idAI::Type))
-	{
-		startTime = static_cast<idAI*>(this)->m_lastThinkTime;
-	}
-	else
-	{
-		startTime = gameLocal.previousTime;
-	}
+	startTime = GetPhysicsStartTime();
 	endTime = gameLocal.time;
 
 	gameLocal.push.InitSavingPushedEntityPositions();
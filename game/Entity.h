@@ -729,6 +729,8 @@ public:
 	void					RestorePhysics( idPhysics *phys );
 							// run the physics for this entity
 	bool					RunPhysics( void );
+							// start time of the simulation step RunPhysics makes during this frame
+	int						GetPhysicsStartTime( void ) const;
 							// set the origin of the physics object (relative to bindMaster if not NULL)
 	void					SetOrigin( const idVec3 &org );
 							// set the axis of the physics object (relative to bindMaster if not NULL)
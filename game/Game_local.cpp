@@ -282,6 +282,9 @@ void idGameLocal::Clear( void )
 	m_guiError.Clear();
 
 	m_AreaManager.Clear();
+	m_AIThinkScheduler.Clear();
+	m_ObstacleCache.Clear();
+	m_ManagerScheduler.Clear();
 	m_ConversationSystem.reset();
 
 	if (m_ModelGenerator)
@@ -2504,6 +2507,7 @@ void idGameLocal::MapShutdown( void ) {
 	}
 
 	m_DifficultyManager.Clear();
+	m_ManagerScheduler.Clear();
 
 	if (m_ModelGenerator != NULL)
 	{
@@ -3198,6 +3202,37 @@ void idGameLocal::SortActiveEntityList( void ) {
 	sortPushers = false;
 }
 
+/*
+================
+idGameLocal::PresolveArticulatedFigures
+
+  Puts islands of touching figures to rest and solves the active ones in parallel.
+  Only the figures of entities which are about to run their physics alone are considered.
+================
+*/
+void idGameLocal::PresolveArticulatedFigures( void ) {
+	TRACE_CPU_SCOPE( "PresolveArticulatedFigures" )
+	idList<idPhysics_AF *> figures;
+	idList<int> timeSteps;
+
+	for ( idEntity *ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() ) {
+		if ( !( ent->thinkFlags & TH_PHYSICS ) || ent->GetTeamMaster() != NULL ) {
+			continue;
+		}
+		if ( inCinematic && g_cinematic.GetBool() && !ent->cinematic ) {
+			continue;
+		}
+		idPhysics *phys = ent->GetPhysics();
+		if ( !phys->IsType( idPhysics_AF::Type ) ) {
+			continue;
+		}
+		figures.Append( static_cast<idPhysics_AF *>( phys ) );
+		timeSteps.Append( time - ent->GetPhysicsStartTime() );
+	}
+
+	idPhysics_AF::PresolveFigures( figures, timeSteps, time );
+}
+
 /*
 ================
 idGameLocal::RunFrame
@@ -3302,6 +3337,9 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds, int timestepMs
 			// update our gravity vector if needed.
 			UpdateGravity();
 
+			// relink clip models if broadphase was changed
+			clip.UpdateBroadphase();
+
 			// create a merged pvs for all players
 			SetupPlayerPVS();
 
@@ -3316,13 +3354,22 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds, int timestepMs
 			unsigned int ticks = static_cast<unsigned int>(sys->GetClockTicks());
 
 			// Tick the timers. Should be done before stim/response, just to be safe. :)
-			ProcessTimer(ticks);
+			// Timers which are not running don't need ticks, starting one wakes this up.
+			if (m_ManagerScheduler.BeginRun(CManagerScheduler::ETimers))
+			{
+				int numRunning = ProcessTimer(ticks);
+				m_ManagerScheduler.EndRun(CManagerScheduler::ETimers, numRunning > 0 ? time : CManagerScheduler::SLEEP_UNTIL_WOKEN);
+			}
 
 			// TDM: Work through the active stims/responses
 			ProcessStimResponse(ticks);
 
 			// TDM: Update objective system
-			m_MissionData->UpdateObjectives();
+			if (m_ManagerScheduler.BeginRun(CManagerScheduler::EObjectives))
+			{
+				m_MissionData->UpdateObjectives();
+				m_ManagerScheduler.EndRun(CManagerScheduler::EObjectives, m_MissionData->GetNextUpdateTime());
+			}
 
 			// sort the active entity list
 			SortActiveEntityList();
@@ -3330,6 +3377,11 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds, int timestepMs
 			timer_think.Clear();
 			timer_think.Start();
 
+			PresolveArticulatedFigures();
+
+			// decide which AI may think in this frame
+			m_AIThinkScheduler.Schedule();
+
 			{ // let entities think
 				TRACE_CPU_SCOPE( "ThinkAllEntities" )
 				num = 0;
@@ -3365,6 +3417,7 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds, int timestepMs
 					}
 				}
 			}
+			m_AIThinkScheduler.EndFrame();
 
 			// remove any entities that have stopped thinking
 			if ( numEntitiesToDeactivate ) {
@@ -3395,10 +3448,20 @@ gameReturn_t idGameLocal::RunFrame( const usercmd_t *clientCmds, int timestepMs
 			timer_events.Stop();
 
 			// Process the active AI conversations
-			m_ConversationSystem->ProcessConversations();
+			if (m_ManagerScheduler.BeginRun(CManagerScheduler::EConversations))
+			{
+				int nextTime = m_ConversationSystem->ProcessConversations();
+				m_ManagerScheduler.EndRun(CManagerScheduler::EConversations, nextTime);
+			}
 
 			// grayman #3857 - Process the active searches
-			m_searchManager->ProcessSearches();
+			if (m_ManagerScheduler.BeginRun(CManagerScheduler::ESearches))
+			{
+				int nextTime = m_searchManager->ProcessSearches();
+				m_ManagerScheduler.EndRun(CManagerScheduler::ESearches, nextTime);
+			}
+
+			m_ManagerScheduler.EndFrame();
 
 			// free the player pvs
 			FreePlayerPVS();
@@ -7465,9 +7528,10 @@ int idGameLocal::DoResponseAction(const CStimPtr& stim, const idClip_EntityList
 	return numResponses;
 }
 
-void idGameLocal::ProcessTimer(unsigned int ticks)
+int idGameLocal::ProcessTimer(unsigned int ticks)
 {
 	int i, n;
+	int numRunning = 0;
 	CStimResponseTimer *t;
 
 	n = m_Timer.Num();
@@ -7483,8 +7547,15 @@ void idGameLocal::ProcessTimer(unsigned int ticks)
 		{
 			t = m_Timer[i];
 			t->Tick(ticks);
+
+			if (t->GetState() == CStimResponseTimer::SRTS_RUNNING)
+			{
+				numRunning++;
+			}
 		}
 	}
+
+	return numRunning;
 }
 
 CStimResponsePtr idGameLocal::FindStimResponse(int uniqueId)
@@ -111,6 +111,9 @@ void gameError( const char *fmt, ... );
 #include "DifficultyManager.h"
 
 #include "ai/AreaManager.h"
+#include "ai/ThinkScheduler.h"
+#include "ai/ObstacleCache.h"
+#include "ManagerScheduler.h"
 #include "GamePlayTimer.h"
 #include "ModelGenerator.h"
 #include "LightController.h"
@@ -502,6 +505,15 @@ public:
 	// The manager for handling AI => Area mappings (needed for AI to remember locked doors, for instance)
 	ai::AreaManager			m_AreaManager;
 
+	// Decides which AI think in each frame, keeping AI think time within budget
+	ai::ThinkScheduler		m_AIThinkScheduler;
+
+	// Potential obstacles shared by AI doing obstacle avoidance
+	ai::ObstacleCache		m_ObstacleCache;
+
+	// Decides when conversations, searches, timers and objectives need processing
+	CManagerScheduler		m_ManagerScheduler;
+
 	// The manager class for all map conversations
 	ai::ConversationSystemPtr	m_ConversationSystem;
 
@@ -913,7 +925,8 @@ public:
 	/**
 	 * Process the timer ticks for all timers that are used for other purposes than stim/responses.
 	 */
-	void					ProcessTimer(unsigned int ticks);
+	// returns the number of timers still running
+	int						ProcessTimer(unsigned int ticks);
 
 	/**
 	 * ProcessStimResponse will check whether stims are in reach of a response and if so activate them.
@@ -1050,6 +1063,7 @@ private:
 	void					FreePlayerPVS( void );
 	void					UpdateGravity( void );
 	void					SortActiveEntityList( void );
+	void					PresolveArticulatedFigures( void );
 	void					ShowTargets( void );
 	void					RunDebugInfo( void );
 
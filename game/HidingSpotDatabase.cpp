@@ -0,0 +1,557 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "HidingSpotDatabase.h"
+#include "DarkmodAASHidingSpotFinder.h"
+#include "DarkModGlobals.h"
+#include "darkModLAS.h"
+#include "ai/Memory.h"
+
+static const int HIDING_SPOT_DATABASE_MAGIC = ('H' << 24) | ('S' << 16) | ('D' << 8) | 'B';
+static const int HIDING_SPOT_DATABASE_VERSION = 1;
+
+// Number of horizontal directions tested for cover
+#define COVER_TEST_DIRECTIONS 8
+
+// How far away geometry still counts as cover
+#define COVER_TEST_DISTANCE 64.0f
+
+// Height above the candidate origin at which cover is tested
+#define COVER_TEST_HEIGHT 16.0f
+
+// A light has to move this far to invalidate the lighting stored in the database
+#define LIGHT_MOVE_TOLERANCE 1.0f
+
+//----------------------------------------------------------------------------
+
+CHidingSpotDatabase::CHidingSpotDatabase() :
+	loadAttempted(false),
+	loaded(false),
+	hidingHeight(0),
+	changedLightsFrame(-1)
+{}
+
+//----------------------------------------------------------------------------
+
+void CHidingSpotDatabase::clear()
+{
+	aasName.Clear();
+	loadAttempted = false;
+	loaded = false;
+	hidingHeight = 0;
+	candidates.Clear();
+	areaFirstCandidate.Clear();
+	lights.Clear();
+	lightHash.ClearFree();
+	changedLights.Clear();
+	changedLightsFrame = -1;
+}
+
+//----------------------------------------------------------------------------
+
+idStr CHidingSpotDatabase::getFileName(const idStr& in_aasName)
+{
+	idStr fileName = gameLocal.GetMapName();
+	fileName.SetFileExtension(in_aasName);
+	fileName += ".hide";
+	return fileName;
+}
+
+//----------------------------------------------------------------------------
+
+void CHidingSpotDatabase::getLightState(idLight* p_light, lightState_t& out_state)
+{
+	const renderLight_t* renderLight = p_light->GetRenderLight();
+
+	out_state.name = p_light->name;
+	out_state.origin = p_light->GetLightOrigin();
+	if (renderLight->pointLight)
+	{
+		out_state.radius = renderLight->lightRadius.Length();
+	}
+	else
+	{
+		// The frustum edges run from the origin through the target +- right +- up corners
+		// and are cut off by the falloff plane at the light end
+		idVec3 falloff = renderLight->end - renderLight->start;
+		falloff.Normalize();
+		float endDist = renderLight->end * falloff;
+
+		out_state.radius = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			idVec3 corner = renderLight->target;
+			corner += (i & 1) ? renderLight->right : -renderLight->right;
+			corner += (i & 2) ? renderLight->up : -renderLight->up;
+
+			float cornerDist = corner * falloff;
+			if (endDist > 0 && cornerDist > idMath::FLT_EPS)
+			{
+				corner *= endDist / cornerDist;
+			}
+			if (corner.Length() > out_state.radius)
+			{
+				out_state.radius = corner.Length();
+			}
+		}
+	}
+	out_state.level = p_light->GetLightLevel();
+	out_state.color.Set(renderLight->shaderParms[SHADERPARM_RED], renderLight->shaderParms[SHADERPARM_GREEN], renderLight->shaderParms[SHADERPARM_BLUE]);
+}
+
+//----------------------------------------------------------------------------
+
+bool CHidingSpotDatabase::load(const idStr& in_aasName)
+{
+	if (in_aasName == aasName && loadAttempted)
+	{
+		return loaded;
+	}
+
+	clear();
+	aasName = in_aasName;
+	loadAttempted = true;
+
+	idAAS* p_aas = gameLocal.GetAAS(aasName);
+	if (p_aas == NULL)
+	{
+		return false;
+	}
+
+	idStr fileName = getFileName(aasName);
+	void* buffer = NULL;
+	int length = fileSystem->ReadFile(fileName, &buffer);
+	if (buffer == NULL)
+	{
+		DM_LOG(LC_AI, LT_INFO)LOGSTRING("No hiding spot database %s, hiding spots are searched at runtime\r", fileName.c_str());
+		return false;
+	}
+
+	idFile_Memory file(fileName, static_cast<const char*>(buffer), length);
+
+	int magic = 0;
+	int version = 0;
+	ID_TIME_T aasTime = 0;
+	int numAreas = -1;
+	int numLights = -1;
+	int numCandidates = -1;
+	file.ReadInt(magic);
+	file.ReadInt(version);
+	file.Read(&aasTime, sizeof(aasTime));
+	file.ReadInt(numAreas);
+	file.ReadFloat(hidingHeight);
+	file.ReadInt(numLights);
+	file.ReadInt(numCandidates);
+
+	// The database is only valid for the AAS it was built from
+	ID_TIME_T currentAASTime = FILE_NOT_FOUND_TIMESTAMP;
+	fileSystem->ReadFile(idStr(gameLocal.GetMapName()).SetFileExtension(aasName), NULL, &currentAASTime);
+
+	bool valid =
+	(
+		magic == HIDING_SPOT_DATABASE_MAGIC && version == HIDING_SPOT_DATABASE_VERSION &&
+		currentAASTime != FILE_NOT_FOUND_TIMESTAMP && aasTime == currentAASTime &&
+		numAreas == p_aas->GetNumAreas() && numLights >= 0 && numCandidates >= 0
+	);
+
+	if (valid)
+	{
+		lights.SetNum(numLights);
+		lightHash.ClearFree(1024, numLights);
+		for (int i = 0; i < numLights; i++)
+		{
+			lightState_t& light = lights[i];
+			file.ReadString(light.name);
+			file.ReadVec3(light.origin);
+			file.ReadFloat(light.radius);
+			file.ReadInt(light.level);
+			file.ReadVec3(light.color);
+			lightHash.Add(idStr::Hash(light.name), i);
+		}
+
+		areaFirstCandidate.SetNum(numAreas + 1);
+		for (int i = 0; i <= numAreas; i++)
+		{
+			file.ReadInt(areaFirstCandidate[i]);
+		}
+
+		candidates.SetNum(numCandidates);
+		for (int i = 0; i < numCandidates; i++)
+		{
+			candidate_t& candidate = candidates[i];
+			file.ReadVec3(candidate.origin);
+			file.ReadInt(candidate.pvsArea);
+			file.ReadFloat(candidate.lightQuotient);
+			file.ReadFloat(candidate.cover);
+		}
+
+		valid = (file.Tell() == length && areaFirstCandidate[numAreas] == numCandidates);
+	}
+
+	fileSystem->FreeFile(buffer);
+
+	if (!valid)
+	{
+		gameLocal.Warning("Hiding spot database %s is out of date, run aas_buildHidingSpots to rebuild it", fileName.c_str());
+		idStr keepName = aasName;
+		clear();
+		aasName = keepName;
+		loadAttempted = true;
+		return false;
+	}
+
+	loaded = true;
+	DM_LOG(LC_AI, LT_INFO)LOGSTRING("Loaded %d hiding spot candidates from %s\r", candidates.Num(), fileName.c_str());
+	return true;
+}
+
+//----------------------------------------------------------------------------
+
+/*!
+* Fills out_coords with the grid coordinates between min and max,
+* always including the one at the max edge
+*/
+static void GetGridCoordinates(float min, float max, idList<float>& out_coords)
+{
+	out_coords.Clear();
+
+	float start = min + WALL_MARGIN_SIZE;
+	float end = max - WALL_MARGIN_SIZE;
+
+	if (start > end)
+	{
+		// Area too thin for the grid, test along its far edge if that is inside it
+		if (end > min)
+		{
+			out_coords.Append(end);
+		}
+		return;
+	}
+
+	for (float coord = start; coord < end; coord += HIDE_GRID_SPACING)
+	{
+		out_coords.Append(coord);
+	}
+	out_coords.Append(end);
+}
+
+//----------------------------------------------------------------------------
+
+bool CHidingSpotDatabase::build(const idStr& in_aasName)
+{
+	idAAS* p_aas = gameLocal.GetAAS(in_aasName);
+	if (p_aas == NULL)
+	{
+		gameLocal.Warning("No AAS with name '%s' exists for this map", in_aasName.c_str());
+		return false;
+	}
+
+	ID_TIME_T aasTime = FILE_NOT_FOUND_TIMESTAMP;
+	fileSystem->ReadFile(idStr(gameLocal.GetMapName()).SetFileExtension(in_aasName), NULL, &aasTime);
+	if (aasTime == FILE_NOT_FOUND_TIMESTAMP)
+	{
+		gameLocal.Warning("AAS file for '%s' not found", in_aasName.c_str());
+		return false;
+	}
+
+	int startTime = Sys_Milliseconds();
+
+	clear();
+	aasName = in_aasName;
+	loadAttempted = true;
+	hidingHeight = HIDING_OBJECT_HEIGHT;
+
+	// Record the lights which lit the candidates
+	idList<idLight*> mapLights;
+	LAS.getLights(mapLights);
+	for (int i = 0; i < mapLights.Num(); i++)
+	{
+		idLight* light = mapLights[i];
+		if (light->IsBlend() || light->IsFog() || !light->IsSeenByAI())
+		{
+			continue;
+		}
+		getLightState(light, lights.Alloc());
+	}
+	lightHash.ClearFree(1024, lights.Num());
+	for (int i = 0; i < lights.Num(); i++)
+	{
+		lightHash.Add(idStr::Hash(lights[i].name), i);
+	}
+
+	idList<float> xCoords;
+	idList<float> yCoords;
+
+	int numAreas = p_aas->GetNumAreas();
+	areaFirstCandidate.SetNum(numAreas + 1);
+
+	// AAS area 0 is the invalid area
+	areaFirstCandidate[0] = 0;
+	for (int areaNum = 1; areaNum < numAreas; areaNum++)
+	{
+		areaFirstCandidate[areaNum] = candidates.Num();
+
+		if ((p_aas->AreaFlags(areaNum) & AREA_REACHABLE_WALK) == 0)
+		{
+			continue;
+		}
+
+		// Same grid as the runtime search of a visible AAS area
+		idBounds areaBounds = p_aas->GetAreaBounds(areaNum);
+		GetGridCoordinates(areaBounds[0].x, areaBounds[1].x, xCoords);
+		GetGridCoordinates(areaBounds[0].y, areaBounds[1].y, yCoords);
+
+		for (int xi = 0; xi < xCoords.Num(); xi++)
+		{
+			for (int yi = 0; yi < yCoords.Num(); yi++)
+			{
+				idVec3 origin(xCoords[xi], yCoords[yi], areaBounds[1].z + WALL_MARGIN_SIZE);
+
+				int pvsArea = gameLocal.pvs.GetPVSArea(origin);
+				if (pvsArea < 0)
+				{
+					// Outside of the world
+					continue;
+				}
+
+				candidate_t& candidate = candidates.Alloc();
+				candidate.origin = origin;
+				candidate.pvsArea = pvsArea;
+				candidate.lightQuotient = LAS.queryLightingAlongLine(origin, origin + idVec3(0, 0, hidingHeight), NULL, true);
+
+				// Count the directions in which there is something to hide behind
+				idVec3 coverStart = origin + idVec3(0, 0, COVER_TEST_HEIGHT);
+				int numBlocked = 0;
+				for (int dir = 0; dir < COVER_TEST_DIRECTIONS; dir++)
+				{
+					float s, c;
+					idMath::SinCos(dir * idMath::TWO_PI / COVER_TEST_DIRECTIONS, s, c);
+
+					trace_t result;
+					if (gameLocal.clip.TracePoint(result, coverStart, coverStart + idVec3(c, s, 0) * COVER_TEST_DISTANCE, MASK_SOLID, NULL))
+					{
+						numBlocked++;
+					}
+				}
+				candidate.cover = static_cast<float>(numBlocked) / COVER_TEST_DIRECTIONS;
+			}
+		}
+	}
+	areaFirstCandidate[numAreas] = candidates.Num();
+
+	loaded = true;
+
+	idStr fileName = getFileName(aasName);
+	idFile* file = fileSystem->OpenFileWrite(fileName);
+	if (file == NULL)
+	{
+		gameLocal.Warning("Couldn't write hiding spot database %s", fileName.c_str());
+		return false;
+	}
+
+	file->WriteInt(HIDING_SPOT_DATABASE_MAGIC);
+	file->WriteInt(HIDING_SPOT_DATABASE_VERSION);
+	file->Write(&aasTime, sizeof(aasTime));
+	file->WriteInt(numAreas);
+	file->WriteFloat(hidingHeight);
+	file->WriteInt(lights.Num());
+	file->WriteInt(candidates.Num());
+
+	for (int i = 0; i < lights.Num(); i++)
+	{
+		const lightState_t& light = lights[i];
+		file->WriteString(light.name);
+		file->WriteVec3(light.origin);
+		file->WriteFloat(light.radius);
+		file->WriteInt(light.level);
+		file->WriteVec3(light.color);
+	}
+
+	for (int i = 0; i <= numAreas; i++)
+	{
+		file->WriteInt(areaFirstCandidate[i]);
+	}
+
+	for (int i = 0; i < candidates.Num(); i++)
+	{
+		const candidate_t& candidate = candidates[i];
+		file->WriteVec3(candidate.origin);
+		file->WriteInt(candidate.pvsArea);
+		file->WriteFloat(candidate.lightQuotient);
+		file->WriteFloat(candidate.cover);
+	}
+
+	fileSystem->CloseFile(file);
+
+	gameLocal.Printf("Wrote %d hiding spot candidates in %d AAS areas to %s (%d msec)\n", candidates.Num(), numAreas, fileName.c_str(), Sys_Milliseconds() - startTime);
+	return true;
+}
+
+//----------------------------------------------------------------------------
+
+bool CHidingSpotDatabase::isLoaded() const
+{
+	return loaded;
+}
+
+//----------------------------------------------------------------------------
+
+float CHidingSpotDatabase::getHidingHeight() const
+{
+	return hidingHeight;
+}
+
+//----------------------------------------------------------------------------
+
+int CHidingSpotDatabase::getNumCandidates(int aasAreaNum) const
+{
+	if (!loaded || aasAreaNum < 0 || aasAreaNum + 1 >= areaFirstCandidate.Num())
+	{
+		return 0;
+	}
+	return areaFirstCandidate[aasAreaNum + 1] - areaFirstCandidate[aasAreaNum];
+}
+
+//----------------------------------------------------------------------------
+
+const CHidingSpotDatabase::candidate_t* CHidingSpotDatabase::getCandidates(int aasAreaNum) const
+{
+	if (getNumCandidates(aasAreaNum) == 0)
+	{
+		return NULL;
+	}
+	return candidates.Ptr() + areaFirstCandidate[aasAreaNum];
+}
+
+//----------------------------------------------------------------------------
+
+void CHidingSpotDatabase::updateChangedLights()
+{
+	changedLightsFrame = gameLocal.framenum;
+	changedLights.SetNum(0, false);
+
+	idList<bool> lightFound;
+	lightFound.SetNum(lights.Num());
+	for (int i = 0; i < lightFound.Num(); i++)
+	{
+		lightFound[i] = false;
+	}
+
+	idList<idLight*> mapLights;
+	LAS.getLights(mapLights);
+
+	for (int i = 0; i < mapLights.Num(); i++)
+	{
+		idLight* light = mapLights[i];
+		if (light->IsBlend() || light->IsFog() || !light->IsSeenByAI())
+		{
+			continue;
+		}
+
+		lightState_t state;
+		getLightState(light, state);
+
+		bool changed = true;
+		for (int j = lightHash.First(idStr::Hash(state.name)); j != -1; j = lightHash.Next(j))
+		{
+			const lightState_t& stored = lights[j];
+			if (stored.name != state.name)
+			{
+				continue;
+			}
+
+			lightFound[j] = true;
+			changed = !
+			(
+				stored.level == state.level &&
+				stored.origin.Compare(state.origin, LIGHT_MOVE_TOLERANCE) &&
+				stored.color.Compare(state.color, 0.01f) &&
+				idMath::Fabs(stored.radius - state.radius) < LIGHT_MOVE_TOLERANCE
+			);
+
+			if (changed)
+			{
+				// The lighting stored in the database is wrong where the light used to shine, too
+				changedLight_t& old = changedLights.Alloc();
+				old.origin = stored.origin;
+				old.radiusSqr = Square(stored.radius);
+			}
+			break;
+		}
+
+		if (changed && state.level > 0)
+		{
+			changedLight_t& current = changedLights.Alloc();
+			current.origin = state.origin;
+			current.radiusSqr = Square(state.radius);
+		}
+	}
+
+	// Lights which have been removed since
+	for (int i = 0; i < lights.Num(); i++)
+	{
+		if (!lightFound[i])
+		{
+			changedLight_t& removed = changedLights.Alloc();
+			removed.origin = lights[i].origin;
+			removed.radiusSqr = Square(lights[i].radius);
+		}
+	}
+}
+
+//----------------------------------------------------------------------------
+
+float CHidingSpotDatabase::getLightQuotient(const candidate_t& candidate, idEntity* p_ignoreEntity, bool& out_requeried)
+{
+	out_requeried = false;
+
+	if (changedLightsFrame != gameLocal.framenum)
+	{
+		updateChangedLights();
+	}
+
+	for (int i = 0; i < changedLights.Num(); i++)
+	{
+		if ((candidate.origin - changedLights[i].origin).LengthSqr() < changedLights[i].radiusSqr)
+		{
+			out_requeried = true;
+			return LAS.queryLightingAlongLine(candidate.origin, candidate.origin + idVec3(0, 0, hidingHeight), p_ignoreEntity, true);
+		}
+	}
+
+	return candidate.lightQuotient;
+}
+
+//----------------------------------------------------------------------------
+
+void CHidingSpotDatabase::Build_f(const idCmdArgs& args)
+{
+	if (gameLocal.GameState() != GAMESTATE_ACTIVE)
+	{
+		gameLocal.Printf("aas_buildHidingSpots needs a running map\n");
+		return;
+	}
+
+	idStr name = (args.Argc() > 1) ? args.Argv(1) : LAS.getAASName().c_str();
+	if (name.IsEmpty())
+	{
+		name = "aas32";
+	}
+
+	LAS.hidingSpotDatabase.build(name);
+}
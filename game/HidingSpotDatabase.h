@@ -0,0 +1,136 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#ifndef HIDING_SPOT_DATABASE_H
+#define HIDING_SPOT_DATABASE_H
+
+class idEntity;
+class idLight;
+
+/*!
+// @class CHidingSpotDatabase
+//
+// Precomputed hiding spot candidates of one AAS, built by the aas_buildHidingSpots
+// command and stored beside the .aas file as maps/<map>.<aas name>.hide
+//
+// For every walkable AAS area, the points of the hiding spot search grid are stored
+// together with everything about them that doesn't depend on who is hiding from whom:
+// - the PVS area containing the point
+// - the light quotient, as lit by the lights of the map when the database was built
+// - cover: the fraction of horizontal directions blocked by nearby world geometry
+//
+// The hiding spot finder then only filters and ranks these candidates instead of
+// querying the LAS for every grid point. Lights which were moved, switched or recolored
+// since the database was built (or didn't exist then) are collected once per frame,
+// and candidates within their reach get their lighting queried again.
+*/
+class CHidingSpotDatabase
+{
+public:
+	struct candidate_t
+	{
+		idVec3 origin;
+		int pvsArea;
+		float lightQuotient;
+		float cover;
+	};
+
+	CHidingSpotDatabase();
+
+	/*!
+	* Forgets the database (called on map shutdown)
+	*/
+	void clear();
+
+	/*!
+	* Loads the database of the given AAS of the current map, unless it
+	* is already loaded. Loading is only attempted once per map and AAS.
+	*
+	* @return true if an up-to-date database is available
+	*/
+	bool load(const idStr& in_aasName);
+
+	/*!
+	* Computes the database for the given AAS of the current map
+	* and writes it beside the .aas file.
+	*
+	* @return true on success
+	*/
+	bool build(const idStr& in_aasName);
+
+	bool isLoaded() const;
+
+	// The height above the candidate origins the lighting was tested along
+	float getHidingHeight() const;
+
+	int getNumCandidates(int aasAreaNum) const;
+	const candidate_t* getCandidates(int aasAreaNum) const;
+
+	/*!
+	* Returns the light quotient of a candidate, queried again from the LAS
+	* if any light which changed since the database was built can reach it.
+	*
+	* @param out_requeried set to true if the LAS was queried
+	*/
+	float getLightQuotient(const candidate_t& candidate, idEntity* p_ignoreEntity, bool& out_requeried);
+
+	/*!
+	* Console command: aas_buildHidingSpots [aas name]
+	*/
+	static void Build_f(const idCmdArgs& args);
+
+protected:
+	// State of a light which affects the lighting of candidates
+	struct lightState_t
+	{
+		idStr name;
+		idVec3 origin;
+		float radius;
+		int level;
+		idVec3 color;
+	};
+
+	// A sphere in which lighting differs from the one stored in the candidates
+	struct changedLight_t
+	{
+		idVec3 origin;
+		float radiusSqr;
+	};
+
+	idStr aasName;
+	bool loadAttempted;
+	bool loaded;
+	float hidingHeight;
+
+	// Candidates of AAS area n are candidates[areaFirstCandidate[n] .. areaFirstCandidate[n+1]-1]
+	idList<candidate_t> candidates;
+	idList<int> areaFirstCandidate;
+
+	// Lights as they were when the database was built
+	idList<lightState_t> lights;
+	idHashIndex lightHash;
+
+	idList<changedLight_t> changedLights;
+	int changedLightsFrame;
+
+	static idStr getFileName(const idStr& in_aasName);
+
+	static void getLightState(idLight* p_light, lightState_t& out_state);
+
+	// Finds the lights whose influence differs from the time the database was built
+	void updateChangedLights();
+};
+
+#endif
@@ -0,0 +1,105 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "Game_local.h"
+#include "ManagerScheduler.h"
+
+const char* const CManagerScheduler::Names[CManagerScheduler::ENumManagers] =
+{
+	"conversations",
+	"searches",
+	"timers",
+	"objectives",
+};
+
+CManagerScheduler::CManagerScheduler()
+{
+	Clear();
+}
+
+void CManagerScheduler::Clear()
+{
+	memset(_managers, 0, sizeof(_managers));
+
+	for (int i = 0; i < ENumManagers; i++)
+	{
+		_managers[i].woken = true;
+	}
+
+	_startTicks = 0;
+}
+
+bool CManagerScheduler::BeginRun(EManager manager)
+{
+	ManagerState& state = _managers[manager];
+
+	if (g_managerSchedule.GetBool() && !state.woken && gameLocal.time < state.nextRunTime)
+	{
+		state.skips++;
+		return false;
+	}
+
+	// events during the run are handled by the run itself
+	state.woken = false;
+
+	_startTicks = sys->GetClockTicks();
+	return true;
+}
+
+void CManagerScheduler::EndRun(EManager manager, int nextRunTime)
+{
+	ManagerState& state = _managers[manager];
+
+	double ticks = sys->GetClockTicks() - _startTicks;
+	float msec = static_cast<float>(ticks * 1000.0 / sys->ClockTicksPerSecond());
+
+	state.nextRunTime = nextRunTime;
+	state.runs++;
+	state.ranThisFrame = true;
+	state.frameMsec += msec;
+	state.totalMsec += msec;
+}
+
+void CManagerScheduler::Wake(EManager manager)
+{
+	_managers[manager].woken = true;
+}
+
+void CManagerScheduler::EndFrame()
+{
+	if (g_managerScheduleStats.GetBool())
+	{
+		idStr text = va("%d: managers", gameLocal.time);
+
+		for (int i = 0; i < ENumManagers; i++)
+		{
+			const ManagerState& state = _managers[i];
+			text += va(" %s:%s %.3f ms (%d run/%d skipped, %.1f ms total)",
+				Names[i], state.ranThisFrame ? "run" : "sleep", state.frameMsec,
+				state.runs, state.skips, state.totalMsec);
+		}
+
+		gameLocal.Printf("%s\n", text.c_str());
+	}
+
+	for (int i = 0; i < ENumManagers; i++)
+	{
+		_managers[i].ranThisFrame = false;
+		_managers[i].frameMsec = 0.0f;
+	}
+}
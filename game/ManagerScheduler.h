@@ -0,0 +1,87 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#ifndef __MANAGER_SCHEDULER_H__
+#define __MANAGER_SCHEDULER_H__
+
+/**
+ * Decides in which frames the map-wide managers which idGameLocal::RunFrame
+ * used to call every frame actually have to do their work.
+ *
+ * After each run, a manager reports the game time when it has something to do
+ * again (next clocked objective check, next search think, ...), or that it sleeps
+ * until some event wakes it up (conversation started, timer enabled, ...).
+ * Code which causes such events calls Wake(), which makes the manager run
+ * in the current frame (if it has not run yet) or in the next one.
+ *
+ * Time spent in every manager is measured, see g_managerScheduleStats.
+ * Nothing of this is saved: all managers are awake after loading a map or savegame.
+ */
+class CManagerScheduler
+{
+public:
+	enum EManager
+	{
+		EConversations,
+		ESearches,
+		ETimers,
+		EObjectives,
+		ENumManagers
+	};
+
+	// next run time of a manager which has nothing to do until woken
+	static const int SLEEP_UNTIL_WOKEN = INT_MAX;
+
+	CManagerScheduler();
+
+	// wakes all managers and resets statistics
+	void Clear();
+
+	// Returns true if the manager has to run now, and starts measuring its time.
+	// Must be followed by EndRun if it returns true.
+	bool BeginRun(EManager manager);
+
+	// Stops measuring, the manager sleeps until game time nextRunTime
+	// or until woken, whatever comes first.
+	void EndRun(EManager manager, int nextRunTime);
+
+	// Called when something happened that the manager has to react on
+	void Wake(EManager manager);
+
+	// call at the end of the game frame: prints statistics
+	void EndFrame();
+
+private:
+	struct ManagerState
+	{
+		int nextRunTime;
+		bool woken;
+
+		// statistics
+		int runs;
+		int skips;
+		bool ranThisFrame;
+		float frameMsec;
+		double totalMsec;
+	};
+
+	ManagerState _managers[ENumManagers];
+
+	double _startTicks;
+
+	static const char* const Names[ENumManagers];
+};
+
+#endif /* __MANAGER_SCHEDULER_H__ */
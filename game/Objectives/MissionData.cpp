@@ -98,6 +98,10 @@ void CMissionData::Clear( void )
 	m_bObjsNeedUpdate = false;
 	m_Objectives.ClearFree();
 	m_ClockedComponents.ClearFree();
+	for (int i = 0; i < COMP_COUNT; i++)
+	{
+		m_ComponentsByType[i].ClearFree();
+	}
 
 	// Clear all the stats 
 	m_Stats.Clear();
@@ -150,20 +154,8 @@ void CMissionData::Restore(idRestoreGame* savefile)
 		m_Objectives[i].Restore(savefile);
 	}
 
-	// Rebuild list of clocked components now that we've loaded objectives
-	m_ClockedComponents.Clear();
-	for (int ind = 0; ind < m_Objectives.Num(); ind++)
-	{
-		for (int ind2 = 0; ind2 < m_Objectives[ind].m_Components.Num(); ind2++)
-		{
-			CObjectiveComponent& comp = m_Objectives[ind].m_Components[ind2];
-
-			if (comp.m_Type == COMP_CUSTOM_CLOCKED || comp.m_Type == COMP_DISTANCE || comp.m_Type == COMP_INFO_LOCATION)
-			{
-				m_ClockedComponents.Append( &comp );
-			}
-		}
-	}
+	// Rebuild component lists now that we've loaded objectives
+	RebuildComponentIndex();
 
 	m_Stats.Restore(savefile);
 
@@ -273,50 +265,51 @@ void CMissionData::MissionEvent
 	if( CompType == COMP_PICKPOCKET && bBoolArg )
 		m_Stats.PocketsPicked++;
 
-	// Check which objective components need updating
-	for( int i=0; i<m_Objectives.Num(); i++ )
+	// Check which objective components need updating, only those of this type can be affected
+	if( CompType < 0 || CompType >= COMP_COUNT )
+		goto Quit;
+
+	for( int k=0; k < m_ComponentsByType[CompType].Num(); k++ )
 	{
+		CObjectiveComponent& comp = *m_ComponentsByType[CompType][k];
+
+		// m_Index is 1-based, not 0-based
+		int i = comp.m_Index[0] - 1;
+		int j = comp.m_Index[1] - 1;
 		CObjective& obj = m_Objectives[i];
 
-		for( int j=0; j < obj.m_Components.Num(); j++ )
-		{
-			CObjectiveComponent& comp = obj.m_Components[j];
+		DM_LOG(LC_OBJECTIVES,LT_DEBUG)LOGSTRING("Objectives: Matching Component found: %d, %d\r", i+1, j+1 );
 
-			// match component type
-			if( comp.m_Type != CompType )
-				continue;
-			DM_LOG(LC_OBJECTIVES,LT_DEBUG)LOGSTRING("Objectives: Matching Component found: %d, %d\r", i+1, j+1 );
+		// check if the specifiers match, for first spec and second if it exists
+		if( !MatchSpec(&comp, EntDat1, 0) )
+			continue;
+		DM_LOG(LC_OBJECTIVES,LT_DEBUG)LOGSTRING("Objectives: First specification check matched: %d, %d\r", i+1, j+1 );
 
-			// check if the specifiers match, for first spec and second if it exists
-			if( !MatchSpec(&comp, EntDat1, 0) )
+		if( comp.m_SpecMethod[1] != SPEC_NONE )
+		{
+			if( !MatchSpec(&comp, EntDat2, 1) )
 				continue;
-			DM_LOG(LC_OBJECTIVES,LT_DEBUG)LOGSTRING("Objectives: First specification check matched: %d, %d\r", i+1, j+1 );
-
-			if( comp.m_SpecMethod[1] != SPEC_NONE )
-			{
-				if( !MatchSpec(&comp, EntDat2, 1) )
-					continue;
-			}
-			DM_LOG(LC_OBJECTIVES,LT_DEBUG)LOGSTRING("Objectives: Second specification check matched or absent: %d, %d\r", i+1, j+1 );
+		}
+		DM_LOG(LC_OBJECTIVES,LT_DEBUG)LOGSTRING("Objectives: Second specification check matched or absent: %d, %d\r", i+1, j+1 );
 
-			bCompState = EvaluateObjective( &comp, EntDat1, EntDat2, bBoolArg );
-			DM_LOG(LC_OBJECTIVES,LT_DEBUG)LOGSTRING("Objective component evaluation result: %d \r", (int) bCompState );
+		bCompState = EvaluateObjective( &comp, EntDat1, EntDat2, bBoolArg );
+		DM_LOG(LC_OBJECTIVES,LT_DEBUG)LOGSTRING("Objective component evaluation result: %d \r", (int) bCompState );
 
-			// notify the component of the current state. If the state changed,
-			// this will return true and we must mark this objective for update.
-			if( comp.SetState( bCompState ) )
+		// notify the component of the current state. If the state changed,
+		// this will return true and we must mark this objective for update.
+		if( comp.SetState( bCompState ) )
+		{
+			// greebo: Check for irreversible objectives that have already "snapped" into their final state
+			if (!obj.m_bReversible && obj.m_bLatched)
 			{
-				// greebo: Check for irreversible objectives that have already "snapped" into their final state
-				if (!obj.m_bReversible && obj.m_bLatched)
-				{
-					// don't re-evaluate latched irreversible objectives
-					continue;
-				}
-
-				DM_LOG(LC_OBJECTIVES,LT_DEBUG)LOGSTRING("Objective %d, Component %d state changed, needs updating", i+1, j+1 );
-				obj.m_bNeedsUpdate = true;
-				m_bObjsNeedUpdate = true;
+				// don't re-evaluate latched irreversible objectives
+				continue;
 			}
+
+			DM_LOG(LC_OBJECTIVES,LT_DEBUG)LOGSTRING("Objective %d, Component %d state changed, needs updating", i+1, j+1 );
+			obj.m_bNeedsUpdate = true;
+			m_bObjsNeedUpdate = true;
+			gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::EObjectives);
 		}
 	}
 Quit:
@@ -579,16 +572,33 @@ void CMissionData::UpdateObjectives( void )
 				continue;
 			}
 
-			idLocationEntity *loc = gameLocal.LocationForPoint( checkEnt->GetPhysics()->GetOrigin() );
-			if( loc )
+			// The result only depends on the origin, so only look up the location when the entity has moved
+			const idVec3& origin = checkEnt->GetPhysics()->GetOrigin();
+			bool bMoved = !pComp->m_bLocationChecked || origin != pComp->m_LocationCheckOrigin;
+
+			if( bMoved || cv_tdm_obj_verify.GetBool() )
 			{
-				if( pComp->m_SpecMethod[1] == SPEC_GROUP )
-					bEval = (pComp->m_SpecVal[1] == loc->m_ObjectiveGroup );
-				else
-					bEval = ( pComp->m_SpecVal[1] == loc->name );
+				idLocationEntity *loc = gameLocal.LocationForPoint( origin );
+				if( loc )
+				{
+					if( pComp->m_SpecMethod[1] == SPEC_GROUP )
+						bEval = (pComp->m_SpecVal[1] == loc->m_ObjectiveGroup );
+					else
+						bEval = ( pComp->m_SpecVal[1] == loc->name );
+				}
+
+				if( !bMoved && bEval != pComp->m_bLocationResult )
+				{
+					gameLocal.Warning( "Objective %d, component %d: info_location check of %s gave %d, but %d was reused", pComp->m_Index[0], pComp->m_Index[1], checkEnt->name.c_str(), (int) bEval, (int) pComp->m_bLocationResult );
+				}
+
+				pComp->m_bLocationChecked = true;
+				pComp->m_LocationCheckOrigin = origin;
+				pComp->m_bLocationResult = bEval;
 			}
 
-			SetComponentState( pComp, bEval );
+			// still set the state every time, it may have been overridden from script
+			SetComponentState( pComp, pComp->m_bLocationResult );
 		}
 
 // COMP_CUSTOM_CLOCKED - Run a clocked script
@@ -614,6 +624,11 @@ void CMissionData::UpdateObjectives( void )
 
 // ============== End Handling of Clocked Objective Components =============
 
+	if( cv_tdm_obj_verify.GetBool() )
+	{
+		VerifyObjectives();
+	}
+
 	// Check if any objective states have changed:
 	if( !m_bObjsNeedUpdate )
 	{
@@ -633,6 +648,11 @@ void CMissionData::UpdateObjectives( void )
 
 		obj.m_bNeedsUpdate = false;
 
+		for( int j=0; j < obj.m_Components.Num(); j++ )
+		{
+			obj.m_Components[j].m_bEvaluatedState = obj.m_Components[j].m_bState;
+		}
+
 		DM_LOG(LC_OBJECTIVES,LT_DEBUG)LOGSTRING("Objectives: Found objective in need of update: %d \r", i+1);
 
 		// If objective was just completed
@@ -683,6 +703,101 @@ void CMissionData::UpdateObjectives( void )
 	}
 }
 
+void CMissionData::RebuildComponentIndex( void )
+{
+	m_ClockedComponents.Clear();
+	for( int i=0; i < COMP_COUNT; i++ )
+	{
+		m_ComponentsByType[i].Clear();
+	}
+
+	for( int ind = 0; ind < m_Objectives.Num(); ind++ )
+	{
+		for( int ind2 = 0; ind2 < m_Objectives[ind].m_Components.Num(); ind2++ )
+		{
+			CObjectiveComponent& comp = m_Objectives[ind].m_Components[ind2];
+
+			if( comp.m_Type == COMP_CUSTOM_CLOCKED || comp.m_Type == COMP_DISTANCE || comp.m_Type == COMP_INFO_LOCATION )
+			{
+				m_ClockedComponents.Append( &comp );
+			}
+
+			if( comp.m_Type >= 0 && comp.m_Type < COMP_COUNT )
+			{
+				m_ComponentsByType[comp.m_Type].Append( &comp );
+			}
+
+			comp.m_bEvaluatedState = comp.m_bState;
+		}
+	}
+}
+
+void CMissionData::VerifyObjectives( void )
+{
+	int numComponents = 0;
+	for( int i=0; i < COMP_COUNT; i++ )
+	{
+		numComponents += m_ComponentsByType[i].Num();
+	}
+
+	int numTotal = 0;
+	for( int i=0; i < m_Objectives.Num(); i++ )
+	{
+		numTotal += m_Objectives[i].m_Components.Num();
+	}
+
+	if( numComponents != numTotal )
+	{
+		gameLocal.Warning( "Objectives: %d components indexed by type, but there are %d", numComponents, numTotal );
+	}
+
+	for( int i=0; i < m_Objectives.Num(); i++ )
+	{
+		CObjective& obj = m_Objectives[i];
+
+		// skipped by UpdateObjectives anyway, or not re-evaluated on purpose
+		if( obj.m_bNeedsUpdate || obj.m_state == STATE_INVALID || ( !obj.m_bReversible && obj.m_bLatched ) )
+			continue;
+
+		for( int j=0; j < obj.m_Components.Num(); j++ )
+		{
+			CObjectiveComponent& comp = obj.m_Components[j];
+
+			if( comp.m_bState != comp.m_bEvaluatedState )
+			{
+				gameLocal.Warning( "Objective %d, component %d: state changed to %d without the objective being re-evaluated", i+1, j+1, (int) comp.m_bState );
+				// only warn once
+				comp.m_bEvaluatedState = comp.m_bState;
+			}
+		}
+	}
+}
+
+int CMissionData::GetNextUpdateTime( void ) const
+{
+	if( m_bObjsNeedUpdate )
+	{
+		return gameLocal.time;
+	}
+
+	int nextTime = CManagerScheduler::SLEEP_UNTIL_WOKEN;
+
+	// same conditions as in UpdateObjectives
+	for( int k=0; k < m_ClockedComponents.Num(); k++ )
+	{
+		const CObjectiveComponent *pComp = m_ClockedComponents[k];
+
+		if( !pComp || pComp->m_bLatched || m_Objectives[ pComp->m_Index[0] - 1 ].m_state == STATE_INVALID )
+		{
+			continue;
+		}
+
+		nextTime = idMath::Imin( nextTime, pComp->m_TimeStamp + pComp->m_ClockInterval );
+	}
+
+	return nextTime;
+}
+
 void CMissionData::Event_ObjectiveComplete( int ind )
 {
 	bool missionComplete = true;
@@ -1185,6 +1300,7 @@ void CMissionData::SetComponentState(int ObjIndex, int CompIndex, bool bState)
 		DM_LOG(LC_OBJECTIVES,LT_DEBUG)LOGSTRING("SetComponentState: Objective %d, Component %d state changed, needs updating", (ObjIndex+1), (CompIndex+1) );
 		m_Objectives[ObjIndex].m_bNeedsUpdate = true;
 		m_bObjsNeedUpdate = true;
+		gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::EObjectives);
 	}
 }
 
@@ -1235,6 +1351,9 @@ void CMissionData::SetCompletionState( int ObjIndex, int State, bool fireEvents
 
 	obj.m_state = static_cast<EObjCompletionState>(State);
 
+	// clocked components of invalid objectives are not checked
+	gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::EObjectives);
+
 	if (fireEvents)
 	{
 		if( State == STATE_COMPLETE )
@@ -1290,6 +1409,7 @@ void CMissionData::UnlatchObjective( int ObjIndex )
 	}
 
 	m_Objectives[ObjIndex].m_bLatched = false;
+	gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::EObjectives);
 }
 
 void CMissionData::UnlatchObjectiveComp(int ObjIndex, int CompIndex )
@@ -1309,6 +1429,7 @@ void CMissionData::UnlatchObjectiveComp(int ObjIndex, int CompIndex )
 	}
 
 	m_Objectives[ObjIndex].m_Components[CompIndex].m_bLatched = false;
+	gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::EObjectives);
 }
 
 bool CMissionData::GetObjectiveVisibility( int ObjIndex )
@@ -1580,19 +1701,11 @@ int CMissionData::AddObjsFromDict(const idDict& dict)
 		Counter++;
 	}
 
-	// Process the objectives and add clocked components to clocked components list
-	for( int ind = 0; ind < m_Objectives.Num(); ind++ )
-	{
-		for( int ind2 = 0; ind2 < m_Objectives[ind].m_Components.Num(); ind2++ )
-		{
-			CObjectiveComponent& comp = m_Objectives[ind].m_Components[ind2];
+	// Appending may have moved the existing objectives, rebuild all component lists
+	RebuildComponentIndex();
 
-			if (comp.m_Type == COMP_CUSTOM_CLOCKED || comp.m_Type == COMP_DISTANCE || comp.m_Type == COMP_INFO_LOCATION)
-			{
-				m_ClockedComponents.Append( &comp );
-			}
-		}
-	}
+	// new clocked components have to be checked even if the objectives were asleep
+	gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::EObjectives);
 
 	// parse overall mission logic (for specific difficulty if applicable)
 	idStr DiffStr = va("_diff_%d", gameLocal.m_DifficultyManager.GetDifficultyLevel() );
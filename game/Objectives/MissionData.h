@@ -139,6 +139,13 @@ public:
 	**/
 	void UpdateObjectives( void );
 
+	/**
+	* Returns the game time when UpdateObjectives has work to do again:
+	* the next clocked component check, or now if objectives need updating.
+	* Events which make objectives need updating wake the objectives up (see CManagerScheduler).
+	**/
+	int GetNextUpdateTime( void ) const;
+
 	/**
 	* Set the completion state of an objective.  Called both externally and internally.
 	* NOTE: Uses the "internal" index number, so subtract the index by 1 if calling it with "user" index
@@ -532,6 +539,18 @@ protected:
 	**/
 	bool ParseLogicStrs( void );
 
+	/**
+	* Rebuilds m_ClockedComponents and m_ComponentsByType.
+	* Must be called whenever m_Objectives has been changed, since the lists point into it.
+	**/
+	void RebuildComponentIndex( void );
+
+	/**
+	* Debug check (tdm_obj_verify): warns about components whose state changed
+	* without their objective having been marked for re-evaluation.
+	**/
+	void VerifyObjectives( void );
+
 protected:
 	/**
 	* Set to true if any of the objective states have changed and objectives need updating
@@ -550,6 +569,13 @@ protected:
 	**/
 	idList<CObjectiveComponent *> m_ClockedComponents;
 
+	/**
+	* Pointers to all objective components, by the component type (which is
+	* also the type of mission event that can change them).
+	* MissionEvent only visits the components listed for its event type.
+	**/
+	idList<CObjectiveComponent *> m_ComponentsByType[COMP_COUNT];
+
 	/**
 	* Object holding all mission stats relating to AI, damage to player and AI
 	* Loot stats are maintained by the inventory
@@ -60,6 +60,11 @@ CObjectiveComponent::CObjectiveComponent( void )
 	m_ClockInterval = 1000;
 	m_TimeStamp = 0;
 
+	m_bLocationChecked = false;
+	m_LocationCheckOrigin.Zero();
+	m_bLocationResult = false;
+	m_bEvaluatedState = false;
+
 	m_Index[0] = 0;
 	m_Index[1] = 0;
 }
@@ -153,4 +158,7 @@ void CObjectiveComponent::Restore( idRestoreGame *savefile )
 	savefile->ReadInt( m_ClockInterval );
 	savefile->ReadInt( m_TimeStamp );
 	savefile->ReadBool( m_bReversible );
+
+	m_bLocationChecked = false;
+	m_bEvaluatedState = m_bState;
 }
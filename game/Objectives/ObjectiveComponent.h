@@ -150,6 +150,19 @@ protected:
 	
 	int			m_TimeStamp;
 
+	/**
+	* Not saved: result of the last info_location check and the origin of the
+	* checked entity at that time. The location lookup is skipped while it doesn't move.
+	**/
+	bool		m_bLocationChecked;
+	idVec3		m_LocationCheckOrigin;
+	bool		m_bLocationResult;
+
+	/**
+	* Not saved: m_bState when the parent objective was last evaluated, used by tdm_obj_verify
+	**/
+	bool		m_bEvaluatedState;
+
 	/**
 	* Whether the objective component latches after it changes once
 	* Default is reversible.
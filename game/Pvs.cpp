@@ -22,6 +22,12 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 
 #define MAX_BOUNDS_AREAS	16
 
+// portals flooded in parallel, each can only reuse the PVS of portals in earlier batches
+#define PVS_FLOOD_BATCH		64
+
+static const int PVS_CACHE_MAGIC = ( 'P' << 24 ) | ( 'V' << 16 ) | ( 'S' << 8 ) | 'C';
+static const int PVS_CACHE_VERSION = 1;
+
 
 typedef struct pvsPassage_s {
 	byte *				canSee;		// bit set for all portals that can be seen through this passage
@@ -224,86 +230,92 @@ void idPVS::FloodFrontPortalPVS_r( pvsPortal_t *portal, int areaNum ) const {
 /*
 ================
 idPVS::FrontPortalPVS
+
+every portal only writes its own mightSee and vis, so portals are processed in parallel
 ================
 */
 void idPVS::FrontPortalPVS( void ) const {
-	int i, j, k, n, p, side1, side2, areaSide;
-	pvsPortal_t *p1, *p2;
-	pvsArea_t *area;
-
-	for ( i = 0; i < numPortals; i++ ) {
-		p1 = &pvsPortals[i];
+	taskScheduler->ParallelFor( 0, numPortals, [this]( int begin, int end ) {
+		int i, j, k, n, p, side1, side2, areaSide;
+		pvsPortal_t *p1, *p2;
+		pvsArea_t *area;
 
-		for ( j = 0; j < numAreas; j++ ) {
-
-			area = &pvsAreas[j];
+		for ( i = begin; i < end; i++ ) {
+			p1 = &pvsPortals[i];
 
-			areaSide = side1 = area->bounds.PlaneSide( p1->plane );
+			for ( j = 0; j < numAreas; j++ ) {
 
-			// if the whole area is at the back side of the portal
-			if ( areaSide == PLANESIDE_BACK ) {
-				continue;
-			}
+				area = &pvsAreas[j];
 
-			for ( p = 0; p < area->numPortals; p++ ) {
-	
-				p2 = area->portals[p];
+				areaSide = side1 = area->bounds.PlaneSide( p1->plane );
 
-				// if we the whole area is not at the front we need to check
-				if ( areaSide != PLANESIDE_FRONT ) {
-					// if the second portal is completely at the back side of the first portal
-					side1 = p2->bounds.PlaneSide( p1->plane );
-					if ( side1 == PLANESIDE_BACK ) {
-						continue;
-					}
-				}
-
-				// if the first portal is completely at the front of the second portal
-				side2 = p1->bounds.PlaneSide( p2->plane );
-				if ( side2 == PLANESIDE_FRONT ) {
+				// if the whole area is at the back side of the portal
+				if ( areaSide == PLANESIDE_BACK ) {
 					continue;
 				}
 
-				// if the second portal is not completely at the front of the first portal
-				if ( side1 != PLANESIDE_FRONT ) {
-					// more accurate check
-					for ( k = 0; k < p2->w->GetNumPoints(); k++ ) {
-						// if more than an epsilon at the front side
-						if ( p1->plane.Side( (*p2->w)[k].ToVec3(), ON_EPSILON ) == PLANESIDE_FRONT ) {
-							break;
+				for ( p = 0; p < area->numPortals; p++ ) {
+		
+					p2 = area->portals[p];
+
+					// if we the whole area is not at the front we need to check
+					if ( areaSide != PLANESIDE_FRONT ) {
+						// if the second portal is completely at the back side of the first portal
+						side1 = p2->bounds.PlaneSide( p1->plane );
+						if ( side1 == PLANESIDE_BACK ) {
+							continue;
 						}
 					}
-					if ( k >= p2->w->GetNumPoints() ) {
-						continue;	// second portal is at the back of the first portal
+
+					// if the first portal is completely at the front of the second portal
+					side2 = p1->bounds.PlaneSide( p2->plane );
+					if ( side2 == PLANESIDE_FRONT ) {
+						continue;
 					}
-				}
 
-				// if the first portal is not completely at the back side of the second portal
-				if ( side2 != PLANESIDE_BACK ) {
-					// more accurate check
-					for ( k = 0; k < p1->w->GetNumPoints(); k++ ) {
-						// if more than an epsilon at the back side
-						if ( p2->plane.Side( (*p1->w)[k].ToVec3(), ON_EPSILON ) == PLANESIDE_BACK ) {
-							break;
+					// if the second portal is not completely at the front of the first portal
+					if ( side1 != PLANESIDE_FRONT ) {
+						// more accurate check
+						for ( k = 0; k < p2->w->GetNumPoints(); k++ ) {
+							// if more than an epsilon at the front side
+							if ( p1->plane.Side( (*p2->w)[k].ToVec3(), ON_EPSILON ) == PLANESIDE_FRONT ) {
+								break;
+							}
+						}
+						if ( k >= p2->w->GetNumPoints() ) {
+							continue;	// second portal is at the back of the first portal
 						}
 					}
-					if ( k >= p1->w->GetNumPoints() ) {
-						continue;	// first portal is at the front of the second portal
+
+					// if the first portal is not completely at the back side of the second portal
+					if ( side2 != PLANESIDE_BACK ) {
+						// more accurate check
+						for ( k = 0; k < p1->w->GetNumPoints(); k++ ) {
+							// if more than an epsilon at the back side
+							if ( p2->plane.Side( (*p1->w)[k].ToVec3(), ON_EPSILON ) == PLANESIDE_BACK ) {
+								break;
+							}
+						}
+						if ( k >= p1->w->GetNumPoints() ) {
+							continue;	// first portal is at the front of the second portal
+						}
 					}
-				}
 
-				// the portal might be visible at the front
-				n = p2 - pvsPortals;
-				p1->mightSee[ n >> 3 ] |= 1 << (n&7);
+					// the portal might be visible at the front
+					n = p2 - pvsPortals;
+					p1->mightSee[ n >> 3 ] |= 1 << (n&7);
+				}
 			}
 		}
-	}
+	}, 16 );
 
 	// flood the front portal pvs for all portals
-	for ( i = 0; i < numPortals; i++ ) {
-		p1 = &pvsPortals[i];
-		FloodFrontPortalPVS_r( p1, p1->areaNum );
-	}
+	taskScheduler->ParallelFor( 0, numPortals, [this]( int begin, int end ) {
+		for ( int i = begin; i < end; i++ ) {
+			pvsPortal_t *p1 = &pvsPortals[i];
+			FloodFrontPortalPVS_r( p1, p1->areaNum );
+		}
+	}, 16 );
 }
 
 /*
@@ -398,25 +410,50 @@ idPVS::PassagePVS
 ===============
 */
 void idPVS::PassagePVS( void ) const {
-	int i;
-	pvsPortal_t *source;
-	pvsStack_t *stack, *s;
+	int i, first, last;
 
 	// create the passages
 	CreatePassages();
 
+	// calculate portal PVS by flooding through the passages
+	// the batches don't depend on the number of threads, so neither does the result
+	for ( first = 0; first < numPortals; first = last ) {
+		last = idMath::Imin( first + PVS_FLOOD_BATCH, numPortals );
+
+		taskScheduler->ParallelFor( first, last, [this]( int begin, int end ) {
+			FloodPortalRange( begin, end );
+		}, 1 );
+
+		// the PVS of these portals can be used from now on
+		for ( i = first; i < last; i++ ) {
+			pvsPortals[i].done = true;
+		}
+	}
+
+	// destroy the passages
+	DestroyPassages();
+}
+
+/*
+===============
+idPVS::FloodPortalRange
+===============
+*/
+void idPVS::FloodPortalRange( int begin, int end ) const {
+	int i;
+	pvsPortal_t *source;
+	pvsStack_t *stack, *s;
+
 	// allocate first stack entry
 	stack = reinterpret_cast<pvsStack_t*>(new byte[sizeof(pvsStack_t) + portalVisBytes]);
 	stack->mightSee = (reinterpret_cast<byte *>(stack)) + sizeof(pvsStack_t);
 	stack->next = NULL;
 
-	// calculate portal PVS by flooding through the passages
-	for ( i = 0; i < numPortals; i++ ) {
+	for ( i = begin; i < end; i++ ) {
 		source = &pvsPortals[i];
 		memset( source->vis, 0, portalVisBytes );
 		memcpy( stack->mightSee, source->mightSee, portalVisBytes );
 		FloodPassagePVS_r( source, source, stack );
-		source->done = true;
 	}
 
 	// free the allocated stack
@@ -424,9 +461,6 @@ void idPVS::PassagePVS( void ) const {
 		stack = stack->next;
 		delete[] s;
 	}
-
-	// destroy the passages
-	DestroyPassages();
 }
 
 /*
@@ -555,120 +589,142 @@ idPVS::CreatePassages
 #define MAX_PASSAGE_BOUNDS		128
 
 void idPVS::CreatePassages( void ) const {
-	int i, j, l, n, numBounds, front, passageMemory, byteNum, bitNum;
+	int i, j, passageMemory;
+	pvsPortal_t *source;
+
+	// passages of a portal only depend on the mightSee of portals, which is complete at this point
+	taskScheduler->ParallelFor( 0, numPortals, [this]( int begin, int end ) {
+		for ( int k = begin; k < end; k++ ) {
+			CreatePortalPassages( &pvsPortals[k] );
+		}
+	}, 4 );
+
+	passageMemory = 0;
+	for ( i = 0; i < numPortals; i++ ) {
+		source = &pvsPortals[i];
+		for ( j = 0; j < pvsAreas[source->areaNum].numPortals; j++ ) {
+			if ( source->passages[j].canSee ) {
+				passageMemory += portalVisBytes;
+			}
+		}
+	}
+	if ( passageMemory < 1024 ) {
+		gameLocal.Printf( "%5d bytes passage memory used to build PVS\n", passageMemory );
+	}
+	else {
+		gameLocal.Printf( "%5d KB passage memory used to build PVS\n", passageMemory>>10 );
+	}
+}
+
+/*
+================
+idPVS::CreatePortalPassages
+================
+*/
+void idPVS::CreatePortalPassages( pvsPortal_t *source ) const {
+	int j, l, n, numBounds, front, byteNum, bitNum;
 	int sides[MAX_PASSAGE_BOUNDS];
 	idPlane passageBounds[MAX_PASSAGE_BOUNDS];
-	pvsPortal_t *source, *target, *p;
+	pvsPortal_t *target, *p;
 	pvsArea_t *area;
 	pvsPassage_t *passage;
 	idFixedWinding winding;
 	byte canSee, mightSee, bit;
 
-	passageMemory = 0;
-	for ( i = 0; i < numPortals; i++ ) {
-		source = &pvsPortals[i];
-		area = &pvsAreas[source->areaNum];
+	area = &pvsAreas[source->areaNum];
 
-		source->passages = new pvsPassage_t[area->numPortals];
+	source->passages = new pvsPassage_t[area->numPortals];
 
-		for ( j = 0; j < area->numPortals; j++ ) {
-			target = area->portals[j];
-			n = target - pvsPortals;
+	for ( j = 0; j < area->numPortals; j++ ) {
+		target = area->portals[j];
+		n = target - pvsPortals;
 
-			passage = &source->passages[j];
+		passage = &source->passages[j];
 
-			// if the source portal cannot see this portal
-			if ( !( source->mightSee[ n>>3 ] & (1 << (n&7)) ) ) {
-				// not all portals in the area have to be visible because areas are not necesarily convex
-				// also no passage has to be created for the portal which is the opposite of the source
-				passage->canSee = NULL;
-				continue;
-			}
+		// if the source portal cannot see this portal
+		if ( !( source->mightSee[ n>>3 ] & (1 << (n&7)) ) ) {
+			// not all portals in the area have to be visible because areas are not necesarily convex
+			// also no passage has to be created for the portal which is the opposite of the source
+			passage->canSee = NULL;
+			continue;
+		}
 
-			passage->canSee = new byte[portalVisBytes];
-			passageMemory += portalVisBytes;
+		passage->canSee = new byte[portalVisBytes];
 
-			// boundary plane normals point inwards
-			numBounds = 0;
-			AddPassageBoundaries( *(source->w), *(target->w), false, passageBounds, numBounds, MAX_PASSAGE_BOUNDS );
-			AddPassageBoundaries( *(target->w), *(source->w), true, passageBounds, numBounds, MAX_PASSAGE_BOUNDS );
+		// boundary plane normals point inwards
+		numBounds = 0;
+		AddPassageBoundaries( *(source->w), *(target->w), false, passageBounds, numBounds, MAX_PASSAGE_BOUNDS );
+		AddPassageBoundaries( *(target->w), *(source->w), true, passageBounds, numBounds, MAX_PASSAGE_BOUNDS );
 
-			// get all portals visible through this passage
-			for ( byteNum = 0; byteNum < portalVisBytes; byteNum++) {
+		// get all portals visible through this passage
+		for ( byteNum = 0; byteNum < portalVisBytes; byteNum++) {
 
-				canSee = 0;
-				mightSee = source->mightSee[byteNum] & target->mightSee[byteNum];
+			canSee = 0;
+			mightSee = source->mightSee[byteNum] & target->mightSee[byteNum];
 
-				// go through eight portals at a time to speed things up
-				for ( bitNum = 0; bitNum < 8; bitNum++ ) {
+			// go through eight portals at a time to speed things up
+			for ( bitNum = 0; bitNum < 8; bitNum++ ) {
 
-					bit = 1 << bitNum;
+				bit = 1 << bitNum;
 
-					if ( !( mightSee & bit ) ) {
-						continue;
-					}
+				if ( !( mightSee & bit ) ) {
+					continue;
+				}
 
-					p = &pvsPortals[(byteNum << 3) + bitNum];
-	
-					if ( p->areaNum == source->areaNum ) {
-						continue;
-					}
+				p = &pvsPortals[(byteNum << 3) + bitNum];
 
-					for ( front = 0, l = 0; l < numBounds; l++ ) {
-						sides[l] = p->bounds.PlaneSide( passageBounds[l] );
-						// if completely at the back of the passage bounding plane
-						if ( sides[l] == PLANESIDE_BACK ) {
-							break;
-						}
-						// if completely at the front
-						if ( sides[l] == PLANESIDE_FRONT ) {
-							front++;
-						}
+				if ( p->areaNum == source->areaNum ) {
+					continue;
+				}
+
+				for ( front = 0, l = 0; l < numBounds; l++ ) {
+					sides[l] = p->bounds.PlaneSide( passageBounds[l] );
+					// if completely at the back of the passage bounding plane
+					if ( sides[l] == PLANESIDE_BACK ) {
+						break;
 					}
-					// if completely outside the passage
-					if ( l < numBounds ) {
-						continue;
+					// if completely at the front
+					if ( sides[l] == PLANESIDE_FRONT ) {
+						front++;
 					}
+				}
+				// if completely outside the passage
+				if ( l < numBounds ) {
+					continue;
+				}
 
-					// if not at the front of all bounding planes and thus not completely inside the passage
-					if ( front != numBounds ) {
+				// if not at the front of all bounding planes and thus not completely inside the passage
+				if ( front != numBounds ) {
 
-						winding = *p->w;
+					winding = *p->w;
 
-						for ( l = 0; l < numBounds; l++ ) {
-							// only clip if the winding possibly crosses this plane
-							if ( sides[l] != PLANESIDE_CROSS ) {
-								continue;
-							}
-							// clip away the part at the back of the bounding plane
-							winding.ClipInPlace( passageBounds[l] );
-							// if completely clipped away
-							if ( !winding.GetNumPoints() ) {
-								break;
-							}
-						}
-						// if completely outside the passage
-						if ( l < numBounds ) {
+					for ( l = 0; l < numBounds; l++ ) {
+						// only clip if the winding possibly crosses this plane
+						if ( sides[l] != PLANESIDE_CROSS ) {
 							continue;
 						}
+						// clip away the part at the back of the bounding plane
+						winding.ClipInPlace( passageBounds[l] );
+						// if completely clipped away
+						if ( !winding.GetNumPoints() ) {
+							break;
+						}
+					}
+					// if completely outside the passage
+					if ( l < numBounds ) {
+						continue;
 					}
-
-					canSee |= bit;
 				}
 
-				// store results of all eight portals
-				passage->canSee[byteNum] = canSee;
+				canSee |= bit;
 			}
 
-			// can always see the target portal
-			passage->canSee[n >> 3] |= (1 << (n&7));
+			// store results of all eight portals
+			passage->canSee[byteNum] = canSee;
 		}
-	}
-	if ( passageMemory < 1024 ) {
-		gameLocal.Printf( "%5d bytes passage memory used to build PVS\n", passageMemory );
-	}
-	else {
-		gameLocal.Printf( "%5d KB passage memory used to build PVS\n", passageMemory>>10 );
+
+		// can always see the target portal
+		passage->canSee[n >> 3] |= (1 << (n&7));
 	}
 }
 
@@ -773,6 +829,121 @@ int idPVS::AreaPVSFromPortalPVS( void ) const {
 	return totalVisibleAreas;
 }
 
+/*
+================
+idPVS::GetPortalChecksum
+
+checksum of everything the PVS is calculated from
+================
+*/
+unsigned int idPVS::GetPortalChecksum( void ) const {
+	int i, j, k, n;
+	idList<float> data;
+
+	data.Append( numAreas );
+	data.Append( numPortals );
+	for ( i = 0; i < numAreas; i++ ) {
+		n = gameRenderWorld->NumPortalsInArea( i );
+		data.Append( n );
+
+		for ( j = 0; j < n; j++ ) {
+			auto portal = gameRenderWorld->GetPortal( i, j );
+
+			data.Append( portal.areas[1] );
+			data.Append( portal.w.GetNumPoints() );
+			for ( k = 0; k < portal.w.GetNumPoints(); k++ ) {
+				data.Append( portal.w[k].x );
+				data.Append( portal.w[k].y );
+				data.Append( portal.w[k].z );
+			}
+		}
+	}
+	return MD4_BlockChecksum( data.Ptr(), data.Num() * sizeof( float ) );
+}
+
+/*
+================
+idPVS::GetPVSCacheFileName
+================
+*/
+idStr idPVS::GetPVSCacheFileName( void ) const {
+	idStr fileName = gameLocal.GetMapName();
+	fileName.SetFileExtension( "pvs" );
+	return fileName;
+}
+
+/*
+================
+idPVS::LoadPVSCache
+
+returns false if there is no valid cache for the portals of the current map
+================
+*/
+bool idPVS::LoadPVSCache( unsigned int checksum, int &totalVisibleAreas ) {
+	int i, j;
+
+	idStr fileName = GetPVSCacheFileName();
+	void *buffer = NULL;
+	int length = fileSystem->ReadFile( fileName, &buffer );
+	if ( !buffer ) {
+		return false;
+	}
+	idFile_Memory file( fileName, ( const char * )buffer, length );
+
+	int magic = 0, version = 0, fileAreas = -1, filePortals = -1, fileVisBytes = -1;
+	unsigned int fileChecksum = 0;
+	file.ReadInt( magic );
+	file.ReadInt( version );
+	file.ReadUnsignedInt( fileChecksum );
+	file.ReadInt( fileAreas );
+	file.ReadInt( filePortals );
+	file.ReadInt( fileVisBytes );
+
+	bool valid = (
+		magic == PVS_CACHE_MAGIC && version == PVS_CACHE_VERSION && fileChecksum == checksum &&
+		fileAreas == numAreas && filePortals == numPortals && fileVisBytes == areaVisBytes &&
+		length == file.Tell() + numAreas * areaVisBytes
+	);
+	if ( valid ) {
+		file.Read( areaPVS, numAreas * areaVisBytes );
+
+		totalVisibleAreas = 0;
+		for ( i = 0; i < numAreas; i++ ) {
+			const byte *pvs = areaPVS + i * areaVisBytes;
+			for ( j = 0; j < numAreas; j++ ) {
+				if ( pvs[j>>3] & (1 << (j&7)) ) {
+					totalVisibleAreas++;
+				}
+			}
+		}
+	}
+	fileSystem->FreeFile( buffer );
+
+	return valid;
+}
+
+/*
+================
+idPVS::WritePVSCache
+================
+*/
+void idPVS::WritePVSCache( unsigned int checksum ) const {
+	idFile *file = fileSystem->OpenFileWrite( GetPVSCacheFileName() );
+	if ( !file ) {
+		return;
+	}
+
+	file->WriteInt( PVS_CACHE_MAGIC );
+	file->WriteInt( PVS_CACHE_VERSION );
+	file->WriteUnsignedInt( checksum );
+	file->WriteInt( numAreas );
+	file->WriteInt( numPortals );
+	file->WriteInt( areaVisBytes );
+	file->Write( areaPVS, numAreas * areaVisBytes );
+
+	fileSystem->CloseFile( file );
+}
+
 /*
 ================
 idPVS::Init
@@ -812,21 +983,34 @@ void idPVS::Init( void ) {
 	idTimer timer;
 	timer.Start();
 
-	CreatePVSData();
+	unsigned int checksum = 0;
+	bool cached = false;
+	if ( numPortals && g_pvsCache.GetBool() ) {
+		checksum = GetPortalChecksum();
+		cached = LoadPVSCache( checksum, totalVisibleAreas );
+	}
+
+	if ( !cached ) {
+		CreatePVSData();
+
+		FrontPortalPVS();
 
-	FrontPortalPVS();
+		CopyPortalPVSToMightSee();
 
-	CopyPortalPVSToMightSee();
+		PassagePVS();
 
-	PassagePVS();
+		totalVisibleAreas = AreaPVSFromPortalPVS();
 
-	totalVisibleAreas = AreaPVSFromPortalPVS();
+		DestroyPVSData();
 
-	DestroyPVSData();
+		if ( numPortals && g_pvsCache.GetBool() ) {
+			WritePVSCache( checksum );
+		}
+	}
 
 	timer.Stop();
 
-	gameLocal.Printf( "%5.0f msec to calculate PVS\n", timer.Milliseconds() );
+	gameLocal.Printf( "%5.0f msec to %s PVS\n", timer.Milliseconds(), cached ? "load" : "calculate" );
 	gameLocal.Printf( "%5d areas\n", numAreas );
 	gameLocal.Printf( "%5d portals\n", numPortals );
 	gameLocal.Printf( "%5d areas visible on average\n", totalVisibleAreas / numAreas );
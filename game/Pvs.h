@@ -106,11 +106,17 @@ private:
 	void				FloodFrontPortalPVS_r( struct pvsPortal_s *portal, int areaNum ) const;
 	void				FrontPortalPVS( void ) const;
 	struct pvsStack_s *		FloodPassagePVS_r( struct pvsPortal_s *source, const struct pvsPortal_s *portal, struct pvsStack_s *prevStack ) const;
+	void				FloodPortalRange( int begin, int end ) const;
 	void				PassagePVS( void ) const;
 	void				AddPassageBoundaries( const idWinding &source, const idWinding &pass, bool flipClip, idPlane *bounds, int &numBounds, int maxBounds ) const;
 	void				CreatePassages( void ) const;
+	void				CreatePortalPassages( struct pvsPortal_s *source ) const;
 	void				DestroyPassages( void ) const;
 	int				AreaPVSFromPortalPVS( void ) const;
+	unsigned int		GetPortalChecksum( void ) const;
+	idStr				GetPVSCacheFileName( void ) const;
+	bool				LoadPVSCache( unsigned int checksum, int &totalVisibleAreas );
+	void				WritePVSCache( unsigned int checksum ) const;
 	void				GetConnectedAreas( int srcArea, bool *connectedAreas ) const;
 	pvsHandle_t			AllocCurrentPVS( unsigned int h ) const;
 };
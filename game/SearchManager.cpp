@@ -2127,12 +2127,12 @@ void CSearchManager::ConsiderSwitchingSearchers(Search *search, int searcherNum)
 
 // The Search Manager's "Think" method.
 
-void CSearchManager::ProcessSearches()
+int CSearchManager::ProcessSearches()
 {
 	// grayman #4220 - add a delay between 'thinks'
 	if ( gameLocal.time < _nextThinkTime )
 	{
-		return;
+		return _nextThinkTime;
 	}
 
 	_nextThinkTime = gameLocal.time + SEARCH_THINK_INTERVAL;
@@ -2169,6 +2169,7 @@ void CSearchManager::ProcessSearches()
 	*/
 
 	idPlayer* player = gameLocal.GetLocalPlayer();
+	bool ongoingSearches = false;
 
 	for ( int i = 0 ; i < _searches.Num() ; i++ )
 	{
@@ -2209,6 +2210,7 @@ void CSearchManager::ProcessSearches()
 		}
 
 		// There is at least one searcher.
+		ongoingSearches = true;
 
 		// If this is a swarm search, no other checks are necessary.
 		// Since all searchers are active searchers, there's no point
@@ -2351,6 +2353,9 @@ void CSearchManager::ProcessSearches()
 		ConsiderSwitchingSearchers(search, 1); // check the first active searcher
 		ConsiderSwitchingSearchers(search, 2); // check the second active searcher
 	}
+
+	// Without searches, nothing happens until a new one is created
+	return ongoingSearches ? _nextThinkTime : CManagerScheduler::SLEEP_UNTIL_WOKEN;
 }
 
 
@@ -2378,6 +2383,9 @@ Search* CSearchManager::CreateSearch(int searchID)
 	}
 
 	search->_searchID = searchID;
+
+	gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::ESearches);
+
 	return search;
 }
 
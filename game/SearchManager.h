@@ -224,7 +224,8 @@ public:
 
 	void		CreateListOfGuardSpots(Search* search, idAI* ai);
 
-	void		ProcessSearches();
+	// returns the game time when searches need processing again
+	int			ProcessSearches();
 
 	void		Save( idSaveGame *savefile );
 
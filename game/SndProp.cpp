@@ -107,6 +107,10 @@ CsndProp::CsndProp ( void )
 
 	m_TimeStampProp = 0;
 	m_TimeStampPortLoss = 0;
+
+	m_PortLossGeneration = 0;
+	m_ExpCacheHits = 0;
+	m_ExpCacheMisses = 0;
 }
 
 void CsndProp::Clear( void )
@@ -146,6 +150,9 @@ void CsndProp::Clear( void )
 		m_PopAreas = NULL;
 	}
 
+	ClearExpansionCache();
+	m_EntAreas.Clear();
+
 	// delete m_sndAreas and m_PortData
 	DestroyAreasData();
 }
@@ -215,6 +222,9 @@ void CsndProp::Restore(idRestoreGame *savefile)
 	savefile->ReadInt(m_TimeStampProp);
 	savefile->ReadInt(m_TimeStampPortLoss);
 
+	// cached expansions point into m_EventAreas, which is reallocated below
+	ClearExpansionCache();
+
 	m_PopAreasInd.Clear();
 	savefile->ReadInt(num);
 	m_PopAreasInd.SetNum(num);
@@ -687,7 +697,7 @@ void CsndProp::Propagate
 	DM_LOG(LC_SOUND, LT_DEBUG)LOGSTRING("Filling populated areas array with AI\r" );
 	for ( int j = 0 ; j < validEnts.Num() ; j++ )
 	{
-		int AIAreaNum = gameRenderWorld->PointInArea( validEnts[j]->GetPhysics()->GetOrigin() );
+		int AIAreaNum = EntityArea( validEnts[j] );
 		
 		// Sometimes PointInArea returns -1, don't know why
 		if ( AIAreaNum < 0 )
@@ -763,6 +773,7 @@ void CsndProp::Propagate
 	{
 		timer_Prop.Stop();
 		DM_LOG(LC_SOUND, LT_INFO)LOGSTRING("Total TIME for propagation: %lf [ms]\r", timer_Prop.Milliseconds() );
+		gameLocal.Printf("Expansion cache: %d hits, %d misses\n", m_ExpCacheHits, m_ExpCacheMisses );
 	}
 }
 
@@ -855,9 +866,30 @@ bool CsndProp::ExpandWave(float volInit, idVec3 origin, float minAudThresh) // g
 	SExpQue				tempQEntry;
 	SPortEvent			*pPortEv; // pointer to portal event data
 	SPopArea			*pPopArea; // pointer to populated area data
+	idList<int>			Entries; // area and local portal of every flood into an area, for the cache
 
 	DM_LOG(LC_SOUND, LT_DEBUG)LOGSTRING("Starting wavefront expansion\r" );
 
+	int initArea = gameRenderWorld->PointInArea( origin );
+	DM_LOG(LC_SOUND, LT_DEBUG)LOGSTRING("Sound origin is in portal area: %d\r", initArea );
+	if ( initArea == -1 )
+	{
+		DM_LOG(LC_SOUND, LT_DEBUG)LOGSTRING("Sound origin is outside the map, aborting propagation.\r" );
+		return false;
+	}
+
+	// The expansion only depends on these inputs and the portal losses,
+	// so a sound repeated at the same spot can reuse the previous result.
+	if ( cv_spr_cache.GetBool() )
+	{
+		const SExpCache *cached = ReplayExpansion( initArea, origin, volInit, minAudThresh );
+		if ( cached != NULL )
+		{
+			DM_LOG(LC_SOUND, LT_DEBUG)LOGSTRING("Reused cached expansion of %d areas\r", cached->VisitedAreas.Num() );
+			return cached->bFinished;
+		}
+	}
+
 	// clear the visited settings on m_EventAreas from previous propagations
 	for ( int i = 0 ; i < m_numAreas ; i++ )
 	{
@@ -871,14 +903,6 @@ bool CsndProp::ExpandWave(float volInit, idVec3 origin, float minAudThresh) // g
 
 	DM_LOG(LC_SOUND, LT_DEBUG)LOGSTRING("Processing initial area\r" );
 
-	int initArea = gameRenderWorld->PointInArea( origin );
-	DM_LOG(LC_SOUND, LT_DEBUG)LOGSTRING("Sound origin is in portal area: %d\r", initArea );
-	if ( initArea == -1 )
-	{
-		DM_LOG(LC_SOUND, LT_DEBUG)LOGSTRING("Sound origin is outside the map, aborting propagation.\r" );
-		return false;
-	}
-
 	m_EventAreas[ initArea ].bVisited = true;
 
 	// Update m_PopAreas to show that the area has been visited
@@ -1002,6 +1026,18 @@ bool CsndProp::ExpandWave(float volInit, idVec3 origin, float minAudThresh) // g
 			
 			DM_LOG(LC_SOUND, LT_DEBUG)LOGSTRING("Identified local portal index %d\r", LocalPort );
 
+			// Portals of an area entered for the first time still hold the losses
+			// of an earlier propagation, which must not cancel floods through them.
+			// Cached expansions are only reproducible with this reset, so it is tied to the cache:
+			// without it, propagation behaves exactly as it always did.
+			if ( cv_spr_cache.GetBool() && !pEventAreas->bVisited )
+			{
+				for ( int i = 0 ; i < pSndAreas->numPortals ; i++ )
+				{
+					pEventAreas->PortalDat[i].Loss = idMath::INFINITY;
+				}
+			}
+
 			pPortEv = &pEventAreas->PortalDat[ LocalPort ];
 
 			// copy information from the portal's other side
@@ -1022,6 +1058,9 @@ bool CsndProp::ExpandWave(float volInit, idVec3 origin, float minAudThresh) // g
 				pPopArea->VisitedPorts.AddUnique( LocalPort );
 			}
 
+			Entries.Append( area );
+			Entries.Append( LocalPort );
+
 			// Flood to portals in this area
 			for ( int i = 0 ; i < pSndAreas->numPortals ; i++ )
 			{
@@ -1102,6 +1141,11 @@ bool CsndProp::ExpandWave(float volInit, idVec3 origin, float minAudThresh) // g
 	// return true if the expansion died out naturally rather than being stopped
 	returnval = ( !NextAreas.Num() );
 
+	if ( cv_spr_cache.GetBool() )
+	{
+		StoreExpansion( initArea, origin, volInit, minAudThresh, returnval, Entries );
+	}
+
 	return returnval;
 } // end function
 
@@ -1765,6 +1809,12 @@ void CsndProp::DrawLines(idList<idVec3>& pointlist)
 
 void CsndProp::SetPortalAILoss( int handle, float value ) // grayman #3042 - specific to AI
 {
+	// doors call this every frame while moving, only a real change invalidates cached expansions
+	if ( ( m_PortData != NULL ) && ( handle >= 1 ) && ( handle <= m_numPortals ) && ( m_PortData[ handle - 1 ].lossAI != value ) )
+	{
+		m_PortLossGeneration++;
+	}
+
 	CsndPropBase::SetPortalAILoss( handle, value );
 
 	// update the portal loss info timestamp
@@ -1779,6 +1829,146 @@ void CsndProp::SetPortalPlayerLoss( int handle, float value ) // grayman #3042 -
 	m_TimeStampPortLoss = gameLocal.time;
 }
 
+// Number of wavefront expansions kept for reuse
+const int s_MAX_EXPCACHE = 16;
+
+const SExpCache *CsndProp::ReplayExpansion( int initArea, const idVec3& origin, float volInit, float minAudThresh )
+{
+	SExpCache *entry = NULL;
+
+	for ( int i = 0 ; i < m_ExpCache.Num() ; i++ )
+	{
+		SExpCache &test = m_ExpCache[i];
+
+		if ( ( test.area == initArea ) && ( test.lossGeneration == m_PortLossGeneration ) &&
+			 ( test.volInit == volInit ) && ( test.minAudThresh == minAudThresh ) && ( test.origin == origin ) )
+		{
+			entry = &test;
+			break;
+		}
+	}
+
+	if ( entry == NULL )
+	{
+		m_ExpCacheMisses++;
+		return NULL;
+	}
+
+	m_ExpCacheHits++;
+	entry->lastUsed = m_ExpCacheHits + m_ExpCacheMisses;
+
+	for ( int i = 0 ; i < m_numAreas ; i++ )
+	{
+		m_EventAreas[i].bVisited = false;
+	}
+
+	// restore the portal data of the visited areas, the PrevPort pointers still point into m_EventAreas
+	const SPortEvent *pPortDat = entry->PortalDat.Ptr();
+	for ( int i = 0 ; i < entry->VisitedAreas.Num() ; i++ )
+	{
+		int area = entry->VisitedAreas[i];
+		int numPorts = m_sndAreas[area].numPortals;
+
+		m_EventAreas[area].bVisited = true;
+		memcpy( m_EventAreas[area].PortalDat, pPortDat, numPorts * sizeof( SPortEvent ) );
+		pPortDat += numPorts;
+	}
+
+	// the populated areas differ between propagations, so mark them like the wave would have
+	m_PopAreas[ initArea ].bVisited = true;
+
+	for ( int i = 0 ; i < entry->Entries.Num() ; i += 2 )
+	{
+		SPopArea *pPopArea = &m_PopAreas[ entry->Entries[i] ];
+
+		if ( pPopArea->addedTime == m_TimeStampProp )
+		{
+			pPopArea->bVisited = true;
+			pPopArea->VisitedPorts.AddUnique( entry->Entries[i + 1] );
+		}
+	}
+
+	return entry;
+}
+
+void CsndProp::StoreExpansion( int initArea, const idVec3& origin, float volInit, float minAudThresh, bool bFinished, const idList<int>& entries )
+{
+	SExpCache *entry;
+
+	if ( m_ExpCache.Num() < s_MAX_EXPCACHE )
+	{
+		entry = &m_ExpCache.Alloc();
+	}
+	else
+	{
+		entry = &m_ExpCache[0];
+		for ( int i = 1 ; i < m_ExpCache.Num() ; i++ )
+		{
+			if ( m_ExpCache[i].lastUsed < entry->lastUsed )
+			{
+				entry = &m_ExpCache[i];
+			}
+		}
+	}
+
+	entry->area = initArea;
+	entry->origin = origin;
+	entry->volInit = volInit;
+	entry->minAudThresh = minAudThresh;
+	entry->lossGeneration = m_PortLossGeneration;
+	entry->lastUsed = m_ExpCacheHits + m_ExpCacheMisses;
+	entry->bFinished = bFinished;
+	entry->Entries = entries;
+
+	entry->VisitedAreas.SetNum( 0, false );
+	entry->PortalDat.SetNum( 0, false );
+
+	for ( int i = 0 ; i < m_numAreas ; i++ )
+	{
+		if ( !m_EventAreas[i].bVisited )
+		{
+			continue;
+		}
+
+		entry->VisitedAreas.Append( i );
+		for ( int j = 0 ; j < m_sndAreas[i].numPortals ; j++ )
+		{
+			entry->PortalDat.Append( m_EventAreas[i].PortalDat[j] );
+		}
+	}
+}
+
+void CsndProp::ClearExpansionCache( void )
+{
+	m_ExpCache.Clear();
+}
+
+int CsndProp::EntityArea( idEntity *ent )
+{
+	int entNum = ent->entityNumber;
+	const idVec3 &origin = ent->GetPhysics()->GetOrigin();
+
+	if ( m_EntAreas.Num() != MAX_GENTITIES )
+	{
+		m_EntAreas.SetNum( MAX_GENTITIES );
+		for ( int i = 0 ; i < MAX_GENTITIES ; i++ )
+		{
+			m_EntAreas[i].area = -2;
+		}
+	}
+
+	SEntArea &entArea = m_EntAreas[ entNum ];
+
+	// the area only depends on the point, so it doesn't matter if the entity number was reused
+	if ( ( entArea.area == -2 ) || ( entArea.origin != origin ) )
+	{
+		entArea.origin = origin;
+		entArea.area = gameRenderWorld->PointInArea( origin );
+	}
+
+	return entArea.area;
+}
+
 /* grayman - not used
 bool CsndProp::ExpandWaveFast( float volInit, idVec3 origin, float MaxDist, int MaxFloods )
 {
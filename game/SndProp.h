@@ -129,6 +129,46 @@ typedef struct SExpQue_s
 
 
 
+/**
+* Result of a wavefront expansion, kept so that it can be replayed when
+* another sound starts at the same spot with the same volume, as long as
+* no portal loss has changed in between (doors, windows, ...)
+**/
+typedef struct SExpCache_s
+{
+	int					area; // initial area
+
+	idVec3				origin;
+
+	float				volInit;
+
+	float				minAudThresh;
+
+	int					lossGeneration; // m_PortLossGeneration at the time of the expansion
+
+	int					lastUsed; // for replacing the least recently used entry
+
+	bool				bFinished; // return value of the expansion
+
+	idList<int>			VisitedAreas; // areas reached by the wave
+
+	idList<SPortEvent>	PortalDat; // portal event data of the visited areas, in the same order
+
+	idList<int>			Entries; // area and local portal index pairs for every flood into an area, in order
+
+} SExpCache;
+
+/**
+* Last known portal area of an entity, for the AI gathering pass
+**/
+typedef struct SEntArea_s
+{
+	idVec3		origin;
+
+	int			area; // -2 if unknown
+
+} SEntArea;
+
 class CsndProp : public CsndPropBase {
 
 public:
@@ -252,6 +292,28 @@ protected:
 	**/
 	void DrawLines(idList<idVec3>& pointlist);
 
+	/**
+	* Looks for a cached expansion with the same inputs and writes its results
+	* to m_EventAreas and m_PopAreas. Returns NULL if there is none.
+	**/
+	const SExpCache *ReplayExpansion( int initArea, const idVec3& origin, float volInit, float minAudThresh );
+
+	/**
+	* Stores the expansion that was just done, entries holds the area/portal pairs flooded in on
+	**/
+	void StoreExpansion( int initArea, const idVec3& origin, float volInit, float minAudThresh,
+						 bool bFinished, const idList<int>& entries );
+
+	/**
+	* Drops all cached expansions
+	**/
+	void ClearExpansionCache( void );
+
+	/**
+	* PointInArea for the origin of an entity, cached as long as the entity doesn't move
+	**/
+	int EntityArea( idEntity *ent );
+
 
 protected:
 
@@ -291,6 +353,27 @@ protected:
 	* come from close to the same spot, for optimization.
 	**/
 	SEventArea		*m_EventAreas;
+
+	/**
+	* Recently done wavefront expansions (not saved)
+	**/
+	idList<SExpCache>	m_ExpCache;
+
+	/**
+	* Incremented whenever a portal loss for AI changes, which invalidates the cached expansions
+	**/
+	int				m_PortLossGeneration;
+
+	/**
+	* Counters for the cache, printed with tdm_spr_debug
+	**/
+	int				m_ExpCacheHits;
+	int				m_ExpCacheMisses;
+
+	/**
+	* Portal areas of entities, indexed by entity number (not saved)
+	**/
+	idList<SEntArea>	m_EntAreas;
 };
 
 #endif
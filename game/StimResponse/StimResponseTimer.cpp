@@ -217,6 +217,12 @@ void CStimResponseTimer::Reset(void)
 void CStimResponseTimer::SetState(TimerState State)
 {
 	m_State = State;
+
+	// Running timers need ticking
+	if (State == SRTS_RUNNING)
+	{
+		gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::ETimers);
+	}
 }
 
 bool CStimResponseTimer::Tick(unsigned int sysTicks)
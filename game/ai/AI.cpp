@@ -620,6 +620,10 @@ idAI::idAI()
 	m_maxInterleaveThinkDist = 3000;
 	m_lastThinkTime = 0;
 	m_nextThinkFrame = 0;
+	m_thinkScheduleFrame = -1;
+	m_thinkAllowed = false;
+	m_thinkDebt = 0;
+	m_thinkCost = 0.0f;
 
 	INIT_TIMER_HANDLE(aiThinkTimer);
 	INIT_TIMER_HANDLE(aiMindTimer);
@@ -2362,6 +2366,7 @@ void idAI::Think( void )
 	{
 		return;
 	}
+	ai::ThinkScheduler::ScopedThink scopedThink(this);
 
 	SetNextThinkFrame();
 
@@ -2736,22 +2741,52 @@ idAI::ThinkingIsAllowed
 =====================
 */
 bool idAI::ThinkingIsAllowed()
+{
+	if (m_thinkScheduleFrame == gameLocal.framenum)
+	{
+		return m_thinkAllowed;
+	}
+	// not seen by scheduler, e.g. spawned or activated during this frame
+	return ThinkIsDue();
+}
+
+/*
+=====================
+idAI::ThinkIsForced
+=====================
+*/
+bool idAI::ThinkIsForced()
+{
+	// Ragdolls think every frame to avoid physics weirdness.
+	if ( ( health <= 0 ) || IsKnockedOut() ) // grayman #2840 - you're also a ragdoll if you're KO'ed
+	{
+		return true;
+	}
+
+	// angua: AI think every frame while sitting/laying down and getting up
+	// otherwise, the AI might end up in a different sleeping position
+	if (move.moveType == MOVETYPE_SIT_DOWN
+		|| move.moveType == MOVETYPE_FALL_ASLEEP // grayman #3820 - was MOVETYPE_LAY_DOWN
+		|| move.moveType == MOVETYPE_GET_UP
+		|| move.moveType == MOVETYPE_WAKE_UP) // grayman #3820 - was MOVETYPE_GET_UP_FROM_LYING
+	{
+		return true;
+	}
+
+	return false;
+}
+
+/*
+=====================
+idAI::ThinkIsDue
+=====================
+*/
+bool idAI::ThinkIsDue()
 {
 	int frameNum = gameLocal.framenum;
 	if (frameNum < m_nextThinkFrame)
 	{
-		// Ragdolls think every frame to avoid physics weirdness.
-		if ( ( health <= 0 ) || IsKnockedOut() ) // grayman #2840 - you're also a ragdoll if you're KO'ed
-		{
-			return true;
-		}
-
-		// angua: AI think every frame while sitting/laying down and getting up
-		// otherwise, the AI might end up in a different sleeping position
-		if (move.moveType == MOVETYPE_SIT_DOWN
-			|| move.moveType == MOVETYPE_FALL_ASLEEP // grayman #3820 - was MOVETYPE_LAY_DOWN
-			|| move.moveType == MOVETYPE_GET_UP
-			|| move.moveType == MOVETYPE_WAKE_UP) // grayman #3820 - was MOVETYPE_GET_UP_FROM_LYING
+		if (ThinkIsForced())
 		{
 			return true;
 		}
@@ -6955,6 +6990,12 @@ void idAI::Killed( idEntity *inflictor, idEntity *attacker, int damage, const id
 	// make sure the monster is activated
 	EndAttack();
 
+	if ( m_InConversation )
+	{
+		// the conversation must end
+		gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::EConversations);
+	}
+
 	if ( g_debugDamage.GetBool() ) {
 		gameLocal.Printf( "Damage: joint: '%s', zone '%s'\n", animator.GetJointName( ( jointHandle_t )location ),
 			GetDamageGroup( location ) );
@@ -12073,6 +12114,12 @@ void idAI::Knockout( idEntity* inflictor )
 		return;
 	}
 
+	if ( m_InConversation )
+	{
+		// the conversation must end
+		gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::EConversations);
+	}
+
 	EndAttack();
 
 	// stop all voice sounds
@@ -1392,8 +1392,15 @@ public: // greebo: Made these public for now, I didn't want to write an accessor
 	 */
 
 	// This checks whether the AI should think in this frame
+	// (decided by think scheduler, unless AI was not active when it ran)
 	bool					ThinkingIsAllowed();
 
+	// Interleaving rules only: true if the AI wants to think in this frame
+	bool					ThinkIsDue();
+
+	// true if the AI must think in every frame regardless of interleaving and think budget
+	bool					ThinkIsForced();
+
 	// Sets the frame number when the AI should think next time
 	void					SetNextThinkFrame();
 
@@ -1412,6 +1419,12 @@ public: // greebo: Made these public for now, I didn't want to write an accessor
 	// the last time where the AI did its thinking (used for physics)
 	int						m_lastThinkTime;
 
+	// think scheduler state, not saved (see ai::ThinkScheduler)
+	int						m_thinkScheduleFrame;	// frame when scheduler last decided about this AI
+	bool					m_thinkAllowed;			// decision of scheduler for m_thinkScheduleFrame
+	int						m_thinkDebt;			// msec the AI was due to think, but was deferred by budget
+	float					m_thinkCost;			// running average of think time in msec
+
 	// grayman #2691 - this checks if a doorway is large enough to fit through when the door is fully open
 	bool					CanPassThroughDoor(CFrobDoor* frobDoor);
 
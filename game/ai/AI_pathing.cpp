@@ -388,12 +388,12 @@ bool GetFirstBlockingObstacle(const idPhysics *physics, const obstacle_t *obstac
 
 /*
 ============
-GetObstacles
+GetObstaclesInternal
 ============
 */
-int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ignore, int areaNum,
+static int GetObstaclesInternal( const idPhysics *physics, const idAAS *aas, const idEntity *ignore, int areaNum,
 				  const idVec3 &startPos, const idVec3 &seekPos, obstacle_t *obstacles, int maxObstacles, 
-				  idBounds &clipBounds, obstaclePath_t& pathInfo ) 
+				  idBounds &clipBounds, obstaclePath_t& pathInfo, bool useCache ) 
 {
 	int clipMask;
 	float stepHeight, headHeight, min, max;
@@ -451,8 +451,14 @@ int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ig
 	}
 
 	// find all obstacles touching the clip bounds
+	// AI in the same AAS area share potential obstacles gathered once per frame
 	idClip_ClipModelList clipModelList;
-	int numListedClipModels = gameLocal.clip.ClipModelsTouchingBounds( clipBounds, clipMask, clipModelList );
+	int numListedClipModels;
+	if ( useCache && gameLocal.m_ObstacleCache.GetClipModels( aas, areaNum, clipMask, clipBounds, clipModelList ) ) {
+		numListedClipModels = clipModelList.Num();
+	} else {
+		numListedClipModels = gameLocal.clip.ClipModelsTouchingBounds( clipBounds, clipMask, clipModelList );
+	}
 
 	int numObstacles = 0; // no obstacles so far
 
@@ -859,6 +865,24 @@ int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ig
 	return numObstacles;
 }
 
+/*
+============
+GetObstacles
+
+time of the whole call is counted for cache on and off, see aiObstacleCacheStats
+============
+*/
+int GetObstacles( const idPhysics *physics, const idAAS *aas, const idEntity *ignore, int areaNum,
+				  const idVec3 &startPos, const idVec3 &seekPos, obstacle_t *obstacles, int maxObstacles,
+				  idBounds &clipBounds, obstaclePath_t& pathInfo )
+{
+	bool useCache = ai_obstacleCache.GetBool();
+	double startTicks = sys->GetClockTicks();
+	int numObstacles = GetObstaclesInternal( physics, aas, ignore, areaNum, startPos, seekPos, obstacles, maxObstacles, clipBounds, pathInfo, useCache );
+	gameLocal.m_ObstacleCache.AddQueryTime( useCache, sys->GetClockTicks() - startTicks );
+	return numObstacles;
+}
+
 /*
 ============
 FreePathTree_r
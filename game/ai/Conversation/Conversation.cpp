@@ -33,7 +33,8 @@ Conversation::Conversation() :
 	_playCount(0),
 	_maxPlayCount(-1),
 	_actorsMustBeWithinTalkDistance(true),
-	_actorsAlwaysFaceEachOtherWhileTalking(true)
+	_actorsAlwaysFaceEachOtherWhileTalking(true),
+	_waiting(false)
 {}
 
 Conversation::Conversation(const idDict& spawnArgs, int index) :
@@ -42,7 +43,8 @@ Conversation::Conversation(const idDict& spawnArgs, int index) :
 	_playCount(0),
 	_maxPlayCount(-1),
 	_actorsMustBeWithinTalkDistance(true),
-	_actorsAlwaysFaceEachOtherWhileTalking(true)
+	_actorsAlwaysFaceEachOtherWhileTalking(true),
+	_waiting(false)
 {
 	// Pass the call to the parser
 	InitFromSpawnArgs(spawnArgs, index);
@@ -160,6 +162,7 @@ void Conversation::Start()
 
 	// Set the index to the first command
 	_currentCommand = 0;
+	_waiting = false;
 
 	// Reset the command execution status to ready
 	for ( int i = 0 ; i < _commands.Num() ; i++ )
@@ -245,6 +248,9 @@ bool Conversation::Process()
 	// Get the command as specified by the pointer
 	const ConversationCommandPtr& command = _commands[_currentCommand];
 
+	int previousCommand = _currentCommand;
+	ConversationCommand::State previousState = command->GetState();
+
 	// greebo: Check if any of the actors has been knocked out or killed
 	if (!CheckActorAvailability())
 	{
@@ -302,10 +308,20 @@ bool Conversation::Process()
 		};
 	}
 
+	// Nothing happened: wait for the actors to change their state. WaitForActor
+	// is an exception, it is only checked while the conversation is processed.
+	_waiting = (_currentCommand == previousCommand && command->GetState() == previousState &&
+		command->GetType() != ConversationCommand::EWaitForActor);
+
 	// Return TRUE if the command iterator is still in the valid range (i.e. we have commands left)
 	return (_currentCommand >= 0 && _currentCommand < _commands.Num());
 }
 
+bool Conversation::IsWaiting() const
+{
+	return _waiting;
+}
+
 ConversationStatePtr Conversation::GetConversationState(int actor)
 {
 	idAI* ai = GetActor(actor);
@@ -59,6 +59,9 @@ private:
 	// TRUE if the actors always turn to each other while talking
 	bool _actorsAlwaysFaceEachOtherWhileTalking;
 
+	// TRUE if the last Process() call didn't change anything (not saved)
+	bool _waiting;
+
 public:
 	Conversation();
 
@@ -118,6 +121,13 @@ public:
 	// Returns TRUE if the conversation has no more commands to execute
 	bool IsDone();
 
+	/**
+	 * Returns TRUE if the last Process() call neither advanced nor changed the
+	 * current command. The conversation then waits for an actor to change
+	 * its conversation state, and doesn't need processing until that happens.
+	 */
+	bool IsWaiting() const;
+
 	// Gets the actor with the given index/name
 	idAI* GetActor(int index);
 	idAI* GetActor(const idStr& name);
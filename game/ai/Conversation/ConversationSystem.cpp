@@ -118,6 +118,8 @@ void ConversationSystem::StartConversation(int index)
 
 	// Register this conversation for processing
 	_activeConversations.AddUnique(index);
+
+	gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::EConversations);
 }
 
 void ConversationSystem::EndConversation(int index)
@@ -134,9 +136,12 @@ void ConversationSystem::EndConversation(int index)
 	conv->End();
 
 	_dyingConversations.AddUnique(index);
+
+	// the dying conversation is removed next frame
+	gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::EConversations);
 }
 
-void ConversationSystem::ProcessConversations()
+int ConversationSystem::ProcessConversations()
 {
 	// Remove the dying conversations first
 	for (int i = 0; i < _dyingConversations.Num(); i++)
@@ -147,6 +152,14 @@ void ConversationSystem::ProcessConversations()
 
 	_dyingConversations.Clear();
 
+	if (_activeConversations.Num() == 0)
+	{
+		// Nothing to do until a conversation is started
+		return CManagerScheduler::SLEEP_UNTIL_WOKEN;
+	}
+
+	bool allWaiting = true;
+
 	// What remains is a list of active conversations
 	for (int i = 0; i < _activeConversations.Num(); i++)
 	{
@@ -170,7 +183,16 @@ void ConversationSystem::ProcessConversations()
 			EndConversation(_activeConversations[i]);
 			continue;
 		}
+
+		if (!conv->IsWaiting())
+		{
+			allWaiting = false;
+		}
 	}
+
+	// The actors wake us up when their conversation state changes. Actors
+	// becoming unavailable don't always do, so check them from time to time.
+	return allWaiting ? gameLocal.time + CONVERSATION_MAX_SLEEP : gameLocal.time;
 }
 
 void ConversationSystem::Save(idSaveGame* savefile) const
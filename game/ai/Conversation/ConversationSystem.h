@@ -20,6 +20,9 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 
 #include "Conversation.h"
 
+// Longest time (msec) conversations which wait for their actors are not processed
+#define CONVERSATION_MAX_SLEEP	500
+
 namespace ai {
 
 class ConversationSystem
@@ -76,8 +79,12 @@ public:
 	/**
 	 * greebo: This is the "thinking" routine for conversations which
 	 * remotely controls the participating actors.
+	 *
+	 * @returns: the game time when conversations need processing again.
+	 * Conversations which only wait for their actors sleep until an actor
+	 * wakes them (see CManagerScheduler), but at most CONVERSATION_MAX_SLEEP msec.
 	 */
-	void ProcessConversations();
+	int ProcessConversations();
 
 	// Save/Restore routines
 	void Save(idSaveGame* savefile) const;
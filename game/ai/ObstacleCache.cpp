@@ -0,0 +1,217 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "ObstacleCache.h"
+#include "../Game_local.h"
+#include "../BinaryFrobMover.h"
+
+namespace ai
+{
+
+// Obstacles are gathered in the bounds of the AAS area expanded by this much.
+// Clip bounds of GetObstacles reach MAX_OBSTACLE_RADIUS to the sides of the path and
+// a bit more along it, so this covers most queries of AI standing in the area.
+static const float OBSTACLE_CACHE_AREA_MARGIN = 256.0f;
+
+ObstacleCache::ObstacleCache()
+{
+	_candidates.SetGranularity(256);
+	Clear();
+}
+
+void ObstacleCache::Clear()
+{
+	_frame = -1;
+	_areas.Clear();
+	_areaHash.Clear();
+	_candidates.Clear();
+	ResetStats();
+}
+
+int ObstacleCache::FindArea(const idAAS* aas, int areaNum, int clipMask) const
+{
+	for (int i = _areaHash.First(areaNum); i != -1; i = _areaHash.Next(i))
+	{
+		const Area& area = _areas[i];
+		if (area.areaNum == areaNum && area.aas == aas && area.clipMask == clipMask)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+int ObstacleCache::GatherArea(const idAAS* aas, int areaNum, int clipMask)
+{
+	int index = _areas.Append(Area());
+	_areaHash.Add(areaNum, index);
+
+	Area& area = _areas[index];
+	area.aas = aas;
+	area.areaNum = areaNum;
+	area.clipMask = clipMask;
+	area.bounds = aas->GetAreaBounds(areaNum).Expand(OBSTACLE_CACHE_AREA_MARGIN);
+	area.firstCandidate = _candidates.Num();
+
+	idClip_ClipModelList clipModelList;
+	int num = gameLocal.clip.ClipModelsTouchingBounds(area.bounds, clipMask, clipModelList);
+	for (int i = 0; i < num; i++)
+	{
+		idClipModel* clipModel = clipModelList[i];
+		idEntity* ent = clipModel->GetEntity();
+
+		// only these can ever be obstacles, see GetObstacles
+		if (!ent->IsType(idActor::Type) && !ent->IsType(CBinaryFrobMover::Type) &&
+			!ent->IsType(idMoveable::Type) && !ent->IsType(idStaticEntity::Type))
+		{
+			continue;
+		}
+
+		Candidate& candidate = _candidates.Alloc();
+		candidate.clipModel = clipModel;
+		candidate.clipModelId = clipModel->GetId();
+		candidate.entityNum = ent->entityNumber;
+		candidate.spawnId = gameLocal.spawnIds[ent->entityNumber];
+	}
+	area.numCandidates = _candidates.Num() - area.firstCandidate;
+
+	_stats.gathers++;
+	return index;
+}
+
+bool ObstacleCache::GetClipModels(const idAAS* aas, int areaNum, int clipMask, const idBounds& clipBounds, idClip_ClipModelList& clipModelList)
+{
+	if (aas == NULL || areaNum <= 0)
+	{
+		return false;
+	}
+
+	// obstacles move, so the gathered set is only shared within one frame
+	if (_frame != gameLocal.framenum)
+	{
+		_frame = gameLocal.framenum;
+		_areas.SetNum(0, false);
+		_areaHash.Clear();
+		_candidates.SetNum(0, false);
+	}
+
+	int index = FindArea(aas, areaNum, clipMask);
+	if (index == -1)
+	{
+		index = GatherArea(aas, areaNum, clipMask);
+	}
+	else
+	{
+		_stats.hits++;
+	}
+
+	const Area& area = _areas[index];
+	if (!area.bounds.ContainsPoint(clipBounds[0]) || !area.bounds.ContainsPoint(clipBounds[1]))
+	{
+		_stats.fallbacks++;
+		return false;
+	}
+
+	// same checks as idClip::ClipModelsTouchingBounds, on current state of the clip models
+	idBounds testBounds = clipBounds.Expand(CM_BOX_EPSILON);
+
+	clipModelList.Clear();
+	for (int i = 0; i < area.numCandidates; i++)
+	{
+		const Candidate& candidate = _candidates[area.firstCandidate + i];
+
+		// entity may have been removed or may have changed its clip model since the gather
+		if (gameLocal.spawnIds[candidate.entityNum] != candidate.spawnId)
+		{
+			continue;
+		}
+		idEntity* ent = gameLocal.entities[candidate.entityNum];
+		if (ent == NULL || ent->GetPhysics()->GetClipModel(candidate.clipModelId) != candidate.clipModel)
+		{
+			continue;
+		}
+
+		idClipModel* clipModel = candidate.clipModel;
+		if (!clipModel->IsLinked() || !clipModel->IsEnabled() || !(clipModel->GetContents() & clipMask))
+		{
+			continue;
+		}
+		if (!clipModel->GetAbsBounds().IntersectsBounds(testBounds))
+		{
+			continue;
+		}
+		clipModelList.AddGrow(clipModel);
+	}
+	return true;
+}
+
+void ObstacleCache::AddQueryTime(bool cached, double ticks)
+{
+	if (cached)
+	{
+		_stats.cachedQueries++;
+		_stats.cachedTicks += ticks;
+	}
+	else
+	{
+		_stats.directQueries++;
+		_stats.directTicks += ticks;
+	}
+}
+
+void ObstacleCache::PrintStats() const
+{
+	double ticksToMsec = 1000.0 / sys->ClockTicksPerSecond();
+	double cachedMsec = _stats.cachedTicks * ticksToMsec;
+	double directMsec = _stats.directTicks * ticksToMsec;
+
+	int lookups = _stats.hits + _stats.gathers;
+	gameLocal.Printf("areas gathered: %d, queries: %d, shared: %d (%.1f%%), outside of gathered region: %d\n",
+		_stats.gathers, lookups, _stats.hits, (lookups > 0 ? 100.0f * _stats.hits / lookups : 0.0f), _stats.fallbacks);
+	gameLocal.Printf("GetObstacles with cache: %d calls, %.2f ms (%.4f ms per call)\n",
+		_stats.cachedQueries, cachedMsec, (_stats.cachedQueries > 0 ? cachedMsec / _stats.cachedQueries : 0.0));
+	gameLocal.Printf("GetObstacles without cache: %d calls, %.2f ms (%.4f ms per call)\n",
+		_stats.directQueries, directMsec, (_stats.directQueries > 0 ? directMsec / _stats.directQueries : 0.0));
+
+	if (_stats.cachedQueries > 0 && _stats.directQueries > 0)
+	{
+		double savedPerCall = directMsec / _stats.directQueries - cachedMsec / _stats.cachedQueries;
+		gameLocal.Printf("time saved in AI think: %.4f ms per call, %.2f ms total\n", savedPerCall, savedPerCall * _stats.cachedQueries);
+	}
+	else
+	{
+		gameLocal.Printf("toggle ai_obstacleCache and run the same scene again to measure time saved\n");
+	}
+}
+
+void ObstacleCache::ResetStats()
+{
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+void ObstacleCache::Stats_f(const idCmdArgs& args)
+{
+	if (args.Argc() > 1 && !idStr::Icmp(args.Argv(1), "reset"))
+	{
+		gameLocal.m_ObstacleCache.ResetStats();
+		return;
+	}
+	gameLocal.m_ObstacleCache.PrintStats();
+}
+
+} // namespace ai
@@ -0,0 +1,95 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#ifndef __AI_OBSTACLE_CACHE_H__
+#define __AI_OBSTACLE_CACHE_H__
+
+namespace ai
+{
+
+/**
+ * Per-frame cache of potential obstacles for dynamic obstacle avoidance (GetObstacles).
+ *
+ * The first AI querying obstacles from an AAS area in a frame gathers all clip models
+ * around the area which can ever be obstacles (actors, doors and other binary movers,
+ * moveables, func_statics). Other AI in the same area reuse this set in the same frame:
+ * they only pick the clip models touching their own clip bounds, and apply all per-AI
+ * filtering (self, enemies, path rank, tactile func_statics, doors) and the expansion
+ * for their bounds afterwards.
+ *
+ * Queries reaching outside of the gathered region search the clip world directly.
+ */
+class ObstacleCache
+{
+public:
+	ObstacleCache();
+
+	void Clear();
+
+	// fills clipModelList with clip models touching clipBounds which may be obstacles
+	// returns false if the query isn't covered by the shared set, then the caller has to search itself
+	bool GetClipModels(const idAAS* aas, int areaNum, int clipMask, const idBounds& clipBounds, idClip_ClipModelList& clipModelList);
+
+	// time of a whole GetObstacles call, with cache enabled or disabled
+	void AddQueryTime(bool cached, double ticks);
+
+	void PrintStats() const;
+	void ResetStats();
+
+	static void Stats_f(const idCmdArgs& args);
+
+private:
+	struct Candidate
+	{
+		idClipModel* clipModel;		// only compared with current clip model of the entity, never dereferenced blindly
+		int clipModelId;
+		int entityNum;
+		int spawnId;
+	};
+
+	struct Area
+	{
+		const idAAS* aas;
+		int areaNum;
+		int clipMask;
+		idBounds bounds;			// gathered region
+		int firstCandidate;
+		int numCandidates;
+	};
+
+	struct Stats
+	{
+		int gathers;			// areas gathered
+		int hits;				// queries served from gathered set
+		int fallbacks;			// queries outside of gathered region
+		int cachedQueries;
+		double cachedTicks;		// total clock ticks of GetObstacles calls with cache enabled
+		int directQueries;
+		double directTicks;		// total clock ticks of GetObstacles calls with cache disabled
+	};
+
+	int _frame;
+	idList<Area> _areas;
+	idHashIndex _areaHash;
+	idList<Candidate> _candidates;
+	Stats _stats;
+
+	int FindArea(const idAAS* aas, int areaNum, int clipMask) const;
+	int GatherArea(const idAAS* aas, int areaNum, int clipMask);
+};
+
+} // namespace ai
+
+#endif /* __AI_OBSTACLE_CACHE_H__ */
@@ -58,6 +58,9 @@ const idStr& ConversationState::GetName() const
 void ConversationState::Cleanup(idAI* owner) // grayman #3559
 {
 	owner->m_InConversation = false;
+
+	// The conversation has to notice that this actor is gone
+	gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::EConversations);
 }
 
 // Wrap up and end state
@@ -162,6 +165,8 @@ void ConversationState::Init(idAI* owner)
 			);
 		}
 	}
+
+	gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::EConversations);
 }
 
 // Gets called each time the mind is thinking
@@ -176,6 +181,7 @@ void ConversationState::Think(idAI* owner)
 	{
 		DM_LOG(LC_CONVERSATION, LT_DEBUG)LOGSTRING("Actor %s is too alert to continue a conversation\r", owner->GetName());
 		owner->GetMind()->SwitchState(owner->backboneStates[EObservant]);
+		gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::EConversations);
 		return;
 	}
 
@@ -189,6 +195,9 @@ void ConversationState::Think(idAI* owner)
 
 		// Reset the finish time
 		_finishTime = -1;
+
+		// Let the conversation continue with the next command
+		gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::EConversations);
 	}
 
 	DrawDebugOutput(owner);
@@ -209,6 +218,9 @@ void ConversationState::OnSubsystemTaskFinished(idAI* owner, SubsystemId subSyst
 {
 	if (_state != EExecuting && _state != ENotReady && _state != EBusy) return;
 
+	// Finished tasks may make this actor ready for the next command
+	gameLocal.m_ManagerScheduler.Wake(CManagerScheduler::EConversations);
+
 	if (subSystem == SubsysMovement)
 	{
 		// greebo: Are we still in preparation phase?
@@ -0,0 +1,185 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "ThinkScheduler.h"
+#include "AI.h"
+
+namespace ai
+{
+
+// weight of the latest measurement in running average of think time
+static const float THINK_COST_BLEND = 0.2f;
+
+ThinkScheduler::ScopedThink::ScopedThink(idAI* ai) :
+	_ai(ai),
+	_startTicks(sys->GetClockTicks())
+{}
+
+ThinkScheduler::ScopedThink::~ScopedThink()
+{
+	double ticks = sys->GetClockTicks() - _startTicks;
+	float msec = static_cast<float>(ticks * 1000.0 / sys->ClockTicksPerSecond());
+	gameLocal.m_AIThinkScheduler.ThinkFinished(_ai, msec);
+}
+
+ThinkScheduler::ThinkScheduler()
+{
+	Clear();
+}
+
+void ThinkScheduler::Clear()
+{
+	_candidates.Clear();
+	memset(&_stats, 0, sizeof(_stats));
+	_averageCost = 0.0f;
+}
+
+float ThinkScheduler::EstimatedCost(const idAI* ai) const
+{
+	return (ai->m_thinkCost > 0.0f ? ai->m_thinkCost : _averageCost);
+}
+
+void ThinkScheduler::Grant(idAI* ai)
+{
+	ai->m_thinkAllowed = true;
+	_stats.scheduled++;
+	_stats.estimatedMsec += EstimatedCost(ai);
+}
+
+void ThinkScheduler::ThinkFinished(idAI* ai, float msec)
+{
+	ai->m_thinkCost = (ai->m_thinkCost > 0.0f ? ai->m_thinkCost + (msec - ai->m_thinkCost) * THINK_COST_BLEND : msec);
+	ai->m_thinkDebt = 0;
+	_averageCost = (_averageCost > 0.0f ? _averageCost + (msec - _averageCost) * THINK_COST_BLEND : msec);
+
+	_stats.thought++;
+	_stats.thinkMsec += msec;
+}
+
+float ThinkScheduler::Priority(idAI* ai, const idEntity* player, int frameMsec)
+{
+	// every frame of waiting adds the same urgency, AI which have waited longer go first
+	float waited = static_cast<float>(gameLocal.time - ai->m_lastThinkTime) / idMath::Imax(frameMsec, 1);
+	float priority = 1.0f + idMath::ClampFloat(0.0f, 100.0f, waited);
+
+	// alerted AI react to the player, idle ones can wait
+	priority *= 1.0f + idMath::ClampFloat(0.0f, static_cast<float>(ai::ECombat), ai->AI_AlertIndex);
+
+	// the player may see hitches of AI in view
+	if (gameLocal.InPlayerPVS(ai))
+	{
+		priority *= 4.0f;
+	}
+
+	if (player != NULL)
+	{
+		float distance = (ai->GetPhysics()->GetOrigin() - player->GetPhysics()->GetOrigin()).LengthFast();
+		priority /= 1.0f + distance / 1024.0f;
+	}
+
+	return priority;
+}
+
+int ThinkScheduler::CompareCandidates(const Candidate* a, const Candidate* b)
+{
+	if (a->priority > b->priority) return -1;
+	if (a->priority < b->priority) return 1;
+	return 0;
+}
+
+void ThinkScheduler::Schedule()
+{
+	TRACE_CPU_SCOPE("AIThinkSchedule")
+
+	memset(&_stats, 0, sizeof(_stats));
+	_candidates.SetNum(0, false);
+
+	float budget = g_aiThinkBudget.GetFloat();
+	int maxDelay = g_aiThinkMaxDelay.GetInteger();
+	int frameMsec = gameLocal.time - gameLocal.previousTime;
+	const idEntity* player = gameLocal.GetLocalPlayer();
+
+	for (idEntity* ent = gameLocal.activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next())
+	{
+		if (!ent->IsType(idAI::Type))
+		{
+			continue;
+		}
+		if (gameLocal.inCinematic && g_cinematic.GetBool() && !ent->cinematic)
+		{
+			continue; // won't think anyway
+		}
+
+		idAI* ai = static_cast<idAI*>(ent);
+		ai->m_thinkScheduleFrame = gameLocal.framenum;
+		ai->m_thinkAllowed = false;
+
+		if (!ai->ThinkIsDue())
+		{
+			continue;
+		}
+		_stats.due++;
+		_stats.maxDebt = idMath::Imax(_stats.maxDebt, ai->m_thinkDebt);
+
+		if (budget <= 0.0f || ai->ThinkIsForced() || ai->m_thinkDebt >= maxDelay)
+		{
+			_stats.forced++;
+			Grant(ai);
+			continue;
+		}
+
+		Candidate& candidate = _candidates.Alloc();
+		candidate.ai = ai;
+		candidate.priority = Priority(ai, player, frameMsec);
+	}
+
+	_candidates.Sort(CompareCandidates);
+
+	for (int i = 0; i < _candidates.Num(); i++)
+	{
+		idAI* ai = _candidates[i].ai;
+		if (_stats.estimatedMsec + EstimatedCost(ai) <= budget)
+		{
+			Grant(ai);
+		}
+		else
+		{
+			// try again next frame with higher priority
+			ai->m_thinkDebt += frameMsec;
+			_stats.deferred++;
+		}
+	}
+}
+
+void ThinkScheduler::EndFrame()
+{
+	TRACE_PLOT_NUMBER("aiThinkDue", (int64_t)_stats.due);
+	TRACE_PLOT_NUMBER("aiThinkDeferred", (int64_t)_stats.deferred);
+	TRACE_PLOT_NUMBER("aiThinkMsec", _stats.thinkMsec);
+	TRACE_PLOT_NUMBER("aiThinkMaxDebt", (int64_t)_stats.maxDebt);
+
+	if (g_aiScheduleStats.GetBool() && _stats.due > 0)
+	{
+		gameLocal.Printf("%d: AI think due:%d forced:%d scheduled:%d deferred:%d thought:%d est:%.2f/%.2f ms actual:%.2f ms maxdebt:%d ms\n",
+			gameLocal.framenum, _stats.due, _stats.forced, _stats.scheduled, _stats.deferred, _stats.thought,
+			_stats.estimatedMsec, g_aiThinkBudget.GetFloat(), _stats.thinkMsec, _stats.maxDebt
+		);
+	}
+}
+
+} // namespace ai
@@ -0,0 +1,94 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#ifndef __AI_THINK_SCHEDULER_H__
+#define __AI_THINK_SCHEDULER_H__
+
+class idAI;
+
+namespace ai
+{
+
+/**
+ * Decides once per frame, before entities think, which AI may think in this frame.
+ *
+ * Interleaved thinking (idAI::ThinkIsDue) still decides when AI wants to think.
+ * Among AI which are due, the ones that must think every frame (ragdolls, sitting down, etc.)
+ * and the ones deferred for longer than g_aiThinkMaxDelay always think.
+ * The rest are sorted by priority (alert level, distance to player, player PVS, time since
+ * last think) and get think slots as long as the sum of their estimated think times fits
+ * into g_aiThinkBudget. Deferred AI keep their debt and rise in priority next frame.
+ *
+ * Think time of every AI is measured and kept as running average, it is used as estimate.
+ */
+class ThinkScheduler
+{
+public:
+	// measures think time of AI for the duration of scope
+	class ScopedThink
+	{
+	public:
+		ScopedThink(idAI* ai);
+		~ScopedThink();
+	private:
+		idAI* _ai;
+		double _startTicks;
+	};
+
+	ThinkScheduler();
+
+	void Clear();
+
+	// call before entities think
+	void Schedule();
+	// call after entities think: reports statistics
+	void EndFrame();
+
+private:
+	struct Candidate
+	{
+		idAI* ai;
+		float priority;
+	};
+
+	struct FrameStats
+	{
+		int due;			// AI which wanted to think
+		int forced;			// scheduled regardless of budget
+		int scheduled;		// scheduled, including forced
+		int deferred;		// due, but did not fit into budget
+		int thought;		// actually thought
+		int maxDebt;		// msec of the most deferred AI
+		float estimatedMsec;
+		float thinkMsec;
+	};
+
+	idList<Candidate> _candidates;
+	FrameStats _stats;
+
+	// average think time over all AI, used for AI which have not thought yet
+	float _averageCost;
+
+	float EstimatedCost(const idAI* ai) const;
+	void Grant(idAI* ai);
+	void ThinkFinished(idAI* ai, float msec);
+
+	static float Priority(idAI* ai, const idEntity* player, int frameMsec);
+	static int CompareCandidates(const Candidate* a, const Candidate* b);
+};
+
+} // namespace ai
+
+#endif /* __AI_THINK_SCHEDULER_H__ */
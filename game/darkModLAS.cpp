@@ -1229,6 +1229,9 @@ void darkModLAS::initialize()
 	// Log status
 	DM_LOG(LC_LIGHT, LT_DEBUG)LOGSTRING("LAS initialized for %d map areas.\r", m_numAreas);
 
+	// The hiding spot database is loaded on first use
+	hidingSpotDatabase.clear();
+
 	// Build default PVS to AAS Mapping table
 	pvsToAASMappingTable.clear();
 	if (!pvsToAASMappingTable.buildMappings("aas32"))
@@ -1465,6 +1468,8 @@ void darkModLAS::shutDown()
 	pvsToAASMappingTable.clear();
 	DM_LOG(LC_LIGHT, LT_DEBUG)LOGSTRING("PVS to AAS(0) mapping table cleared\r");
 
+	hidingSpotDatabase.clear();
+
 
 }
 
@@ -1781,3 +1786,22 @@ idStr darkModLAS::getAASName()
 	return pvsToAASMappingTable.getAASName();
 }
 
+//----------------------------------------------------------------------------
+
+void darkModLAS::getLights(idList<idLight*>& out_lights)
+{
+	if (m_pp_areaLightLists == NULL)
+	{
+		return;
+	}
+
+	// Lights in the void are kept in the extra list at the end
+	for (int areaIndex = 0; areaIndex < m_numAreas + 1; areaIndex++)
+	{
+		for (idLinkList<darkModLightRecord_t>* p_cursor = m_pp_areaLightLists[areaIndex]; p_cursor != NULL; p_cursor = p_cursor->NextNode())
+		{
+			out_lights.Append(p_cursor->Owner()->p_idLight);
+		}
+	}
+}
+
@@ -27,6 +27,9 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 // The PVS to AAS mapping table
 #include "PVSToAASMapping.h"
 
+// Precomputed hiding spot candidates
+#include "HidingSpotDatabase.h"
+
 
 /*!
 * This structure tracks a light in relation to the area system
@@ -144,6 +147,12 @@ public:
    */
    PVSToAASMapping pvsToAASMappingTable;
 
+   /*!
+   * Hiding spot candidates of the AAS used by pvsToAASMappingTable, if built for this map.
+   * It is loaded on first use and cleared in darkModLAS::initialize and darkModLAS::shutdown
+   */
+   CHidingSpotDatabase hidingSpotDatabase;
+
 	/*!
 	* Constructor
 	*/
@@ -243,6 +252,11 @@ public:
    */
    idStr getAASName();
 
+   /**
+   * Appends all lights tracked by the LAS to out_lights
+   */
+   void getLights(idList<idLight*>& out_lights);
+
 	#ifdef TIMING_BUILD
 private:
 	int queryLightingAlongLineTimer;
@@ -480,6 +480,18 @@ void Automation::ParseQuery(ParseIn &parseIn) {
 		WriteResponse(parseIn.seqno, buff);
 	}
 
+	if (token == "timings") {
+		//per-subsystem msec totals since last reset, "reset" argument starts new measurement
+		const frameTimings_t &t = com_frameTimings;
+		char buff[256];
+		sprintf(buff, "frames %d\ngame %lld\ndraw %lld\nfrontend %lld\nbackend %lld\n",
+			t.frames, (long long)t.gameFrame, (long long)t.gameDraw, (long long)t.frontend, (long long)t.backend
+		);
+		WriteResponse(parseIn.seqno, buff);
+		if (rest && strstr(rest, "reset"))
+			memset(&com_frameTimings, 0, sizeof(com_frameTimings));
+	}
+
 	if (token == "console") {
 		int arg0, arg1;
 		int argsNum = sscanf(rest, "%d%d", &arg0, &arg1);
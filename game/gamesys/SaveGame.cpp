@@ -24,6 +24,36 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 
 #include "zlib.h"
 
+/*
+================
+PrintSaveGameClassStats
+
+Sorts classes by time and prints them with g_profileSaveGame
+================
+*/
+static void PrintSaveGameClassStats( const char *title, const idList<saveGameClassStats_t> &stats ) {
+	idList<int> order;
+	uint64 totalTime = 0;
+	int totalBytes = 0;
+	for ( int i = 0; i < stats.Num(); i++ ) {
+		if ( stats[i].count ) {
+			order.Append( i );
+			totalTime += stats[i].microseconds;
+			totalBytes += stats[i].bytes;
+		}
+	}
+	std::sort( order.begin(), order.end(), [&stats]( int a, int b ) {
+		return stats[a].microseconds > stats[b].microseconds;
+	} );
+
+	gameLocal.Printf( "%s: %.2f ms, %d KB\n", title, totalTime * 0.001, totalBytes >> 10 );
+	gameLocal.Printf( "%10s %8s %10s %10s  %s\n", "ms", "objects", "KB", "B/object", "class" );
+	for ( int i : order ) {
+		const saveGameClassStats_t &s = stats[i];
+		gameLocal.Printf( "%10.3f %8d %10.1f %10d  %s\n", s.microseconds * 0.001, s.count, s.bytes / 1024.0, s.bytes / s.count, idClass::GetType( i )->classname );
+	}
+}
+
 /*
 Save game related helper classes.
 
@@ -81,6 +111,8 @@ idSaveGame::idSaveGame( idFile *savefile ) {
 	// Put NULL at the start of the list so we can skip over it.
 	objects.Clear();
 	objects.Append( NULL );
+	objectIndices.Clear();
+	objectIndices.Set( NULL, 0 );
 }
 
 idSaveGame::~idSaveGame() {
@@ -97,11 +129,30 @@ void idSaveGame::Close( void ) {
 	// read trace models
 	idClipModel::SaveTraceModels( this );
 
-	for( i = 1; i < objects.Num(); i++ ) {
-		CallSave_r( objects[ i ]->GetType(), objects[ i ] );
+	if ( g_profileSaveGame.GetBool() ) {
+		idList<saveGameClassStats_t> stats;
+		stats.SetNum( idClass::GetNumTypes() );
+		memset( stats.Ptr(), 0, stats.MemoryUsed() );
+
+		for( i = 1; i < objects.Num(); i++ ) {
+			uint64 startTime = Sys_GetTimeMicroseconds();
+			int startSize = GetWrittenSize();
+			const idTypeInfo *type = objects[ i ]->GetType();
+			CallSave_r( type, objects[ i ] );
+			saveGameClassStats_t &s = stats[type->typeNum];
+			s.count++;
+			s.bytes += GetWrittenSize() - startSize;
+			s.microseconds += Sys_GetTimeMicroseconds() - startTime;
+		}
+		PrintSaveGameClassStats( "Saved objects", stats );
+	} else {
+		for( i = 1; i < objects.Num(); i++ ) {
+			CallSave_r( objects[ i ]->GetType(), objects[ i ] );
+		}
 	}
 
 	objects.Clear();
+	objectIndices.Clear();
 
 #ifdef ID_USE_TYPEINFO
 	idStr gameState = file->GetName();
@@ -162,7 +213,13 @@ void idSaveGame::CallSave_r( const idTypeInfo *cls, const idClass *obj ) {
 }
 
 void idSaveGame::AddObject( const idClass *obj ) {
-	objects.AddUnique( obj );
+	if ( objectIndices.AddIfNew( obj, objects.Num() ) ) {
+		objects.Append( obj );
+	}
+}
+
+int idSaveGame::GetWrittenSize() const {
+	return isCompressed ? (int)cache.size() : file->Tell();
 }
 
 void idSaveGame::Write( const void *buffer, int len ) {
@@ -218,7 +275,7 @@ void idSaveGame::WriteWinding( const idWinding &w ) {
 void idSaveGame::WriteObject( const idClass *obj ) {
 	int index;
 
-	index = objects.FindIndex( obj );
+	index = objectIndices.Get( obj, -1 );
 	if ( index < 0 ) {
 		//gameLocal.Warning( "idSaveGame::WriteObject - WriteObject FindIndex failed" ); // grayman #4340
 
@@ -663,8 +720,26 @@ void idRestoreGame::RestoreObjects( void ) {
 	idClipModel::RestoreTraceModels( this );
 
 	// restore all the objects
-	for( i = 1; i < objects.Num(); i++ ) {
-		CallRestore_r( objects[ i ]->GetType(), objects[ i ] );
+	if ( g_profileSaveGame.GetBool() ) {
+		idList<saveGameClassStats_t> stats;
+		stats.SetNum( idClass::GetNumTypes() );
+		memset( stats.Ptr(), 0, stats.MemoryUsed() );
+
+		for( i = 1; i < objects.Num(); i++ ) {
+			uint64 startTime = Sys_GetTimeMicroseconds();
+			int startSize = GetReadSize();
+			const idTypeInfo *type = objects[ i ]->GetType();
+			CallRestore_r( type, objects[ i ] );
+			saveGameClassStats_t &s = stats[type->typeNum];
+			s.count++;
+			s.bytes += GetReadSize() - startSize;
+			s.microseconds += Sys_GetTimeMicroseconds() - startTime;
+		}
+		PrintSaveGameClassStats( "Restored objects", stats );
+	} else {
+		for( i = 1; i < objects.Num(); i++ ) {
+			CallRestore_r( objects[ i ]->GetType(), objects[ i ] );
+		}
 	}
 
 	// regenerate render entities and render lights because are not saved
@@ -729,6 +804,10 @@ void idRestoreGame::Read( void *buffer, int len ) {
 		file->Read(buffer, len);
 }
 
+int idRestoreGame::GetReadSize() const {
+	return isCompressed ? cachePointer : file->Tell();
+}
+
 void idRestoreGame::ReadJoint( jointHandle_t &value ) {
 	ReadInt( (int&)value );
 }
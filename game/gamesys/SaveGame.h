@@ -45,6 +45,13 @@ typedef struct trace_s trace_t;
 class idTraceModel;
 class idClipModel;
 
+// time and size spent in Save/Restore of all objects of one class (g_profileSaveGame)
+struct saveGameClassStats_t {
+	int						count;
+	int						bytes;
+	uint64					microseconds;
+};
+
 class idSaveGame {
 public:
 							idSaveGame( idFile *savefile );
@@ -110,10 +117,14 @@ public:
 	// Dump the contents of cache buffer to file
 	void					FinalizeCache();
 
+	// Number of bytes written so far (including not yet compressed cache)
+	int						GetWrittenSize() const;
+
 private:
 	idFile *				file;
 
 	idList<const idClass *>	objects;
+	idHashMap<const idClass *, int> objectIndices;	// inverse of objects, avoids linear search
 
 	bool					isCompressed;
 	CRawVector				cache;
@@ -196,12 +207,14 @@ private:
 	int						buildNumber;
 	int						codeRevision;
 
-	idList<idClass *>		objects;
+	idList<idClass *>		objects;		// dense: object index from save file maps directly to pointer
 
 	bool					isCompressed;
 	CRawVector				cache;
 	int						cachePointer;
 
+	int						GetReadSize() const;
+
 	void					CallRestore_r( const idTypeInfo *cls, idClass *obj );
 };
 
@@ -34,6 +34,7 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 #include "../FrobLockHandle.h"
 #include "../FrobLever.h"
 #include "../Grabber.h"
+#include "../HidingSpotDatabase.h"
 
 #include "TypeInfo.h"
 
@@ -1960,6 +1961,60 @@ static void Cmd_TestDeath_f( const idCmdArgs &args ) {
 
 }
 
+/*
+==================
+Cmd_TestAFStress_f
+
+  spawns a pile of articulated figures in front of the player (always the same for the same view)
+  and measures the cost of AF physics while they fall and come to rest
+==================
+*/
+static void Cmd_TestAFStress_f( const idCmdArgs &args ) {
+	idPlayer *player;
+
+	player = gameLocal.GetLocalPlayer();
+	if ( !player || !gameLocal.CheatsOk() ) {
+		return;
+	}
+
+	if ( args.Argc() < 2 ) {
+		gameLocal.Printf( "usage: testAFStress <classname> [count = 16] [frames = 600]\n" );
+		return;
+	}
+	const char *classname = args.Argv( 1 );
+	int count = ( args.Argc() > 2 ? idMath::ClampInt( 1, 256, atoi( args.Argv( 2 ) ) ) : 16 );
+	int frames = ( args.Argc() > 3 ? idMath::Imax( atoi( args.Argv( 3 ) ), 1 ) : 600 );
+
+	if ( !gameLocal.FindEntityDef( classname, false ) ) {
+		gameLocal.Printf( "Unknown classname '%s'\n", classname );
+		return;
+	}
+
+	// two layers of figures, so that the upper one falls onto the lower one
+	idRandom random( 0 );
+	float yaw = player->viewAngles.yaw;
+	idMat3 axis = idAngles( 0, yaw, 0 ).ToMat3();
+	idVec3 center = player->GetPhysics()->GetOrigin() + axis[0] * 160.0f;
+	int side = idMath::Imax( idMath::FtoiFast( idMath::Sqrt( count * 0.5f ) ), 1 );
+
+	for ( int i = 0; i < count; i++ ) {
+		int layer = i / ( side * side );
+		int row = ( i / side ) % side;
+		int column = i % side;
+		idVec3 offset( ( row - 0.5f * ( side - 1 ) ) * 40.0f, ( column - 0.5f * ( side - 1 ) ) * 40.0f, 32.0f + layer * 48.0f );
+
+		idDict dict;
+		dict.Set( "classname", classname );
+		dict.Set( "origin", ( center + offset * axis ).ToString() );
+		dict.SetFloat( "angle", yaw + random.CRandomFloat() * 180.0f );
+		dict.SetBool( "sleep", false );
+		gameLocal.SpawnEntityDef( dict );
+	}
+
+	gameLocal.Printf( "Spawned %d %s, measuring AF physics over %d frames\n", count, classname, frames );
+	idPhysics_AF::StartStatistics( frames );
+}
+
 /*
 ==================
 Cmd_WeaponSplat_f
@@ -2397,6 +2452,37 @@ static void Cmd_TestSave_f( const idCmdArgs &args ) {
 	fileSystem->CloseFile( f );
 }
 
+/*
+==================
+Cmd_BenchmarkSave_f
+==================
+*/
+static void Cmd_BenchmarkSave_f( const idCmdArgs &args ) {
+	int count = 1;
+	if ( args.Argc() > 1 ) {
+		count = idMath::Imax( atoi( args.Argv( 1 ) ), 1 );
+	}
+
+	uint64 totalTime = 0, minTime = UINT64_MAX;
+	int size = 0;
+	for ( int i = 0; i < count; i++ ) {
+		// save to memory so that disk speed does not matter
+		idFile_Memory f( "benchmark.sav" );
+		uint64 startTime = Sys_GetTimeMicroseconds();
+		gameLocal.SaveGame( &f );
+		uint64 elapsed = Sys_GetTimeMicroseconds() - startTime;
+		totalTime += elapsed;
+		if ( elapsed < minTime ) {
+			minTime = elapsed;
+		}
+		size = f.Length();
+	}
+	gameLocal.Printf( "Saved game %d times: avg %.2f ms, min %.2f ms, size %d KB\n", count, totalTime * 0.001 / count, minTime * 0.001, size >> 10 );
+	if ( !g_profileSaveGame.GetBool() ) {
+		gameLocal.Printf( "Set g_profileSaveGame 1 for per-class breakdown\n" );
+	}
+}
+
 /*
 =================
 FindEntityGUIs
@@ -3613,7 +3699,12 @@ void idGameLocal::InitConsoleCommands( void ) {
 	cmdSystem->AddCommand( "testPointLight",		Cmd_TestPointLight_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"tests a point light" );
 	cmdSystem->AddCommand( "popLight",				Cmd_PopLight_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"removes the last created light" );
 	cmdSystem->AddCommand( "testDeath",				Cmd_TestDeath_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests death" );
+	cmdSystem->AddCommand( "testAFStress",			Cmd_TestAFStress_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"spawns a pile of articulated figures and measures AF physics cost", idCmdSystem::ArgCompletion_Decl<DECL_ENTITYDEF> );
+	cmdSystem->AddCommand( "benchmarkClip",			idClip::Benchmark_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"compares sector tree and AABB tree broadphase of clip models on current map, usage: 'benchmarkClip [queries]'" );
+	cmdSystem->AddCommand( "benchmarkTracePoints",	idClip::BenchmarkTracePoints_f,	CMD_FL_GAME|CMD_FL_CHEAT,	"compares single and batched point traces between actors on current map, usage: 'benchmarkTracePoints [batches]'" );
+	cmdSystem->AddCommand( "aiObstacleCacheStats",	ai::ObstacleCache::Stats_f,		CMD_FL_GAME,				"prints statistics of shared AI obstacles and time of GetObstacles with and without cache, usage: 'aiObstacleCacheStats [reset]'" );
 	cmdSystem->AddCommand( "testSave",				Cmd_TestSave_f,				CMD_FL_GAME|CMD_FL_CHEAT,	"writes out a test savegame" );
+	cmdSystem->AddCommand( "benchmarkSave",			Cmd_BenchmarkSave_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"saves game to memory N times and reports time and size, usage: 'benchmarkSave [N]'" );
 	cmdSystem->AddCommand( "testModel",				idTestModel::TestModel_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests a model", idTestModel::ArgCompletion_TestModel );
 	cmdSystem->AddCommand( "testSkin",				idTestModel::TestSkin_f,			CMD_FL_GAME|CMD_FL_CHEAT,	"tests a skin on an existing testModel", idCmdSystem::ArgCompletion_Decl<DECL_SKIN> );
 	cmdSystem->AddCommand( "testShaderParm",		idTestModel::TestShaderParm_f,		CMD_FL_GAME|CMD_FL_CHEAT,	"sets a shaderParm on an existing testModel" );
@@ -3665,6 +3756,7 @@ void idGameLocal::InitConsoleCommands( void ) {
 	cmdSystem->AddCommand( "aas_showWalkPath",		Cmd_ShowWalkPath_f,			CMD_FL_GAME,				"Shows the walk path from the player to the given area number (AAS32)." );
 	cmdSystem->AddCommand( "aas_showReachabilities",Cmd_ShowReachabilities_f,			CMD_FL_GAME,				"Shows the reachabilities for the given area number (AAS32)." );
 	cmdSystem->AddCommand( "aas_showStats",			Cmd_ShowAASStats_f,			CMD_FL_GAME,				"Shows the AAS statistics." );
+	cmdSystem->AddCommand( "aas_buildHidingSpots",	CHidingSpotDatabase::Build_f,	CMD_FL_GAME,				"Precomputes hiding spot candidates of the running map and writes them beside its .aas file, usage: 'aas_buildHidingSpots [aas name]'" );
 	cmdSystem->AddCommand( "eas_showRoute",			Cmd_ShowEASRoute_f,			CMD_FL_GAME,				"Shows the EAS route to the goal area." );
 
 	cmdSystem->AddCommand( "tdm_start_conversation",	Cmd_StartConversation_f,	CMD_FL_GAME,			"Starts the conversation with the given name." );
@@ -84,6 +84,7 @@ idCVar cv_sndprop_disable(			"tdm_sndprop_disable",		"0",			CVAR_GAME | CVAR_ARC
 idCVar cv_spr_debug(				"tdm_spr_debug",			"0",			CVAR_GAME | CVAR_ARCHIVE | CVAR_BOOL,  "If set to true, sound propagation debugging information will be sent to the console, and the log information will become more detailed." );
 idCVar cv_spr_show(					"tdm_showsprop",			"0",			CVAR_GAME | CVAR_ARCHIVE | CVAR_BOOL,  "If set to true, sound propagation paths to nearby AI will be shown as lines. The volume of the sound heard by the AI and the alert increase will be displayed." );
 idCVar cv_spr_radius_show(			"tdm_showsprop_radius",		"0",			CVAR_GAME | CVAR_ARCHIVE | CVAR_BOOL,  "If set to true, sound ranges are drawn." );
+idCVar cv_spr_cache(				"tdm_spr_cache",			"1",			CVAR_GAME | CVAR_BOOL,  "If set to true, the wavefront expansion of a sound is reused for sounds starting at the same spot with the same volume, until a door or other portal loss changes." );
 
 idCVar cv_ko_show(					"tdm_showko",				"0",			CVAR_GAME | CVAR_ARCHIVE | CVAR_BOOL,  "If set to true, knockout zones will be shown for debugging." );
 idCVar cv_ai_search_show (			"tdm_ai_search_show",		"0.0",			CVAR_GAME | CVAR_ARCHIVE | CVAR_FLOAT, "If >= 1.0, this is the number of milliseconds for which a graphic showing search activity targets will be shown. If < 1.0 then the graphics will not be drawn. For debugging.");
@@ -108,6 +109,7 @@ idCVar cv_ai_opt_nopresent (					"tdm_ai_opt_nopresent",				"0",			CVAR_GAME | C
 idCVar cv_ai_opt_noobstacleavoidance (			"tdm_ai_opt_noobstacleavoidance",	"0",			CVAR_GAME | CVAR_BOOL, "If true (nonzero), AI will not check for obstacles." );
 idCVar cv_ai_hiding_spot_max_light_quotient(	"tdm_ai_hiding_spot_max_light_quotient",	"2.0",	CVAR_GAME | CVAR_FLOAT, "Hiding spot search light quotient." );
 idCVar cv_ai_max_hiding_spot_tests_per_frame(	"tdm_ai_max_hiding_spot_tests_per_frame",	"10",	CVAR_GAME | CVAR_INTEGER, "This is the maximum number of hiding spot point tests to do in a single AI frame." );
+idCVar cv_ai_hiding_spot_database(			"tdm_ai_hiding_spot_database",				"1",	CVAR_GAME | CVAR_BOOL, "If true (nonzero), hiding spot searches use the candidates precomputed by aas_buildHidingSpots, if they are up to date with the AAS file." );
 idCVar cv_ai_debug_transition_barks(			"tdm_ai_debug_transition_barks",			"0",	CVAR_GAME | CVAR_BOOL | CVAR_ARCHIVE, "If set to 1, prints to the console the AI barks during alert level transitions, and events that would cause the AI to use Alert Idle");
 idCVar cv_ai_debug_greetings(					"tdm_ai_debug_greetings",			"0",			CVAR_GAME | CVAR_BOOL | CVAR_ARCHIVE, "If set to 1, prints to the console the AI greeting and response barks");
 idCVar cv_ai_debug_anims (						"tdm_ai_debug_anims",				"0",			CVAR_GAME | CVAR_BOOL, "If true (nonzero), show debug info about AI anims in the console and log file." );
@@ -425,6 +427,7 @@ idCVar cv_tdm_inv_gui_file(	"tdm_inv_hud_file", "guis/tdm_inv.gui",	CVAR_GAME, "
 idCVar cv_tdm_inv_loot_item_def("tdm_inv_loot_item_def", "atdm:inv_loot_info_item", CVAR_GAME, "The name of the entityDef that defines the player's inventory loot item.");
 
 idCVar cv_tdm_obj_gui_file(	"tdm_obj_hud_file", "guis/tdm_objectives.gui",	CVAR_GAME, "The name of the gui file that defines the in-game objectives.");
+idCVar cv_tdm_obj_verify(	"tdm_obj_verify", "0",	CVAR_GAME | CVAR_BOOL, "Cross-check the incremental objective update: warns when a component changed without its objective being re-evaluated, or when a skipped info_location check disagrees with a full one.");
 idCVar cv_tdm_waituntilready_gui_file( "tdm_waituntilready_gui_file", "guis/tdm_waituntilready.gui",	CVAR_GAME, "The name of the gui file that is displayed after loading a map and before starting the gameplay action.");
 idCVar cv_tdm_invgrid_gui_file( "tdm_invgrid_hud_file", "guis/tdm_invgrid_parchment.gui",  CVAR_GAME | CVAR_ARCHIVE, "The name of the gui file that defines the in-game inventory grid.");
 idCVar cv_tdm_subtitles_gui_file( "tdm_subtitles_gui_file", "guis/tdm_subtitles.gui",  CVAR_GAME, "The name of the gui file for in-game subtitles overlay");
@@ -619,6 +622,7 @@ idCVar g_showTriggers(				"g_showTriggers",			"0",			CVAR_GAME | CVAR_BOOL, "dra
 idCVar g_showCollisionWorld(		"g_showCollisionWorld",		"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showCollisionModels(		"g_showCollisionModels",	"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_showCollisionTraces(		"g_showCollisionTraces",	"0",			CVAR_GAME | CVAR_BOOL, "" );
+idCVar g_clipBroadphase(			"g_clipBroadphase",			"0",			CVAR_GAME | CVAR_INTEGER, "structure used to find clip models touching bounds: 0 = fixed-depth sector tree, 1 = dynamic AABB tree", 0, 1, idCmdSystem::ArgCompletion_Integer<0,1> );
 idCVar g_showCollisionAlongView(		"g_showCollisionAlongView",	"0",			CVAR_GAME | CVAR_INTEGER, "Sends a ray along player's view direction and highlights first hit (using idClip::Translation). The value specifies contents mask for clipping (1 = solid, 2 = opaque, ...)." );
 idCVar g_maxShowDistance(			"g_maxShowDistance",		"128",			CVAR_GAME | CVAR_FLOAT, "" );
 idCVar g_showEntityInfo(			"g_showEntityInfo",			"0",			CVAR_GAME | CVAR_BOOL, "" );
@@ -633,6 +637,12 @@ idCVar g_frametime(					"g_frametime",				"0",			CVAR_GAME | CVAR_BOOL, "display
 // TDM: greebo: Use this to stretch the hardcoded 16 msec each frame takes. This can be used to let the game run ultra-slow.
 idCVar g_timeModifier(				"g_timeModifier",			"1",			CVAR_GAME | CVAR_FLOAT, "Use this to stretch the hardcoded 16 msec each frame takes. This can be used to let the game run ultra-slow." );
 idCVar g_timeentities(				"g_timeEntities",			"0",			CVAR_GAME | CVAR_FLOAT, "when non-zero, shows entities whose think functions exceeded the # of milliseconds specified" );
+idCVar g_aiThinkBudget(				"g_aiThinkBudget",			"4",			CVAR_GAME | CVAR_FLOAT | CVAR_ARCHIVE, "msec per frame for AI thinking: AI which don't fit are deferred to next frames by priority, 0 = unlimited" );
+idCVar g_aiThinkMaxDelay(			"g_aiThinkMaxDelay",		"250",			CVAR_GAME | CVAR_INTEGER | CVAR_ARCHIVE, "AI deferred by g_aiThinkBudget for this many msec think regardless of budget" );
+idCVar g_aiScheduleStats(			"g_aiScheduleStats",		"0",			CVAR_GAME | CVAR_BOOL, "prints AI think scheduler statistics every frame" );
+idCVar g_managerSchedule(			"g_managerSchedule",		"1",			CVAR_GAME | CVAR_BOOL, "skip conversation, search, timer and objective processing in frames where they have nothing to do" );
+idCVar g_managerScheduleStats(		"g_managerScheduleStats",	"0",			CVAR_GAME | CVAR_BOOL, "prints time spent in conversation, search, timer and objective processing every frame" );
+idCVar g_pvsCache(					"g_pvsCache",				"1",			CVAR_GAME | CVAR_BOOL, "store the PVS of a map in maps/<map>.pvs and load it from there while the portals of the map are unchanged" );
 
 
 idCVar g_enablePortalSky(			"g_enablePortalSky",		"2",			CVAR_GAME | CVAR_INTEGER | CVAR_ARCHIVE, "enables the portal sky: 1 - old method, 2 - new method" );
@@ -645,6 +655,7 @@ idCVar ai_testPredictPath(			"ai_testPredictPath",		"0",			CVAR_GAME | CVAR_BOOL
 idCVar ai_showCombatNodes(			"ai_showCombatNodes",		"0",			CVAR_GAME | CVAR_BOOL, "draws attack cones for monsters" );
 idCVar ai_showPaths(				"ai_showPaths",				"0",			CVAR_GAME | CVAR_BOOL, "draws path_* entities" );
 idCVar ai_showObstacleAvoidance(	"ai_showObstacleAvoidance",	"0",			CVAR_GAME | CVAR_INTEGER, "draws obstacle avoidance information for monsters.  if 2, draws obstacles for player, as well", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
+idCVar ai_obstacleCache(			"ai_obstacleCache",			"1",			CVAR_GAME | CVAR_BOOL, "share potential obstacles gathered once per frame between AI in the same AAS area" );
 idCVar ai_blockedFailSafe(			"ai_blockedFailSafe",		"1",			CVAR_GAME | CVAR_BOOL, "enable blocked fail safe handling" );
 	
 idCVar g_dvTime(					"g_dvTime",					"1",			CVAR_GAME | CVAR_FLOAT, "" );
@@ -719,6 +730,9 @@ idCVar af_showInertia(				"af_showInertia",			"0",			CVAR_GAME | CVAR_BOOL, "sho
 idCVar af_showVelocity(				"af_showVelocity",			"0",			CVAR_GAME | CVAR_BOOL, "show the velocity of each body" );
 idCVar af_showActive(				"af_showActive",			"0",			CVAR_GAME | CVAR_BOOL, "show tree-like structures of articulated figures not at rest" );
 idCVar af_testSolid(				"af_testSolid",				"1",			CVAR_GAME | CVAR_BOOL, "test for bodies initially stuck in solid" );
+idCVar af_parallelSolve(			"af_parallelSolve",			"1",			CVAR_GAME | CVAR_BOOL, "solve active articulated figures in parallel before entities think" );
+idCVar af_islandSleep(				"af_islandSleep",			"1",			CVAR_GAME | CVAR_BOOL, "put articulated figures touching each other to rest together" );
+idCVar af_sleepTime(				"af_sleepTime",				"0.5",			CVAR_GAME | CVAR_FLOAT, "time a figure touching other figures must be almost still before it can rest" );
 
 idCVar rb_showTimings(				"rb_showTimings",			"0",			CVAR_GAME | CVAR_BOOL, "show rigid body cpu usage" );
 idCVar rb_showBodies(				"rb_showBodies",			"0",			CVAR_GAME | CVAR_BOOL, "show rigid bodies" );
@@ -806,6 +820,7 @@ idCVar g_testModelBlend(			"g_testModelBlend",			"0",			CVAR_GAME | CVAR_INTEGER
 idCVar g_testDeath(					"g_testDeath",				"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_exportMask(				"g_exportMask",				"",				CVAR_GAME, "" );
 idCVar g_flushSave(					"g_flushSave",				"0",			CVAR_GAME | CVAR_BOOL, "1 = don't buffer file writing for save games." );
+idCVar g_profileSaveGame(			"g_profileSaveGame",		"0",			CVAR_GAME | CVAR_BOOL, "1 = print time and size of every object class when saving or loading game" );
 
 idCVar g_rotoscope(					"g_rotoscope",				"0",			CVAR_GAME | CVAR_ARCHIVE | CVAR_BOOL, "Noir cartoon-like rendering" );
 
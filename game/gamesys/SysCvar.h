@@ -72,6 +72,7 @@ extern idCVar cv_ai_opt_nolipsync;
 extern idCVar cv_ai_opt_nopresent;
 extern idCVar cv_ai_opt_noobstacleavoidance;
 extern idCVar cv_ai_hiding_spot_max_light_quotient;
+extern idCVar cv_ai_hiding_spot_database;
 extern idCVar cv_ai_max_hiding_spot_tests_per_frame;
 extern idCVar cv_ai_debug_anims;
 
@@ -122,6 +123,7 @@ extern idCVar cv_sndprop_disable;
 extern idCVar cv_spr_debug;
 extern idCVar cv_spr_show;
 extern idCVar cv_spr_radius_show;
+extern idCVar cv_spr_cache;
 extern idCVar cv_ko_show;
 extern idCVar cv_ai_animstate_show;
 
@@ -315,6 +317,7 @@ extern idCVar cv_reverse_grab_control;
 extern idCVar cv_tdm_rope_pull_force_factor;
 
 extern idCVar cv_tdm_obj_gui_file;
+extern idCVar cv_tdm_obj_verify;
 extern idCVar cv_tdm_waituntilready_gui_file;
 extern idCVar cv_tdm_invgrid_gui_file;	// #4286
 extern idCVar cv_tdm_subtitles_gui_file;
@@ -483,6 +486,7 @@ extern idCVar	g_showTriggers;
 extern idCVar	g_showCollisionWorld;
 extern idCVar	g_showCollisionModels;
 extern idCVar	g_showCollisionTraces;
+extern idCVar	g_clipBroadphase;
 extern idCVar g_showCollisionAlongView;
 extern idCVar	g_maxShowDistance;
 extern idCVar	g_showEntityInfo;
@@ -494,6 +498,12 @@ extern idCVar	g_showEnemies;
 
 extern idCVar	g_frametime;
 extern idCVar	g_timeentities;
+extern idCVar	g_aiThinkBudget;
+extern idCVar	g_aiThinkMaxDelay;
+extern idCVar	g_aiScheduleStats;
+extern idCVar	g_managerSchedule;
+extern idCVar	g_managerScheduleStats;
+extern idCVar	g_pvsCache;
 
 extern idCVar	g_timeModifier;
 
@@ -504,6 +514,7 @@ extern idCVar	ai_testPredictPath;
 extern idCVar	ai_showCombatNodes;
 extern idCVar	ai_showPaths;
 extern idCVar	ai_showObstacleAvoidance;
+extern idCVar	ai_obstacleCache;
 extern idCVar	ai_blockedFailSafe;
 
 extern idCVar	g_dvTime;
@@ -567,6 +578,9 @@ extern idCVar	af_showInertia;
 extern idCVar	af_showVelocity;
 extern idCVar	af_showActive;
 extern idCVar	af_testSolid;
+extern idCVar	af_parallelSolve;
+extern idCVar	af_islandSleep;
+extern idCVar	af_sleepTime;
 
 extern idCVar	rb_showTimings;
 extern idCVar	rb_showBodies;
@@ -643,6 +657,7 @@ extern idCVar	g_testModelAnimate;
 extern idCVar	g_testModelBlend;
 extern idCVar	g_exportMask;
 extern idCVar	g_flushSave;
+extern idCVar	g_profileSaveGame;
 
 extern idCVar	aas_test;
 extern idCVar	aas_showAreas;
@@ -296,6 +296,8 @@ void idClipModel::Init( void ) {
 	renderModelHandle = -1;
 	traceModelIndex = -1;
 	clipLinks = NULL;
+	clipTree = NULL;
+	clipTreeLeaf = idClipTree::NULL_NODE;
 	touchCount = -1;
 }
 
@@ -373,6 +375,8 @@ idClipModel::idClipModel( const idClipModel *model ) {
 	}
 	renderModelHandle = model->renderModelHandle;
 	clipLinks = NULL;
+	clipTree = NULL;
+	clipTreeLeaf = idClipTree::NULL_NODE;
 	touchCount = -1;
 }
 
@@ -411,7 +415,7 @@ void idClipModel::Save( idSaveGame *savefile ) const {
 		savefile->WriteString( "" );
 	}
 	savefile->WriteInt( traceModelIndex );
-	savefile->WriteBool( clipLinks != NULL );
+	savefile->WriteBool( IsLinked() );
 	savefile->WriteInt( touchCount );
 }
 
@@ -457,6 +461,8 @@ void idClipModel::Restore( idRestoreGame *savefile ) {
 	// the render model will be set when the clip model is linked, so do not restore it
 	renderModelHandle = -1;
 	clipLinks = NULL;
+	clipTree = NULL;
+	clipTreeLeaf = idClipTree::NULL_NODE;
 	touchCount = -1;
 
 	if ( linked ) {
@@ -470,7 +476,7 @@ idClipModel::SetPosition
 ================
 */
 void idClipModel::SetPosition( const idVec3 &newOrigin, const idMat3 &newAxis ) {
-	if ( clipLinks ) {
+	if ( IsLinked() ) {
 		Unlink();	// unlink from old position
 	}
 	origin = newOrigin;
@@ -517,6 +523,16 @@ idClipModel::Unlink
 ===============
 */
 void idClipModel::Unlink( void ) {
+	UnlinkSectors();
+	UnlinkTree();
+}
+
+/*
+===============
+idClipModel::UnlinkSectors
+===============
+*/
+void idClipModel::UnlinkSectors( void ) {
 	clipLink_t *link;
 
 	for ( link = clipLinks; link; link = clipLinks ) {
@@ -533,6 +549,19 @@ void idClipModel::Unlink( void ) {
 	}
 }
 
+/*
+===============
+idClipModel::UnlinkTree
+===============
+*/
+void idClipModel::UnlinkTree( void ) {
+	if ( clipTreeLeaf != idClipTree::NULL_NODE ) {
+		clipTree->Remove( clipTreeLeaf );
+		clipTree = NULL;
+		clipTreeLeaf = idClipTree::NULL_NODE;
+	}
+}
+
 /*
 ===============
 idClipModel::Link_r
@@ -578,10 +607,11 @@ void idClipModel::Link( idClip &clp ) {
 	}
 
 	if ( clipLinks ) {
-		Unlink();	// unlink from old position
+		UnlinkSectors();	// unlink from old position
 	}
 
 	if ( bounds.IsCleared() ) {
+		UnlinkTree();
 		return;
 	}
 
@@ -600,7 +630,24 @@ void idClipModel::Link( idClip &clp ) {
 	absBounds[0] -= vec3_boxEpsilon;
 	absBounds[1] += vec3_boxEpsilon;
 
-	Link_r( clp.clipSectors );
+	if ( clp.broadphase & CLIP_BROADPHASE_SECTORS ) {
+		Link_r( clp.clipSectors );
+	}
+
+	// tree leaf is moved instead of unlinking, so that small movements are cheap
+	if ( clipTree != &clp.clipTree ) {
+		UnlinkTree();
+	}
+	if ( clp.broadphase & CLIP_BROADPHASE_TREE ) {
+		if ( clipTreeLeaf != idClipTree::NULL_NODE ) {
+			clipTree->Move( clipTreeLeaf, absBounds );
+		} else {
+			clipTree = &clp.clipTree;
+			clipTreeLeaf = clipTree->Insert( this, absBounds );
+		}
+	} else {
+		UnlinkTree();
+	}
 }
 
 /*
@@ -652,7 +699,9 @@ idClip::idClip( void ) {
 	numClipSectors = 0;
 	clipSectors = NULL;
 	worldBounds.Zero();
+	broadphase = queryBroadphase = CLIP_BROADPHASE_SECTORS;
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
+	numCandidates = numTouching = 0;
 }
 
 /*
@@ -720,6 +769,11 @@ void idClip::Init( void ) {
 	numClipSectors = 0;
 	touchCount = -1;
 
+	// sectors are always created, so that broadphase can be switched while map is running
+	broadphase = queryBroadphase = ( g_clipBroadphase.GetInteger() == 1 ? CLIP_BROADPHASE_TREE : CLIP_BROADPHASE_SECTORS );
+	g_clipBroadphase.ClearModified();
+	clipTree.Clear();
+
 	// get world map bounds
 	//stgatilov: name of collision model equals "name" spawnarg of worldspawn entity (and "worldMap" if not specified)
 	//however, it is certain that world collision model is always the first one (that's how it worked before rev 9592)
@@ -739,6 +793,7 @@ void idClip::Init( void ) {
 
 	// set counters to zero
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
+	numCandidates = numTouching = 0;
 }
 
 /*
@@ -749,6 +804,7 @@ idClip::Shutdown
 void idClip::Shutdown( void ) {
 	delete[] clipSectors;
 	clipSectors = NULL;
+	clipTree.Clear();
 
 	// free the trace model used for the temporaryClipModel
 	if ( temporaryClipModel.traceModelIndex != -1 ) {
@@ -791,6 +847,7 @@ void idClip::ClipModelsTouchingBounds_r( const struct clipSector_s *node, listPa
 
 	for ( clipLink_t *link = node->clipLinks; link; link = link->nextInSector ) {
 		idClipModel	*check = link->clipModel;
+		numCandidates++;
 
 		// if the clip model is enabled
 		if ( !check->enabled ) {
@@ -813,10 +870,41 @@ void idClip::ClipModelsTouchingBounds_r( const struct clipSector_s *node, listPa
 		}
 
 		check->touchCount = touchCount;
+		numTouching++;
 		parms.list->AddGrow(check);
 	}
 }
 
+/*
+====================
+idClip::ClipModelsTouchingBoundsTree
+====================
+*/
+void idClip::ClipModelsTouchingBoundsTree( listParms_t &parms ) const {
+	auto nodeTest = [&parms]( const idBounds &nodeBounds ) -> bool {
+		return nodeBounds.IntersectsBounds( parms.bounds );
+	};
+	auto leafFunc = [this, &parms]( idClipModel *check ) {
+		numCandidates++;
+
+		// every clip model has exactly one leaf, so no duplicates possible
+		if ( !check->enabled ) {
+			return;
+		}
+		if ( !( check->contents & parms.contentMask ) ) {
+			return;
+		}
+		// leaf bounds may be enlarged
+		if ( !check->absBounds.IntersectsBounds( parms.bounds ) ) {
+			return;
+		}
+
+		numTouching++;
+		parms.list->AddGrow( check );
+	};
+	clipTree.Query( nodeTest, leafFunc );
+}
+
 /*
 ====================
 idClip::ClipModelsTouchingMovingBounds_r
@@ -862,6 +950,7 @@ void idClip::ClipModelsTouchingMovingBounds_r( const clipSector_s *node, idBound
 
 	for ( clipLink_t *link = node->clipLinks; link; link = link->nextInSector ) {
 		idClipModel	*check = link->clipModel;
+		numCandidates++;
 
 		// if the clip model is enabled
 		if ( !check->enabled ) {
@@ -889,11 +978,46 @@ void idClip::ClipModelsTouchingMovingBounds_r( const clipSector_s *node, idBound
 		}
 
 		check->touchCount = touchCount;
+		numTouching++;
 		parms.list->AddGrow(check);
 		parms.fractionLowers->AddGrow(tempRange[0]);
 	}
 }
 
+/*
+====================
+idClip::ClipModelsTouchingMovingBoundsTree
+====================
+*/
+void idClip::ClipModelsTouchingMovingBoundsTree( listParmsMoving &parms ) const {
+	auto nodeTest = [&parms]( const idBounds &nodeBounds ) -> bool {
+		float tempRange[2];
+		return nodeBounds.IntersectsBounds( parms.bounds ) && parms.IntersectsBounds( nodeBounds, tempRange );
+	};
+	auto leafFunc = [this, &parms]( idClipModel *check ) {
+		float tempRange[2];
+		numCandidates++;
+
+		if ( !check->enabled ) {
+			return;
+		}
+		if ( !( check->contents & parms.contentMask ) ) {
+			return;
+		}
+		if ( !check->absBounds.IntersectsBounds( parms.bounds ) ) {
+			return;
+		}
+		if ( !parms.IntersectsBounds( check->absBounds, tempRange ) ) {
+			return;
+		}
+
+		numTouching++;
+		parms.list->AddGrow( check );
+		parms.fractionLowers->AddGrow( tempRange[0] );
+	};
+	clipTree.Query( nodeTest, leafFunc );
+}
+
 /*
 ================
 idClip::ClipModelsTouchingBounds
@@ -914,8 +1038,12 @@ int idClip::ClipModelsTouchingBounds( const idBounds &bounds, int contentMask, i
 	parms.list = &clipModelList;
 	clipModelList.Clear();
 
-	touchCount++;
-	ClipModelsTouchingBounds_r( clipSectors, parms );
+	if ( queryBroadphase == CLIP_BROADPHASE_TREE ) {
+		ClipModelsTouchingBoundsTree( parms );
+	} else {
+		touchCount++;
+		ClipModelsTouchingBounds_r( clipSectors, parms );
+	}
 
 	return clipModelList.Num();
 }
@@ -950,9 +1078,13 @@ int idClip::ClipModelsTouchingMovingBounds(
 	parms.extent = stillBounds.GetSize() * 0.5f + vec3_boxEpsilon;
 	parms.invDir = GetInverseMovementVelocity(start, end);
 
-	touchCount++;
-	idBounds nodeBounds(idVec3(-1e+10f), idVec3(1e+10f));
-	ClipModelsTouchingMovingBounds_r( clipSectors, nodeBounds, parms );
+	if ( queryBroadphase == CLIP_BROADPHASE_TREE ) {
+		ClipModelsTouchingMovingBoundsTree( parms );
+	} else {
+		touchCount++;
+		idBounds nodeBounds(idVec3(-1e+10f), idVec3(1e+10f));
+		ClipModelsTouchingMovingBounds_r( clipSectors, nodeBounds, parms );
+	}
 
 	// sort clip models by lower bound on intersection time
 	int n = clipModelList.Num();
@@ -1264,6 +1396,143 @@ bool idClip::Translation( trace_t &results, const idVec3 &start, const idVec3 &e
 	return ( results.fraction < 1.0f );
 }
 
+/*
+============
+idClip::TracePoints
+
+  gives same results as TracePoint for every ray,
+  but clip models are gathered once for all rays and traced with all rays touching them
+============
+*/
+void idClip::TracePoints( trace_t *results, const idVec3 *starts, const idVec3 *ends, int numRays, int contentMask, const idEntity *passEntity ) {
+	int i;
+
+	if ( numRays <= 0 ) {
+		return;
+	}
+	TRACE_CPU_SCOPE( "Clip:TracePoints" );
+
+	if ( !passEntity || passEntity->entityNumber != ENTITYNUM_WORLD ) {
+		// test world
+		idClip::numTranslations += numRays;
+		collisionModelManager->TranslationPoints( results, starts, ends, numRays, contentMask, 0, vec3_origin, mat3_default );
+		for ( i = 0; i < numRays; i++ ) {
+			results[i].c.entityNum = results[i].fraction != 1.0f ? ENTITYNUM_WORLD : ENTITYNUM_NONE;
+		}
+	} else {
+		for ( i = 0; i < numRays; i++ ) {
+			memset( &results[i], 0, sizeof( results[i] ) );
+			results[i].fraction = 1.0f;
+			results[i].endpos = ends[i];
+			results[i].endAxis = mat3_identity;
+		}
+	}
+
+	// per ray culling data, same as in Translation
+	idFlexList<idBounds, 16> rayBounds;
+	idFlexList<idVec3, 16> rayInvDirs;
+	idFlexList<float, 16> rayPartOfWhole;
+	rayBounds.SetNum( numRays );
+	rayInvDirs.SetNum( numRays );
+	rayPartOfWhole.SetNum( numRays );
+
+	idBounds batchBounds;
+	batchBounds.Clear();
+	for ( i = 0; i < numRays; i++ ) {
+		if ( results[i].fraction == 0.0f ) {
+			continue;	// blocked immediately by the world
+		}
+		rayBounds[i].Clear();
+		rayBounds[i].AddPoint( starts[i] );
+		rayBounds[i].AddPoint( results[i].endpos );
+		batchBounds.AddBounds( rayBounds[i] );
+		rayBounds[i].ExpandSelf( CM_BOX_EPSILON );
+
+		float totalMovement = ( results[i].endpos - starts[i] ).Length();
+		if ( totalMovement > CM_BOX_EPSILON ) {
+			rayInvDirs[i] = GetInverseMovementVelocity( starts[i], results[i].endpos );
+			rayPartOfWhole[i] = totalMovement * idMath::InvSqrt( ( ends[i] - starts[i] ).LengthSqr() );
+		} else {
+			rayPartOfWhole[i] = 0.0f;
+		}
+	}
+	if ( batchBounds.IsCleared() ) {
+		return;
+	}
+
+	idClip_ClipModelList clipModelList;
+	int num = GetTraceClipModels( batchBounds, contentMask, passEntity, clipModelList );
+
+	idFlexList<int, 16> rays;
+	idFlexList<idVec3, 16> rayStarts, rayEnds;
+	idFlexList<trace_t, 16> rayResults;
+	trace_t trace;
+
+	for ( int m = 0; m < num; m++ ) {
+		idClipModel *touch = clipModelList[m];
+		if ( !touch ) {
+			continue;
+		}
+
+		// select rays which can hit this clip model
+		rays.Clear();
+		for ( i = 0; i < numRays; i++ ) {
+			if ( results[i].fraction == 0.0f ) {
+				continue;
+			}
+			if ( !touch->absBounds.IntersectsBounds( rayBounds[i] ) ) {
+				continue;
+			}
+			if ( rayPartOfWhole[i] > 0.0f ) {
+				float range[2] = { 0.0f, 1.0f };
+				if ( !MovingBoundsIntersectBounds( starts[i], rayInvDirs[i], vec3_boxEpsilon, touch->absBounds, range ) ) {
+					continue;
+				}
+				if ( range[0] * rayPartOfWhole[i] > results[i].fraction ) {
+					continue;
+				}
+			}
+			rays.AddGrow( i );
+		}
+		if ( rays.Num() == 0 ) {
+			continue;
+		}
+
+		if ( touch->renderModelHandle != -1 ) {
+			for ( int r = 0; r < rays.Num(); r++ ) {
+				i = rays[r];
+				idClip::numRenderModelTraces++;
+				TraceRenderModel( trace, starts[i], ends[i], 0.0f, mat3_identity, touch );
+				if ( trace.fraction < results[i].fraction ) {
+					results[i] = trace;
+					results[i].c.entityNum = touch->entity->entityNumber;
+					results[i].c.id = touch->id;
+				}
+			}
+			continue;
+		}
+
+		rayStarts.SetNum( rays.Num() );
+		rayEnds.SetNum( rays.Num() );
+		rayResults.SetNum( rays.Num() );
+		for ( int r = 0; r < rays.Num(); r++ ) {
+			rayStarts[r] = starts[rays[r]];
+			rayEnds[r] = ends[rays[r]];
+		}
+		idClip::numTranslations += rays.Num();
+		collisionModelManager->TranslationPoints( rayResults.Ptr(), rayStarts.Ptr(), rayEnds.Ptr(), rays.Num(), contentMask,
+									touch->Handle(), touch->origin, touch->axis );
+		for ( int r = 0; r < rays.Num(); r++ ) {
+			i = rays[r];
+			if ( rayResults[r].fraction < results[i].fraction ) {
+				results[i] = rayResults[r];
+				results[i].c.entityNum = touch->entity->entityNumber;
+				results[i].c.id = touch->id;
+			}
+		}
+	}
+}
+
 /*
 ============
 idClip::Rotation
@@ -1790,9 +2059,278 @@ idClip::PrintStatistics
 ============
 */
 void idClip::PrintStatistics( void ) {
-	gameLocal.Printf( "t = %-3d, r = %-3d, m = %-3d, render = %-3d, contents = %-3d, contacts = %-3d\n",
-					numTranslations, numRotations, numMotions, numRenderModelTraces, numContents, numContacts );
+	gameLocal.Printf( "t = %-3d, r = %-3d, m = %-3d, render = %-3d, contents = %-3d, contacts = %-3d, candidates = %-4d, touching = %-4d\n",
+					numTranslations, numRotations, numMotions, numRenderModelTraces, numContents, numContacts, numCandidates, numTouching );
 	numRotations = numTranslations = numMotions = numRenderModelTraces = numContents = numContacts = 0;
+	numCandidates = numTouching = 0;
+}
+
+/*
+============
+idClip::GetLinkedClipModels
+============
+*/
+void idClip::GetLinkedClipModels( idList<idClipModel *> &clipModels ) const {
+	clipModels.Clear();
+	if ( broadphase & CLIP_BROADPHASE_TREE ) {
+		clipTree.GetModels( clipModels );
+		return;
+	}
+
+	// clip model can be linked into many sectors
+	touchCount++;
+	for ( int i = 0; i < numClipSectors; i++ ) {
+		for ( clipLink_t *link = clipSectors[i].clipLinks; link; link = link->nextInSector ) {
+			idClipModel *check = link->clipModel;
+			if ( check->touchCount != touchCount ) {
+				check->touchCount = touchCount;
+				clipModels.Append( check );
+			}
+		}
+	}
+}
+
+/*
+============
+idClip::SetBroadphase
+
+relinks all clip models into given structures
+============
+*/
+void idClip::SetBroadphase( int flags ) {
+	assert( flags & ( CLIP_BROADPHASE_SECTORS | CLIP_BROADPHASE_TREE ) );
+
+	idList<idClipModel *> clipModels;
+	GetLinkedClipModels( clipModels );
+	for ( int i = 0; i < clipModels.Num(); i++ ) {
+		clipModels[i]->Unlink();
+	}
+
+	broadphase = flags;
+	queryBroadphase = ( flags & CLIP_BROADPHASE_TREE ) ? CLIP_BROADPHASE_TREE : CLIP_BROADPHASE_SECTORS;
+	clipTree.Clear();
+
+	for ( int i = 0; i < clipModels.Num(); i++ ) {
+		clipModels[i]->Link( *this );
+	}
+}
+
+/*
+============
+idClip::UpdateBroadphase
+============
+*/
+void idClip::UpdateBroadphase( void ) {
+	if ( !g_clipBroadphase.IsModified() ) {
+		return;
+	}
+	g_clipBroadphase.ClearModified();
+
+	int flags = ( g_clipBroadphase.GetInteger() == 1 ? CLIP_BROADPHASE_TREE : CLIP_BROADPHASE_SECTORS );
+	if ( flags != broadphase ) {
+		SetBroadphase( flags );
+		gameLocal.Printf( "clip models relinked into %s\n", flags == CLIP_BROADPHASE_TREE ? "AABB tree" : "sector tree" );
+	}
+}
+
+/*
+============
+idClip::Benchmark_f
+============
+*/
+void idClip::Benchmark_f( const idCmdArgs &args ) {
+	if ( gameLocal.GameState() != GAMESTATE_ACTIVE ) {
+		gameLocal.Printf( "No map running\n" );
+		return;
+	}
+	int numQueries = ( args.Argc() > 1 ? atoi( args.Argv( 1 ) ) : 20000 );
+	numQueries = idMath::Imax( numQueries, 1 );
+
+	idClip &clip = gameLocal.clip;
+	int oldBroadphase = clip.broadphase;
+	static const int structures[2] = { CLIP_BROADPHASE_SECTORS, CLIP_BROADPHASE_TREE };
+	static const char *names[2] = { "sector tree", "AABB tree" };
+
+	// time of linking all clip models from scratch
+	uint64 linkTime[2];
+	for ( int s = 0; s < 2; s++ ) {
+		uint64 startTime = Sys_GetTimeMicroseconds();
+		clip.SetBroadphase( structures[s] );
+		linkTime[s] = Sys_GetTimeMicroseconds() - startTime;
+	}
+	clip.SetBroadphase( CLIP_BROADPHASE_SECTORS | CLIP_BROADPHASE_TREE );
+
+	idList<idClipModel *> clipModels;
+	clip.GetLinkedClipModels( clipModels );
+	if ( clipModels.Num() == 0 ) {
+		clip.SetBroadphase( oldBroadphase );
+		gameLocal.Printf( "No clip models linked\n" );
+		return;
+	}
+
+	int numLinks = 0;
+	for ( int i = 0; i < clip.numClipSectors; i++ ) {
+		for ( clipLink_t *link = clip.clipSectors[i].clipLinks; link; link = link->nextInSector ) {
+			numLinks++;
+		}
+	}
+	gameLocal.Printf( "%d clip models: %d links in %d sectors, AABB tree with %d nodes and height %d\n",
+		clipModels.Num(), numLinks, clip.numClipSectors, clip.clipTree.GetNumNodes(), clip.clipTree.GetHeight() );
+
+	// random boxes and sweeps around clip models, same for both structures
+	struct query_t {
+		idBounds	bounds;
+		idBounds	stillBounds;
+		idBounds	moveBounds;
+		idVec3		start;
+		idVec3		end;
+	};
+	idList<query_t> queries;
+	queries.SetNum( numQueries );
+	idRandom rnd( 0 );
+	for ( int i = 0; i < numQueries; i++ ) {
+		query_t &q = queries[i];
+		const idClipModel *model = clipModels[rnd.RandomInt( clipModels.Num() )];
+		idVec3 extent( 8.0f + 120.0f * rnd.RandomFloat(), 8.0f + 120.0f * rnd.RandomFloat(), 8.0f + 120.0f * rnd.RandomFloat() );
+		q.start = model->absBounds.GetCenter() + 128.0f * idVec3( rnd.CRandomFloat(), rnd.CRandomFloat(), rnd.CRandomFloat() );
+		q.end = q.start + 256.0f * idVec3( rnd.CRandomFloat(), rnd.CRandomFloat(), rnd.CRandomFloat() );
+		q.stillBounds = idBounds( -extent, extent );
+		q.bounds = q.stillBounds + q.start;
+		q.moveBounds = q.bounds + ( q.stillBounds + q.end );
+	}
+
+	idClip_ClipModelList list;
+	idClip_FloatList fractions;
+	for ( int s = 0; s < 2; s++ ) {
+		clip.queryBroadphase = structures[s];
+
+		clip.numCandidates = clip.numTouching = 0;
+		uint64 startTime = Sys_GetTimeMicroseconds();
+		for ( int i = 0; i < numQueries; i++ ) {
+			clip.ClipModelsTouchingBounds( queries[i].bounds, -1, list );
+		}
+		uint64 boundsTime = Sys_GetTimeMicroseconds() - startTime;
+		int boundsCandidates = clip.numCandidates, boundsTouching = clip.numTouching;
+
+		clip.numCandidates = clip.numTouching = 0;
+		startTime = Sys_GetTimeMicroseconds();
+		for ( int i = 0; i < numQueries; i++ ) {
+			const query_t &q = queries[i];
+			clip.ClipModelsTouchingMovingBounds( q.moveBounds, q.stillBounds, q.start, q.end, -1, list, fractions );
+		}
+		uint64 movingTime = Sys_GetTimeMicroseconds() - startTime;
+
+		gameLocal.Printf( "%s: link all %.2f ms\n", names[s], linkTime[s] * 1e-3 );
+		gameLocal.Printf( "  bounds: %.2f ms, %d candidates, %d touching\n", boundsTime * 1e-3, boundsCandidates, boundsTouching );
+		gameLocal.Printf( "  moving: %.2f ms, %d candidates, %d touching\n", movingTime * 1e-3, clip.numCandidates, clip.numTouching );
+	}
+
+	// both structures must return the same sets of clip models
+	int mismatches = 0;
+	idClip_ClipModelList treeList;
+	for ( int i = 0; i < numQueries; i++ ) {
+		clip.queryBroadphase = CLIP_BROADPHASE_TREE;
+		clip.ClipModelsTouchingBounds( queries[i].bounds, -1, treeList );
+		// sector query marks all clip models it returns
+		clip.queryBroadphase = CLIP_BROADPHASE_SECTORS;
+		clip.ClipModelsTouchingBounds( queries[i].bounds, -1, list );
+		bool same = ( list.Num() == treeList.Num() );
+		for ( int j = 0; j < treeList.Num() && same; j++ ) {
+			same = ( treeList[j]->touchCount == clip.touchCount );
+		}
+		mismatches += !same;
+	}
+	gameLocal.Printf( "%d of %d queries returned different results\n", mismatches, numQueries );
+
+	clip.numCandidates = clip.numTouching = 0;
+	clip.SetBroadphase( oldBroadphase );
+}
+
+/*
+============
+idClip::BenchmarkTracePoints_f
+
+  compares TracePoint against TracePoints on visibility rays between actors
+============
+*/
+void idClip::BenchmarkTracePoints_f( const idCmdArgs &args ) {
+	if ( gameLocal.GameState() != GAMESTATE_ACTIVE ) {
+		gameLocal.Printf( "No map running\n" );
+		return;
+	}
+	int numBatches = ( args.Argc() > 1 ? atoi( args.Argv( 1 ) ) : 10000 );
+	numBatches = idMath::Imax( numBatches, 1 );
+	static const int BATCH = 4;
+
+	idList<idActor *> actors;
+	for ( idEntity *ent = gameLocal.spawnedEntities.Next(); ent; ent = ent->spawnNode.Next() ) {
+		if ( ent->IsType( idActor::Type ) ) {
+			actors.Append( static_cast<idActor *>( ent ) );
+		}
+	}
+	if ( actors.Num() == 0 ) {
+		gameLocal.Printf( "No actors on map\n" );
+		return;
+	}
+
+	// same rays as idActor::CanSee: from eye of one actor to eye, origin and shoulders of another
+	idList<idVec3> starts, ends;
+	idList<const idEntity *> passEntities;
+	starts.SetNum( numBatches * BATCH );
+	ends.SetNum( numBatches * BATCH );
+	passEntities.SetNum( numBatches );
+	idRandom rnd( 0 );
+	for ( int b = 0; b < numBatches; b++ ) {
+		idActor *viewer = actors[rnd.RandomInt( actors.Num() )];
+		idActor *target = actors[rnd.RandomInt( actors.Num() )];
+		idVec3 eye = viewer->GetEyePosition();
+		idVec3 targetEye = target->GetEyePosition();
+		idVec3 targetOrigin = target->GetPhysics()->GetOrigin();
+		idVec3 side = ( targetEye - eye ).Cross( target->GetPhysics()->GetGravityNormal() );
+		side.NormalizeFast();
+		passEntities[b] = viewer;
+		for ( int r = 0; r < BATCH; r++ ) {
+			starts[b * BATCH + r] = eye;
+		}
+		ends[b * BATCH + 0] = targetEye;
+		ends[b * BATCH + 1] = targetOrigin;
+		ends[b * BATCH + 2] = targetOrigin + ( targetEye - targetOrigin ) * 0.7f + side * 8.0f;
+		ends[b * BATCH + 3] = targetOrigin + ( targetEye - targetOrigin ) * 0.7f - side * 8.0f;
+	}
+
+	idClip &clip = gameLocal.clip;
+	idList<trace_t> single, batched;
+	single.SetNum( starts.Num() );
+	batched.SetNum( starts.Num() );
+
+	uint64 startTime = Sys_GetTimeMicroseconds();
+	for ( int b = 0; b < numBatches; b++ ) {
+		for ( int r = 0; r < BATCH; r++ ) {
+			int i = b * BATCH + r;
+			clip.TracePoint( single[i], starts[i], ends[i], MASK_OPAQUE, passEntities[b] );
+		}
+	}
+	uint64 singleTime = Sys_GetTimeMicroseconds() - startTime;
+
+	startTime = Sys_GetTimeMicroseconds();
+	for ( int b = 0; b < numBatches; b++ ) {
+		int i = b * BATCH;
+		clip.TracePoints( &batched[i], &starts[i], &ends[i], BATCH, MASK_OPAQUE, passEntities[b] );
+	}
+	uint64 batchedTime = Sys_GetTimeMicroseconds() - startTime;
+
+	int mismatches = 0;
+	for ( int i = 0; i < starts.Num(); i++ ) {
+		if ( idMath::Fabs( single[i].fraction - batched[i].fraction ) > 1e-5f || single[i].c.entityNum != batched[i].c.entityNum ) {
+			mismatches++;
+		}
+	}
+
+	int numRays = starts.Num();
+	gameLocal.Printf( "%d rays from %d actors\n", numRays, actors.Num() );
+	gameLocal.Printf( "  TracePoint:  %.2f ms (%.0f rays/s)\n", singleTime * 1e-3, numRays * 1e6 / idMath::Fmax( (float)singleTime, 1.0f ) );
+	gameLocal.Printf( "  TracePoints: %.2f ms (%.0f rays/s)\n", batchedTime * 1e-3, numRays * 1e6 / idMath::Fmax( (float)batchedTime, 1.0f ) );
+	gameLocal.Printf( "%d of %d rays returned different results\n", mismatches, numRays );
 }
 
 /*
@@ -21,6 +21,7 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 #endif
 
 #include "containers/FlexList.h"
+#include "ClipTree.h"
 
 /*
 ===============================================================================
@@ -38,6 +39,10 @@ class idClipModel;
 class idEntity;
 struct listParmsMoving;
 
+// structures clip models are linked into, see g_clipBroadphase
+#define CLIP_BROADPHASE_SECTORS		1
+#define CLIP_BROADPHASE_TREE		2
+
 //stgatilov: size of automatic storage in returned arrays of entities
 #define CLIPARRAY_AUTOSIZE 128
 typedef idFlexList<idEntity*, CLIPARRAY_AUTOSIZE> idClip_EntityList;
@@ -74,7 +79,7 @@ public:
 
 	void					Link( idClip &clp );				// must have been linked with an entity and id before
 	void					Link( idClip &clp, idEntity *ent, int newId, const idVec3 &newOrigin, const idMat3 &newAxis, int renderModelHandle = -1 );
-	void					Unlink( void );						// unlink from sectors
+	void					Unlink( void );						// unlink from sectors and tree
 	void					SetPosition( const idVec3 &newOrigin, const idMat3 &newAxis );	// unlinks the clip model
 	/**
 	* Translates the origin of the clip model relative to the clipmodel itself
@@ -132,10 +137,14 @@ private:
 	int						renderModelHandle;		// render model def handle
 
 	struct clipLink_s *		clipLinks;				// links into sectors
+	idClipTree *			clipTree;				// tree this clip model is linked into
+	int						clipTreeLeaf;			// leaf in clipTree
 	int						touchCount;
 
 	void					Init( void );			// initialize
 	void					Link_r( struct clipSector_s *node );
+	void					UnlinkSectors( void );
+	void					UnlinkTree( void );
 
 	static int				AllocTraceModel( const idTraceModel &trm );
 	static void				FreeTraceModel( const int traceModelIndex );
@@ -240,7 +249,7 @@ ID_INLINE bool idClipModel::IsTraceModel( void ) const {
 }
 
 ID_INLINE bool idClipModel::IsLinked( void ) const {
-	return ( clipLinks != NULL );
+	return ( clipLinks != NULL || clipTreeLeaf != idClipTree::NULL_NODE );
 }
 
 ID_INLINE bool idClipModel::IsEnabled( void ) const {
@@ -292,6 +301,9 @@ public:
 								int contentMask, const idEntity *passEntity );
 	bool					TraceBounds( trace_t &results, const idVec3 &start, const idVec3 &end, const idBounds &bounds,
 								int contentMask, const idEntity *passEntity );
+	// trace many points at once, results are the same as TracePoint would give for every ray
+	void					TracePoints( trace_t *results, const idVec3 *starts, const idVec3 *ends, int numRays,
+								int contentMask, const idEntity *passEntity );
 
 	// clip versus a specific model
 	void					TranslationModel( trace_t &results, const idVec3 &start, const idVec3 &end,
@@ -327,6 +339,13 @@ public:
 	bool					DrawModelContactFeature( const contactInfo_t &contact, const idClipModel *clipModel, int lifetime ) const;
 	void					DrawClipModel( const idClipModel *clipModel, const idVec3 &eye, const float radius ) const;
 
+							// relink all clip models if g_clipBroadphase was changed
+	void					UpdateBroadphase( void );
+							// compare query performance of sector tree and AABB tree on current map
+	static void				Benchmark_f( const class idCmdArgs &args );
+							// compare single and batched point traces between actors
+	static void				BenchmarkTracePoints_f( const class idCmdArgs &args );
+
 private:
 	int						numClipSectors;
 	struct clipSector_s *	clipSectors;
@@ -334,6 +353,9 @@ private:
 	idClipModel				temporaryClipModel;
 	idClipModel				defaultClipModel;
 	mutable int				touchCount;
+	int						broadphase;				// CLIP_BROADPHASE_* flags of maintained structures
+	int						queryBroadphase;		// structure used for queries
+	idClipTree				clipTree;
 							// statistics
 	int						numTranslations;
 	int						numRotations;
@@ -341,10 +363,15 @@ private:
 	int						numRenderModelTraces;
 	int						numContents;
 	int						numContacts;
+	mutable int				numCandidates;			// clip models tested by broadphase queries
+	mutable int				numTouching;			// clip models returned by broadphase queries
 
 private:
 	struct clipSector_s *	CreateClipSectors_r( const int depth, const idBounds &bounds, idVec3 &maxSector );
 	void					ClipModelsTouchingBounds_r( const struct clipSector_s *node, struct listParms_s &parms ) const;
+	void					ClipModelsTouchingBoundsTree( struct listParms_s &parms ) const;
+	void					GetLinkedClipModels( idList<idClipModel *> &clipModels ) const;
+	void					SetBroadphase( int flags );
 	const idTraceModel *	TraceModelForClipModel( const idClipModel *mdl ) const;
 	int						GetTraceClipModels( const idBounds &bounds, int contentMask, const idEntity *passEntity, idClip_ClipModelList &clipModelList ) const;
 	void					TraceRenderModel( trace_t &trace, const idVec3 &start, const idVec3 &end, const float radius, const idMat3 &axis, idClipModel *touch ) const;
@@ -353,6 +380,7 @@ private:
 	void					FilterEntities( idClip_EntityList &entityList, idClip_ClipModelList &clipModelList ) const;
 
 	void					ClipModelsTouchingMovingBounds_r( const clipSector_s *node, idBounds &nodeBounds, listParmsMoving &parms ) const;
+	void					ClipModelsTouchingMovingBoundsTree( listParmsMoving &parms ) const;
 	int						ClipModelsTouchingMovingBounds( const idBounds &absBounds, const idBounds &stillBounds, const idVec3 &start, const idVec3 &end,
 								int contentMask, idClip_ClipModelList &clipModelList, idClip_FloatList &fractionLowers ) const;
 	int						GetTraceClipModels( const idBounds &absBounds, const idBounds &stillBounds, const idVec3 &start, const idVec3 &end,
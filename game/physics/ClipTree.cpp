@@ -0,0 +1,384 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "ClipTree.h"
+
+// margin added to bounds of moving clip models
+static const float CLIP_TREE_MARGIN = 8.0f;
+// leaf is reinserted if its bounds are looser than this
+static const float CLIP_TREE_MAX_SLACK = 4.0f * CLIP_TREE_MARGIN;
+
+/*
+================
+BoundsCost
+
+half of surface area
+================
+*/
+static ID_INLINE float BoundsCost( const idBounds &b ) {
+	idVec3 size = b[1] - b[0];
+	return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+/*
+================
+BoundsContain
+================
+*/
+static ID_INLINE bool BoundsContain( const idBounds &outer, const idBounds &inner ) {
+	return	inner[0].x >= outer[0].x && inner[0].y >= outer[0].y && inner[0].z >= outer[0].z &&
+			inner[1].x <= outer[1].x && inner[1].y <= outer[1].y && inner[1].z <= outer[1].z;
+}
+
+/*
+================
+idClipTree::idClipTree
+================
+*/
+idClipTree::idClipTree() {
+	nodes.SetGranularity( 1024 );
+	root = NULL_NODE;
+	freeList = NULL_NODE;
+	numFree = 0;
+	numLeaves = 0;
+}
+
+/*
+================
+idClipTree::Clear
+================
+*/
+void idClipTree::Clear() {
+	nodes.Clear();
+	root = NULL_NODE;
+	freeList = NULL_NODE;
+	numFree = 0;
+	numLeaves = 0;
+}
+
+/*
+================
+idClipTree::AllocNode
+================
+*/
+int idClipTree::AllocNode() {
+	int index;
+	if ( freeList != NULL_NODE ) {
+		index = freeList;
+		freeList = nodes[index].parent;
+		numFree--;
+	} else {
+		index = nodes.Append( node_t() );
+	}
+	node_t &node = nodes[index];
+	node.parent = NULL_NODE;
+	node.children[0] = node.children[1] = NULL_NODE;
+	node.height = 0;
+	node.model = NULL;
+	return index;
+}
+
+/*
+================
+idClipTree::FreeNode
+================
+*/
+void idClipTree::FreeNode( int index ) {
+	node_t &node = nodes[index];
+	node.parent = freeList;
+	node.height = -1;
+	node.model = NULL;
+	freeList = index;
+	numFree++;
+}
+
+/*
+================
+idClipTree::Insert
+================
+*/
+int idClipTree::Insert( idClipModel *model, const idBounds &bounds ) {
+	// models which never move are inserted with tight bounds
+	int leaf = AllocNode();
+	nodes[leaf].bounds = bounds;
+	nodes[leaf].model = model;
+	InsertLeaf( leaf );
+	numLeaves++;
+	return leaf;
+}
+
+/*
+================
+idClipTree::Remove
+================
+*/
+void idClipTree::Remove( int leaf ) {
+	assert( nodes[leaf].height == 0 );
+	RemoveLeaf( leaf );
+	FreeNode( leaf );
+	numLeaves--;
+}
+
+/*
+================
+idClipTree::Move
+================
+*/
+bool idClipTree::Move( int leaf, const idBounds &bounds ) {
+	assert( nodes[leaf].height == 0 );
+	const idBounds &old = nodes[leaf].bounds;
+	if ( BoundsContain( old, bounds ) && BoundsContain( bounds.Expand( CLIP_TREE_MAX_SLACK ), old ) ) {
+		return false;
+	}
+	RemoveLeaf( leaf );
+	nodes[leaf].bounds = bounds.Expand( CLIP_TREE_MARGIN );
+	InsertLeaf( leaf );
+	return true;
+}
+
+/*
+================
+idClipTree::InsertLeaf
+================
+*/
+void idClipTree::InsertLeaf( int leaf ) {
+	if ( root == NULL_NODE ) {
+		root = leaf;
+		nodes[root].parent = NULL_NODE;
+		return;
+	}
+
+	// descend to the sibling which minimizes total area of internal nodes
+	idBounds leafBounds = nodes[leaf].bounds;
+	int index = root;
+	while ( nodes[index].height > 0 ) {
+		const node_t &node = nodes[index];
+		float area = BoundsCost( node.bounds );
+		float combinedArea = BoundsCost( node.bounds + leafBounds );
+
+		// cost of creating a new parent for this node and the new leaf
+		float cost = 2.0f * combinedArea;
+		// minimum cost of pushing the leaf further down the tree
+		float inheritanceCost = 2.0f * ( combinedArea - area );
+
+		float childCost[2];
+		for ( int i = 0; i < 2; i++ ) {
+			const node_t &child = nodes[node.children[i]];
+			childCost[i] = BoundsCost( child.bounds + leafBounds ) + inheritanceCost;
+			if ( child.height > 0 ) {
+				childCost[i] -= BoundsCost( child.bounds );
+			}
+		}
+
+		if ( cost < childCost[0] && cost < childCost[1] ) {
+			break;
+		}
+		index = node.children[ childCost[0] < childCost[1] ? 0 : 1 ];
+	}
+	int sibling = index;
+
+	// create a new parent (note: invalidates references to nodes)
+	int oldParent = nodes[sibling].parent;
+	int newParent = AllocNode();
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].bounds = leafBounds + nodes[sibling].bounds;
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].children[0] = sibling;
+	nodes[newParent].children[1] = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if ( oldParent != NULL_NODE ) {
+		node_t &op = nodes[oldParent];
+		op.children[ op.children[0] == sibling ? 0 : 1 ] = newParent;
+	} else {
+		root = newParent;
+	}
+
+	RefitAncestors( newParent );
+}
+
+/*
+================
+idClipTree::RemoveLeaf
+================
+*/
+void idClipTree::RemoveLeaf( int leaf ) {
+	if ( leaf == root ) {
+		root = NULL_NODE;
+		return;
+	}
+
+	int parent = nodes[leaf].parent;
+	int grandParent = nodes[parent].parent;
+	int sibling = nodes[parent].children[ nodes[parent].children[0] == leaf ? 1 : 0 ];
+
+	if ( grandParent != NULL_NODE ) {
+		// connect sibling to grand parent
+		node_t &gp = nodes[grandParent];
+		gp.children[ gp.children[0] == parent ? 0 : 1 ] = sibling;
+		nodes[sibling].parent = grandParent;
+		FreeNode( parent );
+		RefitAncestors( grandParent );
+	} else {
+		root = sibling;
+		nodes[sibling].parent = NULL_NODE;
+		FreeNode( parent );
+	}
+}
+
+/*
+================
+idClipTree::RefitAncestors
+
+recompute bounds and heights from given internal node up to root
+================
+*/
+void idClipTree::RefitAncestors( int index ) {
+	while ( index != NULL_NODE ) {
+		index = Balance( index );
+
+		node_t &node = nodes[index];
+		const node_t &c0 = nodes[node.children[0]];
+		const node_t &c1 = nodes[node.children[1]];
+		node.height = 1 + idMath::Imax( c0.height, c1.height );
+		node.bounds = c0.bounds + c1.bounds;
+
+		index = node.parent;
+	}
+}
+
+/*
+================
+idClipTree::Balance
+
+performs left or right rotation if node A is imbalanced, returns new root of subtree
+================
+*/
+int idClipTree::Balance( int iA ) {
+	node_t &A = nodes[iA];
+	if ( A.height < 2 ) {
+		return iA;
+	}
+
+	int iB = A.children[0];
+	int iC = A.children[1];
+	node_t &B = nodes[iB];
+	node_t &C = nodes[iC];
+
+	int balance = C.height - B.height;
+	if ( balance >= -1 && balance <= 1 ) {
+		return iA;
+	}
+
+	// the higher child is raised, A becomes its child
+	int iUp = ( balance > 1 ? iC : iB );
+	int upSide = ( balance > 1 ? 1 : 0 );
+	node_t &Up = nodes[iUp];
+	int iF = Up.children[0];
+	int iG = Up.children[1];
+	node_t &F = nodes[iF];
+	node_t &G = nodes[iG];
+
+	Up.children[0] = iA;
+	Up.parent = A.parent;
+	A.parent = iUp;
+
+	if ( Up.parent != NULL_NODE ) {
+		node_t &P = nodes[Up.parent];
+		P.children[ P.children[0] == iA ? 0 : 1 ] = iUp;
+	} else {
+		root = iUp;
+	}
+
+	// the higher grandchild stays under raised node, the lower one replaces it under A
+	int iKeep = iF, iMove = iG;
+	if ( F.height < G.height ) {
+		iKeep = iG;
+		iMove = iF;
+	}
+	Up.children[1] = iKeep;
+	A.children[upSide] = iMove;
+	nodes[iMove].parent = iA;
+
+	const node_t &A0 = nodes[A.children[0]];
+	const node_t &A1 = nodes[A.children[1]];
+	A.bounds = A0.bounds + A1.bounds;
+	A.height = 1 + idMath::Imax( A0.height, A1.height );
+
+	const node_t &K = nodes[iKeep];
+	Up.bounds = A.bounds + K.bounds;
+	Up.height = 1 + idMath::Imax( A.height, K.height );
+
+	return iUp;
+}
+
+/*
+================
+idClipTree::GetModels
+================
+*/
+void idClipTree::GetModels( idList<idClipModel *> &models ) const {
+	for ( int i = 0; i < nodes.Num(); i++ ) {
+		if ( nodes[i].height == 0 ) {
+			models.Append( nodes[i].model );
+		}
+	}
+}
+
+/*
+================
+idClipTree::Validate
+================
+*/
+void idClipTree::Validate() const {
+	if ( root != NULL_NODE ) {
+		Validate_r( root, NULL_NODE );
+	}
+	int n = 0;
+	for ( int i = freeList; i != NULL_NODE; i = nodes[i].parent ) {
+		assert( nodes[i].height == -1 );
+		n++;
+	}
+	assert( n == numFree );
+	int leaves = 0;
+	for ( int i = 0; i < nodes.Num(); i++ ) {
+		leaves += ( nodes[i].height == 0 );
+	}
+	assert( leaves == numLeaves );
+}
+
+/*
+================
+idClipTree::Validate_r
+================
+*/
+void idClipTree::Validate_r( int index, int parent ) const {
+	const node_t &node = nodes[index];
+	assert( node.parent == parent );
+	if ( node.height == 0 ) {
+		assert( node.model != NULL );
+		return;
+	}
+	const node_t &c0 = nodes[node.children[0]];
+	const node_t &c1 = nodes[node.children[1]];
+	assert( node.height == 1 + idMath::Imax( c0.height, c1.height ) );
+	assert( BoundsContain( node.bounds, c0.bounds ) && BoundsContain( node.bounds, c1.bounds ) );
+	Validate_r( node.children[0], index );
+	Validate_r( node.children[1], index );
+}
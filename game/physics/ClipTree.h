@@ -0,0 +1,122 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#ifndef __CLIPTREE_H__
+#define __CLIPTREE_H__
+
+/*
+===============================================================================
+
+	Dynamic AABB tree of clip models
+
+	Alternative broadphase for idClip: a binary tree of bounding boxes with
+	one leaf per clip model, which adapts to the actual distribution of models
+	instead of subdividing world bounds uniformly.
+
+	Leaves are inserted at the place of minimal surface area growth and the
+	tree is kept balanced by rotations. A leaf of a model which has moved gets
+	a margin around its bounds, so further small movements don't touch the tree.
+
+	All nodes are stored in one array and referenced by index.
+
+===============================================================================
+*/
+
+class idClipModel;
+
+class idClipTree {
+public:
+	static const int		NULL_NODE = -1;
+
+							idClipTree();
+
+	void					Clear();
+
+							// returns leaf index
+	int						Insert( idClipModel *model, const idBounds &bounds );
+	void					Remove( int leaf );
+							// returns true if leaf had to be reinserted
+	bool					Move( int leaf, const idBounds &bounds );
+
+							// calls leafFunc( model ) for every leaf reached from root through nodes passing nodeTest( bounds )
+	template<class NodeTest, class LeafFunc>
+	void					Query( const NodeTest &nodeTest, const LeafFunc &leafFunc ) const;
+
+	void					GetModels( idList<idClipModel *> &models ) const;
+	int						GetNumLeaves() const { return numLeaves; }
+	int						GetNumNodes() const { return nodes.Num() - numFree; }
+	int						GetHeight() const { return ( root == NULL_NODE ? 0 : nodes[root].height ); }
+	size_t					Allocated() const { return nodes.Allocated(); }
+
+							// check internal consistency (debug only)
+	void					Validate() const;
+
+private:
+	static const int		MAX_STACK = 256;
+
+	struct node_t {
+		idBounds			bounds;			// bounds of leaf are enlarged with margin
+		int					parent;			// next free node if node is free
+		int					children[2];
+		int					height;			// 0 for leaves, -1 for free nodes
+		idClipModel *		model;
+	};
+
+	idList<node_t>			nodes;
+	int						root;
+	int						freeList;
+	int						numFree;
+	int						numLeaves;
+
+	int						AllocNode();
+	void					FreeNode( int index );
+	void					InsertLeaf( int leaf );
+	void					RemoveLeaf( int leaf );
+	int						Balance( int index );
+	void					RefitAncestors( int index );
+	void					Validate_r( int index, int parent ) const;
+};
+
+/*
+================
+idClipTree::Query
+================
+*/
+template<class NodeTest, class LeafFunc>
+ID_INLINE void idClipTree::Query( const NodeTest &nodeTest, const LeafFunc &leafFunc ) const {
+	if ( root == NULL_NODE ) {
+		return;
+	}
+
+	int stack[MAX_STACK];
+	int top = 0;
+	stack[top++] = root;
+
+	while ( top > 0 ) {
+		const node_t &node = nodes[stack[--top]];
+		if ( !nodeTest( node.bounds ) ) {
+			continue;
+		}
+		if ( node.height == 0 ) {
+			leafFunc( node.model );
+		} else {
+			assert( top + 2 <= MAX_STACK );
+			stack[top++] = node.children[1];
+			stack[top++] = node.children[0];
+		}
+	}
+}
+
+#endif /* !__CLIPTREE_H__ */
@@ -60,10 +60,30 @@ static const float MAX_GRABBER_EXT_ANGVEL		= 5.0f;
 
 #define AF_TIMINGS
 
+// cost of AF physics over a number of frames (see testAFStress)
+typedef struct afSolveStats_s {
+	int						measureFrames;				// number of frames to measure, zero if not measuring
+	int						numFrames;
+	int						numFigures;					// active figures passed to PresolveFigures
+	int						numPresolved;				// figures solved before their entities think
+	int						numEvaluated;				// figures simulated by Evaluate
+	int						numIslandsSlept;
+	int						numFiguresSlept;
+	uint64					presolveTime;				// microseconds in PresolveFigures
+	uint64					solveTime;					// microseconds in its parallel part
+	uint64					evaluateTime;				// microseconds in Evaluate
+} afSolveStats_t;
+
+static afSolveStats_t afStats;
+
+// figures which need more stack are solved on main thread
+static const int PRESOLVE_MAX_STACK_SIZE = 1 << 20;
+
 #ifdef AF_TIMINGS
 static int lastTimerReset = 0;
 static int numArticulatedFigures = 0;
-static idTimer timer_total, timer_pc, timer_ac, timer_collision, timer_lcp;
+// figures are also solved on worker threads (see PresolveFigures)
+static thread_local idTimer timer_total, timer_pc, timer_ac, timer_collision, timer_lcp;
 #endif
 
 
@@ -6344,6 +6364,8 @@ void idPhysics_AF::Activate( void ) {
 	}
 	current.atRest = -1;
 	current.noMoveTime = 0.0f;
+	sleepTime = 0.0f;
+	sleepReady = false;
 	self->BecomeActive( TH_PHYSICS );
 }
 
@@ -6560,13 +6582,12 @@ const idBounds &idPhysics_AF::GetAbsBounds( int id ) const {
 
 /*
 ================
-idPhysics_AF::Evaluate
+idPhysics_AF::BeginEvaluate
+
+  returns false if the simulation is suspended
 ================
 */
-bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) 
-{
-	float timeStep;
-
+bool idPhysics_AF::BeginEvaluate( int timeStepMSec, int endTimeMSec, float &timeStep ) {
 	if ( timeScaleRampStart < MS2SEC( endTimeMSec ) && timeScaleRampEnd > MS2SEC( endTimeMSec ) ) {
 		timeStep = MS2SEC( timeStepMSec ) * ( MS2SEC( endTimeMSec ) - timeScaleRampStart ) / ( timeScaleRampEnd - timeScaleRampStart );
 	} else if ( af_timeScale.GetFloat() != 1.0f ) {
@@ -6598,12 +6619,88 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 
 	// if the simulation is suspended because the figure is at rest
 	if ( current.atRest >= 0 || timeStep <= 0.0f ) {
-		DebugDraw();
 		return false;
 	}
 
-	// move the af velocity into the frame of a pusher
-	AddPushVelocity( -current.pushVelocity );
+	return true;
+}
+
+/*
+================
+idPhysics_AF::SetupConstraints
+================
+*/
+void idPhysics_AF::SetupConstraints( float timeStep, int endTimeMSec ) {
+	// evaluate constraint equations
+	EvaluateConstraints( timeStep );
+
+	// apply friction
+	ApplyFriction( timeStep, endTimeMSec );
+
+	// add frame constraints
+	AddFrameConstraints();
+}
+
+/*
+================
+idPhysics_AF::SolveConstraints
+
+  Touches nothing but the figure itself,
+  so different figures can be solved in parallel (see PresolveFigures)
+================
+*/
+void idPhysics_AF::SolveConstraints( float timeStep ) {
+#ifdef AF_TIMINGS
+	timer_pc.Start();
+#endif
+
+	// factor matrices for primary constraints
+	PrimaryFactor();
+
+	// calculate forces on bodies after applying primary constraints
+	PrimaryForces( timeStep );
+
+#ifdef AF_TIMINGS
+	timer_pc.Stop();
+	timer_ac.Start();
+#endif
+
+	// calculate and apply auxiliary constraint forces
+	AuxiliaryForces( timeStep );
+
+#ifdef AF_TIMINGS
+	timer_ac.Stop();
+#endif
+
+	// evolve current state to next state
+	Evolve( timeStep );
+}
+
+/*
+================
+idPhysics_AF::Evaluate
+================
+*/
+bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec ) 
+{
+	float timeStep;
+	uint64 startTime = ( afStats.measureFrames > 0 ? Sys_GetTimeMicroseconds() : 0 );
+
+	// constraint forces may be already solved in parallel before entities think
+	bool presolved = TakePresolve( timeStepMSec, endTimeMSec );
+
+	if ( presolved ) {
+		timeStep = current.lastTimeStep;
+	}
+	else {
+		if ( !BeginEvaluate( timeStepMSec, endTimeMSec, timeStep ) ) {
+			DebugDraw();
+			return false;
+		}
+
+		// move the af velocity into the frame of a pusher
+		AddPushVelocity( -current.pushVelocity );
+	}
 
 	// TDM: Enable the clipmodels of all team members for collisions
 	idEntity *part = NULL;
@@ -6630,59 +6727,39 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 #endif
 
 #ifdef AF_TIMINGS
-	timer_collision.Start();
+	int i, numPrimary = 0, numAuxiliary = 0;
 #endif
 
-	// evaluate contacts
-	EvaluateContacts();
-
-	// setup contact constraints
-	SetupContactConstraints();
-
+	if ( !presolved ) {
 #ifdef AF_TIMINGS
-	timer_collision.Stop();
+		timer_collision.Start();
 #endif
 
-	// evaluate constraint equations
-	EvaluateConstraints( timeStep );
+		// evaluate contacts
+		EvaluateContacts();
 
-	// apply friction
-	ApplyFriction( timeStep, endTimeMSec );
-
-	// add frame constraints
-	AddFrameConstraints();
+		// setup contact constraints
+		SetupContactConstraints();
 
 #ifdef AF_TIMINGS
-	int i, numPrimary = 0, numAuxiliary = 0;
-	for ( i = 0; i < primaryConstraints.Num(); i++ ) {
-		numPrimary += primaryConstraints[i]->J1.GetNumRows();
-	}
-	for ( i = 0; i < auxiliaryConstraints.Num(); i++ ) {
-		numAuxiliary += auxiliaryConstraints[i]->J1.GetNumRows();
-	}
-	timer_pc.Start();
+		timer_collision.Stop();
 #endif
 
-	// factor matrices for primary constraints
-	PrimaryFactor();
-
-	// calculate forces on bodies after applying primary constraints
-	PrimaryForces( timeStep );
+		// evaluate constraints, apply friction, add frame constraints
+		SetupConstraints( timeStep, endTimeMSec );
 
 #ifdef AF_TIMINGS
-	timer_pc.Stop();
-	timer_ac.Start();
-#endif
-
-	// calculate and apply auxiliary constraint forces
-	AuxiliaryForces( timeStep );
-
-#ifdef AF_TIMINGS
-	timer_ac.Stop();
+		for ( i = 0; i < primaryConstraints.Num(); i++ ) {
+			numPrimary += primaryConstraints[i]->J1.GetNumRows();
+		}
+		for ( i = 0; i < auxiliaryConstraints.Num(); i++ ) {
+			numAuxiliary += auxiliaryConstraints[i]->J1.GetNumRows();
+		}
 #endif
 
-	// evolve current state to next state
-	Evolve( timeStep );
+		// calculate constraint forces and evolve current state to next state
+		SolveConstraints( timeStep );
+	}
 
 	// debug graphics
 	DebugDraw();
@@ -6722,9 +6799,16 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 	}
 
 	// test if the simulation can be suspended because the whole figure is at rest
-	if ( comeToRest && TestIfAtRest( timeStep ) ) {
+	bool canRest = comeToRest && TestIfAtRest( timeStep );
+
+	// figures touching each other are put to rest together by PresolveFigures,
+	// so that a figure which is almost still does not keep waking up its neighbors
+	sleepReady = comeToRest && islandSize > 1 && ( canRest || TestIfSleepy( timeStep ) );
+	islandSize = 0;
+
+	if ( canRest && !sleepReady ) {
 		Rest();
-	} else {
+	} else if ( !sleepReady ) {
 		ActivateContactEntities();
 	}
 
@@ -6793,9 +6877,295 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 		}
 	}
 
+	if ( afStats.measureFrames > 0 ) {
+		afStats.evaluateTime += Sys_GetTimeMicroseconds() - startTime;
+		afStats.numEvaluated++;
+	}
+
 	return true;
 }
 
+/*
+================
+idPhysics_AF::CanPresolve
+================
+*/
+bool idPhysics_AF::CanPresolve( void ) const {
+	// bound figures follow the master, which only moves when its entity thinks
+	return bodies.Num() > 0 && masterBody == NULL && current.pushVelocity == vec6_origin;
+}
+
+/*
+================
+idPhysics_AF::SolveStackSize
+
+  upper estimate of stack memory used by SolveConstraints
+================
+*/
+int idPhysics_AF::SolveStackSize( void ) const {
+	int i, numRows, paddedRows;
+
+	for ( numRows = 0, i = 0; i < auxiliaryConstraints.Num(); i++ ) {
+		numRows += auxiliaryConstraints[i]->J1.GetNumRows();
+	}
+	paddedRows = ( numRows + 3 ) & ~3;
+
+	// body responses in AuxiliaryForces, constraint matrix and its clamped copy in LCP, vectors
+	return	bodies.Num() * numRows * 9 * sizeof( float ) +
+			2 * numRows * paddedRows * sizeof( float ) +
+			16 * paddedRows * sizeof( float ) + 4096;
+}
+
+/*
+================
+idPhysics_AF::TakePresolve
+
+  returns true if constraint forces for this simulation step were solved by PresolveFigures
+================
+*/
+bool idPhysics_AF::TakePresolve( int timeStepMSec, int endTimeMSec ) {
+	int i;
+
+	if ( presolveEndTime < 0 ) {
+		return false;
+	}
+	bool sameStep = ( presolveEndTime == endTimeMSec && presolveTimeStep == timeStepMSec );
+	presolveEndTime = -1;
+
+	if ( !sameStep || current.atRest >= 0 || !CanPresolve() ) {
+		return false;
+	}
+	if ( changedAF || linearTime != af_useLinearTime.GetBool() || presolveStates.Num() != bodies.Num() ) {
+		return false;
+	}
+	// if something pushed or moved the figure after it was solved, solve it again
+	for ( i = 0; i < bodies.Num(); i++ ) {
+		if ( memcmp( bodies[i]->current, &presolveStates[i], sizeof( AFBodyPState_t ) ) != 0 ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+================
+idPhysics_AF::TestIfSleepy
+
+  cheap rest test for figures lying on each other:
+  contacts with neighbors cause too much jitter in acceleration for TestIfAtRest
+================
+*/
+bool idPhysics_AF::TestIfSleepy( float timeStep ) {
+	int i;
+
+#ifdef MOD_WATERPHYSICS
+	if ( water != NULL ) {
+		sleepTime = 0.0f;
+		return false;
+	}
+#endif
+
+	// activateTime is updated by TestIfAtRest
+	if ( minMoveTime > 0.0f && current.activateTime < minMoveTime ) {
+		sleepTime = 0.0f;
+		return false;
+	}
+
+	for ( i = 0; i < bodies.Num(); i++ ) {
+		const idVec6 &velocity = bodies[i]->current->spatialVelocity;
+		if ( velocity.SubVec3(0).LengthSqr() > Square( suspendVelocity[0] ) || velocity.SubVec3(1).LengthSqr() > Square( suspendVelocity[1] ) ) {
+			sleepTime = 0.0f;
+			return false;
+		}
+	}
+
+	sleepTime += timeStep;
+	return sleepTime >= af_sleepTime.GetFloat();
+}
+
+/*
+================
+idPhysics_AF::PresolveFigures
+
+  Called every frame before entities think, with all active figures which are not part of a team.
+  First the figures touching each other (islands) are put to rest together when all of them are almost still.
+  Then contacts and constraints of the other figures are set up serially, and their constraint forces
+  are solved in parallel. The results are committed serially when entities think and call Evaluate.
+================
+*/
+void idPhysics_AF::PresolveFigures( const idList<idPhysics_AF *> &figures, const idList<int> &timeSteps, int endTimeMSec ) {
+	int i, j;
+
+	if ( afStats.measureFrames > 0 && afStats.numFrames >= afStats.measureFrames ) {
+		PrintStatistics();
+		afStats.measureFrames = 0;
+	}
+	bool measure = ( afStats.measureFrames > 0 );
+	uint64 startTime = Sys_GetTimeMicroseconds();
+
+	for ( i = 0; i < figures.Num(); i++ ) {
+		figures[i]->islandIndex = i;
+	}
+
+	if ( af_islandSleep.GetBool() ) {
+		idList<int> parent, islandSizes;
+		idList<bool> touchesMoving, islandAwake;
+		parent.SetNum( figures.Num() );
+		islandSizes.SetNum( figures.Num() );
+		touchesMoving.SetNum( figures.Num() );
+		islandAwake.SetNum( figures.Num() );
+		for ( i = 0; i < figures.Num(); i++ ) {
+			parent[i] = i;
+			islandSizes[i] = 0;
+			touchesMoving[i] = false;
+			islandAwake[i] = false;
+		}
+		auto FindRoot = [&parent]( int x ) {
+			while ( parent[x] != x ) {
+				x = parent[x] = parent[parent[x]];
+			}
+			return x;
+		};
+
+		// join figures which were touching each other during the last frame
+		for ( i = 0; i < figures.Num(); i++ ) {
+			const idPhysics_AF *af = figures[i];
+			for ( j = 0; j < af->contacts.Num(); j++ ) {
+				idEntity *ent = gameLocal.entities[ af->contacts[j].entityNum ];
+				if ( !ent || ent == af->self ) {
+					continue;
+				}
+				idPhysics *phys = ent->GetPhysics();
+				if ( phys->IsType( idPhysics_AF::Type ) && static_cast<idPhysics_AF *>( phys )->islandIndex >= 0 ) {
+					parent[ FindRoot( i ) ] = FindRoot( static_cast<idPhysics_AF *>( phys )->islandIndex );
+				}
+				else if ( !phys->IsAtRest() ) {
+					// something moving keeps the whole island awake
+					touchesMoving[i] = true;
+				}
+			}
+		}
+		for ( i = 0; i < figures.Num(); i++ ) {
+			int root = FindRoot( i );
+			islandSizes[root]++;
+			if ( !figures[i]->sleepReady || touchesMoving[i] ) {
+				islandAwake[root] = true;
+			}
+		}
+
+		// put islands to rest when all their figures are ready for it
+		for ( i = 0; i < figures.Num(); i++ ) {
+			int root = FindRoot( i );
+			figures[i]->islandSize = islandSizes[root];
+			if ( islandSizes[root] > 1 && !islandAwake[root] ) {
+				figures[i]->Rest();
+				if ( measure ) {
+					afStats.numFiguresSlept++;
+					afStats.numIslandsSlept += ( root == i );
+				}
+			}
+		}
+	}
+
+	bool parallel = (
+		af_parallelSolve.GetBool() && taskScheduler->GetNumWorkers() > 0 &&
+		// impulse friction changes the current state, so it cannot be solved again if necessary
+		!af_useImpulseFriction.GetBool() && !af_useJointImpulseFriction.GetBool() &&
+		!af_showTimings.GetBool()
+	);
+
+	// set up contacts and constraints serially
+	idList<idPhysics_AF *> solved;
+	for ( i = 0; i < figures.Num(); i++ ) {
+		idPhysics_AF *af = figures[i];
+		float timeStep;
+
+		af->presolveEndTime = -1;
+		if ( !parallel || af->current.atRest >= 0 || !af->CanPresolve() ) {
+			continue;
+		}
+		if ( !af->BeginEvaluate( timeSteps[i], endTimeMSec, timeStep ) ) {
+			continue;
+		}
+
+		// same as idEntity::RunPhysics does around Evaluate
+		if ( !af->self->fl.solidForTeam ) {
+			af->DisableClip();
+		}
+		af->EvaluateContacts();
+		af->SetupContactConstraints();
+		af->EnableClip();
+
+		af->SetupConstraints( timeStep, endTimeMSec );
+
+		if ( af->SolveStackSize() > PRESOLVE_MAX_STACK_SIZE ) {
+			af->SolveConstraints( timeStep );
+		} else {
+			solved.Append( af );
+		}
+		af->presolveTimeStep = timeSteps[i];
+		af->presolveEndTime = endTimeMSec;
+	}
+
+	// solve constraint forces in parallel
+	uint64 solveStartTime = Sys_GetTimeMicroseconds();
+	taskScheduler->ParallelFor( 0, solved.Num(), [&solved]( int begin, int end ) {
+		for ( int k = begin; k < end; k++ ) {
+			solved[k]->SolveConstraints( solved[k]->current.lastTimeStep );
+		}
+	}, 1 );
+	uint64 solveTime = Sys_GetTimeMicroseconds() - solveStartTime;
+
+	for ( i = 0; i < figures.Num(); i++ ) {
+		idPhysics_AF *af = figures[i];
+		af->islandIndex = -1;
+		if ( af->presolveEndTime < 0 ) {
+			continue;
+		}
+		af->RemoveFrameConstraints();
+		af->presolveStates.SetNum( af->bodies.Num(), false );
+		for ( j = 0; j < af->bodies.Num(); j++ ) {
+			af->presolveStates[j] = *af->bodies[j]->current;
+		}
+		if ( measure ) {
+			afStats.numPresolved++;
+		}
+	}
+
+	if ( measure ) {
+		afStats.numFrames++;
+		afStats.numFigures += figures.Num();
+		afStats.solveTime += solveTime;
+		afStats.presolveTime += Sys_GetTimeMicroseconds() - startTime;
+	}
+}
+
+/*
+================
+idPhysics_AF::StartStatistics
+================
+*/
+void idPhysics_AF::StartStatistics( int numFrames ) {
+	memset( &afStats, 0, sizeof( afStats ) );
+	afStats.measureFrames = numFrames;
+}
+
+/*
+================
+idPhysics_AF::PrintStatistics
+================
+*/
+void idPhysics_AF::PrintStatistics( void ) {
+	int frames = idMath::Imax( afStats.numFrames, 1 );
+
+	gameLocal.Printf( "Articulated figures over %d frames: %.1f active per frame\n", afStats.numFrames, float( afStats.numFigures ) / frames );
+	gameLocal.Printf( "  presolve: %.3f ms per frame (parallel solve %.3f ms), %d figures solved in advance\n",
+		afStats.presolveTime * 0.001 / frames, afStats.solveTime * 0.001 / frames, afStats.numPresolved );
+	gameLocal.Printf( "  evaluate: %.3f ms per frame, %d figures evaluated\n", afStats.evaluateTime * 0.001 / frames, afStats.numEvaluated );
+	gameLocal.Printf( "  total:    %.3f ms per frame\n", ( afStats.presolveTime + afStats.evaluateTime ) * 0.001 / frames );
+	gameLocal.Printf( "  %d islands with %d figures put to rest together\n", afStats.numIslandsSlept, afStats.numFiguresSlept );
+}
+
 /*
 ================
 idPhysics_AF::UpdateTime
@@ -6994,6 +7364,13 @@ idPhysics_AF::idPhysics_AF( void ) {
 	changedAF = true;
 	masterBody = NULL;
 
+	presolveTimeStep = 0;
+	presolveEndTime = -1;
+	islandIndex = -1;
+	islandSize = 0;
+	sleepTime = 0.0f;
+	sleepReady = false;
+
 	lcp = idLCP::AllocSymmetric();
 
 	memset( &current, 0, sizeof( current ) );
@@ -1006,6 +1006,17 @@ public:	// common physics interface
 	int						GetNumOrigConstraints( void ) { return m_NumOrigConstraints; };
 	void					SetNumOrigConstraints( int num ) { m_NumOrigConstraints = num; };
 
+	/**
+	* Solve active figures before their entities think:
+	* put islands of figures touching each other to rest, then solve constraint forces in parallel.
+	* timeSteps are the simulation steps which entities will pass to Evaluate during this frame.
+	**/
+	static void				PresolveFigures( const idList<idPhysics_AF *> &figures, const idList<int> &timeSteps, int endTimeMSec );
+	/**
+	* Measure the cost of AF physics over the given number of frames and print it afterwards
+	**/
+	static void				StartStatistics( int numFrames );
+
 private:
 							// articulated figure
 	idList<idAFTree *>		trees;							// tree structures
@@ -1085,6 +1096,16 @@ private:
 	idAFBody *				masterBody;						// master body
 	idLCP *					lcp;							// linear complementarity problem solver
 
+							// solved in advance by PresolveFigures
+	int						presolveTimeStep;
+	int						presolveEndTime;				// -1 if nothing was solved in advance
+	idList<AFBodyPState_t>	presolveStates;					// body states after solving, solve again if they change
+							// islands of figures touching each other
+	int						islandIndex;					// index in the list during PresolveFigures, -1 otherwise
+	int						islandSize;						// number of active figures in the island during this frame
+	float					sleepTime;						// time the figure is almost still
+	bool					sleepReady;						// figure could rest together with its island
+
 private:
 	bool					IsClosedLoop( const idAFBody *body1, const idAFBody *body2 ) const;
 	void					PrimaryFactor( void );
@@ -1099,6 +1120,13 @@ private:
 	void					SetupContactConstraints( void );
 	void					ApplyContactForces( void );
 	void					Evolve( float timeStep );
+	bool					BeginEvaluate( int timeStepMSec, int endTimeMSec, float &timeStep );
+	void					SetupConstraints( float timeStep, int endTimeMSec );
+	void					SolveConstraints( float timeStep );
+	bool					CanPresolve( void ) const;
+	int						SolveStackSize( void ) const;
+	bool					TakePresolve( int timeStepMSec, int endTimeMSec );
+	static void				PrintStatistics( void );
 	idEntity *				SetupCollisionForBody( idAFBody *body ) const;
 	bool					CollisionImpulse( float timeStep, idAFBody *body, trace_t &collision );
 	bool					ApplyCollisions( float timeStep );
@@ -1107,6 +1135,7 @@ private:
 	void					AddGravity( void );
 	void					SwapStates( void );
 	bool					TestIfAtRest( float timeStep );
+	bool					TestIfSleepy( float timeStep );
 	void					Rest( void );
 	void					AddPushVelocity( const idVec6 &pushVelocity );
 	void					DebugDraw( void );
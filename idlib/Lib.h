@@ -270,5 +270,6 @@ template<class T> struct idRaw {
 #include "Thread.h"
 #include "RevisionTracker.h"
 #include "ParallelJobList.h"
+#include "TaskScheduler.h"
 
 #endif	/* !__LIB_H__ */
@@ -209,6 +209,8 @@ private:
 	idSysInterlockedInteger doneGuards[NUM_DONE_GUARDS];
 	int						currentDoneGuard;
 	idSysInterlockedInteger	version;
+	bool					usingTasks;			// submitted to task scheduler instead of job threads
+	idTaskGroup				taskGroup;
 	struct job_t {
 		jobRun_t	function;
 		void *		data;
@@ -226,6 +228,7 @@ private:
 	int						RunJobsInternal( unsigned int threadNum, threadJobListState_t & state, bool singleJob );
 
 	static void				Nop( void * data ) {}
+	static void				RunTask( void * data );
 
 	static int				JOB_SIGNAL;
 	static int				JOB_SYNCHRONIZE;
@@ -251,6 +254,7 @@ idParallelJobList_Threads::idParallelJobList_Threads( jobListId_t id, jobListPri
 	lastSignalJob( 0 ),
 	waitForGuard( NULL ),
 	currentDoneGuard( 0 ),
+	usingTasks( false ),
 	jobList() {
 
 	assert( listPriority != JOBLIST_PRIORITY_NONE );
@@ -275,6 +279,7 @@ idParallelJobList_Threads::~idParallelJobList_Threads() {
 	Wait();
 }
 
+static idCVar jobs_useTaskScheduler( "jobs_useTaskScheduler", "1", CVAR_BOOL | CVAR_NOCHEAT, "run simple job lists (without sync points) as tasks of work-stealing scheduler" );
 static idCVarBool jobs_debugCheck( "jobs_debugCheck", "0", CVAR_TOOL, "check job data integrity" );
 
 /*
@@ -394,6 +399,26 @@ void idParallelJobList_Threads::Submit( idParallelJobList_Threads * waitForJobLi
 		return;
 	}
 
+	if ( waitForJobList != NULL && waitForJobList->usingTasks ) {
+		// task-based lists have no done guards: finish it right here
+		waitForJobList->taskGroup.Wait();
+		waitForJobList = NULL;
+	}
+
+	usingTasks = (
+		threaded && jobs_useTaskScheduler.GetBool() && taskScheduler->GetNumWorkers() > 0 &&
+		numSyncs == 0 && !hasSignal && waitForJobList == NULL &&
+		parallelism == JOBLIST_PARALLELISM_DEFAULT
+	);
+	if ( usingTasks ) {
+		// thin layer over task scheduler: every job becomes a task
+		deferredThreadStats.startTime = deferredThreadStats.submitTime;
+		for ( int i = 0; i < jobList.Num(); i++ ) {
+			taskGroup.Run( RunTask, &jobList[i] );
+		}
+		return;
+	}
+
 	if ( waitForJobList != NULL ) {
 		waitForGuard = & waitForJobList->doneGuards[waitForJobList->currentDoneGuard];
 	} else {
@@ -427,7 +452,17 @@ idParallelJobList_Threads::Wait
 ========================
 */
 void idParallelJobList_Threads::Wait() {
-	if ( jobList.Num() > 0 ) {
+	if ( usingTasks ) {
+		uint64 waitStart = Sys_Microseconds();
+		bool waited = !taskGroup.IsDone();
+		// executes pending tasks instead of spinning
+		taskGroup.Wait();
+		jobList.SetNum( 0 );
+		usingTasks = false;
+		uint64 waitEnd = Sys_Microseconds();
+		deferredThreadStats.waitTime = waited ? ( waitEnd - waitStart ) : 0;
+		deferredThreadStats.endTime = waitEnd;
+	} else if ( jobList.Num() > 0 ) {
 		// don't lock up but return if the job list was never properly submitted
 		if ( !verify( !done && signalJobCount.Num() > 0 ) ) {
 			return;
@@ -464,6 +499,13 @@ idParallelJobList_Threads::TryWait
 ========================
 */
 bool idParallelJobList_Threads::TryWait() {
+	if ( usingTasks ) {
+		if ( taskGroup.IsDone() ) {
+			Wait();
+			return true;
+		}
+		return false;
+	}
 	if ( jobList.Num() == 0 || signalJobCount[signalJobCount.Num() - 1].GetValue() <= 0 ) {
 		Wait();
 		return true;
@@ -471,6 +513,17 @@ bool idParallelJobList_Threads::TryWait() {
 	return false;
 }
 
+/*
+========================
+idParallelJobList_Threads::RunTask
+========================
+*/
+void idParallelJobList_Threads::RunTask( void * data ) {
+	job_t * job = (job_t *)data;
+	job->function( job->data );
+	job->executed = 1;
+}
+
 /*
 ========================
 idParallelJobList_Threads::IsSubmitted
@@ -1160,6 +1213,10 @@ void idParallelJobManagerLocal::RescaleThreadList() {
 		int idx = --currentActiveThreads;
 		threads[idx].StopThread( false );
 	}
+
+	// simple job lists run as tasks (see jobs_useTaskScheduler), job threads only get lists with sync points,
+	// so jobs_numThreads is the number of task workers too, and zero disables parallel tasks as well
+	taskScheduler->SetNumWorkers( maxThreads );
 }
 
 /*
@@ -1169,9 +1226,9 @@ idParallelJobManagerLocal::Init
 */
 void idParallelJobManagerLocal::Init() {
 	currentActiveThreads = 0;
-	RescaleThreadList();
 	Sys_CPUCount( numPhysicalCpuCores, numLogicalCpuCores, numCpuPackages );
 	assert(numLogicalCpuCores >= 0);
+	RescaleThreadList();
 }
 
 /*
@@ -1184,6 +1241,7 @@ void idParallelJobManagerLocal::Shutdown() {
 		threads[i].StopThread();
 	}
 	currentActiveThreads = 0;
+	taskScheduler->Shutdown();
 }
 
 /*
@@ -338,6 +338,13 @@ void idParser::Error( const char *str, ... ) const {
 	if ( idParser::scriptstack ) {
 		idParser::scriptstack->Error( text );
 	}
+	else if ( idParser::precompiledTokens && !( idParser::flags & LEXFL_NOERRORS ) ) {
+		if ( idParser::flags & LEXFL_NOFATALERRORS ) {
+			idLib::common->Warning( "file %s, line %d: %s", idParser::filename.c_str(), idParser::precompiledLine, text );
+		} else {
+			idLib::common->Error( "file %s, line %d: %s", idParser::filename.c_str(), idParser::precompiledLine, text );
+		}
+	}
 }
 
 /*
@@ -355,6 +362,9 @@ void idParser::Warning( const char *str, ... ) const {
 	if ( idParser::scriptstack ) {
 		idParser::scriptstack->Warning( text );
 	}
+	else if ( idParser::precompiledTokens && !( idParser::flags & LEXFL_NOWARNINGS ) ) {
+		idLib::common->Warning( "file %s, line %d: %s", idParser::filename.c_str(), idParser::precompiledLine, text );
+	}
 }
 
 /*
@@ -487,6 +497,31 @@ int idParser::UnreadSourceToken( idToken *token ) {
 	return true;
 }
 
+/*
+================
+idParser::ReadPrecompiledToken
+================
+*/
+int idParser::ReadPrecompiledToken( idToken *token ) {
+	idToken *t;
+
+	if ( idParser::tokens ) {
+		// tokens pushed back with UnreadToken come first
+		*token = idParser::tokens;
+		t = idParser::tokens;
+		idParser::tokens = idParser::tokens->next;
+		delete t;
+	}
+	else if ( idParser::precompiledIndex < idParser::precompiledTokens->Num() ) {
+		*token = (*idParser::precompiledTokens)[idParser::precompiledIndex++];
+	}
+	else {
+		return false;
+	}
+	idParser::precompiledLine = token->line;
+	return true;
+}
+
 /*
 ================
 idParser::ReadDefineParms
@@ -1028,6 +1063,7 @@ int idParser::Directive_include( void ) {
 	}
 	script->SetFlags( idParser::flags );
 	script->SetPunctuations( idParser::punctuations );
+	idParser::includedFiles.AddUnique( script->GetFileName() );
 	idParser::PushScript( script );
 	return true;
 }
@@ -2362,6 +2398,11 @@ idParser::ReadToken
 int idParser::ReadToken( idToken *token ) {
 	define_t *define;
 
+	if ( idParser::precompiledTokens ) {
+		// already preprocessed: directives and defines were expanded when the tokens were recorded
+		return idParser::ReadPrecompiledToken( token );
+	}
+
 	while(1) {
 		if ( !idParser::ReadSourceToken( token ) ) {
 			return false;
@@ -3100,6 +3141,28 @@ int idParser::LoadMemory(const char *ptr, int length, const char *name ) {
 	return true;
 }
 
+/*
+================
+idParser::LoadPrecompiledTokens
+================
+*/
+int idParser::LoadPrecompiledTokens( const idList<idToken> &tokenList, const char *name ) {
+	if ( idParser::loaded ) {
+		idLib::common->FatalError("idParser::LoadPrecompiledTokens: another source already loaded");
+		return false;
+	}
+	idParser::filename = name;
+	idParser::scriptstack = NULL;
+	idParser::tokens = NULL;
+	idParser::indentstack = NULL;
+	idParser::skip = 0;
+	idParser::precompiledTokens = &tokenList;
+	idParser::precompiledIndex = 0;
+	idParser::precompiledLine = 0;
+	idParser::loaded = true;
+	return true;
+}
+
 /*
 ================
 idParser::FreeSource
@@ -3146,6 +3209,9 @@ void idParser::FreeSource( bool keepDefines ) {
 			definehash = NULL;
 		}
 	}
+	precompiledTokens = NULL;
+	precompiledIndex = 0;
+	includedFiles.Clear();
 	loaded = false;
 }
 
@@ -3207,6 +3273,9 @@ idParser::idParser() {
 	this->defines = NULL;
 	this->tokens = NULL;
 	this->marker_p = NULL;
+	this->precompiledTokens = NULL;
+	this->precompiledIndex = 0;
+	this->precompiledLine = 0;
 }
 
 /*
@@ -3225,6 +3294,9 @@ idParser::idParser( int flags ) {
 	this->defines = NULL;
 	this->tokens = NULL;
 	this->marker_p = NULL;
+	this->precompiledTokens = NULL;
+	this->precompiledIndex = 0;
+	this->precompiledLine = 0;
 }
 
 /*
@@ -3243,6 +3315,9 @@ idParser::idParser( const char *filename, int flags, bool OSPath ) {
 	this->defines = NULL;
 	this->tokens = NULL;
 	this->marker_p = NULL;
+	this->precompiledTokens = NULL;
+	this->precompiledIndex = 0;
+	this->precompiledLine = 0;
 	LoadFile( filename, OSPath );
 }
 
@@ -3262,6 +3337,9 @@ idParser::idParser( const char *ptr, int length, const char *name, int flags ) {
 	this->defines = NULL;
 	this->tokens = NULL;
 	this->marker_p = NULL;
+	this->precompiledTokens = NULL;
+	this->precompiledIndex = 0;
+	this->precompiledLine = 0;
 	LoadMemory( ptr, length, name );
 }
 
@@ -75,6 +75,8 @@ public:
 					// load a source from the given memory with the given length
 					// NOTE: the ptr is expected to point at a valid C string: ptr[length] == '\0'
 	int				LoadMemory( const char *ptr, int length, const char *name );
+					// replay already preprocessed tokens (e.g. from a compiled cache), no further preprocessing is done
+	int				LoadPrecompiledTokens( const idList<idToken> &tokenList, const char *name );
 					// free the current source
 	void			FreeSource( bool keepDefines = false );
 					// returns true if a source is loaded
@@ -170,6 +172,8 @@ public:
 					// stgatilov: returns string representation of macro value
 					// it is just concatenation of all replacement tokens (useful for constants)
 	idStr			GetDefineValueString(const char *name);
+					// names of all files pulled in with #include so far
+	const idList<idStr> &GetIncludedFiles() const { return includedFiles; }
 
 private:
 	int				loaded;						// set when a source file is loaded from file or memory
@@ -185,6 +189,10 @@ private:
 	indent_t *		indentstack;				// stack with indents
 	int				skip;						// > 0 if skipping conditional code
 	const char*		marker_p;
+	const idList<idToken> *precompiledTokens;	// tokens replayed by LoadPrecompiledTokens
+	int				precompiledIndex;			// next token to replay
+	int				precompiledLine;			// line of the last replayed token
+	idList<idStr>	includedFiles;				// files loaded with #include
 
 	static define_t *globaldefines;				// list with global defines added to every source loaded
 
@@ -193,6 +201,7 @@ private:
 	void			PopIndent( int *type, int *skip );
 	void			PushScript( idLexer *script );
 	int				ReadSourceToken( idToken *token );
+	int				ReadPrecompiledToken( idToken *token );
 	int				ReadLine( idToken *token );
 	int				UnreadSourceToken( idToken *token );
 	int				ReadDefineParms( define_t *define, idToken **parms, int maxparms );
@@ -238,6 +247,9 @@ private:
 };
 
 ID_INLINE const char *idParser::GetFileName( void ) const {
+	if ( idParser::precompiledTokens ) {
+		return idParser::filename.c_str();
+	}
 	if ( idParser::scriptstack ) {
 		return idParser::scriptstack->GetFileName();
 	}
@@ -265,6 +277,9 @@ ID_INLINE const ID_TIME_T idParser::GetFileTime( void ) const {
 }
 
 ID_INLINE const int idParser::GetLineNum( void ) const {
+	if ( idParser::precompiledTokens ) {
+		return idParser::precompiledLine;
+	}
 	if ( idParser::scriptstack ) {
 		return idParser::scriptstack->GetLineNum();
 	}
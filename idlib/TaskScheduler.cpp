@@ -0,0 +1,745 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+#include "precompiled.h"
+#pragma hdrstop
+
+idTaskScheduler taskSchedulerLocal;
+idTaskScheduler *taskScheduler = &taskSchedulerLocal;
+
+// scheduler and worker index of the calling thread (worker index is -1 for non-worker threads)
+static thread_local idTaskScheduler *currentScheduler = nullptr;
+static thread_local int currentWorker = -1;
+
+static const int TASK_DEQUE_INITIAL_SIZE = 256;
+static const int TASK_WORKER_SPINS = 64;				// failed attempts to find a task before worker sleeps
+static const int TASK_WORKER_SLEEP_MSEC = 50;			// safety net against lost wakeups
+static const int TASK_WORKER_STACK_SIZE = 4 << 20;		// tasks may use alloca heavily (e.g. LCP in AF physics)
+
+/*
+================================================================================================
+
+	idTaskWorker
+
+================================================================================================
+*/
+
+class idTaskWorker : public idSysThread {
+public:
+	idTaskScheduler *		scheduler;
+	int						index;
+	idSysSignal				wakeSignal;
+	std::atomic<bool>		sleeping;
+
+							idTaskWorker( idTaskScheduler *scheduler, int index ) : scheduler( scheduler ), index( index ), sleeping( false ) {}
+
+protected:
+	virtual int				Run();
+};
+
+/*
+========================
+idTaskWorker::Run
+========================
+*/
+int idTaskWorker::Run() {
+	currentScheduler = scheduler;
+	currentWorker = index;
+
+	int fails = 0;
+	idTaskScheduler::task_t task;
+	while ( !IsTerminating() ) {
+		if ( index >= scheduler->numWorkers.load( std::memory_order_acquire ) ) {
+			// parked: nobody else pops from the back of our deque, so finish it before sleeping
+			if ( idTaskScheduler::PopBack( scheduler->deques[index], task ) ) {
+				scheduler->numQueued--;
+				scheduler->Execute( task );
+			} else {
+				TRACE_CPU_SCOPE_COLOR( "TaskWorker::Parked", TRACE_COLOR_IDLE )
+				wakeSignal.Wait( TASK_WORKER_SLEEP_MSEC );
+			}
+			fails = 0;
+			continue;
+		}
+		if ( scheduler->FindTask( index, task ) ) {
+			scheduler->Execute( task );
+			fails = 0;
+			continue;
+		}
+		if ( ++fails < TASK_WORKER_SPINS ) {
+			Sys_Yield();
+			continue;
+		}
+
+		// announce that we are going to sleep, then check for work once more:
+		// either we see the new task, or the spawner sees us sleeping and wakes us
+		sleeping.store( true );
+		scheduler->numSleeping++;
+		if ( scheduler->numQueued.load() == 0 && !IsTerminating() ) {
+			TRACE_CPU_SCOPE_COLOR( "TaskWorker::Sleep", TRACE_COLOR_IDLE )
+			wakeSignal.Wait( TASK_WORKER_SLEEP_MSEC );
+		}
+		scheduler->numSleeping--;
+		sleeping.store( false );
+		fails = 0;
+	}
+
+	currentScheduler = nullptr;
+	currentWorker = -1;
+	return 0;
+}
+
+/*
+================================================================================================
+
+	idTaskGroup
+
+================================================================================================
+*/
+
+/*
+========================
+idTaskGroup::idTaskGroup
+========================
+*/
+idTaskGroup::idTaskGroup( idTaskScheduler *scheduler_ ) :
+	scheduler( scheduler_ ? scheduler_ : taskScheduler ),
+	pending( 1 ),
+	closed( false ),
+	continuation( nullptr ),
+	continuationData( nullptr ),
+	continuationParent( nullptr ) {
+}
+
+/*
+========================
+idTaskGroup::~idTaskGroup
+========================
+*/
+idTaskGroup::~idTaskGroup() {
+	// tasks reference the group, so it must not die before they are finished
+	assert( pending.load() == ( closed.load() ? 0 : 1 ) );
+}
+
+/*
+========================
+idTaskGroup::Run
+========================
+*/
+void idTaskGroup::Run( taskRun_t function, void *data ) {
+	assert( !closed.load() || pending.load() > 0 );
+	pending++;
+	idTaskScheduler::task_t task = { function, data, this };
+	scheduler->Spawn( task );
+}
+
+/*
+========================
+idTaskGroup::Wait
+
+The open reference is kept, so the group can be reused afterwards.
+Tasks never see the counter reach zero, so they don't touch the group after finishing.
+========================
+*/
+void idTaskGroup::Wait() {
+	assert( !closed.load() );
+	if ( pending.load( std::memory_order_acquire ) <= 1 ) {
+		return;
+	}
+	TRACE_CPU_SCOPE( "TaskGroup::Wait" )
+	while ( pending.load( std::memory_order_acquire ) > 1 ) {
+		// execute something useful instead of spinning
+		if ( !scheduler->HelpOnce() ) {
+			Sys_Yield();
+		}
+	}
+}
+
+/*
+========================
+idTaskGroup::Then
+========================
+*/
+void idTaskGroup::Then( taskRun_t function, void *data, idTaskGroup *parent ) {
+	assert( !closed.load() && parent && parent != this );
+	continuation = function;
+	continuationData = data;
+	continuationParent = parent;
+	// parent can't finish before continuation is spawned into it
+	parent->pending++;
+	Close();
+}
+
+/*
+========================
+idTaskGroup::IsDone
+
+Counter is read first: if it has dropped to zero, the decrement in Close
+was done after closed was set, and acquire makes the flag visible here.
+========================
+*/
+bool idTaskGroup::IsDone() const {
+	int count = pending.load( std::memory_order_acquire );
+	return count == ( closed.load( std::memory_order_acquire ) ? 0 : 1 );
+}
+
+/*
+========================
+idTaskGroup::Close
+========================
+*/
+void idTaskGroup::Close() {
+	// released by the decrement in TaskFinished, see IsDone
+	closed.store( true, std::memory_order_release );
+	TaskFinished();
+}
+
+/*
+========================
+idTaskGroup::TaskFinished
+========================
+*/
+void idTaskGroup::TaskFinished() {
+	if ( pending.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) {
+		// only closed groups can reach zero, and they always have continuation
+		assert( continuation );
+		// parent's counter was already incremented in Then
+		idTaskScheduler::task_t task = { continuation, continuationData, continuationParent };
+		scheduler->Spawn( task );
+	}
+}
+
+/*
+================================================================================================
+
+	idTaskScheduler
+
+================================================================================================
+*/
+
+/*
+========================
+idTaskScheduler::idTaskScheduler
+========================
+*/
+idTaskScheduler::idTaskScheduler() : numWorkers( 0 ), numDeques( 0 ), numStarted( 0 ), numQueued( 0 ), numSleeping( 0 ) {
+	memset( workers, 0, sizeof( workers ) );
+	for ( int i = 0; i < MAX_WORKERS; i++ ) {
+		deques[i].first = deques[i].count = 0;
+	}
+	injected.first = injected.count = 0;
+}
+
+/*
+========================
+idTaskScheduler::~idTaskScheduler
+========================
+*/
+idTaskScheduler::~idTaskScheduler() {
+	Shutdown();
+}
+
+/*
+========================
+idTaskScheduler::SetNumWorkers
+
+Threads are never stopped here: tasks may be queued or running on any of them
+(including the caller), so waiting for a worker to finish could deadlock.
+Workers above the new count park themselves, and are woken again when the count grows.
+========================
+*/
+void idTaskScheduler::SetNumWorkers( int newNumWorkers ) {
+	newNumWorkers = idMath::ClampInt( 0, MAX_WORKERS, newNumWorkers );
+	idScopedCriticalSection lock( resizeMutex );
+
+	// workers and their deques must be ready before anyone can see them
+	while ( numStarted < newNumWorkers ) {
+		int idx = numStarted++;
+		if ( deques[idx].tasks.Num() == 0 ) {
+			deques[idx].tasks.SetNum( TASK_DEQUE_INITIAL_SIZE );
+		}
+		workers[idx] = new idTaskWorker( this, idx );
+		numDeques.store( idMath::Imax( numDeques.load(), idx + 1 ) );
+	}
+
+	int oldNumWorkers = numWorkers.exchange( newNumWorkers );
+
+	for ( int idx = 0; idx < newNumWorkers; idx++ ) {
+		if ( !workers[idx]->IsRunning() ) {
+			workers[idx]->StartThread( va( "TaskWorker_%d", idx ), CORE_ANY, THREAD_NORMAL, TASK_WORKER_STACK_SIZE );
+		} else if ( idx >= oldNumWorkers ) {
+			// unpark
+			workers[idx]->wakeSignal.Raise();
+		}
+	}
+}
+
+/*
+========================
+idTaskScheduler::Shutdown
+========================
+*/
+void idTaskScheduler::Shutdown() {
+	idScopedCriticalSection lock( resizeMutex );
+	numWorkers.store( 0 );
+
+	for ( int idx = 0; idx < numStarted; idx++ ) {
+		idTaskWorker *worker = workers[idx];
+		if ( worker->IsRunning() ) {
+			worker->StopThread( false );
+			worker->wakeSignal.Raise();
+			worker->WaitForThread();
+		}
+		delete worker;
+		workers[idx] = nullptr;
+
+		// nobody will pop these tasks from the back, so hand them over
+		task_t task;
+		while ( PopFront( deques[idx], task ) ) {
+			PushBack( injected, task );
+		}
+	}
+	numStarted = 0;
+}
+
+/*
+========================
+idTaskScheduler::PushBack
+========================
+*/
+bool idTaskScheduler::PushBack( taskDeque_t &deque, const task_t &task ) {
+	idScopedCriticalSection lock( deque.mutex );
+	int size = deque.tasks.Num();
+	if ( deque.count == size ) {
+		// grow and make contiguous
+		idList<task_t> grown;
+		grown.SetNum( idMath::Imax( size * 2, TASK_DEQUE_INITIAL_SIZE ) );
+		for ( int i = 0; i < deque.count; i++ ) {
+			grown[i] = deque.tasks[( deque.first + i ) % size];
+		}
+		deque.tasks.Swap( grown );
+		deque.first = 0;
+		size = deque.tasks.Num();
+	}
+	deque.tasks[( deque.first + deque.count ) % size] = task;
+	deque.count++;
+	return true;
+}
+
+/*
+========================
+idTaskScheduler::PopBack
+========================
+*/
+bool idTaskScheduler::PopBack( taskDeque_t &deque, task_t &task ) {
+	idScopedCriticalSection lock( deque.mutex );
+	if ( deque.count == 0 ) {
+		return false;
+	}
+	deque.count--;
+	task = deque.tasks[( deque.first + deque.count ) % deque.tasks.Num()];
+	return true;
+}
+
+/*
+========================
+idTaskScheduler::PopFront
+========================
+*/
+bool idTaskScheduler::PopFront( taskDeque_t &deque, task_t &task ) {
+	idScopedCriticalSection lock( deque.mutex );
+	if ( deque.count == 0 ) {
+		return false;
+	}
+	task = deque.tasks[deque.first];
+	deque.first = ( deque.first + 1 ) % deque.tasks.Num();
+	deque.count--;
+	return true;
+}
+
+/*
+========================
+idTaskScheduler::Spawn
+========================
+*/
+void idTaskScheduler::Spawn( const task_t &task ) {
+	if ( numWorkers.load( std::memory_order_acquire ) == 0 ) {
+		// nobody to execute it in parallel
+		Execute( task );
+		return;
+	}
+
+	int idx = ( currentScheduler == this ? currentWorker : -1 );
+	PushBack( idx >= 0 ? deques[idx] : injected, task );
+	numQueued++;
+
+	if ( numSleeping.load() > 0 ) {
+		WakeOne();
+	}
+}
+
+/*
+========================
+idTaskScheduler::WakeOne
+========================
+*/
+void idTaskScheduler::WakeOne() {
+	int num = numWorkers.load( std::memory_order_acquire );
+	for ( int i = 0; i < num; i++ ) {
+		idTaskWorker *worker = workers[i];
+		if ( worker && worker->sleeping.exchange( false ) ) {
+			worker->wakeSignal.Raise();
+			return;
+		}
+	}
+}
+
+/*
+========================
+idTaskScheduler::FindTask
+========================
+*/
+bool idTaskScheduler::FindTask( int workerIndex, task_t &task ) {
+	if ( numQueued.load() == 0 ) {
+		return false;
+	}
+
+	bool found = false;
+	if ( workerIndex >= 0 ) {
+		// newest own task: its data is most likely in cache
+		found = PopBack( deques[workerIndex], task );
+	}
+	if ( !found ) {
+		found = PopFront( injected, task );
+	}
+	if ( !found ) {
+		// steal oldest task from someone else, starting from pseudo-random victim
+		static thread_local unsigned int seed = 0x9E3779B9u;
+		seed = seed * 1664525u + 1013904223u;
+		int num = numDeques.load( std::memory_order_acquire );
+		int start = num > 0 ? int( ( seed >> 8 ) % num ) : 0;
+		for ( int i = 0; i < num && !found; i++ ) {
+			int victim = ( start + i ) % num;
+			if ( victim != workerIndex ) {
+				found = PopFront( deques[victim], task );
+			}
+		}
+	}
+
+	if ( found ) {
+		numQueued--;
+	}
+	return found;
+}
+
+/*
+========================
+idTaskScheduler::Execute
+========================
+*/
+void idTaskScheduler::Execute( const task_t &task ) {
+	task.function( task.data );
+	task.group->TaskFinished();
+}
+
+/*
+========================
+idTaskScheduler::HelpOnce
+========================
+*/
+bool idTaskScheduler::HelpOnce() {
+	int idx = ( currentScheduler == this ? currentWorker : -1 );
+	task_t task;
+	if ( !FindTask( idx, task ) ) {
+		return false;
+	}
+	Execute( task );
+	return true;
+}
+
+/*
+========================
+idTaskScheduler::AutoGrain
+========================
+*/
+int idTaskScheduler::AutoGrain( int count ) const {
+	// several chunks per thread, so that imbalanced work can be stolen
+	int numChunks = ( numWorkers.load( std::memory_order_relaxed ) + 1 ) * 8;
+	return idMath::Imax( count / numChunks, 1 );
+}
+
+/*
+========================
+idTaskScheduler::ParallelForInternal
+
+Recursively splits the range in halves: one half is spawned as a task, another half is
+processed further on the same thread. Thieves take the oldest (i.e. largest) ranges.
+========================
+*/
+struct parallelForRange_t {
+	struct parallelForState_t *	state;
+	int							begin;
+	int							end;
+};
+struct parallelForState_t {
+	void						( *body )( const void *, int, int );
+	const void *				context;
+	int							grain;
+	idTaskGroup					group;
+	std::atomic<int>			nextRange;
+	idList<parallelForRange_t>	ranges;
+
+	parallelForState_t( idTaskScheduler *scheduler ) : group( scheduler ), nextRange( 0 ) {}
+};
+
+static void ParallelForRange( parallelForRange_t *range ) {
+	parallelForState_t *state = range->state;
+	int begin = range->begin;
+	int end = range->end;
+	while ( end - begin > state->grain ) {
+		int idx = state->nextRange++;
+		if ( idx >= state->ranges.Num() ) {
+			break;	// should not happen
+		}
+		int middle = begin + ( end - begin ) / 2;
+		parallelForRange_t &half = state->ranges[idx];
+		half.state = state;
+		half.begin = middle;
+		half.end = end;
+		state->group.Run( (taskRun_t)ParallelForRange, &half );
+		end = middle;
+	}
+	state->body( state->context, begin, end );
+}
+
+void idTaskScheduler::ParallelForInternal( int begin, int end, int grain, void ( *body )( const void *, int, int ), const void *context ) {
+	if ( end <= begin ) {
+		return;
+	}
+	if ( numWorkers.load( std::memory_order_acquire ) == 0 || end - begin <= grain ) {
+		body( context, begin, end );
+		return;
+	}
+
+	parallelForState_t state( this );
+	state.body = body;
+	state.context = context;
+	state.grain = grain;
+	// every split produces a range of size > grain / 2
+	state.ranges.SetNum( 2 * ( end - begin ) / grain + 2 );
+
+	parallelForRange_t root = { &state, begin, end };
+	ParallelForRange( &root );
+	state.group.Wait();
+}
+
+/*
+================================================================================================
+
+	Benchmark
+
+================================================================================================
+*/
+
+static float TaskBusyWork( int iterations ) {
+	float x = 1.0f;
+	for ( int i = 0; i < iterations; i++ ) {
+		x = x * 0.999f + 0.5f;
+	}
+	return x;
+}
+
+struct benchTinyTask_t {
+	int					iterations;
+	std::atomic<int> *	counter;
+};
+static void BenchTinyTask( benchTinyTask_t *data ) {
+	volatile float result = TaskBusyWork( data->iterations );
+	( *data->counter )++;
+}
+
+struct benchForkJoin_t {
+	int					depth;
+	int					iterations;
+	std::atomic<int> *	counter;
+};
+static void BenchForkJoin( benchForkJoin_t *data ) {
+	if ( data->depth == 0 ) {
+		volatile float result = TaskBusyWork( data->iterations );
+		( *data->counter )++;
+		return;
+	}
+	benchForkJoin_t left = { data->depth - 1, data->iterations, data->counter };
+	benchForkJoin_t right = left;
+	idTaskGroup group;
+	group.Run( (taskRun_t)BenchForkJoin, &left );
+	BenchForkJoin( &right );
+	group.Wait();
+}
+
+/*
+========================
+idTaskScheduler::Benchmark_f
+========================
+*/
+void idTaskScheduler::Benchmark_f( const idCmdArgs &args ) {
+	idTaskScheduler &sched = *taskScheduler;
+	idLib::Printf( "Task scheduler benchmark: %d workers\n", sched.GetNumWorkers() );
+
+	// tiny tasks: measures overhead of spawning and finishing a task
+	{
+		const int NUM = 100000;
+		std::atomic<int> counter( 0 );
+		benchTinyTask_t data = { 10, &counter };
+		idTaskGroup group;
+		uint64 start = Sys_Microseconds();
+		for ( int i = 0; i < NUM; i++ ) {
+			group.Run( (taskRun_t)BenchTinyTask, &data );
+		}
+		group.Wait();
+		uint64 elapsed = Sys_Microseconds() - start;
+		idLib::Printf( "  tiny tasks:      %d tasks in %.2f ms (%.3f us per task)%s\n", NUM, elapsed * 0.001, double( elapsed ) / NUM, counter.load() == NUM ? "" : " FAILED" );
+	}
+
+	// fork/join: nested tasks spawned from tasks
+	for ( int depth = 8; depth <= 16; depth += 4 ) {
+		std::atomic<int> counter( 0 );
+		benchForkJoin_t data = { depth, 1000, &counter };
+		uint64 start = Sys_Microseconds();
+		BenchForkJoin( &data );
+		uint64 elapsed = Sys_Microseconds() - start;
+		idLib::Printf( "  fork/join:       depth %d (%d leaves) in %.2f ms%s\n", depth, 1 << depth, elapsed * 0.001, counter.load() == ( 1 << depth ) ? "" : " FAILED" );
+	}
+
+	// imbalanced: cost grows quadratically with index, compared with serial loop
+	{
+		const int NUM = 4096;
+		auto work = []( int i ) { return TaskBusyWork( ( i * i ) >> 10 ); };
+		uint64 start = Sys_Microseconds();
+		float serial = 0.0f;
+		for ( int i = 0; i < NUM; i++ ) {
+			serial += work( i );
+		}
+		uint64 serialTime = Sys_Microseconds() - start;
+
+		start = Sys_Microseconds();
+		float parallel = sched.ParallelReduce( 0, NUM, 0.0f, [&work]( int begin, int end ) {
+			float sum = 0.0f;
+			for ( int i = begin; i < end; i++ ) {
+				sum += work( i );
+			}
+			return sum;
+		}, []( float a, float b ) { return a + b; } );
+		uint64 parallelTime = Sys_Microseconds() - start;
+
+		idLib::Printf( "  imbalanced:      serial %.2f ms, parallel_reduce %.2f ms (speedup %.2f), result %s\n",
+			serialTime * 0.001, parallelTime * 0.001, double( serialTime ) / idMath::Imax( (int)parallelTime, 1 ),
+			idMath::Fabs( serial - parallel ) <= 1e-3f * idMath::Fabs( serial ) ? "OK" : "MISMATCH"
+		);
+	}
+}
+
+/*
+================================================================================================
+
+	Tests
+
+================================================================================================
+*/
+
+#include "../tests/testing.h"
+
+TEST_CASE("idTaskScheduler: parallel for and reduce") {
+	idTaskScheduler sched;
+	sched.SetNumWorkers( 3 );
+
+	const int NUM = 10000;
+	idList<int> visited;
+	visited.SetNum( NUM );
+	memset( visited.Ptr(), 0, visited.MemoryUsed() );
+	sched.ParallelFor( 0, NUM, [&]( int begin, int end ) {
+		for ( int i = begin; i < end; i++ ) {
+			visited[i]++;
+		}
+	}, 7 );
+	int numOnce = 0;
+	for ( int i = 0; i < NUM; i++ ) {
+		numOnce += ( visited[i] == 1 );
+	}
+	CHECK( numOnce == NUM );
+
+	int64 sum = sched.ParallelReduce( 0, NUM, int64( 0 ), []( int begin, int end ) {
+		int64 s = 0;
+		for ( int i = begin; i < end; i++ ) {
+			s += i;
+		}
+		return s;
+	}, []( int64 a, int64 b ) { return a + b; } );
+	CHECK( sum == int64( NUM ) * ( NUM - 1 ) / 2 );
+
+	sched.Shutdown();
+}
+
+static void TestContinuation( std::atomic<int> *counter ) {
+	// continuation must see all tasks of the group finished
+	CHECK( counter->load() == 100 );
+	( *counter )++;
+}
+static void TestIncrement( std::atomic<int> *counter ) {
+	( *counter )++;
+}
+
+TEST_CASE("idTaskScheduler: nested tasks and continuation") {
+	idTaskScheduler sched;
+	sched.SetNumWorkers( 2 );
+
+	std::atomic<int> counter( 0 );
+	idTaskGroup parent( &sched );
+	idTaskGroup children( &sched );
+	for ( int i = 0; i < 100; i++ ) {
+		children.Run( (taskRun_t)TestIncrement, &counter );
+	}
+	children.Then( (taskRun_t)TestContinuation, &counter, &parent );
+	parent.Wait();
+	CHECK( counter.load() == 101 );
+
+	sched.Shutdown();
+}
+
+TEST_CASE("idTaskScheduler: resize while tasks are running") {
+	idTaskScheduler sched;
+	sched.SetNumWorkers( 4 );
+
+	const int NUM = 1000;
+	std::atomic<int> counter( 0 );
+	sched.ParallelFor( 0, NUM, [&]( int begin, int end ) {
+		if ( begin == 0 ) {
+			// parked workers must still finish tasks which are already in their deques
+			sched.SetNumWorkers( 1 );
+		} else if ( end == NUM ) {
+			sched.SetNumWorkers( 3 );
+		}
+		counter += end - begin;
+	}, 1 );
+	CHECK( counter.load() == NUM );
+
+	sched.SetNumWorkers( 0 );
+	counter = 0;
+	sched.ParallelFor( 0, NUM, [&]( int begin, int end ) {
+		counter += end - begin;
+	}, 1 );
+	CHECK( counter.load() == NUM );
+
+	sched.Shutdown();
+}
@@ -0,0 +1,209 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+#ifndef __TASKSCHEDULER_H__
+#define __TASKSCHEDULER_H__
+
+#include <atomic>
+
+/*
+================================================================================================
+
+	Work-stealing task scheduler
+
+	Every worker thread owns a deque of tasks: it pushes and pops tasks at its back,
+	while idle workers steal from the front of other deques. Tasks spawned from threads
+	which are not workers (e.g. main thread) go to a shared injection queue.
+
+	Tasks can spawn more tasks (nested parallelism): a task simply creates its own
+	idTaskGroup, runs sub-tasks in it and waits for it. A thread waiting for a group
+	executes other tasks until the group is done, so waiting never blocks a worker.
+
+	idTaskGroup is also a dependency counter: a continuation can be attached to it,
+	which is spawned (into another group) when all tasks of the group have finished.
+
+	A task should still take at least a few thousand clock cycles,
+	use ParallelFor to automatically split a large range into such tasks.
+
+================================================================================================
+*/
+
+class idTaskScheduler;
+
+typedef void ( * taskRun_t )( void * );
+
+/*
+================================================
+idTaskGroup
+
+Counts tasks which are not finished yet.
+Wait executes tasks until all tasks of the group are finished,
+after that the group can be reused.
+Then closes the group: the group must stay alive until its continuation is spawned.
+================================================
+*/
+class idTaskGroup {
+public:
+							idTaskGroup( idTaskScheduler *scheduler = nullptr );
+							~idTaskGroup();
+
+	// spawn a task into this group (can be called from any thread, including tasks of this group)
+	void					Run( taskRun_t function, void *data );
+
+	// execute tasks until all tasks of this group are finished
+	void					Wait();
+
+	// close the group: when all its tasks are finished, spawn continuation into parent group
+	// parent must be waited for (or have its own continuation) to make sure continuation is done
+	void					Then( taskRun_t function, void *data, idTaskGroup *parent );
+
+	bool					IsDone() const;
+
+private:
+	friend class idTaskScheduler;
+
+	idTaskScheduler *		scheduler;
+	std::atomic<int>		pending;			// unfinished tasks + 1 until Then is called
+	std::atomic<bool>		closed;				// set by Then, possibly while other threads check IsDone
+	taskRun_t				continuation;
+	void *					continuationData;
+	idTaskGroup *			continuationParent;
+
+	void					Close();
+	void					TaskFinished();
+
+							idTaskGroup( const idTaskGroup & ) = delete;
+	void					operator=( const idTaskGroup & ) = delete;
+};
+
+/*
+================================================
+idTaskScheduler
+================================================
+*/
+class idTaskScheduler {
+public:
+	static const int		MAX_WORKERS = 32;
+
+							idTaskScheduler();
+							~idTaskScheduler();
+
+	// change number of workers taking tasks, can be called at any time (even from a task)
+	// extra workers are only parked: they finish tasks of their own deque and sleep
+	void					SetNumWorkers( int numWorkers );
+	int						GetNumWorkers() const { return numWorkers.load( std::memory_order_acquire ); }
+	// stop all worker threads, must not be called while tasks are running
+	void					Shutdown();
+
+	// try to execute one pending task on the calling thread, returns false if nothing was found
+	bool					HelpOnce();
+
+	// calls func( rangeBegin, rangeEnd ) for subranges covering [begin, end) in parallel
+	// grain is the max size of one subrange, zero means "choose automatically"
+	template<class Func> void ParallelFor( int begin, int end, const Func &func, int grain = 0 );
+
+	// computes reduce( map( r0 ), reduce( map( r1 ), ... ) ) for consecutive subranges r0, r1, ... of [begin, end)
+	// the subranges and order of reduction only depend on range and grain, so result is deterministic
+	template<class Type, class MapFunc, class ReduceFunc>
+	Type					ParallelReduce( int begin, int end, const Type &identity, const MapFunc &map, const ReduceFunc &reduce, int grain = 0 );
+
+	// microbenchmark: fork/join depth, tiny tasks, imbalanced tasks
+	static void				Benchmark_f( const class idCmdArgs &args );
+
+private:
+	friend class idTaskGroup;
+	friend class idTaskWorker;
+
+	struct task_t {
+		taskRun_t			function;
+		void *				data;
+		idTaskGroup *		group;
+	};
+	struct taskDeque_t {
+		idSysMutex			mutex;
+		idList<task_t>		tasks;			// circular buffer
+		int					first;
+		int					count;
+	};
+
+	std::atomic<int>		numWorkers;		// workers taking tasks, the rest of started ones are parked
+	std::atomic<int>		numDeques;		// deques which may contain tasks (including parked workers)
+	int						numStarted;		// worker threads created so far, never decreases until Shutdown
+	idSysMutex				resizeMutex;
+	class idTaskWorker *	workers[MAX_WORKERS];
+	taskDeque_t				deques[MAX_WORKERS];
+	taskDeque_t				injected;		// tasks spawned from non-worker threads
+	std::atomic<int>		numQueued;		// total number of tasks in all deques
+	std::atomic<int>		numSleeping;
+
+	void					Spawn( const task_t &task );
+	bool					FindTask( int workerIndex, task_t &task );
+	void					Execute( const task_t &task );
+	void					WakeOne();
+
+	static bool				PushBack( taskDeque_t &deque, const task_t &task );
+	static bool				PopBack( taskDeque_t &deque, task_t &task );
+	static bool				PopFront( taskDeque_t &deque, task_t &task );
+
+	int						AutoGrain( int count ) const;
+	void					ParallelForInternal( int begin, int end, int grain, void ( *body )( const void *, int, int ), const void *context );
+};
+
+extern idTaskScheduler *	taskScheduler;
+
+/*
+========================
+idTaskScheduler::ParallelFor
+========================
+*/
+template<class Func>
+ID_INLINE void idTaskScheduler::ParallelFor( int begin, int end, const Func &func, int grain ) {
+	if ( grain <= 0 ) {
+		grain = AutoGrain( end - begin );
+	}
+	auto body = []( const void *context, int rangeBegin, int rangeEnd ) {
+		( *(const Func *)context )( rangeBegin, rangeEnd );
+	};
+	ParallelForInternal( begin, end, grain, body, &func );
+}
+
+/*
+========================
+idTaskScheduler::ParallelReduce
+========================
+*/
+template<class Type, class MapFunc, class ReduceFunc>
+ID_INLINE Type idTaskScheduler::ParallelReduce( int begin, int end, const Type &identity, const MapFunc &map, const ReduceFunc &reduce, int grain ) {
+	if ( end <= begin ) {
+		return identity;
+	}
+	if ( grain <= 0 ) {
+		grain = AutoGrain( end - begin );
+	}
+	int numChunks = ( end - begin + grain - 1 ) / grain;
+	idList<Type> partial;
+	partial.SetNum( numChunks );
+	ParallelFor( 0, numChunks, [&]( int chunkBegin, int chunkEnd ) {
+		for ( int c = chunkBegin; c < chunkEnd; c++ ) {
+			partial[c] = map( begin + c * grain, idMath::Imin( begin + ( c + 1 ) * grain, end ) );
+		}
+	}, 1 );
+	Type result = identity;
+	for ( int c = 0; c < numChunks; c++ ) {
+		result = reduce( result, partial[c] );
+	}
+	return result;
+}
+
+#endif // !__TASKSCHEDULER_H__
@@ -45,16 +45,10 @@ void idSIMD::Init( void ) {
 
 /*
 ============
-idSIMD::InitProcessor
+idSIMD::GetCpuid
 ============
 */
-void idSIMD::InitProcessor( const char *module, const char *forceImpl ) {
-	if (processor != generic) {
-		delete processor;
-		processor = nullptr;
-		SIMDProcessor = generic;
-	}
-
+int idSIMD::GetCpuid( void ) {
 	int cpuid = idLib::sys->GetProcessorId();
 
 	//stgatilov: force cpuid bits for SIMD choice if compiler macros are set
@@ -82,6 +76,23 @@ void idSIMD::InitProcessor( const char *module, const char *forceImpl ) {
 		cpuid |= CPUID_FMA3;
 	#endif
 
+	return cpuid;
+}
+
+/*
+============
+idSIMD::InitProcessor
+============
+*/
+void idSIMD::InitProcessor( const char *module, const char *forceImpl ) {
+	if (processor != generic) {
+		delete processor;
+		processor = nullptr;
+		SIMDProcessor = generic;
+	}
+
+	int cpuid = GetCpuid();
+
 	// Print what we found to console
 	idLib::common->Printf( "Found %s CPU, features:%s%s%s%s%s%s%s%s\n",
 	                       // Vendor
@@ -3110,6 +3121,87 @@ void TestConvertRGTCFromRGBA8() {
 	}
 }
 
+/*
+============
+TestCompressDXTFromRGBA8
+============
+*/
+typedef void ( idSIMDProcessor::*compressFunc_t )( const byte *srcPtr, int width, int height, int stride, byte *dstPtr );
+
+static void TestCompressFromRGBA8( const char *name, compressFunc_t func, int blockSize ) {
+	idRandom rnd(RANDOM_SEED);
+
+	// smooth image with noise, similar to real textures
+	static const int SIZE = 256;
+	idList<dword> inputData;
+	inputData.SetNum(SIZE * SIZE);
+	for (int i = 0; i < SIZE; i++)
+		for (int j = 0; j < SIZE; j++) {
+			dword pixel = 0;
+			for (int c = 0; c < 4; c++) {
+				int val = ((i * (c + 1) + j * (3 - c)) >> 1) + rnd.RandomInt(16);
+				pixel |= dword(idMath::ClampInt(0, 255, val)) << (8 * c);
+			}
+			inputData[i * SIZE + j] = pixel;
+		}
+	idList<byte> outputGeneric, outputSIMD;
+	outputGeneric.SetNum((SIZE / 4) * (SIZE / 4) * blockSize);
+	outputSIMD.SetNum(outputGeneric.Num());
+
+	static const int TRIES = 16;
+	TIME_TYPE start, end;
+	TIME_TYPE bestClocksGeneric = 0;
+	for ( int i = 0; i < TRIES; i++ ) {
+		StartRecordTime( start );
+		(p_generic->*func)((const byte*)inputData.Ptr(), SIZE, SIZE, 4 * SIZE, outputGeneric.Ptr());
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksGeneric );
+	}
+	PrintClocks( va( "generic->%s( %d )", name, SIZE ), SIZE * SIZE, bestClocksGeneric );
+
+	TIME_TYPE bestClocksSIMD = 0;
+	for ( int i = 0; i < TRIES; i++ ) {
+		StartRecordTime( start );
+		(p_simd->*func)((const byte*)inputData.Ptr(), SIZE, SIZE, 4 * SIZE, outputSIMD.Ptr());
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksSIMD );
+	}
+	bool same = memcmp(outputGeneric.Ptr(), outputSIMD.Ptr(), outputGeneric.Num()) == 0;
+	PrintClocks( va( "   simd->%s( %d ) %s", name, SIZE, same ? "ok" : S_COLOR_RED"X" ), SIZE * SIZE, bestClocksSIMD, bestClocksGeneric );
+
+	double ticksPerSecond = idLib::sys->ClockTicksPerSecond();
+	idLib::common->Printf( "   throughput: generic %.1f MPixels/s, %s %.1f MPixels/s\n",
+		SIZE * SIZE / ( bestClocksGeneric / ticksPerSecond ) * 1e-6,
+		p_simd->GetName(), SIZE * SIZE / ( bestClocksSIMD / ticksPerSecond ) * 1e-6
+	);
+
+	// various image sizes and strides
+	for (int h = 1; h <= 23; h++) {
+		for (int w = 1; w <= 23; w++) {
+			int stride = w + rnd.RandomInt(10);
+			idList<dword> rgbaPixels;
+			rgbaPixels.SetNum(h * stride);
+			for (int i = 0; i < rgbaPixels.Num(); i++)
+				rgbaPixels[i] = rnd.RandomInt(1 << 16) + (rnd.RandomInt(1 << 16) << 16);
+
+			int outSize = ((h + 3) / 4) * ((w + 3) / 4) * blockSize;
+			idList<byte> outputGen, outputFast;
+			outputGen.SetNum(outSize);
+			outputFast.SetNum(outSize);
+			(p_generic->*func)((const byte*)rgbaPixels.Ptr(), w, h, 4 * stride, outputGen.Ptr());
+			(p_simd->*func)((const byte*)rgbaPixels.Ptr(), w, h, 4 * stride, outputFast.Ptr());
+			if (memcmp(outputGen.Ptr(), outputFast.Ptr(), outSize) != 0)
+				common->Error("TestCompressFromRGBA8: %s output mismatch", name);
+		}
+	}
+}
+
+void TestCompressDXTFromRGBA8() {
+	TestCompressFromRGBA8( "CompressDXT1FromRGBA8", &idSIMDProcessor::CompressDXT1FromRGBA8, 8 );
+	TestCompressFromRGBA8( "CompressDXT5FromRGBA8", &idSIMDProcessor::CompressDXT5FromRGBA8, 16 );
+	TestCompressFromRGBA8( "CompressRGTCFromRGBA8", &idSIMDProcessor::CompressRGTCFromRGBA8, 16 );
+}
+
 /*
 ============
 TestSoundUpSampling
@@ -3924,6 +4016,7 @@ void idSIMD::Test_f( const idCmdArgs &args ) {
 		TestNormalizeTangents();
 		TestCreateShadowCache();
 		TestConvertRGTCFromRGBA8();
+		TestCompressDXTFromRGBA8();
 	}
 
 	if ( testBits & 8 ) {
@@ -32,7 +32,9 @@ public:
 	static void			Init( void );
 	static void			InitProcessor( const char *module, const char *forceImpl = nullptr );
 	static void			Shutdown( void );
+	static int			GetCpuid( void );			// processor id with flags forced by compiler macros
 	static void			Test_f( const class idCmdArgs &args );
+	static void			Benchmark_f( const class idCmdArgs &args );
 };
 
 //stgatilov: when we should compile SSE/AVX processors at all?
@@ -179,6 +181,8 @@ public:
 	// images
 	virtual void GenerateMipMap2x2( const byte *srcPtr, int srcStride, int halfWidth, int halfHeight, byte *dstPtr, int dstStride ) = 0;
 	virtual void CompressRGTCFromRGBA8( const byte *srcPtr, int width, int height, int stride, byte *dstPtr ) = 0;
+	virtual void CompressDXT1FromRGBA8( const byte *srcPtr, int width, int height, int stride, byte *dstPtr ) = 0;
+	virtual void CompressDXT5FromRGBA8( const byte *srcPtr, int width, int height, int stride, byte *dstPtr ) = 0;
 	virtual bool ConvertTargaRowToRGBA8( const byte *srcPtr, int width, int bitsPerPixel, byte *dstPtr ) = 0;
 	virtual void DecompressRGBA8FromDXT1( const byte *srcPtr, int width, int height, byte *dstPtr, int stride, bool allowTransparency ) = 0;
 	virtual void DecompressRGBA8FromDXT3( const byte *srcPtr, int width, int height, byte *dstPtr, int stride ) = 0;
@@ -0,0 +1,831 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "Simd_Generic.h"
+#include "Simd_SSE.h"
+#include "Simd_SSE2.h"
+#include "Simd_SSSE3.h"
+#include "Simd_AVX.h"
+#include "Simd_AVX2.h"
+#include "Simd_IdAsm.h"
+
+/*
+===============================================================================
+
+	SIMD benchmark and regression suite
+
+	Unlike testSIMD, which compares the active processor against generic code,
+	this runs every idSIMDProcessor function on every processor supported by CPU.
+	Inputs have realistic sizes (skinned mesh, skeleton, AF matrix, texture,
+	sound mix buffer), results are verified against generic implementation.
+
+	The report can be written as JSON or CSV for tracking regressions between builds.
+	No renderer is needed, so it can be run from command line like this:
+		thedarkmod +set com_skipRenderer 1 +benchmarkSIMD json simd.json +quit
+
+===============================================================================
+*/
+
+static const int BENCH_FLOATS		= 4096;
+static const int BENCH_GRID			= 64;
+static const int BENCH_VERTS		= BENCH_GRID * BENCH_GRID;
+static const int BENCH_TRIS			= ( BENCH_GRID - 1 ) * ( BENCH_GRID - 1 ) * 2;
+static const int BENCH_INDEXES		= BENCH_TRIS * 3;
+static const int BENCH_JOINTS		= 128;
+static const int BENCH_MATX			= 48;
+static const int BENCH_IMAGE		= 256;
+static const int BENCH_PIXELS		= BENCH_IMAGE * BENCH_IMAGE;
+static const int BENCH_MIX			= MIXBUFFER_SAMPLES;
+
+static const int BENCH_SEED			= 1013904223;
+
+// read-only inputs shared by all processors
+struct simdBenchInput_t {
+	float *				f0;				// [-10, 10]
+	float *				f1;				// [0.5, 2], safe for division
+	float *				f2;				// [0, 1]
+	idVec2 *			v2;
+	idVec3 *			v3a;
+	idVec3 *			v3b;
+	idPlane *			planes;
+	idVec3				vec3;
+	idPlane				plane;
+
+	idDrawVert *		verts;			// wavy grid mesh
+	int *				indexes;
+	dominantTri_s *		dominantTris;
+	int *				shadowRemap;
+	idVec3				lightOrigin;
+	idPlane				cullPlanes[6];
+
+	idJointQuat *		quats;
+	idJointQuat *		blendQuats;
+	int *				jointIndex;
+	idJointMat *		localMats;
+	idJointMat *		modelMats;
+	int *				parents;
+	idVec4 *			weights;
+	int *				weightIndex;
+	int					numWeights;
+
+	idMatX				mat;
+	idMatX				spd;			// symmetric positive definite
+	idMatX				ldlt;			// LDL' factorization of spd
+	idVecX				vec0;
+	idVecX				vec1;
+
+	byte *				image;			// RGBA8
+	byte *				targa;			// BGR8
+	byte *				dxt1;
+	byte *				dxt5;
+	byte *				rgtc;
+
+	short *				pcm;
+	float *				ogg[2];
+	float *				samples;
+	float *				mixBase;
+	float *				mixed;
+	float				lastV[6];
+	float				currentV[6];
+};
+
+// outputs written by one processor
+struct simdBenchOutput_t {
+	float *				floats;
+	byte *				bytes;
+	unsigned short *	shorts;
+	idVec2 *			vec2s;
+	idVec4 *			vec4s;
+	int *				ints;
+	idPlane *			planes;
+	idDrawVert *		verts;
+	idJointQuat *		quats;
+	idJointMat *		mats;
+	idMatX				mat;
+	idVecX				vec;
+	float				scalars[8];
+	int					result;
+};
+
+typedef void ( *simdBenchPrepare_t )( const simdBenchInput_t &in, simdBenchOutput_t &out );
+typedef void ( *simdBenchRun_t )( idSIMDProcessor *p, const simdBenchInput_t &in, simdBenchOutput_t &out );
+typedef float ( *simdBenchCheck_t )( const simdBenchOutput_t &ref, const simdBenchOutput_t &test );
+
+struct simdBenchCase_t {
+	const char *		name;
+	const char *		group;
+	int					elements;		// number of items processed per call
+	float				tolerance;		// max allowed error compared to generic
+	simdBenchPrepare_t	prepare;		// resets in-place data before every call (not timed)
+	simdBenchRun_t		run;
+	simdBenchCheck_t	check;
+};
+
+struct simdBenchResult_t {
+	const simdBenchCase_t *	test;
+	const char *		processor;
+	double				bestNs;
+	double				medianNs;
+	double				speedup;
+	float				error;
+	bool				passed;
+};
+
+template<class type>
+static type *BenchAlloc( int num ) {
+	int size = num * sizeof( type ) + 64;
+	type *ptr = (type *)Mem_Alloc16( size );
+	memset( (void *)ptr, 0, size );
+	return ptr;
+}
+
+/*
+============
+Error metrics
+============
+*/
+// absolute error for small values, relative error for large ones
+static float FloatError( const float *ref, const float *test, int num ) {
+	float maxError = 0.0f;
+	for ( int i = 0; i < num; i++ ) {
+		float error = idMath::Fabs( ref[i] - test[i] ) / Max( 1.0f, idMath::Fabs( ref[i] ) );
+		if ( error != error ) {
+			return idMath::INFINITY;
+		}
+		maxError = Max( maxError, error );
+	}
+	return maxError;
+}
+
+static float ByteError( const byte *ref, const byte *test, int num ) {
+	int maxError = 0;
+	for ( int i = 0; i < num; i++ ) {
+		maxError = Max( maxError, idMath::Abs( ref[i] - test[i] ) );
+	}
+	return maxError;
+}
+
+static float ShortError( const short *ref, const short *test, int num ) {
+	int maxError = 0;
+	for ( int i = 0; i < num; i++ ) {
+		maxError = Max( maxError, idMath::Abs( ref[i] - test[i] ) );
+	}
+	return maxError;
+}
+
+static float VertError( const idDrawVert *ref, const idDrawVert *test, int num ) {
+	float maxError = 0.0f;
+	for ( int i = 0; i < num; i++ ) {
+		// xyz, st, normal and tangents are consecutive floats
+		maxError = Max( maxError, FloatError( ref[i].xyz.ToFloatPtr(), test[i].xyz.ToFloatPtr(), 14 ) );
+		maxError = Max( maxError, ByteError( ref[i].color, test[i].color, 4 ) );
+	}
+	return maxError;
+}
+
+static float ResultError( const simdBenchOutput_t &ref, const simdBenchOutput_t &test ) {
+	return ref.result == test.result ? 0.0f : idMath::INFINITY;
+}
+
+/*
+============
+Input data
+============
+*/
+static void RandomPlane( idPlane &plane, idRandom &rnd, float range ) {
+	idVec3 normal( rnd.CRandomFloat(), rnd.CRandomFloat(), rnd.CRandomFloat() );
+	normal.Normalize();
+	idVec3 point( rnd.CRandomFloat() * range, rnd.CRandomFloat() * range, rnd.CRandomFloat() * range );
+	plane.SetNormal( normal );
+	plane.FitThroughPoint( point );
+}
+
+static void RandomJoint( idJointQuat &joint, idRandom &rnd ) {
+	idAngles angles( rnd.CRandomFloat() * 180.0f, rnd.CRandomFloat() * 180.0f, rnd.CRandomFloat() * 180.0f );
+	joint.q = angles.ToQuat();
+	joint.t.Set( rnd.CRandomFloat() * 10.0f, rnd.CRandomFloat() * 10.0f, rnd.CRandomFloat() * 10.0f );
+}
+
+static void InitBenchInput( simdBenchInput_t &in, idSIMDProcessor *generic ) {
+	idRandom rnd( BENCH_SEED );
+
+	in.f0 = BenchAlloc<float>( BENCH_FLOATS );
+	in.f1 = BenchAlloc<float>( BENCH_FLOATS );
+	in.f2 = BenchAlloc<float>( BENCH_FLOATS );
+	for ( int i = 0; i < BENCH_FLOATS; i++ ) {
+		in.f0[i] = rnd.CRandomFloat() * 10.0f;
+		in.f1[i] = 0.5f + rnd.RandomFloat() * 1.5f;
+		in.f2[i] = rnd.RandomFloat();
+	}
+
+	in.v2 = BenchAlloc<idVec2>( BENCH_VERTS );
+	in.v3a = BenchAlloc<idVec3>( BENCH_VERTS );
+	in.v3b = BenchAlloc<idVec3>( BENCH_VERTS );
+	in.planes = BenchAlloc<idPlane>( BENCH_VERTS );
+	for ( int i = 0; i < BENCH_VERTS; i++ ) {
+		in.v2[i].Set( rnd.CRandomFloat() * 100.0f, rnd.CRandomFloat() * 100.0f );
+		in.v3a[i].Set( rnd.CRandomFloat() * 100.0f, rnd.CRandomFloat() * 100.0f, rnd.CRandomFloat() * 100.0f );
+		in.v3b[i].Set( rnd.CRandomFloat() * 100.0f, rnd.CRandomFloat() * 100.0f, rnd.CRandomFloat() * 100.0f );
+		RandomPlane( in.planes[i], rnd, 100.0f );
+	}
+	in.vec3.Set( rnd.CRandomFloat(), rnd.CRandomFloat(), rnd.CRandomFloat() );
+	RandomPlane( in.plane, rnd, 100.0f );
+
+	// wavy grid, similar to a terrain patch or a cloth
+	in.verts = BenchAlloc<idDrawVert>( BENCH_VERTS );
+	for ( int y = 0; y < BENCH_GRID; y++ ) {
+		for ( int x = 0; x < BENCH_GRID; x++ ) {
+			idDrawVert &v = in.verts[y * BENCH_GRID + x];
+			v.xyz.Set( x * 8.0f, y * 8.0f, idMath::Sin( x * 0.3f ) * idMath::Cos( y * 0.2f ) * 16.0f + rnd.CRandomFloat() );
+			v.st.Set( x / 16.0f + rnd.CRandomFloat() * 0.01f, y / 16.0f + rnd.CRandomFloat() * 0.01f );
+			v.normal.Set( rnd.CRandomFloat(), rnd.CRandomFloat(), 2.0f );
+			v.tangents[0].Set( 2.0f, rnd.CRandomFloat(), rnd.CRandomFloat() );
+			v.tangents[1].Set( rnd.CRandomFloat(), 2.0f, rnd.CRandomFloat() );
+			v.SetColor( rnd.RandomInt() );
+		}
+	}
+	in.indexes = BenchAlloc<int>( BENCH_INDEXES );
+	int numIndexes = 0;
+	for ( int y = 0; y < BENCH_GRID - 1; y++ ) {
+		for ( int x = 0; x < BENCH_GRID - 1; x++ ) {
+			int v = y * BENCH_GRID + x;
+			in.indexes[numIndexes++] = v;
+			in.indexes[numIndexes++] = v + 1;
+			in.indexes[numIndexes++] = v + BENCH_GRID;
+			in.indexes[numIndexes++] = v + 1;
+			in.indexes[numIndexes++] = v + BENCH_GRID + 1;
+			in.indexes[numIndexes++] = v + BENCH_GRID;
+		}
+	}
+	in.dominantTris = BenchAlloc<dominantTri_s>( BENCH_VERTS );
+	in.shadowRemap = BenchAlloc<int>( BENCH_VERTS );
+	for ( int y = 0; y < BENCH_GRID; y++ ) {
+		for ( int x = 0; x < BENCH_GRID; x++ ) {
+			int v = y * BENCH_GRID + x;
+			in.dominantTris[v].v2 = ( x + 1 < BENCH_GRID ? v + 1 : v - 1 );
+			in.dominantTris[v].v3 = ( y + 1 < BENCH_GRID ? v + BENCH_GRID : v - BENCH_GRID );
+			for ( int k = 0; k < 3; k++ ) {
+				in.dominantTris[v].normalizationScale[k] = 0.5f + rnd.RandomFloat();
+			}
+			in.shadowRemap[v] = ( rnd.RandomFloat() < 0.5f ? -1 : 0 );
+		}
+	}
+	in.lightOrigin.Set( BENCH_GRID * 4.0f, BENCH_GRID * 2.0f, 64.0f );
+	for ( int i = 0; i < 6; i++ ) {
+		RandomPlane( in.cullPlanes[i], rnd, BENCH_GRID * 4.0f );
+		in.cullPlanes[i].TranslateSelf( idVec3( BENCH_GRID * 4.0f, BENCH_GRID * 4.0f, 0.0f ) );
+	}
+
+	// skeleton with random hierarchy, every vertex is skinned to 1-3 joints
+	in.quats = BenchAlloc<idJointQuat>( BENCH_JOINTS );
+	in.blendQuats = BenchAlloc<idJointQuat>( BENCH_JOINTS );
+	in.jointIndex = BenchAlloc<int>( BENCH_JOINTS );
+	in.localMats = BenchAlloc<idJointMat>( BENCH_JOINTS );
+	in.modelMats = BenchAlloc<idJointMat>( BENCH_JOINTS );
+	in.parents = BenchAlloc<int>( BENCH_JOINTS );
+	for ( int i = 0; i < BENCH_JOINTS; i++ ) {
+		RandomJoint( in.quats[i], rnd );
+		RandomJoint( in.blendQuats[i], rnd );
+		in.jointIndex[i] = i;
+		in.parents[i] = ( i == 0 ? -1 : rnd.RandomInt( i ) );
+	}
+	generic->ConvertJointQuatsToJointMats( in.localMats, in.quats, BENCH_JOINTS );
+	memcpy( in.modelMats, in.localMats, BENCH_JOINTS * sizeof( idJointMat ) );
+	generic->TransformJoints( in.modelMats, in.parents, 1, BENCH_JOINTS - 1 );
+
+	in.weights = BenchAlloc<idVec4>( BENCH_VERTS * 3 );
+	in.weightIndex = BenchAlloc<int>( BENCH_VERTS * 3 * 2 );
+	in.numWeights = 0;
+	for ( int v = 0; v < BENCH_VERTS; v++ ) {
+		int num = 1 + v % 3;
+		for ( int k = 0; k < num; k++ ) {
+			int w = in.numWeights++;
+			in.weights[w].Set( rnd.CRandomFloat() * 2.0f, rnd.CRandomFloat() * 2.0f, rnd.CRandomFloat() * 2.0f, 1.0f / num );
+			in.weightIndex[w * 2 + 0] = rnd.RandomInt( BENCH_JOINTS ) * sizeof( idJointMat );
+			in.weightIndex[w * 2 + 1] = ( k == num - 1 );
+		}
+	}
+
+	// typical size of articulated figure constraint matrix
+	in.mat.Random( BENCH_MATX, BENCH_MATX, BENCH_SEED, -1.0f, 1.0f );
+	in.vec0.Random( BENCH_MATX, BENCH_SEED + 1, -1.0f, 1.0f );
+	in.vec1.Random( BENCH_MATX, BENCH_SEED + 2, -1.0f, 1.0f );
+	in.spd.SetSize( BENCH_MATX, BENCH_MATX );
+	generic->MatX_MultiplyMatX( in.spd, in.mat, in.mat.Transpose() );
+	for ( int i = 0; i < BENCH_MATX; i++ ) {
+		in.spd[i][i] += BENCH_MATX;
+	}
+	idVecX invDiag;
+	invDiag.SetSize( BENCH_MATX );
+	in.ldlt = in.spd;
+	generic->MatX_LDLTFactor( in.ldlt, invDiag, BENCH_MATX );
+
+	// smooth image with noise, similar to real textures
+	in.image = BenchAlloc<byte>( BENCH_PIXELS * 4 );
+	in.targa = BenchAlloc<byte>( BENCH_PIXELS * 3 );
+	for ( int i = 0; i < BENCH_IMAGE; i++ ) {
+		for ( int j = 0; j < BENCH_IMAGE; j++ ) {
+			for ( int c = 0; c < 4; c++ ) {
+				int val = ( ( i * ( c + 1 ) + j * ( 3 - c ) ) >> 1 ) + rnd.RandomInt( 16 );
+				in.image[( i * BENCH_IMAGE + j ) * 4 + c] = idMath::ClampInt( 0, 255, val );
+			}
+			for ( int c = 0; c < 3; c++ ) {
+				in.targa[( i * BENCH_IMAGE + j ) * 3 + c] = in.image[( i * BENCH_IMAGE + j ) * 4 + 2 - c];
+			}
+		}
+	}
+	in.dxt1 = BenchAlloc<byte>( BENCH_PIXELS / 2 );
+	in.dxt5 = BenchAlloc<byte>( BENCH_PIXELS );
+	in.rgtc = BenchAlloc<byte>( BENCH_PIXELS );
+	generic->CompressDXT1FromRGBA8( in.image, BENCH_IMAGE, BENCH_IMAGE, BENCH_IMAGE * 4, in.dxt1 );
+	generic->CompressDXT5FromRGBA8( in.image, BENCH_IMAGE, BENCH_IMAGE, BENCH_IMAGE * 4, in.dxt5 );
+	generic->CompressRGTCFromRGBA8( in.image, BENCH_IMAGE, BENCH_IMAGE, BENCH_IMAGE * 4, in.rgtc );
+
+	in.pcm = BenchAlloc<short>( BENCH_MIX * 2 );
+	in.ogg[0] = BenchAlloc<float>( BENCH_MIX );
+	in.ogg[1] = BenchAlloc<float>( BENCH_MIX );
+	in.samples = BenchAlloc<float>( BENCH_MIX * 2 );
+	in.mixBase = BenchAlloc<float>( BENCH_MIX * 6 );
+	in.mixed = BenchAlloc<float>( BENCH_MIX * 2 );
+	for ( int i = 0; i < BENCH_MIX * 2; i++ ) {
+		in.pcm[i] = rnd.RandomInt( 1 << 16 ) - ( 1 << 15 );
+		in.samples[i] = rnd.CRandomFloat() * 32768.0f;
+		// some samples are clamped
+		in.mixed[i] = rnd.CRandomFloat() * 40000.0f;
+	}
+	for ( int i = 0; i < BENCH_MIX; i++ ) {
+		in.ogg[0][i] = rnd.CRandomFloat();
+		in.ogg[1][i] = rnd.CRandomFloat();
+	}
+	for ( int i = 0; i < BENCH_MIX * 6; i++ ) {
+		in.mixBase[i] = rnd.CRandomFloat() * 32768.0f;
+	}
+	for ( int i = 0; i < 6; i++ ) {
+		in.lastV[i] = rnd.RandomFloat();
+		in.currentV[i] = rnd.RandomFloat();
+	}
+}
+
+static void FreeBenchInput( simdBenchInput_t &in ) {
+	void *buffers[] = {
+		in.f0, in.f1, in.f2, in.v2, in.v3a, in.v3b, in.planes,
+		in.verts, in.indexes, in.dominantTris, in.shadowRemap,
+		in.quats, in.blendQuats, in.jointIndex, in.localMats, in.modelMats, in.parents, in.weights, in.weightIndex,
+		in.image, in.targa, in.dxt1, in.dxt5, in.rgtc,
+		in.pcm, in.ogg[0], in.ogg[1], in.samples, in.mixBase, in.mixed
+	};
+	for ( int i = 0; i < (int)( sizeof( buffers ) / sizeof( buffers[0] ) ); i++ ) {
+		Mem_Free16( buffers[i] );
+	}
+}
+
+static void InitBenchOutput( simdBenchOutput_t &out ) {
+	out.floats = BenchAlloc<float>( Max( BENCH_MIX * 6, BENCH_FLOATS ) );
+	out.bytes = BenchAlloc<byte>( BENCH_PIXELS * 4 );
+	out.shorts = BenchAlloc<unsigned short>( Max( BENCH_MIX * 2, BENCH_VERTS ) );
+	out.vec2s = BenchAlloc<idVec2>( BENCH_VERTS );
+	out.vec4s = BenchAlloc<idVec4>( BENCH_VERTS * 2 );
+	out.ints = BenchAlloc<int>( BENCH_VERTS );
+	out.planes = BenchAlloc<idPlane>( BENCH_TRIS );
+	out.verts = BenchAlloc<idDrawVert>( BENCH_VERTS );
+	out.quats = BenchAlloc<idJointQuat>( BENCH_JOINTS );
+	out.mats = BenchAlloc<idJointMat>( BENCH_JOINTS );
+	memset( out.scalars, 0, sizeof( out.scalars ) );
+	out.result = 0;
+}
+
+static void FreeBenchOutput( simdBenchOutput_t &out ) {
+	void *buffers[] = { out.floats, out.bytes, out.shorts, out.vec2s, out.vec4s, out.ints, out.planes, out.verts, out.quats, out.mats };
+	for ( int i = 0; i < (int)( sizeof( buffers ) / sizeof( buffers[0] ) ); i++ ) {
+		Mem_Free16( buffers[i] );
+	}
+}
+
+/*
+============
+Test cases
+============
+*/
+static float CheckFloats( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return FloatError( r.floats, t.floats, BENCH_FLOATS ); }
+static float CheckDots( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return FloatError( r.floats, t.floats, BENCH_VERTS ); }
+static float CheckScalars( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return FloatError( r.scalars, t.scalars, 8 ); }
+static float CheckCmp( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return ByteError( r.bytes, t.bytes, BENCH_FLOATS ); }
+static float CheckMemory( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return ByteError( r.bytes, t.bytes, BENCH_PIXELS * 4 ); }
+static float CheckVec( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return FloatError( r.vec.ToFloatPtr(), t.vec.ToFloatPtr(), r.vec.GetSize() ); }
+static float CheckMat( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return FloatError( r.mat.ToFloatPtr(), t.mat.ToFloatPtr(), r.mat.GetNumRows() * r.mat.GetNumColumns() ); }
+static float CheckSolve( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return FloatError( r.floats, t.floats, BENCH_MATX ); }
+static float CheckLDLT( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return Max( Max( CheckMat( r, t ), CheckVec( r, t ) ), ResultError( r, t ) ); }
+static float CheckQuats( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return FloatError( r.quats[0].q.ToFloatPtr(), t.quats[0].q.ToFloatPtr(), BENCH_JOINTS * 7 ); }
+static float CheckMats( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return FloatError( r.mats[0].ToFloatPtr(), t.mats[0].ToFloatPtr(), BENCH_JOINTS * 12 ); }
+static float CheckVerts( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return VertError( r.verts, t.verts, BENCH_VERTS ); }
+static float CheckCullBits( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return Max( ByteError( r.bytes, t.bytes, BENCH_VERTS ), ResultError( r, t ) ); }
+static float CheckOverlay( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return Max( CheckCullBits( r, t ), FloatError( r.vec2s[0].ToFloatPtr(), t.vec2s[0].ToFloatPtr(), BENCH_VERTS * 2 ) ); }
+static float CheckFacing( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return ByteError( r.bytes, t.bytes, BENCH_TRIS ); }
+static float CheckPlanes( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return FloatError( r.planes[0].ToFloatPtr(), t.planes[0].ToFloatPtr(), BENCH_TRIS * 4 ); }
+static float CheckTangents( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return Max( CheckPlanes( r, t ), CheckVerts( r, t ) ); }
+static float CheckVertexCache( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) {
+	if ( r.result != t.result ) {
+		return idMath::INFINITY;
+	}
+	return FloatError( r.vec4s[0].ToFloatPtr(), t.vec4s[0].ToFloatPtr(), r.result * 4 );
+}
+static float CheckShadowCache( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return Max( CheckVertexCache( r, t ), ByteError( (byte *)r.ints, (byte *)t.ints, BENCH_VERTS * sizeof( int ) ) ); }
+static float CheckFrustum2( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return ByteError( (byte *)r.shorts, (byte *)t.shorts, BENCH_VERTS * 2 ); }
+static float CheckMipMap( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return ByteError( r.bytes, t.bytes, BENCH_PIXELS ); }
+static float CheckDXT1( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return ByteError( r.bytes, t.bytes, BENCH_PIXELS / 2 ); }
+static float CheckDXT5( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return ByteError( r.bytes, t.bytes, BENCH_PIXELS ); }
+static float CheckOneSpeaker( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return FloatError( r.floats, t.floats, BENCH_MIX ); }
+static float CheckTwoSpeakers( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return FloatError( r.floats, t.floats, BENCH_MIX * 2 ); }
+static float CheckSixSpeakers( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return FloatError( r.floats, t.floats, BENCH_MIX * 6 ); }
+static float CheckSamples( const simdBenchOutput_t &r, const simdBenchOutput_t &t ) { return ShortError( (short *)r.shorts, (short *)t.shorts, BENCH_MIX * 2 ); }
+
+static void CopyF0( const simdBenchInput_t &in, simdBenchOutput_t &out ) { memcpy( out.floats, in.f0, BENCH_FLOATS * sizeof( float ) ); }
+static void CopyF2( const simdBenchInput_t &in, simdBenchOutput_t &out ) { memcpy( out.floats, in.f2, BENCH_FLOATS * sizeof( float ) ); }
+static void FillBytes( const simdBenchInput_t &in, simdBenchOutput_t &out ) { memset( out.bytes, 0x0F, BENCH_FLOATS ); }
+static void CopyVec1( const simdBenchInput_t &in, simdBenchOutput_t &out ) { out.vec = in.vec1; }
+static void SizeMat( const simdBenchInput_t &in, simdBenchOutput_t &out ) { out.mat.SetSize( BENCH_MATX, BENCH_MATX ); }
+static void CopySPD( const simdBenchInput_t &in, simdBenchOutput_t &out ) { out.mat = in.spd; out.vec.SetSize( BENCH_MATX ); }
+static void CopyQuats( const simdBenchInput_t &in, simdBenchOutput_t &out ) { memcpy( out.quats, in.quats, BENCH_JOINTS * sizeof( idJointQuat ) ); }
+static void CopyLocalMats( const simdBenchInput_t &in, simdBenchOutput_t &out ) { memcpy( out.mats, in.localMats, BENCH_JOINTS * sizeof( idJointMat ) ); }
+static void CopyModelMats( const simdBenchInput_t &in, simdBenchOutput_t &out ) { memcpy( out.mats, in.modelMats, BENCH_JOINTS * sizeof( idJointMat ) ); }
+static void CopyVerts( const simdBenchInput_t &in, simdBenchOutput_t &out ) { memcpy( out.verts, in.verts, BENCH_VERTS * sizeof( idDrawVert ) ); }
+static void CopyRemap( const simdBenchInput_t &in, simdBenchOutput_t &out ) { memcpy( out.ints, in.shadowRemap, BENCH_VERTS * sizeof( int ) ); }
+static void CopyMix( const simdBenchInput_t &in, simdBenchOutput_t &out ) { memcpy( out.floats, in.mixBase, BENCH_MIX * 6 * sizeof( float ) ); }
+
+#define BENCH_RUN( code )	[]( idSIMDProcessor *p, const simdBenchInput_t &in, simdBenchOutput_t &out ) { code; }
+
+static const simdBenchCase_t benchCases[] = {
+	{ "Add(const)",						"math",		BENCH_FLOATS,	1e-5f,	nullptr,		BENCH_RUN( p->Add( out.floats, 3.0f, in.f0, BENCH_FLOATS ) ),						CheckFloats },
+	{ "Add",							"math",		BENCH_FLOATS,	1e-5f,	nullptr,		BENCH_RUN( p->Add( out.floats, in.f0, in.f1, BENCH_FLOATS ) ),						CheckFloats },
+	{ "Sub(const)",						"math",		BENCH_FLOATS,	1e-5f,	nullptr,		BENCH_RUN( p->Sub( out.floats, 3.0f, in.f0, BENCH_FLOATS ) ),						CheckFloats },
+	{ "Sub",							"math",		BENCH_FLOATS,	1e-5f,	nullptr,		BENCH_RUN( p->Sub( out.floats, in.f0, in.f1, BENCH_FLOATS ) ),						CheckFloats },
+	{ "Mul(const)",						"math",		BENCH_FLOATS,	1e-5f,	nullptr,		BENCH_RUN( p->Mul( out.floats, 3.0f, in.f0, BENCH_FLOATS ) ),						CheckFloats },
+	{ "Mul",							"math",		BENCH_FLOATS,	1e-5f,	nullptr,		BENCH_RUN( p->Mul( out.floats, in.f0, in.f1, BENCH_FLOATS ) ),						CheckFloats },
+	{ "Div(const)",						"math",		BENCH_FLOATS,	1e-3f,	nullptr,		BENCH_RUN( p->Div( out.floats, 3.0f, in.f1, BENCH_FLOATS ) ),						CheckFloats },
+	{ "Div",							"math",		BENCH_FLOATS,	1e-3f,	nullptr,		BENCH_RUN( p->Div( out.floats, in.f0, in.f1, BENCH_FLOATS ) ),						CheckFloats },
+	{ "MulAdd(const)",					"math",		BENCH_FLOATS,	1e-5f,	CopyF2,			BENCH_RUN( p->MulAdd( out.floats, 3.0f, in.f0, BENCH_FLOATS ) ),					CheckFloats },
+	{ "MulAdd",							"math",		BENCH_FLOATS,	1e-5f,	CopyF2,			BENCH_RUN( p->MulAdd( out.floats, in.f0, in.f1, BENCH_FLOATS ) ),					CheckFloats },
+	{ "MulSub(const)",					"math",		BENCH_FLOATS,	1e-5f,	CopyF2,			BENCH_RUN( p->MulSub( out.floats, 3.0f, in.f0, BENCH_FLOATS ) ),					CheckFloats },
+	{ "MulSub",							"math",		BENCH_FLOATS,	1e-5f,	CopyF2,			BENCH_RUN( p->MulSub( out.floats, in.f0, in.f1, BENCH_FLOATS ) ),					CheckFloats },
+	{ "Dot(vec3,vec3[])",				"math",		BENCH_VERTS,	1e-5f,	nullptr,		BENCH_RUN( p->Dot( out.floats, in.vec3, in.v3a, BENCH_VERTS ) ),					CheckDots },
+	{ "Dot(vec3,plane[])",				"math",		BENCH_VERTS,	1e-5f,	nullptr,		BENCH_RUN( p->Dot( out.floats, in.vec3, in.planes, BENCH_VERTS ) ),					CheckDots },
+	{ "Dot(vec3,drawVert[])",			"math",		BENCH_VERTS,	1e-5f,	nullptr,		BENCH_RUN( p->Dot( out.floats, in.vec3, in.verts, BENCH_VERTS ) ),					CheckDots },
+	{ "Dot(plane,vec3[])",				"math",		BENCH_VERTS,	1e-5f,	nullptr,		BENCH_RUN( p->Dot( out.floats, in.plane, in.v3a, BENCH_VERTS ) ),					CheckDots },
+	{ "Dot(plane,plane[])",				"math",		BENCH_VERTS,	1e-5f,	nullptr,		BENCH_RUN( p->Dot( out.floats, in.plane, in.planes, BENCH_VERTS ) ),				CheckDots },
+	{ "Dot(plane,drawVert[])",			"math",		BENCH_VERTS,	1e-5f,	nullptr,		BENCH_RUN( p->Dot( out.floats, in.plane, in.verts, BENCH_VERTS ) ),					CheckDots },
+	{ "Dot(vec3[],vec3[])",				"math",		BENCH_VERTS,	1e-5f,	nullptr,		BENCH_RUN( p->Dot( out.floats, in.v3a, in.v3b, BENCH_VERTS ) ),						CheckDots },
+	{ "Dot(float[],float[])",			"math",		BENCH_FLOATS,	1e-4f,	nullptr,		BENCH_RUN( p->Dot( out.scalars[0], in.f1, in.f2, BENCH_FLOATS ) ),					CheckScalars },
+	{ "CmpGT",							"math",		BENCH_FLOATS,	0.0f,	nullptr,		BENCH_RUN( p->CmpGT( out.bytes, in.f0, 1.0f, BENCH_FLOATS ) ),						CheckCmp },
+	{ "CmpGT(bitNum)",					"math",		BENCH_FLOATS,	0.0f,	FillBytes,		BENCH_RUN( p->CmpGT( out.bytes, 5, in.f0, 1.0f, BENCH_FLOATS ) ),					CheckCmp },
+	{ "CmpGE",							"math",		BENCH_FLOATS,	0.0f,	nullptr,		BENCH_RUN( p->CmpGE( out.bytes, in.f0, 1.0f, BENCH_FLOATS ) ),						CheckCmp },
+	{ "CmpGE(bitNum)",					"math",		BENCH_FLOATS,	0.0f,	FillBytes,		BENCH_RUN( p->CmpGE( out.bytes, 5, in.f0, 1.0f, BENCH_FLOATS ) ),					CheckCmp },
+	{ "CmpLT",							"math",		BENCH_FLOATS,	0.0f,	nullptr,		BENCH_RUN( p->CmpLT( out.bytes, in.f0, 1.0f, BENCH_FLOATS ) ),						CheckCmp },
+	{ "CmpLT(bitNum)",					"math",		BENCH_FLOATS,	0.0f,	FillBytes,		BENCH_RUN( p->CmpLT( out.bytes, 5, in.f0, 1.0f, BENCH_FLOATS ) ),					CheckCmp },
+	{ "CmpLE",							"math",		BENCH_FLOATS,	0.0f,	nullptr,		BENCH_RUN( p->CmpLE( out.bytes, in.f0, 1.0f, BENCH_FLOATS ) ),						CheckCmp },
+	{ "CmpLE(bitNum)",					"math",		BENCH_FLOATS,	0.0f,	FillBytes,		BENCH_RUN( p->CmpLE( out.bytes, 5, in.f0, 1.0f, BENCH_FLOATS ) ),					CheckCmp },
+	{ "MinMax(float[])",				"math",		BENCH_FLOATS,	0.0f,	nullptr,		BENCH_RUN( p->MinMax( out.scalars[0], out.scalars[1], in.f0, BENCH_FLOATS ) ),		CheckScalars },
+	{ "MinMax(vec2[])",					"math",		BENCH_VERTS,	0.0f,	nullptr,		BENCH_RUN( p->MinMax( *(idVec2 *)&out.scalars[0], *(idVec2 *)&out.scalars[2], in.v2, BENCH_VERTS ) ),			CheckScalars },
+	{ "MinMax(vec3[])",					"math",		BENCH_VERTS,	0.0f,	nullptr,		BENCH_RUN( p->MinMax( *(idVec3 *)&out.scalars[0], *(idVec3 *)&out.scalars[3], in.v3a, BENCH_VERTS ) ),			CheckScalars },
+	{ "MinMax(drawVert[])",				"math",		BENCH_VERTS,	0.0f,	nullptr,		BENCH_RUN( p->MinMax( *(idVec3 *)&out.scalars[0], *(idVec3 *)&out.scalars[3], in.verts, BENCH_VERTS ) ),		CheckScalars },
+	{ "MinMax(drawVert[],indexes)",		"math",		BENCH_INDEXES,	0.0f,	nullptr,		BENCH_RUN( p->MinMax( *(idVec3 *)&out.scalars[0], *(idVec3 *)&out.scalars[3], in.verts, in.indexes, BENCH_INDEXES ) ),	CheckScalars },
+	{ "Clamp",							"math",		BENCH_FLOATS,	0.0f,	nullptr,		BENCH_RUN( p->Clamp( out.floats, in.f0, -5.0f, 5.0f, BENCH_FLOATS ) ),				CheckFloats },
+	{ "ClampMin",						"math",		BENCH_FLOATS,	0.0f,	nullptr,		BENCH_RUN( p->ClampMin( out.floats, in.f0, -5.0f, BENCH_FLOATS ) ),					CheckFloats },
+	{ "ClampMax",						"math",		BENCH_FLOATS,	0.0f,	nullptr,		BENCH_RUN( p->ClampMax( out.floats, in.f0, 5.0f, BENCH_FLOATS ) ),					CheckFloats },
+
+	{ "Memcpy",							"memory",	BENCH_PIXELS * 4,	0.0f,	nullptr,	BENCH_RUN( p->Memcpy( out.bytes, in.image, BENCH_PIXELS * 4 ) ),					CheckMemory },
+	{ "Memset",							"memory",	BENCH_PIXELS * 4,	0.0f,	nullptr,	BENCH_RUN( p->Memset( out.bytes, 0x7F, BENCH_PIXELS * 4 ) ),						CheckMemory },
+	{ "Zero16",							"memory",	BENCH_FLOATS,	0.0f,	CopyF0,			BENCH_RUN( p->Zero16( out.floats, BENCH_FLOATS ) ),									CheckFloats },
+	{ "Negate16",						"memory",	BENCH_FLOATS,	0.0f,	CopyF0,			BENCH_RUN( p->Negate16( out.floats, BENCH_FLOATS ) ),								CheckFloats },
+	{ "Copy16",							"memory",	BENCH_FLOATS,	0.0f,	nullptr,		BENCH_RUN( p->Copy16( out.floats, in.f0, BENCH_FLOATS ) ),							CheckFloats },
+	{ "Add16",							"memory",	BENCH_FLOATS,	1e-5f,	nullptr,		BENCH_RUN( p->Add16( out.floats, in.f0, in.f1, BENCH_FLOATS ) ),					CheckFloats },
+	{ "Sub16",							"memory",	BENCH_FLOATS,	1e-5f,	nullptr,		BENCH_RUN( p->Sub16( out.floats, in.f0, in.f1, BENCH_FLOATS ) ),					CheckFloats },
+	{ "Mul16",							"memory",	BENCH_FLOATS,	1e-5f,	nullptr,		BENCH_RUN( p->Mul16( out.floats, in.f0, 3.0f, BENCH_FLOATS ) ),						CheckFloats },
+	{ "AddAssign16",					"memory",	BENCH_FLOATS,	1e-5f,	CopyF0,			BENCH_RUN( p->AddAssign16( out.floats, in.f1, BENCH_FLOATS ) ),						CheckFloats },
+	{ "SubAssign16",					"memory",	BENCH_FLOATS,	1e-5f,	CopyF0,			BENCH_RUN( p->SubAssign16( out.floats, in.f1, BENCH_FLOATS ) ),						CheckFloats },
+	{ "MulAssign16",					"memory",	BENCH_FLOATS,	1e-5f,	CopyF0,			BENCH_RUN( p->MulAssign16( out.floats, 3.0f, BENCH_FLOATS ) ),						CheckFloats },
+
+	{ "MatX_MultiplyVecX",				"matrix",	BENCH_MATX * BENCH_MATX,	1e-5f,	CopyVec1,	BENCH_RUN( p->MatX_MultiplyVecX( out.vec, in.mat, in.vec0 ) ),						CheckVec },
+	{ "MatX_MultiplyAddVecX",			"matrix",	BENCH_MATX * BENCH_MATX,	1e-5f,	CopyVec1,	BENCH_RUN( p->MatX_MultiplyAddVecX( out.vec, in.mat, in.vec0 ) ),					CheckVec },
+	{ "MatX_MultiplySubVecX",			"matrix",	BENCH_MATX * BENCH_MATX,	1e-5f,	CopyVec1,	BENCH_RUN( p->MatX_MultiplySubVecX( out.vec, in.mat, in.vec0 ) ),					CheckVec },
+	{ "MatX_TransposeMultiplyVecX",		"matrix",	BENCH_MATX * BENCH_MATX,	1e-5f,	CopyVec1,	BENCH_RUN( p->MatX_TransposeMultiplyVecX( out.vec, in.mat, in.vec0 ) ),				CheckVec },
+	{ "MatX_TransposeMultiplyAddVecX",	"matrix",	BENCH_MATX * BENCH_MATX,	1e-5f,	CopyVec1,	BENCH_RUN( p->MatX_TransposeMultiplyAddVecX( out.vec, in.mat, in.vec0 ) ),			CheckVec },
+	{ "MatX_TransposeMultiplySubVecX",	"matrix",	BENCH_MATX * BENCH_MATX,	1e-5f,	CopyVec1,	BENCH_RUN( p->MatX_TransposeMultiplySubVecX( out.vec, in.mat, in.vec0 ) ),			CheckVec },
+	{ "MatX_MultiplyMatX",				"matrix",	BENCH_MATX * BENCH_MATX,	1e-4f,	SizeMat,		BENCH_RUN( p->MatX_MultiplyMatX( out.mat, in.mat, in.spd ) ),						CheckMat },
+	{ "MatX_TransposeMultiplyMatX",		"matrix",	BENCH_MATX * BENCH_MATX,	1e-4f,	SizeMat,		BENCH_RUN( p->MatX_TransposeMultiplyMatX( out.mat, in.mat, in.spd ) ),				CheckMat },
+	{ "MatX_LowerTriangularSolve",		"matrix",	BENCH_MATX * BENCH_MATX,	1e-3f,	nullptr,		BENCH_RUN( p->MatX_LowerTriangularSolve( in.ldlt, out.floats, in.vec0.ToFloatPtr(), BENCH_MATX ) ),			CheckSolve },
+	{ "MatX_LowerTriangularSolveTranspose",	"matrix",	BENCH_MATX * BENCH_MATX,	1e-3f,	nullptr,	BENCH_RUN( p->MatX_LowerTriangularSolveTranspose( in.ldlt, out.floats, in.vec0.ToFloatPtr(), BENCH_MATX ) ),	CheckSolve },
+	{ "MatX_LDLTFactor",				"matrix",	BENCH_MATX * BENCH_MATX,	1e-3f,	CopySPD,		BENCH_RUN( out.result = p->MatX_LDLTFactor( out.mat, out.vec, BENCH_MATX ) ),		CheckLDLT },
+
+	{ "BlendJoints",					"render",	BENCH_JOINTS,	1e-2f,	CopyQuats,		BENCH_RUN( p->BlendJoints( out.quats, in.blendQuats, 0.3f, in.jointIndex, BENCH_JOINTS ) ),			CheckQuats },
+	{ "ConvertJointQuatsToJointMats",	"render",	BENCH_JOINTS,	1e-4f,	nullptr,		BENCH_RUN( p->ConvertJointQuatsToJointMats( out.mats, in.quats, BENCH_JOINTS ) ),					CheckMats },
+	{ "ConvertJointMatsToJointQuats",	"render",	BENCH_JOINTS,	1e-4f,	nullptr,		BENCH_RUN( p->ConvertJointMatsToJointQuats( out.quats, in.localMats, BENCH_JOINTS ) ),				CheckQuats },
+	{ "TransformJoints",				"render",	BENCH_JOINTS,	1e-3f,	CopyLocalMats,	BENCH_RUN( p->TransformJoints( out.mats, in.parents, 1, BENCH_JOINTS - 1 ) ),						CheckMats },
+	{ "UntransformJoints",				"render",	BENCH_JOINTS,	1e-3f,	CopyModelMats,	BENCH_RUN( p->UntransformJoints( out.mats, in.parents, 1, BENCH_JOINTS - 1 ) ),						CheckMats },
+	{ "TransformVerts",					"render",	BENCH_VERTS,	1e-3f,	CopyVerts,		BENCH_RUN( p->TransformVerts( out.verts, BENCH_VERTS, in.modelMats, in.weights, in.weightIndex, in.numWeights ) ),	CheckVerts },
+	{ "TracePointCull",					"render",	BENCH_VERTS,	0.0f,	nullptr,		BENCH_RUN( byte totalOr = 0; p->TracePointCull( out.bytes, totalOr, 1.0f, in.cullPlanes, in.verts, BENCH_VERTS ); out.result = totalOr ),	CheckCullBits },
+	{ "DecalPointCull",					"render",	BENCH_VERTS,	0.0f,	nullptr,		BENCH_RUN( p->DecalPointCull( out.bytes, in.cullPlanes, in.verts, BENCH_VERTS ) ),					CheckCullBits },
+	{ "OverlayPointCull",				"render",	BENCH_VERTS,	1e-4f,	nullptr,		BENCH_RUN( p->OverlayPointCull( out.bytes, out.vec2s, in.cullPlanes, in.verts, BENCH_VERTS ) ),		CheckOverlay },
+	{ "CalcTriFacing",					"render",	BENCH_TRIS,		0.0f,	nullptr,		BENCH_RUN( p->CalcTriFacing( in.verts, BENCH_VERTS, in.indexes, BENCH_INDEXES, in.lightOrigin, out.bytes ) ),	CheckFacing },
+	{ "DeriveTriPlanes",				"render",	BENCH_TRIS,		1e-1f,	nullptr,		BENCH_RUN( p->DeriveTriPlanes( out.planes, in.verts, BENCH_VERTS, in.indexes, BENCH_INDEXES ) ),	CheckPlanes },
+	{ "DeriveTangents",					"render",	BENCH_TRIS,		1e-1f,	CopyVerts,		BENCH_RUN( p->DeriveTangents( out.planes, out.verts, BENCH_VERTS, in.indexes, BENCH_INDEXES ) ),	CheckTangents },
+	{ "DeriveUnsmoothedTangents",		"render",	BENCH_VERTS,	1e-1f,	CopyVerts,		BENCH_RUN( p->DeriveUnsmoothedTangents( out.verts, in.dominantTris, BENCH_VERTS ) ),				CheckVerts },
+	{ "NormalizeTangents",				"render",	BENCH_VERTS,	1e-2f,	CopyVerts,		BENCH_RUN( p->NormalizeTangents( out.verts, BENCH_VERTS ) ),										CheckVerts },
+	{ "CreateShadowCache",				"render",	BENCH_VERTS,	1e-2f,	CopyRemap,		BENCH_RUN( out.result = p->CreateShadowCache( out.vec4s, out.ints, in.lightOrigin, in.verts, BENCH_VERTS ) ),	CheckShadowCache },
+	{ "CreateVertexProgramShadowCache",	"render",	BENCH_VERTS,	1e-2f,	nullptr,		BENCH_RUN( out.result = p->CreateVertexProgramShadowCache( out.vec4s, in.verts, BENCH_VERTS ) ),	CheckVertexCache },
+	{ "CullByFrustum",					"render",	BENCH_VERTS,	0.0f,	nullptr,		BENCH_RUN( p->CullByFrustum( in.verts, BENCH_VERTS, in.cullPlanes, out.bytes, 0.1f ) ),			CheckCullBits },
+	{ "CullByFrustum2",					"render",	BENCH_VERTS,	0.0f,	nullptr,		BENCH_RUN( p->CullByFrustum2( in.verts, BENCH_VERTS, in.cullPlanes, out.shorts, 0.1f ) ),			CheckFrustum2 },
+
+	{ "GenerateMipMap2x2",				"image",	BENCH_PIXELS,	0.0f,	nullptr,		BENCH_RUN( p->GenerateMipMap2x2( in.image, BENCH_IMAGE * 4, BENCH_IMAGE / 2, BENCH_IMAGE / 2, out.bytes, BENCH_IMAGE * 2 ) ),	CheckMipMap },
+	{ "CompressRGTCFromRGBA8",			"image",	BENCH_PIXELS,	0.0f,	nullptr,		BENCH_RUN( p->CompressRGTCFromRGBA8( in.image, BENCH_IMAGE, BENCH_IMAGE, BENCH_IMAGE * 4, out.bytes ) ),	CheckDXT5 },
+	{ "CompressDXT1FromRGBA8",			"image",	BENCH_PIXELS,	0.0f,	nullptr,		BENCH_RUN( p->CompressDXT1FromRGBA8( in.image, BENCH_IMAGE, BENCH_IMAGE, BENCH_IMAGE * 4, out.bytes ) ),	CheckDXT1 },
+	{ "CompressDXT5FromRGBA8",			"image",	BENCH_PIXELS,	0.0f,	nullptr,		BENCH_RUN( p->CompressDXT5FromRGBA8( in.image, BENCH_IMAGE, BENCH_IMAGE, BENCH_IMAGE * 4, out.bytes ) ),	CheckDXT5 },
+	{ "ConvertTargaRowToRGBA8",			"image",	BENCH_PIXELS,	0.0f,	nullptr,		BENCH_RUN(
+		for ( int row = 0; row < BENCH_IMAGE; row++ ) {
+			p->ConvertTargaRowToRGBA8( in.targa + row * BENCH_IMAGE * 3, BENCH_IMAGE, 24, out.bytes + row * BENCH_IMAGE * 4 );
+		} ),																																								CheckMemory },
+	{ "DecompressRGBA8FromDXT1",		"image",	BENCH_PIXELS,	1.0f,	nullptr,		BENCH_RUN( p->DecompressRGBA8FromDXT1( in.dxt1, BENCH_IMAGE, BENCH_IMAGE, out.bytes, BENCH_IMAGE * 4, true ) ),	CheckMemory },
+	{ "DecompressRGBA8FromDXT3",		"image",	BENCH_PIXELS,	1.0f,	nullptr,		BENCH_RUN( p->DecompressRGBA8FromDXT3( in.dxt5, BENCH_IMAGE, BENCH_IMAGE, out.bytes, BENCH_IMAGE * 4 ) ),		CheckMemory },
+	{ "DecompressRGBA8FromDXT5",		"image",	BENCH_PIXELS,	1.0f,	nullptr,		BENCH_RUN( p->DecompressRGBA8FromDXT5( in.dxt5, BENCH_IMAGE, BENCH_IMAGE, out.bytes, BENCH_IMAGE * 4 ) ),		CheckMemory },
+	{ "DecompressRGBA8FromRGTC",		"image",	BENCH_PIXELS,	1.0f,	nullptr,		BENCH_RUN( p->DecompressRGBA8FromRGTC( in.rgtc, BENCH_IMAGE, BENCH_IMAGE, out.bytes, BENCH_IMAGE * 4 ) ),		CheckMemory },
+
+	{ "UpSamplePCMTo44kHz(22kHz,stereo)",	"sound",	BENCH_MIX * 2,	1e-3f,	nullptr,	BENCH_RUN( p->UpSamplePCMTo44kHz( out.floats, in.pcm, BENCH_MIX, 22050, 2 ) ),				CheckTwoSpeakers },
+	{ "UpSamplePCMTo44kHz(44kHz,mono)",		"sound",	BENCH_MIX,		1e-3f,	nullptr,	BENCH_RUN( p->UpSamplePCMTo44kHz( out.floats, in.pcm, BENCH_MIX, 44100, 1 ) ),				CheckOneSpeaker },
+	{ "UpSampleOGGTo44kHz(11kHz,mono)",		"sound",	BENCH_MIX,		1e-3f,	nullptr,	BENCH_RUN( p->UpSampleOGGTo44kHz( out.floats, in.ogg, BENCH_MIX / 4, 11025, 1 ) ),			CheckOneSpeaker },
+	{ "UpSampleOGGTo44kHz(44kHz,stereo)",	"sound",	BENCH_MIX * 2,	1e-3f,	nullptr,	BENCH_RUN( p->UpSampleOGGTo44kHz( out.floats, in.ogg, BENCH_MIX * 2, 44100, 2 ) ),			CheckTwoSpeakers },
+	{ "MixSoundTwoSpeakerMono",			"sound",	BENCH_MIX,		1e-4f,	CopyMix,		BENCH_RUN( p->MixSoundTwoSpeakerMono( out.floats, in.samples, BENCH_MIX, in.lastV, in.currentV ) ),		CheckTwoSpeakers },
+	{ "MixSoundTwoSpeakerStereo",		"sound",	BENCH_MIX,		1e-4f,	CopyMix,		BENCH_RUN( p->MixSoundTwoSpeakerStereo( out.floats, in.samples, BENCH_MIX, in.lastV, in.currentV ) ),	CheckTwoSpeakers },
+	{ "MixSoundSixSpeakerMono",			"sound",	BENCH_MIX,		1e-4f,	CopyMix,		BENCH_RUN( p->MixSoundSixSpeakerMono( out.floats, in.samples, BENCH_MIX, in.lastV, in.currentV ) ),		CheckSixSpeakers },
+	{ "MixSoundSixSpeakerStereo",		"sound",	BENCH_MIX,		1e-4f,	CopyMix,		BENCH_RUN( p->MixSoundSixSpeakerStereo( out.floats, in.samples, BENCH_MIX, in.lastV, in.currentV ) ),	CheckSixSpeakers },
+	{ "MixedSoundToSamples",			"sound",	BENCH_MIX * 2,	1.0f,	nullptr,		BENCH_RUN( p->MixedSoundToSamples( (short *)out.shorts, in.mixed, BENCH_MIX * 2 ) ),					CheckSamples },
+};
+
+#undef BENCH_RUN
+
+/*
+============
+CreateBenchProcessors
+
+All processors which can run on this CPU, generic one goes first.
+============
+*/
+static void CreateBenchProcessors( idList<idSIMDProcessor *> &processors ) {
+	int cpuid = idSIMD::GetCpuid();
+
+	processors.Append( new idSIMD_Generic );
+	processors[0]->cpuid = CPUID_GENERIC;
+
+#ifdef ENABLE_SSE_PROCESSORS
+	bool upToSSE = ( cpuid & CPUID_SSE );
+	bool upToSSE2 = upToSSE && ( cpuid & CPUID_SSE2 );
+	bool upToSSE3 = upToSSE2 && ( cpuid & CPUID_SSE3 );
+	bool upToSSSE3 = upToSSE3 && ( cpuid & CPUID_SSSE3 );
+	bool upToSSE41 = upToSSSE3 && ( cpuid & CPUID_SSE41 );
+	bool upToAVX = upToSSE41 && ( cpuid & CPUID_AVX );
+	bool upToAVX2 = upToAVX && ( cpuid & CPUID_AVX2 ) && ( cpuid & CPUID_FMA3 );
+
+	if ( upToSSE ) {
+		processors.Append( new idSIMD_SSE );
+	}
+	if ( upToSSE2 ) {
+		processors.Append( new idSIMD_SSE2 );
+	}
+#if defined(_MSC_VER) && defined(_M_IX86)
+	if ( upToSSE3 ) {
+		processors.Append( new idSIMD_IdAsm );
+	}
+#endif
+	if ( upToSSSE3 ) {
+		processors.Append( new idSIMD_SSSE3 );
+	}
+	if ( upToAVX ) {
+		processors.Append( new idSIMD_AVX );
+	}
+	if ( upToAVX2 ) {
+		processors.Append( new idSIMD_AVX2 );
+	}
+	for ( int i = 1; i < processors.Num(); i++ ) {
+		processors[i]->cpuid = (cpuid_t)cpuid;
+	}
+#endif
+}
+
+/*
+============
+RunBenchCase
+
+Returns timings of all calls, output of the last one is left in out.
+============
+*/
+static void RunBenchCase( const simdBenchCase_t &test, idSIMDProcessor *p, const simdBenchInput_t &in, simdBenchOutput_t &out, double minTicks, idList<double> &samples ) {
+	static const int MIN_RUNS = 5;
+	static const int MAX_RUNS = 1000;
+
+	// outputs which are not written by the function must not differ
+	memset( out.scalars, 0, sizeof( out.scalars ) );
+	out.result = 0;
+
+	samples.SetNum( 0, false );
+	double total = 0.0;
+	for ( int i = 0; i < MAX_RUNS && ( i < MIN_RUNS || total < minTicks ); i++ ) {
+		if ( test.prepare ) {
+			test.prepare( in, out );
+		}
+		double start = idLib::sys->GetClockTicks();
+		test.run( p, in, out );
+		double end = idLib::sys->GetClockTicks();
+		samples.Append( end - start );
+		total += end - start;
+	}
+}
+
+static int CompareTicks( const double *a, const double *b ) {
+	return ( *a < *b ? -1 : ( *a > *b ? 1 : 0 ) );
+}
+
+static idStr JsonString( const char *text ) {
+	idStr res = "\"";
+	for ( const char *s = text; *s; s++ ) {
+		if ( *s == '"' || *s == '\\' ) {
+			res += '\\';
+		}
+		res += *s;
+	}
+	res += "\"";
+	return res;
+}
+
+/*
+============
+idSIMD::Benchmark_f
+
+benchmarkSIMD [json|csv <filename>] [filter <substring>] [time <msec>]
+============
+*/
+void idSIMD::Benchmark_f( const idCmdArgs &args ) {
+	const char *format = nullptr;
+	const char *filename = nullptr;
+	const char *filter = nullptr;
+	float msecPerCase = 20.0f;
+	for ( int i = 1; i < args.Argc(); i++ ) {
+		const char *arg = args.Argv( i );
+		if ( ( idStr::Icmp( arg, "json" ) == 0 || idStr::Icmp( arg, "csv" ) == 0 ) && i + 1 < args.Argc() ) {
+			format = arg;
+			filename = args.Argv( ++i );
+		} else if ( idStr::Icmp( arg, "filter" ) == 0 && i + 1 < args.Argc() ) {
+			filter = args.Argv( ++i );
+		} else if ( idStr::Icmp( arg, "time" ) == 0 && i + 1 < args.Argc() ) {
+			msecPerCase = Max( atof( args.Argv( ++i ) ), 0.0 );
+		} else {
+			idLib::common->Printf( "usage: benchmarkSIMD [json|csv <filename>] [filter <substring>] [time <msec per case>]\n" );
+			return;
+		}
+	}
+
+#ifdef _WIN32
+	SetThreadPriority( GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL );
+#endif /* _WIN32 */
+
+	idList<idSIMDProcessor *> processors;
+	CreateBenchProcessors( processors );
+	idSIMDProcessor *genericProc = processors[0];
+
+	simdBenchInput_t *in = new simdBenchInput_t;
+	InitBenchInput( *in, genericProc );
+	simdBenchOutput_t reference, output;
+	InitBenchOutput( reference );
+	InitBenchOutput( output );
+
+	double ticksPerSecond = idLib::sys->ClockTicksPerSecond();
+	double minTicks = ticksPerSecond * msecPerCase * 0.001;
+	double ticksToNs = 1e+9 / ticksPerSecond;
+
+	idLib::common->SetRefreshOnPrint( true );
+	idLib::common->Printf( "CPU: %s\n", idLib::sys->GetProcessorString() );
+	idLib::common->Printf( "processors:" );
+	for ( int p = 0; p < processors.Num(); p++ ) {
+		idLib::common->Printf( " %s", processors[p]->GetName() );
+	}
+	idLib::common->Printf( "\n" );
+
+	idList<simdBenchResult_t> results;
+	idList<double> samples;
+	int numFailed = 0;
+	int numCases = sizeof( benchCases ) / sizeof( benchCases[0] );
+	for ( int c = 0; c < numCases; c++ ) {
+		const simdBenchCase_t &test = benchCases[c];
+		if ( filter && idStr::FindText( test.name, filter, false ) < 0 && idStr::Icmp( test.group, filter ) != 0 ) {
+			continue;
+		}
+
+		double genericNs = 0.0;
+		for ( int p = 0; p < processors.Num(); p++ ) {
+			simdBenchOutput_t &out = ( p == 0 ? reference : output );
+			RunBenchCase( test, processors[p], *in, out, minTicks, samples );
+			samples.Sort( CompareTicks );
+
+			simdBenchResult_t &res = results.Alloc();
+			res.test = &test;
+			res.processor = processors[p]->GetName();
+			res.bestNs = samples[0] * ticksToNs;
+			res.medianNs = samples[samples.Num() / 2] * ticksToNs;
+			if ( p == 0 ) {
+				genericNs = res.bestNs;
+			}
+			res.speedup = genericNs / Max( res.bestNs, 1e-3 );
+			res.error = ( p == 0 ? 0.0f : test.check( reference, output ) );
+			res.passed = ( res.error <= test.tolerance );
+			if ( !res.passed ) {
+				numFailed++;
+			}
+
+			idLib::common->Printf( "%-36s %-12s %10.0f ns %8.2f ns/elem %6.2fx %s\n",
+				test.name, res.processor, res.bestNs, res.bestNs / test.elements, res.speedup,
+				res.passed ? "ok" : va( S_COLOR_RED "X (error %g > %g)" S_COLOR_DEFAULT, res.error, test.tolerance )
+			);
+		}
+	}
+
+	idLib::common->SetRefreshOnPrint( false );
+	if ( numFailed ) {
+		idLib::common->Warning( "benchmarkSIMD: %d results differ from generic code", numFailed );
+	} else {
+		idLib::common->Printf( "benchmarkSIMD: all %d results match generic code\n", results.Num() );
+	}
+
+	if ( format ) {
+		bool json = ( idStr::Icmp( format, "json" ) == 0 );
+		idStr report;
+		if ( json ) {
+			report += "{\n";
+			report += va( "\t\"cpu\": %s,\n", JsonString( idLib::sys->GetProcessorString() ).c_str() );
+			report += va( "\t\"msecPerCase\": %g,\n", msecPerCase );
+			report += "\t\"processors\": [";
+			for ( int p = 0; p < processors.Num(); p++ ) {
+				report += va( "%s%s", p ? ", " : "", JsonString( processors[p]->GetName() ).c_str() );
+			}
+			report += "],\n";
+			report += va( "\t\"failures\": %d,\n", numFailed );
+			report += "\t\"results\": [\n";
+		} else {
+			report += "function,group,processor,elements,best_ns,median_ns,ns_per_element,speedup,max_error,tolerance,status\n";
+		}
+		for ( int i = 0; i < results.Num(); i++ ) {
+			const simdBenchResult_t &res = results[i];
+			if ( json ) {
+				report += va( "\t\t{ \"function\": %s, \"group\": \"%s\", \"processor\": %s, \"elements\": %d, "
+					"\"bestNs\": %.1f, \"medianNs\": %.1f, \"nsPerElement\": %.4f, \"speedup\": %.3f, "
+					"\"maxError\": %g, \"tolerance\": %g, \"status\": \"%s\" }%s\n",
+					JsonString( res.test->name ).c_str(), res.test->group, JsonString( res.processor ).c_str(), res.test->elements,
+					res.bestNs, res.medianNs, res.bestNs / res.test->elements, res.speedup,
+					res.error == idMath::INFINITY ? 1e+30f : res.error, res.test->tolerance, res.passed ? "ok" : "fail",
+					i + 1 < results.Num() ? "," : ""
+				);
+			} else {
+				report += va( "\"%s\",%s,\"%s\",%d,%.1f,%.1f,%.4f,%.3f,%g,%g,%s\n",
+					res.test->name, res.test->group, res.processor, res.test->elements,
+					res.bestNs, res.medianNs, res.bestNs / res.test->elements, res.speedup,
+					res.error, res.test->tolerance, res.passed ? "ok" : "fail"
+				);
+			}
+		}
+		if ( json ) {
+			report += "\t]\n}\n";
+		}
+
+		idFile *f = idLib::fileSystem->OpenFileWrite( filename );
+		if ( f ) {
+			f->Write( report.c_str(), report.Length() );
+			idLib::common->Printf( "benchmarkSIMD: report written to %s\n", f->GetFullPath() );
+			idLib::fileSystem->CloseFile( f );
+		} else {
+			idLib::common->Warning( "benchmarkSIMD: could not write %s", filename );
+		}
+	}
+
+	FreeBenchOutput( reference );
+	FreeBenchOutput( output );
+	FreeBenchInput( *in );
+	delete in;
+	for ( int p = 0; p < processors.Num(); p++ ) {
+		delete processors[p];
+	}
+
+#ifdef _WIN32
+	SetThreadPriority( GetCurrentThread(), THREAD_PRIORITY_NORMAL );
+#endif /* _WIN32 */
+}
@@ -3027,6 +3027,147 @@ void idSIMD_Generic::GenerateMipMap2x2( const byte *srcPtr, int srcStride, int h
 	}
 }
 
+// load 4x4 block of RGBA pixels, use "clamp" continuation outside of image
+static void LoadBlockRGBA8( const byte *srcPtr, int width, int height, int stride, int brow, int bcol, byte block[16][4] ) {
+	for (int r = 0; r < 4; r++)
+		for (int c = 0; c < 4; c++) {
+			int i = idMath::Imin(brow * 4 + r, height - 1);
+			int j = idMath::Imin(bcol * 4 + c, width - 1);
+			memcpy(block[r * 4 + c], &srcPtr[i * stride + 4 * j], 4);
+		}
+}
+
+// compress 16 values of one channel into BC4 (aka RGTC1, DXT5 alpha) block
+static uint64 CompressBC4Block( const byte values[16] ) {
+	// compute min/max
+	int minv = values[0];
+	int maxv = values[0];
+	for (int i = 0; i < 16; i++) {
+		minv = idMath::Imin(minv, values[i]);
+		maxv = idMath::Imax(maxv, values[i]);
+	}
+	// be sure min < max, so that 7-step case is used
+	if (minv == maxv) {
+		if (maxv < 255)
+			maxv++;
+		else
+			minv--;
+	}
+
+	uint64 blockData = maxv + (minv << 8);
+	int bits = 16;
+	for (int i = 0; i < 16; i++) {
+		// compute ratio
+		int numer = values[i] - minv;
+		int denom = maxv - minv;
+		#if 0
+		// find closest ramp point
+		int idx = (numer * 7 + (denom >> 1)) / denom;
+		#else
+		// this code yields closest ramp point in most cases
+		// among all 32K ratios D/N, there are 258 exceptions with N >= 65
+		// in exceptional cases, ratio is close to middle, and chosen ramp point is almost as close
+		// Note: this code is used here to match CompressRGTCFromRGBA8_Kernel8x4 !
+		int mult = ((7 << 12) + denom-1) / denom;
+		int idx = (mult * numer + (1 << 11)) >> 12;
+		#endif
+		// convert to DXT5 index
+		int val = 8 - idx;
+		if (idx == 7)
+			val = 0;
+		if (idx == 0)
+			val = 1;
+		//append to bit stream
+		blockData += uint64(val) << bits;
+		bits += 3;
+	}
+	assert(bits == 64);
+	return blockData;
+}
+
+// compress RGB of 16 pixels into BC1 (aka DXT1) block without transparency
+// Note: this code must match CompressDXT1FromRGBA8_Kernel4x4 exactly!
+static uint64 CompressBC1Block( const byte block[16][4] ) {
+	// bounding box of colors
+	int minc[3], maxc[3];
+	for (int k = 0; k < 3; k++) {
+		minc[k] = maxc[k] = block[0][k];
+		for (int i = 1; i < 16; i++) {
+			minc[k] = idMath::Imin(minc[k], block[i][k]);
+			maxc[k] = idMath::Imax(maxc[k], block[i][k]);
+		}
+	}
+	// inset it a bit: extreme colors are rarely worth exact match
+	for (int k = 0; k < 3; k++) {
+		int inset = (maxc[k] - minc[k]) >> 4;
+		minc[k] += inset;
+		maxc[k] -= inset;
+	}
+
+	// choose diagonal of bounding box: red and blue are flipped if they correlate negatively with green
+	int center[3];
+	for (int k = 0; k < 3; k++)
+		center[k] = (minc[k] + maxc[k] + 1) >> 1;
+	int covRG = 0, covBG = 0;
+	for (int i = 0; i < 16; i++) {
+		int dr = block[i][0] - center[0];
+		int dg = block[i][1] - center[1];
+		int db = block[i][2] - center[2];
+		covRG += dr * dg;
+		covBG += db * dg;
+	}
+	if (covRG < 0)
+		idSwap(minc[0], maxc[0]);
+	if (covBG < 0)
+		idSwap(minc[2], maxc[2]);
+
+	// quantize endpoints to 565
+	static const int BITS[3] = {5, 6, 5};
+	int ends[2][3], codes[2];
+	for (int e = 0; e < 2; e++) {
+		const int *color = (e == 0 ? maxc : minc);
+		codes[e] = 0;
+		for (int k = 0; k < 3; k++) {
+			int q = (color[k] * ((1 << BITS[k]) - 1) + 128) >> 8;
+			ends[e][k] = q;
+			codes[e] = (codes[e] << BITS[k]) | q;
+		}
+	}
+	// first endpoint must be greater, otherwise block is decoded in 3-color mode
+	if (codes[0] < codes[1]) {
+		idSwap(codes[0], codes[1]);
+		for (int k = 0; k < 3; k++)
+			idSwap(ends[0][k], ends[1][k]);
+	}
+
+	// restore palette like decoder does
+	int palette[4][3];
+	for (int k = 0; k < 3; k++) {
+		for (int e = 0; e < 2; e++)
+			palette[e][k] = (ends[e][k] << (8 - BITS[k])) | (ends[e][k] >> (2 * BITS[k] - 8));
+		palette[2][k] = (2 * palette[0][k] + palette[1][k] + 1) / 3;
+		palette[3][k] = (palette[0][k] + 2 * palette[1][k] + 1) / 3;
+	}
+
+	// find closest palette color for every pixel
+	uint64 blockData = uint64(codes[0]) + (uint64(codes[1]) << 16);
+	for (int i = 0; i < 16; i++) {
+		int bestIdx = 0, bestDist = INT_MAX;
+		for (int p = 0; p < 4; p++) {
+			int dr = block[i][0] - palette[p][0];
+			int dg = block[i][1] - palette[p][1];
+			int db = block[i][2] - palette[p][2];
+			int dist = dr * dr + dg * dg + db * db;
+			if (dist < bestDist) {
+				bestDist = dist;
+				bestIdx = p;
+			}
+		}
+		blockData += uint64(bestIdx) << (32 + 2 * i);
+	}
+	return blockData;
+}
+
 /*
 ============
 idSIMD_Generic::CompressRGTCFromRGBA8
@@ -3036,73 +3177,59 @@ void idSIMD_Generic::CompressRGTCFromRGBA8( const byte *srcPtr, int width, int h
 	int bw = (width + 3) / 4;
 	int bh = (height + 3) / 4;
 	uint64 *dstBlocks = (uint64*)dstPtr;
-	byte block[4][4];
+	byte block[16][4];
+	byte values[16];
 
 	for (int brow = 0; brow < bh; brow++) {
 		for (int bcol = 0; bcol < bw; bcol++) {
+			LoadBlockRGBA8(srcPtr, width, height, stride, brow, bcol, block);
 			for (int comp = 0; comp < 2; comp++) {
+				for (int i = 0; i < 16; i++)
+					values[i] = block[i][comp];
+				*dstBlocks++ = CompressBC4Block(values);
+			}
+		}
+	}
+}
 
-				// load block
-				for (int r = 0; r < 4; r++)
-					for (int c = 0; c < 4; c++) {
-						int i = brow * 4 + r;
-						int j = bcol * 4 + c;
-						// use "clamp" continuation
-						if (i > height - 1)
-							i = height - 1;
-						if (j > width - 1)
-							j = width - 1;
-						block[r][c] = srcPtr[i * stride + 4 * j + comp];
-					}
+/*
+============
+idSIMD_Generic::CompressDXT1FromRGBA8
+============
+*/
+void idSIMD_Generic::CompressDXT1FromRGBA8( const byte *srcPtr, int width, int height, int stride, byte *dstPtr ) {
+	int bw = (width + 3) / 4;
+	int bh = (height + 3) / 4;
+	uint64 *dstBlocks = (uint64*)dstPtr;
+	byte block[16][4];
 
-				// compute min/max
-				int minv = block[0][0];
-				int maxv = block[0][0];
-				for (int r = 0; r < 4; r++)
-					for (int c = 0; c < 4; c++) {
-						minv = idMath::Imin(minv, block[r][c]);
-						maxv = idMath::Imax(maxv, block[r][c]);
-					}
-				// be sure min < max, so that 7-step case is used
-				if (minv == maxv) {
-					if (maxv < 255)
-						maxv++;
-					else
-						minv--;
-				}
+	for (int brow = 0; brow < bh; brow++) {
+		for (int bcol = 0; bcol < bw; bcol++) {
+			LoadBlockRGBA8(srcPtr, width, height, stride, brow, bcol, block);
+			*dstBlocks++ = CompressBC1Block(block);
+		}
+	}
+}
 
-				uint64 blockData = maxv + (minv << 8);
-				int bits = 16;
-				for (int r = 0; r < 4; r++)
-					for (int c = 0; c < 4; c++) {
-						// compute ratio
-						int numer = block[r][c] - minv;
-						int denom = maxv - minv;
-						#if 0
-						// find closest ramp point
-						int idx = (numer * 7 + (denom >> 1)) / denom;
-						#else
-						// this code yields closest ramp point in most cases
-						// among all 32K ratios D/N, there are 258 exceptions with N >= 65
-						// in exceptional cases, ratio is close to middle, and chosen ramp point is almost as close
-						// Note: this code is used here to match CompressRGTCFromRGBA8_Kernel8x4 !
-						int mult = ((7 << 12) + denom-1) / denom;
-						int idx = (mult * numer + (1 << 11)) >> 12;
-						#endif
-						// convert to DXT5 index
-						int val = 8 - idx;
-						if (idx == 7)
-							val = 0;
-						if (idx == 0)
-							val = 1;
-						//append to bit stream
-						blockData += uint64(val) << bits;
-						bits += 3;
-					}
-				assert(bits == 64);
+/*
+============
+idSIMD_Generic::CompressDXT5FromRGBA8
+============
+*/
+void idSIMD_Generic::CompressDXT5FromRGBA8( const byte *srcPtr, int width, int height, int stride, byte *dstPtr ) {
+	int bw = (width + 3) / 4;
+	int bh = (height + 3) / 4;
+	uint64 *dstBlocks = (uint64*)dstPtr;
+	byte block[16][4];
+	byte values[16];
 
-				*dstBlocks++ = blockData;
-			}
+	for (int brow = 0; brow < bh; brow++) {
+		for (int bcol = 0; bcol < bw; bcol++) {
+			LoadBlockRGBA8(srcPtr, width, height, stride, brow, bcol, block);
+			for (int i = 0; i < 16; i++)
+				values[i] = block[i][3];
+			*dstBlocks++ = CompressBC4Block(values);
+			*dstBlocks++ = CompressBC1Block(block);
 		}
 	}
 }
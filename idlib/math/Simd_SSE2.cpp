@@ -603,4 +603,195 @@ void idSIMD_SSE2::CompressRGTCFromRGBA8( const byte *srcPtr, int width, int heig
 	}
 }
 
+// Note: this code must match CompressBC1Block in Simd_Generic.cpp exactly!
+static uint64 CompressDXT1FromRGBA8_Kernel4x4( const byte *srcPtr, int stride ) {
+	__m128i row0 = _mm_loadu_si128((__m128i*)(srcPtr + 0 * stride));
+	__m128i row1 = _mm_loadu_si128((__m128i*)(srcPtr + 1 * stride));
+	__m128i row2 = _mm_loadu_si128((__m128i*)(srcPtr + 2 * stride));
+	__m128i row3 = _mm_loadu_si128((__m128i*)(srcPtr + 3 * stride));
+
+	// Compute bounding box of colors
+	__m128i minBytes = _mm_min_epu8(_mm_min_epu8(row0, row1), _mm_min_epu8(row2, row3));
+	__m128i maxBytes = _mm_max_epu8(_mm_max_epu8(row0, row1), _mm_max_epu8(row2, row3));
+	minBytes = _mm_min_epu8(minBytes, _mm_shuffle_epi32(minBytes, SHUF(2, 3, 0, 1)));
+	maxBytes = _mm_max_epu8(maxBytes, _mm_shuffle_epi32(maxBytes, SHUF(2, 3, 0, 1)));
+	minBytes = _mm_min_epu8(minBytes, _mm_shuffle_epi32(minBytes, SHUF(1, 0, 3, 2)));
+	maxBytes = _mm_max_epu8(maxBytes, _mm_shuffle_epi32(maxBytes, SHUF(1, 0, 3, 2)));
+	__m128i minWords = _mm_unpacklo_epi8(minBytes, _mm_setzero_si128());
+	__m128i maxWords = _mm_unpacklo_epi8(maxBytes, _mm_setzero_si128());
+	// Inset it a bit
+	__m128i insetWords = _mm_srli_epi16(_mm_sub_epi16(maxWords, minWords), 4);
+	minWords = _mm_add_epi16(minWords, insetWords);
+	maxWords = _mm_sub_epi16(maxWords, insetWords);
+	__m128i centerWords = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(minWords, maxWords), _mm_set1_epi16(1)), 1);
+
+	// Convert pixels to words without alpha, two pixels per register
+	__m128i noAlphaMask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+	__m128i pixels[8];
+	#define UNPACKROW(r) \
+		pixels[2 * r + 0] = _mm_and_si128(_mm_unpacklo_epi8(row##r, _mm_setzero_si128()), noAlphaMask); \
+		pixels[2 * r + 1] = _mm_and_si128(_mm_unpackhi_epi8(row##r, _mm_setzero_si128()), noAlphaMask);
+	UNPACKROW(0)
+	UNPACKROW(1)
+	UNPACKROW(2)
+	UNPACKROW(3)
+	#undef UNPACKROW
+
+	// Compute correlation of red and blue with green
+	__m128i covDwords = _mm_setzero_si128();
+	for (int i = 0; i < 8; i++) {
+		__m128i delta = _mm_sub_epi16(pixels[i], centerWords);
+		__m128i deltaGreen = _mm_shufflehi_epi16(_mm_shufflelo_epi16(delta, SHUF(1, 1, 1, 1)), SHUF(1, 1, 1, 1));
+		deltaGreen = _mm_and_si128(deltaGreen, _mm_set1_epi32(0xFFFF));
+		// (dr * dg, db * dg) for each pixel
+		covDwords = _mm_add_epi32(covDwords, _mm_madd_epi16(delta, deltaGreen));
+	}
+	covDwords = _mm_add_epi32(covDwords, _mm_shuffle_epi32(covDwords, SHUF(2, 3, 0, 1)));
+	int covRG = _mm_cvtsi128_si32(covDwords);
+	int covBG = _mm_cvtsi128_si32(_mm_shuffle_epi32(covDwords, SHUF(1, 1, 1, 1)));
+
+	// Choose diagonal and quantize endpoints (scalar, once per block)
+	ALIGNTYPE16 short minMaxWords[2][8];
+	_mm_store_si128((__m128i*)minMaxWords[0], minWords);
+	_mm_store_si128((__m128i*)minMaxWords[1], maxWords);
+	int minc[3], maxc[3];
+	for (int k = 0; k < 3; k++) {
+		minc[k] = minMaxWords[0][k];
+		maxc[k] = minMaxWords[1][k];
+	}
+	if (covRG < 0)
+		idSwap(minc[0], maxc[0]);
+	if (covBG < 0)
+		idSwap(minc[2], maxc[2]);
+	static const int BITS[3] = {5, 6, 5};
+	int ends[2][3], codes[2];
+	for (int e = 0; e < 2; e++) {
+		const int *color = (e == 0 ? maxc : minc);
+		codes[e] = 0;
+		for (int k = 0; k < 3; k++) {
+			int q = (color[k] * ((1 << BITS[k]) - 1) + 128) >> 8;
+			ends[e][k] = q;
+			codes[e] = (codes[e] << BITS[k]) | q;
+		}
+	}
+	if (codes[0] < codes[1]) {
+		idSwap(codes[0], codes[1]);
+		for (int k = 0; k < 3; k++)
+			idSwap(ends[0][k], ends[1][k]);
+	}
+	int palette[4][3];
+	for (int k = 0; k < 3; k++) {
+		for (int e = 0; e < 2; e++)
+			palette[e][k] = (ends[e][k] << (8 - BITS[k])) | (ends[e][k] >> (2 * BITS[k] - 8));
+		palette[2][k] = (2 * palette[0][k] + palette[1][k] + 1) / 3;
+		palette[3][k] = (palette[0][k] + 2 * palette[1][k] + 1) / 3;
+	}
+	__m128i paletteWords[4];
+	for (int p = 0; p < 4; p++)
+		paletteWords[p] = _mm_set_epi16(0, palette[p][2], palette[p][1], palette[p][0], 0, palette[p][2], palette[p][1], palette[p][0]);
+
+	// Find closest palette color for every pixel, four pixels at once
+	uint32 indexBits = 0;
+	for (int g = 0; g < 4; g++) {
+		__m128i bestDist = _mm_setzero_si128(), bestIdx = _mm_setzero_si128();
+		for (int p = 0; p < 4; p++) {
+			__m128i deltaA = _mm_sub_epi16(pixels[2 * g + 0], paletteWords[p]);
+			__m128i deltaB = _mm_sub_epi16(pixels[2 * g + 1], paletteWords[p]);
+			__m128 sqrA = _mm_castsi128_ps(_mm_madd_epi16(deltaA, deltaA));
+			__m128 sqrB = _mm_castsi128_ps(_mm_madd_epi16(deltaB, deltaB));
+			__m128i dist = _mm_add_epi32(
+				_mm_castps_si128(_mm_shuffle_ps(sqrA, sqrB, SHUF(0, 2, 0, 2))),
+				_mm_castps_si128(_mm_shuffle_ps(sqrA, sqrB, SHUF(1, 3, 1, 3)))
+			);
+			if (p == 0) {
+				bestDist = dist;
+				continue;
+			}
+			__m128i better = _mm_cmplt_epi32(dist, bestDist);
+			bestDist = _mm_or_si128(_mm_and_si128(better, dist), _mm_andnot_si128(better, bestDist));
+			bestIdx = _mm_or_si128(_mm_and_si128(better, _mm_set1_epi32(p)), _mm_andnot_si128(better, bestIdx));
+		}
+		// Pack four 2-bit indices into byte
+		__m128i idxWords = _mm_packs_epi32(bestIdx, _mm_setzero_si128());
+		idxWords = _mm_madd_epi16(idxWords, _mm_set_epi16(0, 0, 0, 0, 64, 16, 4, 1));
+		idxWords = _mm_add_epi32(idxWords, _mm_shuffle_epi32(idxWords, SHUF(1, 1, 1, 1)));
+		indexBits |= uint32(_mm_cvtsi128_si32(idxWords)) << (8 * g);
+	}
+
+	return uint64(codes[0]) + (uint64(codes[1]) << 16) + (uint64(indexBits) << 32);
+}
+
+void idSIMD_SSE2::CompressDXT1FromRGBA8( const byte *srcPtr, int width, int height, int stride, byte *dstPtr ) {
+	ALIGNTYPE16 dword inputBlock[4][4];
+	uint64 *dstBlocks = (uint64*)dstPtr;
+
+	for (int sr = 0; sr < height; sr += 4) {
+		for (int sc = 0; sc < width; sc += 4) {
+			if (sr + 4 <= height && sc + 4 <= width) {
+				// Load block directly from image memory
+				*dstBlocks++ = CompressDXT1FromRGBA8_Kernel4x4(&srcPtr[sr * stride + 4 * sc], stride);
+				continue;
+			}
+			// Copy block with clamp-style padding
+			for (int i = 0; i < 4; i++)
+				for (int j = 0; j < 4; j++) {
+					int a = idMath::Imin(sr + i, height - 1);
+					int b = idMath::Imin(sc + j, width - 1);
+					inputBlock[i][j] = *(dword*)&srcPtr[a * stride + 4 * b];
+				}
+			*dstBlocks++ = CompressDXT1FromRGBA8_Kernel4x4((byte*)&inputBlock[0][0], sizeof(inputBlock[0]));
+		}
+	}
+}
+
+static void CompressDXT5FromRGBA8_Kernel8x4( const byte *srcPtr, int stride, byte *dstPtr ) {
+	// Move alpha to red channel and compress it with RGTC kernel
+	ALIGNTYPE16 dword alphaBlocks[4][8];
+	for (int r = 0; r < 4; r++) {
+		__m128i rgbaBlock0 = _mm_loadu_si128((__m128i*)(srcPtr + r * stride + 0));
+		__m128i rgbaBlock1 = _mm_loadu_si128((__m128i*)(srcPtr + r * stride + 16));
+		_mm_store_si128((__m128i*)&alphaBlocks[r][0], _mm_srli_epi32(rgbaBlock0, 24));
+		_mm_store_si128((__m128i*)&alphaBlocks[r][4], _mm_srli_epi32(rgbaBlock1, 24));
+	}
+	ALIGNTYPE16 uint64 rgtcBlocks[4];
+	CompressRGTCFromRGBA8_Kernel8x4((byte*)&alphaBlocks[0][0], sizeof(alphaBlocks[0]), (byte*)rgtcBlocks);
+
+	uint64 *dstBlocks = (uint64*)dstPtr;
+	dstBlocks[0] = rgtcBlocks[0];
+	dstBlocks[1] = CompressDXT1FromRGBA8_Kernel4x4(srcPtr, stride);
+	dstBlocks[2] = rgtcBlocks[2];
+	dstBlocks[3] = CompressDXT1FromRGBA8_Kernel4x4(srcPtr + 16, stride);
+}
+
+void idSIMD_SSE2::CompressDXT5FromRGBA8( const byte *srcPtr, int width, int height, int stride, byte *dstPtr ) {
+	ALIGNTYPE16 dword inputBlocks[4][8];
+	ALIGNTYPE16 byte outputBlocks[32];
+
+	for (int sr = 0; sr < height; sr += 4) {
+		int fitsNum = (sr + 4 <= height ? width >> 3 : 0);
+
+		int iters;
+		for (iters = 0; iters < fitsNum; iters++) {
+			// Load blocks directly from image memory
+			CompressDXT5FromRGBA8_Kernel8x4(&srcPtr[sr * stride + 32 * iters], stride, dstPtr);
+			dstPtr += 32;
+		}
+
+		for (int sc = 8 * iters; sc < width; sc += 8) {
+			// Copy blocks with clamp-style padding
+			for (int i = 0; i < 4; i++)
+				for (int j = 0; j < 8; j++) {
+					int a = idMath::Imin(sr + i, height - 1);
+					int b = idMath::Imin(sc + j, width - 1);
+					inputBlocks[i][j] = *(dword*)&srcPtr[a * stride + 4 * b];
+				}
+			CompressDXT5FromRGBA8_Kernel8x4((byte*)&inputBlocks[0][0], sizeof(inputBlocks[0]), outputBlocks);
+			// Copy one or two blocks to output
+			int numBlocks = idMath::Imin((width - sc + 3) >> 2, 2);
+			memcpy(dstPtr, outputBlocks, 16 * numBlocks);
+			dstPtr += 16 * numBlocks;
+		}
+	}
+}
+
 #endif
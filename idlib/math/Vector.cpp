@@ -446,9 +446,9 @@ const char *idVec6::ToString( int precision ) const {
 //
 //===============================================================
 
-float	idVecX::temp[VECX_MAX_TEMP+4];
-float *	idVecX::tempPtr = (float *)(((intptr_t)idVecX::temp + 15) & ~15);
-int		idVecX::tempIndex = 0;
+thread_local float	idVecX::temp[VECX_MAX_TEMP+4];
+thread_local float *	idVecX::tempPtr = (float *)(((intptr_t)idVecX::temp + 15) & ~15);
+thread_local int		idVecX::tempIndex = 0;
 
 /*
 =============
@@ -280,6 +280,9 @@ public:
 	imageResidency_t	residency;				// determines whether cpuData and/or texnum should be valid
 	imageCompressedData_t *compressedData;		// CPU-side compressed texture contents (aka DDS file)
 	imageLoadState_t	backgroundLoadState;	// state of background loading (usually disabled)
+	int					streamRequestTime;		// when background load was requested
+	int					streamFrame;			// last frame which needed image while it was scheduled
+	float				streamDistance;			// estimated view distance to the image in streamFrame
 
 	//stgatilov: information about why and how this image was loaded (may be missing)
 	LoadStack *			loadStack;
@@ -365,6 +368,7 @@ public:
 	static idCVar		image_writeNormalTGA;		// debug tool to write out .tgas of the final normal maps
 	static idCVar		image_writeTGA;				// debug tool to write out .tgas of the non normal maps
 	static idCVar		image_useNormalCompression;	// use RGTC2 compression
+	static idCVar		image_useColorCompression;	// compress uncompressed color images to DXT1/DXT5 on load
 	static idCVar		image_useOffLineCompression; // will write a batch file with commands for the offline compression
 	static idCVar		image_preload;				// if 0, dynamically load all images
 	static idCVar		image_forceDownSize;		// allows the ability to force a downsize
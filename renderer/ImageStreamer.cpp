@@ -0,0 +1,423 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "tr_local.h"
+#include "ImageStreamer.h"
+
+idCVar image_streamThreads( "image_streamThreads", "2", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "number of threads loading images in background when image_preload is 0 (takes effect on restart)", 1, idImageStreamer::MAX_WORKERS );
+idCVar image_streamUploadBudget( "image_streamUploadBudget", "16384", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "max KB of streamed images uploaded per frame, 0 = unlimited (at least one image is always uploaded)" );
+idCVar image_streamCacheSize( "image_streamCacheSize", "64", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "MB of CPU memory for caching data of streamed images, 0 = disable cache" );
+
+idImageStreamer imageStreamer;
+
+/*
+===============================================================================
+
+	idImageStreamWorker
+
+===============================================================================
+*/
+
+class idImageStreamWorker : public idSysThread {
+public:
+							idImageStreamWorker( idImageStreamer *streamer ) : streamer( streamer ) {}
+
+protected:
+	virtual int				Run();
+
+private:
+	idImageStreamer *		streamer;
+};
+
+/*
+========================
+idImageStreamWorker::Run
+========================
+*/
+int idImageStreamWorker::Run() {
+	while ( 1 ) {
+		idImage *image = nullptr;
+		{
+			std::unique_lock<std::mutex> lock( streamer->mutex );
+			streamer->signal.wait( lock, [this]() { return streamer->queue.Num() > 0 || IsTerminating(); } );
+			if ( IsTerminating() ) {
+				break;
+			}
+			image = streamer->PopNext();
+		}
+
+		auto start = Sys_Milliseconds();
+		R_LoadImageData( *image );
+		int loadTime = Sys_Milliseconds() - start;
+
+		streamer->Loaded( image, idImageStreamer::DataSize( image ), loadTime );
+		image->backgroundLoadState = IS_LOADED;
+	}
+	return 0;
+}
+
+/*
+===============================================================================
+
+	idImageStreamer
+
+===============================================================================
+*/
+
+/*
+========================
+idImageStreamer::idImageStreamer
+========================
+*/
+idImageStreamer::idImageStreamer() {
+	memset( workers, 0, sizeof( workers ) );
+	numWorkers = 0;
+	cacheSize = 0;
+	cacheCounter = 0;
+	budgetFrame = -1;
+	uploadedBytes = 0;
+	pendingLoads = 0;
+	pendingLoadTime = 0;
+	memset( &stats, 0, sizeof( stats ) );
+}
+
+/*
+========================
+idImageStreamer::Init
+========================
+*/
+void idImageStreamer::Init() {
+	numWorkers = idMath::ClampInt( 1, MAX_WORKERS, image_streamThreads.GetInteger() );
+	for ( int i = 0; i < numWorkers; i++ ) {
+		workers[i] = new idImageStreamWorker( this );
+		workers[i]->StartThread( va( "Image Loader %d", i ), CORE_ANY, THREAD_NORMAL );
+	}
+
+	cmdSystem->AddCommand( "imageStreamStats", Stats_f, CMD_FL_RENDERER, "prints statistics of background image streaming, usage: 'imageStreamStats [reset]'" );
+}
+
+/*
+========================
+idImageStreamer::Shutdown
+========================
+*/
+void idImageStreamer::Shutdown() {
+	for ( int i = 0; i < numWorkers; i++ ) {
+		workers[i]->StopThread( false );
+	}
+	{
+		std::unique_lock<std::mutex> lock( mutex );
+		signal.notify_all();
+	}
+	for ( int i = 0; i < numWorkers; i++ ) {
+		workers[i]->WaitForThread();
+		delete workers[i];
+		workers[i] = nullptr;
+	}
+	numWorkers = 0;
+
+	// images which were never loaded stay scheduled forever, reset them
+	for ( int i = 0; i < queue.Num(); i++ ) {
+		queue[i]->backgroundLoadState = IS_NONE;
+	}
+	queue.Clear();
+
+	while ( cache.Num() ) {
+		EvictCached( cache.Num() - 1 );
+	}
+	cache.ClearFree();
+}
+
+/*
+========================
+idImageStreamer::Request
+
+called from back end every time an image is bound before it is loaded
+========================
+*/
+void idImageStreamer::Request( idImage *image ) {
+	// estimate how far the viewer is from the surface being drawn
+	float distance = 0.0f;
+	if ( backEnd.viewDef && backEnd.currentSpace ) {
+		const float *m = backEnd.currentSpace->modelMatrix;
+		distance = ( idVec3( m[12], m[13], m[14] ) - backEnd.viewDef->renderView.vieworg ).LengthFast();
+	}
+
+	std::unique_lock<std::mutex> lock( mutex );
+	if ( image->backgroundLoadState == IS_NONE ) {
+		image->backgroundLoadState = IS_SCHEDULED;
+		image->streamRequestTime = Sys_Milliseconds();
+		image->streamFrame = backEnd.frameCount;
+		image->streamDistance = distance;
+		queue.Append( image );
+		stats.requests++;
+		signal.notify_one();
+	} else if ( image->backgroundLoadState == IS_SCHEDULED ) {
+		// still visible: keep it in front of images not needed any more
+		if ( image->streamFrame != backEnd.frameCount ) {
+			image->streamFrame = backEnd.frameCount;
+			image->streamDistance = distance;
+		} else {
+			image->streamDistance = idMath::Fmin( image->streamDistance, distance );
+		}
+	}
+}
+
+/*
+========================
+idImageStreamer::PopNext
+
+mutex must be locked
+========================
+*/
+idImage *idImageStreamer::PopNext() {
+	int best = 0;
+	for ( int i = 1; i < queue.Num(); i++ ) {
+		const idImage *a = queue[i], *b = queue[best];
+		if ( a->streamFrame > b->streamFrame || ( a->streamFrame == b->streamFrame && a->streamDistance < b->streamDistance ) ) {
+			best = i;
+		}
+	}
+	idImage *image = queue[best];
+	queue.RemoveIndex( best, false );
+	return image;
+}
+
+/*
+========================
+idImageStreamer::Loaded
+========================
+*/
+void idImageStreamer::Loaded( idImage *image, int bytes, int loadTime ) {
+	std::unique_lock<std::mutex> lock( mutex );
+	// workers must not touch backEnd.pc, it is collected by backend in CollectLoadCounters
+	pendingLoads++;
+	pendingLoadTime += loadTime;
+	int latency = Sys_Milliseconds() - image->streamRequestTime;
+	stats.loads++;
+	stats.bytesStreamed += bytes;
+	stats.totalLatency += latency;
+	stats.maxLatency = idMath::Imax( stats.maxLatency, latency );
+}
+
+/*
+========================
+idImageStreamer::CollectLoadCounters
+========================
+*/
+void idImageStreamer::CollectLoadCounters() {
+	std::unique_lock<std::mutex> lock( mutex );
+	backEnd.pc.textureBackgroundLoads += pendingLoads;
+	backEnd.pc.textureLoadTime += pendingLoadTime;
+	pendingLoads = 0;
+	pendingLoadTime = 0;
+}
+
+/*
+========================
+idImageStreamer::AllowUpload
+========================
+*/
+bool idImageStreamer::AllowUpload( const idImage *image ) {
+	std::unique_lock<std::mutex> lock( mutex );
+	if ( budgetFrame != backEnd.frameCount ) {
+		budgetFrame = backEnd.frameCount;
+		uploadedBytes = 0;
+	}
+
+	int bytes = DataSize( image );
+	int64 budget = (int64)image_streamUploadBudget.GetInteger() << 10;
+	if ( budget > 0 && uploadedBytes > 0 && uploadedBytes + bytes > budget ) {
+		stats.uploadsDeferred++;
+		return false;
+	}
+
+	uploadedBytes += bytes;
+	stats.uploads++;
+	stats.bytesUploaded += bytes;
+	return true;
+}
+
+/*
+========================
+idImageStreamer::DataSize
+========================
+*/
+int idImageStreamer::DataSize( const idImage *image ) {
+	int size = 0;
+	if ( image->compressedData ) {
+		size += image->compressedData->GetTotalSize();
+	}
+	if ( image->cpuData.IsValid() ) {
+		size += image->cpuData.GetTotalSizeInBytes();
+	}
+	return size;
+}
+
+/*
+========================
+idImageStreamer::StoreCached
+========================
+*/
+void idImageStreamer::StoreCached( idImage *image ) {
+	std::unique_lock<std::mutex> lock( mutex );
+
+	int64 budget = (int64)image_streamCacheSize.GetInteger() << 20;
+	int size = DataSize( image );
+	if ( size == 0 || size > budget || ( image->residency & IR_CPU ) ) {
+		return;
+	}
+
+	for ( int i = 0; i < cache.Num(); i++ ) {
+		if ( cache[i].image == image ) {
+			EvictCached( i );
+			break;
+		}
+	}
+	// free least recently used entries
+	while ( cacheSize + size > budget ) {
+		int oldest = 0;
+		for ( int i = 1; i < cache.Num(); i++ ) {
+			if ( cache[i].lastUsed < cache[oldest].lastUsed ) {
+				oldest = i;
+			}
+		}
+		EvictCached( oldest );
+	}
+
+	cacheEntry_t &entry = cache.Alloc();
+	entry.image = image;
+	entry.cpuData = image->cpuData;
+	entry.compressedData = image->compressedData;
+	entry.size = size;
+	entry.lastUsed = ++cacheCounter;
+	cacheSize += size;
+
+	// cache owns the data now
+	memset( &image->cpuData, 0, sizeof( image->cpuData ) );
+	image->compressedData = nullptr;
+}
+
+/*
+========================
+idImageStreamer::FetchCached
+========================
+*/
+bool idImageStreamer::FetchCached( idImage *image ) {
+	if ( image->streamRequestTime == 0 ) {
+		// never streamed, so it cannot be in cache: don't count as lookup
+		return false;
+	}
+
+	std::unique_lock<std::mutex> lock( mutex );
+
+	for ( int i = 0; i < cache.Num(); i++ ) {
+		cacheEntry_t &entry = cache[i];
+		if ( entry.image != image ) {
+			continue;
+		}
+		image->cpuData.Purge();
+		if ( image->compressedData ) {
+			R_StaticFree( image->compressedData );
+		}
+		image->cpuData = entry.cpuData;
+		image->compressedData = entry.compressedData;
+
+		// image owns the data again, it comes back to cache after upload
+		cacheSize -= entry.size;
+		cache.RemoveIndex( i, false );
+		stats.cacheHits++;
+		return true;
+	}
+
+	stats.cacheMisses++;
+	return false;
+}
+
+/*
+========================
+idImageStreamer::Invalidate
+========================
+*/
+void idImageStreamer::Invalidate( idImage *image ) {
+	std::unique_lock<std::mutex> lock( mutex );
+	for ( int i = 0; i < cache.Num(); i++ ) {
+		if ( cache[i].image == image ) {
+			EvictCached( i );
+			return;
+		}
+	}
+}
+
+/*
+========================
+idImageStreamer::EvictCached
+========================
+*/
+void idImageStreamer::EvictCached( int index ) {
+	cacheEntry_t &entry = cache[index];
+	entry.cpuData.Purge();
+	if ( entry.compressedData ) {
+		R_StaticFree( entry.compressedData );
+	}
+	cacheSize -= entry.size;
+	cache.RemoveIndex( index, false );
+}
+
+/*
+========================
+idImageStreamer::PrintStats
+========================
+*/
+void idImageStreamer::PrintStats() {
+	std::unique_lock<std::mutex> lock( mutex );
+
+	common->Printf( "%d threads, %d images queued\n", numWorkers, queue.Num() );
+	common->Printf( "requests: %d, loaded: %d, streamed %.1f MB\n", stats.requests, stats.loads, stats.bytesStreamed / float( 1 << 20 ) );
+	if ( stats.loads ) {
+		common->Printf( "latency: %.1f ms average, %d ms max\n", stats.totalLatency / float( stats.loads ), stats.maxLatency );
+	}
+	common->Printf( "uploads: %d, %.1f MB, %d deferred by budget\n", stats.uploads, stats.bytesUploaded / float( 1 << 20 ), stats.uploadsDeferred );
+	int lookups = stats.cacheHits + stats.cacheMisses;
+	common->Printf( "cache: %d images, %.1f / %d MB, hit rate %.1f%% (%d of %d)\n",
+		cache.Num(), cacheSize / float( 1 << 20 ), image_streamCacheSize.GetInteger(),
+		lookups ? 100.0f * stats.cacheHits / lookups : 0.0f, stats.cacheHits, lookups );
+}
+
+/*
+========================
+idImageStreamer::ResetStats
+========================
+*/
+void idImageStreamer::ResetStats() {
+	std::unique_lock<std::mutex> lock( mutex );
+	memset( &stats, 0, sizeof( stats ) );
+}
+
+/*
+========================
+idImageStreamer::Stats_f
+========================
+*/
+void idImageStreamer::Stats_f( const idCmdArgs &args ) {
+	if ( args.Argc() > 1 && !idStr::Icmp( args.Argv( 1 ), "reset" ) ) {
+		imageStreamer.ResetStats();
+		return;
+	}
+	imageStreamer.PrintStats();
+}
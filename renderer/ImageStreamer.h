@@ -0,0 +1,122 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#ifndef __IMAGESTREAMER_H__
+#define __IMAGESTREAMER_H__
+
+#include <mutex>
+#include <condition_variable>
+
+/*
+===============================================================================
+
+	Background image streaming (used when image_preload is 0)
+
+	When the back end binds an image which is not loaded yet, the image is
+	requested here and white image is used instead. Worker threads read and
+	decode requested images: images needed in the latest frame go first,
+	and among them the ones closest to the viewer.
+
+	Loaded image is uploaded the next time it is bound, but only as long as
+	the per-frame upload budget is not exceeded.
+
+	After upload, CPU-side data of streamed images is kept in a LRU cache of
+	limited size, so that loading the image again (e.g. after vid_restart)
+	does not need to read and decode the file.
+
+===============================================================================
+*/
+
+class idImageStreamWorker;
+
+class idImageStreamer {
+public:
+	static const int		MAX_WORKERS = 8;
+
+							idImageStreamer();
+
+	void					Init();
+	void					Shutdown();
+
+	// schedule background load of image, or raise its priority if already scheduled
+	void					Request( idImage *image );
+	// returns false if loaded image should wait for a later frame to be uploaded
+	bool					AllowUpload( const idImage *image );
+
+	// take CPU-side data of just uploaded image into cache
+	void					StoreCached( idImage *image );
+	// give cached data back to image, returns false if there is nothing cached
+	bool					FetchCached( idImage *image );
+	// drop cached data of image (e.g. if its file has changed)
+	void					Invalidate( idImage *image );
+	// add loads finished by workers since last call to backEnd.pc
+	void					CollectLoadCounters();
+
+	void					PrintStats();
+	void					ResetStats();
+
+	static void				Stats_f( const idCmdArgs &args );
+
+private:
+	friend class idImageStreamWorker;
+
+	struct cacheEntry_t {
+		idImage *				image;
+		imageBlock_t			cpuData;
+		imageCompressedData_t *	compressedData;
+		int						size;
+		int						lastUsed;
+	};
+
+	struct stats_t {
+		int						requests;
+		int						loads;
+		int64					bytesStreamed;
+		int64					totalLatency;		// msec from request to loaded data
+		int						maxLatency;
+		int						cacheHits;
+		int						cacheMisses;
+		int						uploads;
+		int64					bytesUploaded;
+		int						uploadsDeferred;	// times upload was postponed due to budget
+	};
+
+	std::mutex				mutex;
+	std::condition_variable	signal;
+	idList<idImage *>		queue;					// scheduled images
+	idImageStreamWorker *	workers[MAX_WORKERS];
+	int						numWorkers;
+
+	idList<cacheEntry_t>	cache;
+	int64					cacheSize;
+	int						cacheCounter;
+
+	int						budgetFrame;			// frame for which uploadedBytes is counted
+	int64					uploadedBytes;
+
+	int						pendingLoads;			// background loads not yet added to backEnd.pc
+	int						pendingLoadTime;
+
+	stats_t					stats;
+
+	idImage *				PopNext();
+	void					Loaded( idImage *image, int bytes, int loadTime );
+	void					EvictCached( int index );
+	static int				DataSize( const idImage *image );
+};
+
+extern idImageStreamer		imageStreamer;
+
+#endif /* !__IMAGESTREAMER_H__ */
@@ -16,7 +16,6 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 #include "precompiled.h"
 #pragma hdrstop
 
-#include <thread>
 #include "tr_local.h"
 
 #include "jpeglib.h"
@@ -1694,7 +1693,7 @@ void R_SampleCubeMap( const idVec3 &dir, int size, byte *buffers[6], byte result
 
 /*
 =======================
-R_MakeIrradiance
+R_MakeAmbientMap
 =======================
 */
 void R_MakeAmbientMap( MakeAmbientMapParam param ) {
@@ -1759,57 +1758,252 @@ void R_MakeAmbientMap( MakeAmbientMapParam param ) {
 	}
 }
 
+/*
+===============================================================================
+
+	Irradiance cube maps
+
+	makeIrradiance projects the source cube map onto the first 9 real spherical
+	harmonics and evaluates their convolution with the cosine lobe at every
+	output texel. Every source texel is visited only once (rows are split into
+	tiles for the job system), and the result is free of sampling noise.
+
+	Only the 27 coefficients depend on the source, so they are stored on disk
+	together with the timestamp of the source images. If that matches the next
+	time, the source images are not even loaded.
+
+===============================================================================
+*/
+
+idCVar image_irradianceCache( "image_irradianceCache", "1", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "cache spherical harmonics of makeIrradiance cube maps on disk, so that their source images are not loaded next time" );
+
+static const int IRRADIANCE_SIZE = 32;
+static const int IRRADIANCE_ROWS_PER_TASK = 16;
+static const int IRRADIANCE_CACHE_MAGIC = ( 'I' << 24 ) | ( 'R' << 16 ) | ( 'S' << 8 ) | 'H';
+static const int IRRADIANCE_CACHE_VERSION = 1;
+
+struct irradianceSH_t {
+	float	c[9][3];		// RGB coefficient per basis function
+	float	weight;			// total weight of projected texels
+};
+
+struct irradianceCacheFile_t {
+	int				magic;
+	int				version;
+	int64			sourceTime;
+	irradianceSH_t	sh;
+};
+
+/*
+=======================
+R_SHBasis
+
+real spherical harmonics of bands 0..2, dir must be normalized
+=======================
+*/
+static ID_INLINE void R_SHBasis( const idVec3 &dir, float basis[9] ) {
+	basis[0] = 0.282095f;
+	basis[1] = 0.488603f * dir.y;
+	basis[2] = 0.488603f * dir.z;
+	basis[3] = 0.488603f * dir.x;
+	basis[4] = 1.092548f * dir.x * dir.y;
+	basis[5] = 1.092548f * dir.y * dir.z;
+	basis[6] = 0.315392f * ( 3.0f * dir.z * dir.z - 1.0f );
+	basis[7] = 1.092548f * dir.x * dir.z;
+	basis[8] = 0.546274f * ( dir.x * dir.x - dir.y * dir.y );
+}
+
 /*
 =======================
-R_MakeAmbientMaps
+R_ProjectCubeMapSH
 =======================
 */
-void R_MakeAmbientMaps( byte *buffers[6], byte *outBuffers[6], int outSize, int samples, int size, int crutchUp, bool specular ) {
-	std::thread threads[6];
-	for ( int i = 0; i < 6; i++ ) {
-		MakeAmbientMapParam p;
-		p.buffers = buffers;
-		p.outBuffer = outBuffers[i];
-		p.outSize = outSize;
-		p.samples = samples;
-		p.size = size;
-		p.crutchUp = crutchUp;
-		p.specular = specular;
-		p.side = i;
-		threads[i] = std::thread( R_MakeAmbientMap, p );
-	}
-
-	for ( auto &th : threads ) {
-		th.join();
+static void R_ProjectCubeMapSH( byte *buffers[6], int size, irradianceSH_t &sh ) {
+	InitCubeAxis();
+
+	irradianceSH_t zero;
+	memset( &zero, 0, sizeof( zero ) );
+
+	auto projectRows = [&]( int rowBegin, int rowEnd ) -> irradianceSH_t {
+		irradianceSH_t part = zero;
+		float basis[9];
+		for ( int row = rowBegin; row < rowEnd; row++ ) {
+			int side = row / size;
+			int y = row % size;
+			const byte *texel = buffers[side] + y * size * 4;
+			float fy = 2.0f * ( y + 0.5f ) / size - 1.0f;
+
+			for ( int x = 0; x < size; x++, texel += 4 ) {
+				float fx = 2.0f * ( x + 0.5f ) / size - 1.0f;
+				// inverse of the lookup in R_SampleCubeMap
+				idVec3 dir = cubeAxis[side][0] - fx * cubeAxis[side][1] - fy * cubeAxis[side][2];
+				float invLength = idMath::InvSqrt( dir.LengthSqr() );
+				dir *= invLength;
+				// solid angle of texel is proportional to this
+				float weight = invLength * invLength * invLength;
+
+				R_SHBasis( dir, basis );
+				float r = texel[0] * weight;
+				float g = texel[1] * weight;
+				float b = texel[2] * weight;
+				for ( int i = 0; i < 9; i++ ) {
+					part.c[i][0] += basis[i] * r;
+					part.c[i][1] += basis[i] * g;
+					part.c[i][2] += basis[i] * b;
+				}
+				part.weight += weight;
+			}
+		}
+		return part;
+	};
+	auto sum = []( const irradianceSH_t &a, const irradianceSH_t &b ) -> irradianceSH_t {
+		irradianceSH_t res;
+		for ( int i = 0; i < 9; i++ ) {
+			for ( int j = 0; j < 3; j++ ) {
+				res.c[i][j] = a.c[i][j] + b.c[i][j];
+			}
+		}
+		res.weight = a.weight + b.weight;
+		return res;
+	};
+	sh = taskScheduler->ParallelReduce( 0, 6 * size, zero, projectRows, sum, IRRADIANCE_ROWS_PER_TASK );
+
+	// weights must sum up to the area of unit sphere
+	float scale = 4.0f * idMath::PI / sh.weight;
+	for ( int i = 0; i < 9; i++ ) {
+		for ( int j = 0; j < 3; j++ ) {
+			sh.c[i][j] *= scale;
+		}
 	}
+	sh.weight = 4.0f * idMath::PI;
+}
+
+/*
+=======================
+R_IrradianceFromSH
+
+fills six RGBA sides of outSize x outSize
+=======================
+*/
+static void R_IrradianceFromSH( const irradianceSH_t &sh, byte *outPics[6], int outSize ) {
+	// cosine lobe convolution weights of bands 0..2 (PI, 2PI/3, PI/4) multiplied by 2/PI:
+	// hemisphere sampling used earlier returned twice the average radiance, and maps are tuned for that
+	static const float bandScale[9] = { 2.0f, 4.0f / 3.0f, 4.0f / 3.0f, 4.0f / 3.0f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f };
+
+	float coeffs[9][3];
+	for ( int i = 0; i < 9; i++ ) {
+		for ( int j = 0; j < 3; j++ ) {
+			coeffs[i][j] = sh.c[i][j] * bandScale[i];
+		}
+	}
+
+	InitCubeAxis();
+	float basis[9];
+	for ( int side = 0; side < 6; side++ ) {
+		byte *pixel = outPics[side];
+		for ( int y = 0; y < outSize; y++ ) {
+			for ( int x = 0; x < outSize; x++, pixel += 4 ) {
+				idVec3 dir = cubeAxis[side][0] + -( -1 + 2.0f * x / ( outSize - 1 ) ) * cubeAxis[side][1] + -( -1 + 2.0f * y / ( outSize - 1 ) ) * cubeAxis[side][2];
+				dir.Normalize();
+				R_SHBasis( dir, basis );
+
+				for ( int j = 0; j < 3; j++ ) {
+					float value = 0.0f;
+					for ( int i = 0; i < 9; i++ ) {
+						value += coeffs[i][j] * basis[i];
+					}
+					pixel[j] = idMath::ClampInt( 0, 255, idMath::Ftoi( value + 0.5f ) );
+				}
+				pixel[3] = 255;
+			}
+		}
+	}
+}
+
+/*
+=======================
+R_IrradianceCacheFileName
+=======================
+*/
+static idStr R_IrradianceCacheFileName( const char *sourceName, cubeFiles_t extensions ) {
+	idStr key = va( "%s/%d", sourceName, ( int )extensions );
+	key.ToLower();
+	return va( "imageCache/irradiance/%08x.sh", MD4_BlockChecksum( key.c_str(), key.Length() ) );
+}
+
+/*
+=======================
+R_LoadCachedIrradiance
+
+returns false if cache is missing or older than source images
+=======================
+*/
+static bool R_LoadCachedIrradiance( const char *sourceName, cubeFiles_t extensions, irradianceSH_t &sh, ID_TIME_T *sourceTime ) {
+	// only timestamps are read here
+	ID_TIME_T newest;
+	if ( !R_LoadCubeImages( sourceName, extensions, nullptr, nullptr, &newest ) || newest == 0 ) {
+		return false;
+	}
+
+	idStr fileName = R_IrradianceCacheFileName( sourceName, extensions );
+	void *buffer = nullptr;
+	int length = fileSystem->ReadFile( fileName, &buffer );
+	if ( !buffer ) {
+		return false;
+	}
+
+	bool valid = false;
+	if ( length == sizeof( irradianceCacheFile_t ) ) {
+		const irradianceCacheFile_t *file = ( const irradianceCacheFile_t * )buffer;
+		if ( file->magic == IRRADIANCE_CACHE_MAGIC && file->version == IRRADIANCE_CACHE_VERSION && file->sourceTime == ( int64 )newest ) {
+			sh = file->sh;
+			*sourceTime = newest;
+			valid = true;
+		}
+	}
+	fileSystem->FreeFile( buffer );
+	return valid;
+}
+
+/*
+=======================
+R_WriteCachedIrradiance
+=======================
+*/
+static void R_WriteCachedIrradiance( const char *sourceName, cubeFiles_t extensions, const irradianceSH_t &sh, ID_TIME_T sourceTime ) {
+	irradianceCacheFile_t file;
+	memset( &file, 0, sizeof( file ) );
+	file.magic = IRRADIANCE_CACHE_MAGIC;
+	file.version = IRRADIANCE_CACHE_VERSION;
+	file.sourceTime = ( int64 )sourceTime;
+	file.sh = sh;
+	fileSystem->WriteFile( R_IrradianceCacheFileName( sourceName, extensions ), &file, sizeof( file ) );
 }
 
 /*
 =======================
 R_MakeIrradiance
+
+replaces source cube map with its irradiance
 =======================
 */
-void R_MakeIrradiance( byte *pics[6], int *size ) {
+static void R_MakeIrradiance( byte *pics[6], int *size, irradianceSH_t &sh ) {
 	if ( *size == 0 ) {
 		return;
 	}
 	int time = Sys_Milliseconds();
-	int outSize = 32;
-	byte *outPics[6];
 
 	// assume cubemaps are RGBA
-	for ( int side = 0; side < 6; side++ ) {
-		outPics[side] = ( byte * )R_StaticAlloc( 4 * outSize * outSize );
-	}
-	R_MakeAmbientMaps( pics, outPics, outSize, 333, *size, 1, false );
-
+	R_ProjectCubeMapSH( pics, *size, sh );
 	for ( int side = 0; side < 6; side++ ) {
 		R_StaticFree( pics[side] );
-		pics[side] = outPics[side];
+		pics[side] = ( byte * )R_StaticAlloc( 4 * IRRADIANCE_SIZE * IRRADIANCE_SIZE );
 	}
+	R_IrradianceFromSH( sh, pics, IRRADIANCE_SIZE );
+
 	time = Sys_Milliseconds() - time;
 	common->Printf( "R_MakeIrradiance completed in %d ms.\n", time );
-	*size = outSize;
+	*size = IRRADIANCE_SIZE;
 }
 
 /*
@@ -1827,6 +2021,7 @@ bool R_LoadCubeImages( const char *imgName, cubeFiles_t extensions, byte *pics[6
 	const char	**sides;
 	char		fullName[MAX_IMAGE_NAME];
 	int			width, height, size = 0, makeIrradiance = 0;
+	ID_TIME_T	newest = 0;
 	idLexer		lexer( imgName, ( int )strlen( imgName ), imgName, LEXFL_ALLOWPATHNAMES );
 	idToken		token;
 
@@ -1840,6 +2035,21 @@ bool R_LoadCubeImages( const char *imgName, cubeFiles_t extensions, byte *pics[6
 	}
 	lexer.FreeSource();
 
+	irradianceSH_t sh;
+	if ( makeIrradiance && pics && image_irradianceCache.GetBool() && R_LoadCachedIrradiance( imgName, extensions, sh, &newest ) ) {
+		for ( i = 0; i < 6; i++ ) {
+			pics[i] = ( byte * )R_StaticAlloc( 4 * IRRADIANCE_SIZE * IRRADIANCE_SIZE );
+		}
+		R_IrradianceFromSH( sh, pics, IRRADIANCE_SIZE );
+		if ( outSize ) {
+			*outSize = IRRADIANCE_SIZE;
+		}
+		if ( timestamp ) {
+			*timestamp = newest;
+		}
+		return true;
+	}
+
 	if ( extensions == CF_CAMERA ) {
 		sides = cameraSides;
 	} else {
@@ -1878,10 +2088,11 @@ bool R_LoadCubeImages( const char *imgName, cubeFiles_t extensions, byte *pics[6
 			break;
 		}
 
+		if ( thisTime > newest ) {
+			newest = thisTime;
+		}
 		if ( timestamp ) {
-			if ( thisTime > *timestamp ) {
-				*timestamp = thisTime;
-			}
+			*timestamp = newest;
 		}
 
 		if ( pics && extensions == CF_CAMERA ) {
@@ -1925,8 +2136,11 @@ bool R_LoadCubeImages( const char *imgName, cubeFiles_t extensions, byte *pics[6
 		return false;
 	}
 
-	if ( makeIrradiance ) {
-		R_MakeIrradiance( pics, &size );
+	if ( makeIrradiance && pics ) {
+		R_MakeIrradiance( pics, &size, sh );
+		if ( image_irradianceCache.GetBool() && size == IRRADIANCE_SIZE ) {
+			R_WriteCachedIrradiance( imgName, extensions, sh, newest );
+		}
 	}
 
 	if ( outSize ) {
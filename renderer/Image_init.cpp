@@ -21,6 +21,7 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 #include "AmbientOcclusionStage.h"
 #include "FrameBufferManager.h"
 #include "LoadStack.h"
+#include "ImageStreamer.h"
 
 #define	DEFAULT_SIZE		16
 #define	NORMAL_MAP_SIZE		32
@@ -52,6 +53,7 @@ idCVar idImageManager::image_colorMipLevels( "image_colorMipLevels", "0", CVAR_R
 idCVar idImageManager::image_preload( "image_preload", "1", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "if 0, dynamically load all images" );
 idCVar idImageManager::image_useCompression( "image_useCompression", "1", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "1 = load compressed (DDS) images, 0 = force everything to high quality. 0 does not work for TDM as all our textures are DDS." );
 idCVar idImageManager::image_useNormalCompression( "image_useNormalCompression", "1", CVAR_RENDERER | CVAR_ARCHIVE, "use compression for normal maps if available, 0 = no, 1 = GL_COMPRESSED_RG_RGTC2" );
+idCVar idImageManager::image_useColorCompression( "image_useColorCompression", "0", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "compress color images which are not precompressed: DXT1 if opaque, DXT5 otherwise (done on image loading threads)" );
 idCVar idImageManager::image_usePrecompressedTextures( "image_usePrecompressedTextures", "1", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_BOOL, "Use .dds files if present." );
 idCVar idImageManager::image_writePrecompressedTextures( "image_writePrecompressedTextures", "0", CVAR_RENDERER | CVAR_BOOL, "write .dds files if necessary" );
 idCVar idImageManager::image_writeNormalTGA( "image_writeNormalTGA", "0", CVAR_RENDERER | CVAR_BOOL, "write .tgas of the final normal maps for debugging" );
@@ -239,6 +241,9 @@ idImage::idImage() {
 	compressedData = nullptr;
 	residency = IR_GRAPHICS;
 	backgroundLoadState = IS_NONE;
+	streamRequestTime = 0;
+	streamFrame = -1;
+	streamDistance = 0.0f;
 	isBindlessHandleResident = false;
 	textureHandle = 0;
 	lastNeededInFrame = -1;
@@ -841,6 +846,10 @@ void idImage::Reload( bool checkPrecompressed, bool force ) {
 	}
 	common->DPrintf( "reloading %s.\n", imgName.c_str() );
 
+	// data cached by streaming may be outdated, unless this is vid_restart
+	if ( !checkPrecompressed ) {
+		imageStreamer.Invalidate( this );
+	}
 	PurgeImage();
 
 	// force no precompressed image check, which will cause it to be reloaded
@@ -1588,6 +1597,8 @@ void idImageManager::Init() {
 	//shadowAtlasHistory = ImageFromFunction( "_shadowAtlasHistory", R_DepthTexture );
 	currentStencilFbo = ImageFromFunction( "_currentStencilFbo", R_RGBA8Image );
 
+	imageStreamer.Init();
+
 	cmdSystem->AddCommand( "reloadImages", R_ReloadImages_f, CMD_FL_RENDERER, "reloads images" );
 	cmdSystem->AddCommand( "listImages", R_ListImages_f, CMD_FL_RENDERER, "lists images" );
 	cmdSystem->AddCommand( "combineCubeImages", R_CombineCubeImages_f, CMD_FL_RENDERER, "combines six images for roq compression" );
@@ -1601,6 +1612,7 @@ Shutdown
 ===============
 */
 void idImageManager::Shutdown() {
+	imageStreamer.Shutdown();
 	images.DeleteContents( true );
 }
 
@@ -18,11 +18,9 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 
 #include "tr_local.h"
 #include "FrameBuffer.h"
-#include <thread>
-#include <mutex>          // std::mutex, std::unique_lock, std::defer_lock
-#include <stack>
-#include <condition_variable>
+#include "ImageStreamer.h"
 #include "LoadStack.h"
+#include "../idlib/math/Simd_Generic.h"
 #include "../tests/testing.h"
 
 /*
@@ -1169,85 +1167,129 @@ void idImage::UploadPrecompressedImage() {
 	SetImageFilterAndRepeat();
 }
 
+typedef void ( idSIMDProcessor::*compressFromRGBA8_t )( const byte *srcPtr, int width, int height, int stride, byte *dstPtr );
+
+static imageCompressedData_t *R_CompressImageData( const imageBlock_t &cpuData, dword fourcc, int blockSize, compressFromRGBA8_t compress ) {
+	// Compute size of compressed output
+	int levw = cpuData.width;
+	int levh = cpuData.height;
+	int totalBytes = 0, mainBytes = 0;
+	int mipLevels = 0;
+	while (1) {
+		int bw = (levw + 3) >> 2;
+		int bh = (levh + 3) >> 2;
+		int currSz = bw * bh * blockSize;
+		if (mainBytes == 0)
+			mainBytes = currSz;
+		mipLevels++;
+		totalBytes += currSz;
+		if (levw == 1 && levh == 1)
+			break;
+		levw = idMath::Imax(levw >> 1, 1);
+		levh = idMath::Imax(levh >> 1, 1);
+	}
+
+	// Allocate DDS data
+	int allocSize = imageCompressedData_t::TotalSizeFromContentSize(totalBytes);
+	imageCompressedData_t *compData = (imageCompressedData_t*)R_StaticAlloc(allocSize);
+	// Fill header
+	compData->fileSize = imageCompressedData_t::FileSizeFromContentSize(totalBytes);
+	compData->magic = DDS_MAKEFOURCC( 'D', 'D', 'S', ' ' );
+	memset(&compData->header, 0, sizeof(compData->header));
+	compData->header.dwSize = sizeof(compData->header);
+	compData->header.dwFlags = DDSF_CAPS | DDSF_PIXELFORMAT | DDSF_WIDTH | DDSF_HEIGHT;
+	compData->header.dwFlags |= DDSF_LINEARSIZE | DDSF_MIPMAPCOUNT;
+	compData->header.dwWidth = cpuData.width;
+	compData->header.dwHeight = cpuData.height;
+	compData->header.dwPitchOrLinearSize = mainBytes;
+	compData->header.dwMipMapCount = mipLevels;
+	compData->header.ddspf.dwSize = sizeof(compData->header.ddspf);
+	compData->header.ddspf.dwFlags = DDSF_FOURCC;
+	compData->header.ddspf.dwFourCC = fourcc;
+	compData->header.dwCaps1 = DDSF_TEXTURE | DDSF_MIPMAP | DDSF_COMPLEX;
+
+	// Generate mipmaps and compress them
+	byte *dstData = compData->contents;
+	byte *srcData = cpuData.GetPic();
+	levw = cpuData.width;
+	levh = cpuData.height;
+	while (1) {
+		int bw = (levw + 3) >> 2;
+		int bh = (levh + 3) >> 2;
+		(SIMDProcessor->*compress)(
+			srcData, levw, levh, 4 * levw,
+			dstData
+		);
+		dstData += bw * bh * blockSize;
+		if (levw == 1 && levh == 1)
+			break;
+		byte *newMip = R_MipMap(srcData, levw, levh);
+		levw = idMath::Imax(levw >> 1, 1);
+		levh = idMath::Imax(levh >> 1, 1);
+		if (srcData != cpuData.GetPic())
+			R_StaticFree(srcData);
+		srcData = newMip;
+	} 
+	if (srcData != cpuData.GetPic())
+		R_StaticFree(srcData);
+
+	return compData;
+}
+
+static bool R_ImageHasAlpha( const imageBlock_t &cpuData ) {
+	const byte *pic = cpuData.GetPic();
+	int num = cpuData.width * cpuData.height;
+	for (int i = 0; i < num; i++)
+		if (pic[4 * i + 3] != 255)
+			return true;
+	return false;
+}
+
 void R_HandleImageCompression( idImage& image ) {
-	bool compressToRgtc = (
+	bool canCompress = (
 		(image.residency & IR_GRAPHICS) && 
-		image.depth == TD_BUMP &&
-		globalImages->image_useNormalCompression.GetBool() &&
 		image.cpuData.IsValid() &&
 		!image.compressedData
 	);
+	bool compressToRgtc = (
+		canCompress &&
+		image.depth == TD_BUMP &&
+		globalImages->image_useNormalCompression.GetBool()
+	);
+	// color textures are compressed on our side, so that result does not depend on driver
+	bool compressToDxt = (
+		canCompress &&
+		image.depth <= TD_DEFAULT &&
+		image.cubeFiles == CF_2D &&
+		globalImages->image_useColorCompression.GetBool()
+	);
 
 	if (compressToRgtc) {
 		TRACE_CPU_SCOPE_STR("Compress:Image", image.imgName)
-		int blockSize = 16;
-
-		// Compute size of compressed output
-		int levw = image.cpuData.width;
-		int levh = image.cpuData.height;
-		int totalBytes = 0, mainBytes = 0;
-		int mipLevels = 0;
-		while (1) {
-			int bw = (levw + 3) >> 2;
-			int bh = (levh + 3) >> 2;
-			int currSz = bw * bh * blockSize;
-			if (mainBytes == 0)
-				mainBytes = currSz;
-			mipLevels++;
-			totalBytes += currSz;
-			if (levw == 1 && levh == 1)
-				break;
-			levw = idMath::Imax(levw >> 1, 1);
-			levh = idMath::Imax(levh >> 1, 1);
-		}
-
-		// Allocate DDS data
-		int allocSize = imageCompressedData_t::TotalSizeFromContentSize(totalBytes);
-		imageCompressedData_t *compData = (imageCompressedData_t*)R_StaticAlloc(allocSize);
-		// Fill header
-		compData->fileSize = imageCompressedData_t::FileSizeFromContentSize(totalBytes);
-		compData->magic = DDS_MAKEFOURCC( 'D', 'D', 'S', ' ' );
-		memset(&compData->header, 0, sizeof(compData->header));
-		compData->header.dwSize = sizeof(compData->header);
-		compData->header.dwFlags = DDSF_CAPS | DDSF_PIXELFORMAT | DDSF_WIDTH | DDSF_HEIGHT;
-		compData->header.dwFlags |= DDSF_LINEARSIZE | DDSF_MIPMAPCOUNT;
-		compData->header.dwWidth = image.cpuData.width;
-		compData->header.dwHeight = image.cpuData.height;
-		compData->header.dwPitchOrLinearSize = mainBytes;
-		compData->header.dwMipMapCount = mipLevels;
-		compData->header.ddspf.dwSize = sizeof(compData->header.ddspf);
-		compData->header.ddspf.dwFlags = DDSF_FOURCC;
-		compData->header.ddspf.dwFourCC = DDS_MAKEFOURCC( 'A', 'T', 'I', '2' );
-		compData->header.dwCaps1 = DDSF_TEXTURE | DDSF_MIPMAP | DDSF_COMPLEX;
-
-		// Generate mipmaps and compress them
-		byte *dstData = compData->contents;
-		byte *srcData = image.cpuData.GetPic();
-		levw = image.cpuData.width;
-		levh = image.cpuData.height;
-		while (1) {
-			int bw = (levw + 3) >> 2;
-			int bh = (levh + 3) >> 2;
-			SIMDProcessor->CompressRGTCFromRGBA8(
-				srcData, levw, levh, 4 * levw,
-				dstData
-			);
-			dstData += bw * bh * blockSize;
-			if (levw == 1 && levh == 1)
-				break;
-			byte *newMip = R_MipMap(srcData, levw, levh);
-			levw = idMath::Imax(levw >> 1, 1);
-			levh = idMath::Imax(levh >> 1, 1);
-			if (srcData != image.cpuData.GetPic())
-				R_StaticFree(srcData);
-			srcData = newMip;
-		} 
-		if (srcData != image.cpuData.GetPic())
-			R_StaticFree(srcData);
-
 		// Save compressed DDS in image
 		assert(!image.compressedData);
-		image.compressedData = compData;
+		image.compressedData = R_CompressImageData(
+			image.cpuData, DDS_MAKEFOURCC( 'A', 'T', 'I', '2' ), 16, &idSIMDProcessor::CompressRGTCFromRGBA8
+		);
+	}
+	else if (compressToDxt) {
+		TRACE_CPU_SCOPE_STR("Compress:Image", image.imgName)
+		if (R_ImageHasAlpha(image.cpuData)) {
+			image.compressedData = R_CompressImageData(
+				image.cpuData, DDS_MAKEFOURCC( 'D', 'X', 'T', '5' ), 16, &idSIMDProcessor::CompressDXT5FromRGBA8
+			);
+		} else {
+			image.compressedData = R_CompressImageData(
+				image.cpuData, DDS_MAKEFOURCC( 'D', 'X', 'T', '1' ), 8, &idSIMDProcessor::CompressDXT1FromRGBA8
+			);
+		}
+
+		if ( globalImages->image_writePrecompressedTextures.GetBool() ) {
+			// cache it, so that it is loaded as precompressed image next time
+			char filename[MAX_IMAGE_NAME];
+			image.ImageProgramStringToCompressedFileName( image.imgName, filename );
+			fileSystem->WriteFile( filename, image.compressedData->GetFileData(), image.compressedData->fileSize );
+		}
 	}
 }
 
@@ -1292,7 +1334,7 @@ void R_LoadImageData( idImage& image ) {
 	R_HandleImageCompression( image );
 }
 
-void R_UploadImageData( idImage& image ) {
+void R_UploadImageData( idImage& image, bool cacheData = false ) {
 	TRACE_CPU_SCOPE_STR("Upload:Image", image.imgName)
 	auto& cpuData = image.cpuData;
 
@@ -1349,6 +1391,10 @@ void R_UploadImageData( idImage& image ) {
 		return;
 	}
 
+	// keep data of streamed image in memory in case it is purged and needed again
+	if (cacheData)
+		imageStreamer.StoreCached(&image);
+
 	if (!(image.residency & IR_CPU))
 		cpuData.Purge();
 	if (image.compressedData) {
@@ -1357,31 +1403,6 @@ void R_UploadImageData( idImage& image ) {
 	}
 }
 
-std::stack<idImage*> backgroundLoads;
-std::mutex signalMutex;
-std::condition_variable imageThreadSignal;
-
-void BackgroundLoading() {
-	while ( 1 ) {
-		idImage* img = nullptr;
-		{
-			std::unique_lock<std::mutex> lock( signalMutex );
-			imageThreadSignal.wait( lock, []() { return backgroundLoads.size() > 0; } );
-			img = backgroundLoads.top();
-			backgroundLoads.pop();
-		}
-		/*if ( loading && !uploading ) // debug state check
-			GetTickCount();*/
-		auto start = Sys_Milliseconds();
-		R_LoadImageData( *img );
-		backEnd.pc.textureLoadTime += ( Sys_Milliseconds() - start );
-		backEnd.pc.textureBackgroundLoads++;
-		img->backgroundLoadState = IS_LOADED;
-	}
-}
-
-uintptr_t backgroundImageLoader = Sys_CreateThread((xthread_t)BackgroundLoading, NULL, THREAD_NORMAL, "Image Loader" );
-
 /*
 ===============
 ActuallyLoadImage
@@ -1411,22 +1432,21 @@ void idImage::ActuallyLoadImage( bool allowBackground ) {
 	// load the image from disk
 	//
 	if ( allowBackground ) {
-		if ( backgroundLoadState == IS_NONE ) {
-			backgroundLoadState = IS_SCHEDULED;
-			std::unique_lock<std::mutex> lock( signalMutex );
-			backgroundLoads.push( this );
-			imageThreadSignal.notify_all();
-			return;
+		if ( backgroundLoadState == IS_NONE && imageStreamer.FetchCached( this ) ) {
+			backgroundLoadState = IS_LOADED;
 		}
-		if ( backgroundLoadState == IS_SCHEDULED ) {
+		if ( backgroundLoadState != IS_LOADED ) {
+			// schedule load, or tell streamer that image is still needed
+			imageStreamer.Request( this );
 			return;
 		}
-		if ( backgroundLoadState == IS_LOADED ) {
-			backgroundLoadState = IS_NONE; // hopefully allow reload to happen
-			R_UploadImageData( *this );
+		if ( !imageStreamer.AllowUpload( this ) ) {
+			return;
 		}
+		backgroundLoadState = IS_NONE; // hopefully allow reload to happen
+		R_UploadImageData( *this, true );
 	} else {
-		if ( backgroundLoadState != IS_LOADED ) {
+		if ( backgroundLoadState != IS_LOADED && !imageStreamer.FetchCached( this ) ) {
 			R_LoadImageData( *this );
 		}
 		backgroundLoadState = IS_NONE;
@@ -1451,6 +1471,9 @@ void idImage::PurgeImage( bool purgeCpuData ) {
 		texnum = static_cast< GLuint >( TEXTURE_NOT_LOADED );
 	}
 
+	// data loaded in background is freed below, so it must be loaded again
+	if ( backgroundLoadState == IS_LOADED )
+		backgroundLoadState = IS_NONE;
 	if ( purgeCpuData && cpuData.IsValid() )
 		cpuData.Purge();
 	if ( compressedData ) {
@@ -2009,3 +2032,51 @@ TEST_CASE("DecompressDxt:Performance"
 ) {
 	TestDecompressDxt(true);
 }
+
+static void TestCompressOnImage(int W, int H, const idList<byte> &inputUnc, bool alpha, float maxMeanError, int maxError) {
+	int blockSize = alpha ? 16 : 8;
+	int compSize = ((W+3)/4) * ((H+3)/4) * blockSize;
+	idList<byte> comp, compGeneric, softUnc;
+	comp.SetNum(compSize);
+	compGeneric.SetNum(compSize);
+	softUnc.SetNum(W * H * 4);
+
+	idSIMD_Generic generic;
+	if (alpha) {
+		SIMDProcessor->CompressDXT5FromRGBA8(inputUnc.Ptr(), W, H, 4 * W, comp.Ptr());
+		generic.CompressDXT5FromRGBA8(inputUnc.Ptr(), W, H, 4 * W, compGeneric.Ptr());
+		generic.DecompressRGBA8FromDXT5(comp.Ptr(), W, H, softUnc.Ptr(), 4 * W);
+	}
+	else {
+		SIMDProcessor->CompressDXT1FromRGBA8(inputUnc.Ptr(), W, H, 4 * W, comp.Ptr());
+		generic.CompressDXT1FromRGBA8(inputUnc.Ptr(), W, H, 4 * W, compGeneric.Ptr());
+		generic.DecompressRGBA8FromDXT1(comp.Ptr(), W, H, softUnc.Ptr(), 4 * W, false);
+	}
+	// SIMD implementations must produce exactly the same blocks
+	CHECK(memcmp(comp.Ptr(), compGeneric.Ptr(), compSize) == 0);
+
+	double sumError = 0.0;
+	int worstError = 0, count = 0;
+	for (int i = 0; i < W * H * 4; i++) {
+		if (!alpha && i % 4 == 3)
+			continue;
+		int delta = idMath::Abs(0 + inputUnc[i] - softUnc[i]);
+		sumError += delta;
+		worstError = idMath::Imax(worstError, delta);
+		count++;
+	}
+	CHECK(sumError / count <= maxMeanError);
+	CHECK(worstError <= maxError);
+}
+
+TEST_CASE("CompressDxt:Correctness") {
+	idRandom rnd;
+	for (int alpha = 0; alpha < 2; alpha++) {
+		TestCompressOnImage(16, 16, GenImageConstant(16, 16, 255, 255, 255, 255), alpha, 0.0f, 0);
+		TestCompressOnImage(16, 16, GenImageConstant(16, 16, 100, 128, 127, 197), alpha, 4.0f, 4);
+		TestCompressOnImage(512, 512, GenImageGradient(512, 512), alpha, 2.0f, 8);
+		TestCompressOnImage(23, 17, GenImageGradient(23, 17), alpha, 16.0f, 64);
+		TestCompressOnImage(22, 18, GenImageGradient(22, 18), alpha, 16.0f, 64);
+		TestCompressOnImage(231, 177, GenImageRandom(231, 177, rnd), alpha, 128.0f, 255);
+	}
+}
@@ -28,6 +28,7 @@ idCVar idRenderModelStatic::r_mergeModelSurfaces( "r_mergeModelSurfaces", "1", C
 idCVar idRenderModelStatic::r_slopVertex( "r_slopVertex", "0.01", CVAR_RENDERER, "merge xyz coordinates this far apart" );
 idCVar idRenderModelStatic::r_slopTexCoord( "r_slopTexCoord", "0.001", CVAR_RENDERER, "merge texture coordinates this far apart" );
 idCVar idRenderModelStatic::r_slopNormal( "r_slopNormal", "0.02", CVAR_RENDERER, "merge normals that dot less than this" );
+idCVar idRenderModelStatic::r_useProcessedModelCache( "r_useProcessedModelCache", "1", CVAR_BOOL|CVAR_RENDERER|CVAR_ARCHIVE, "store cleaned up surfaces of static models in modelCache/ and load them from there while source file is unchanged" );
 
 /*
 ================
@@ -271,6 +272,15 @@ void idRenderModelStatic::InitFromFile( const char *fileName ) {
 	// FIXME: load new .proc map format
 	name.ExtractFileExtension( extension );
 
+	// proxies depend on other models, renderBump needs unprocessed surfaces
+	bool useCache = r_useProcessedModelCache.GetBool() && !fastLoad && extension.Icmp( "proxy" ) != 0;
+	if ( useCache && LoadProcessedModel( fileName ) ) {
+		reloadable = true;
+		purged = false;
+		FinishSurfaceBounds();
+		return;
+	}
+
 	if ( extension.Icmp( "ase" ) == 0 ) {
 		loaded		= LoadASE( name );
 		// Tels: #3111 try to load LWO as a fallback
@@ -317,8 +327,15 @@ void idRenderModelStatic::InitFromFile( const char *fileName ) {
 	// it is now available for use
 	purged = false;
 
-	// create the bounds for culling and dynamic surface creation
-	FinishSurfaces();
+	if ( useCache && surfaces.Num() > 0 ) {
+		// same as FinishSurfaces, but cleaned surfaces are stored before bounds are enlarged for deforms
+		CleanupSurfaces();
+		WriteProcessedModel( fileName );
+		FinishSurfaceBounds();
+	} else {
+		// create the bounds for culling and dynamic surface creation
+		FinishSurfaces();
+	}
 }
 
 /*
@@ -585,7 +602,6 @@ Extends the bounds of deformed surfaces so they don't cull incorrectly at screen
 */
 void idRenderModelStatic::FinishSurfaces() {
 	int			i;
-	int			totalVerts, totalIndexes;
 
 	purged = false;
 
@@ -609,6 +625,22 @@ void idRenderModelStatic::FinishSurfaces() {
 		return;
 	}
 
+	CleanupSurfaces();
+	FinishSurfaceBounds();
+}
+
+/*
+================
+idRenderModelStatic::CleanupSurfaces
+
+Everything in this part only depends on the source file and the materials,
+so its results can be stored in the processed model cache.
+================
+*/
+void idRenderModelStatic::CleanupSurfaces() {
+	int			i;
+	int			totalVerts, totalIndexes;
+
 	// cleanup all the final surfaces, but don't create sil edges
 	totalVerts = 0;
 	totalIndexes = 0;
@@ -665,6 +697,15 @@ void idRenderModelStatic::FinishSurfaces() {
 			totalIndexes += surf->geometry->numIndexes;
 		}
 	}
+}
+
+/*
+================
+idRenderModelStatic::FinishSurfaceBounds
+================
+*/
+void idRenderModelStatic::FinishSurfaceBounds() {
+	int			i;
 
 	// add up the total surface area for development information
 	for ( i = 0 ; i < surfaces.Num() ; i++ ) {
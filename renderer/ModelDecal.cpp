@@ -30,6 +30,57 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 // clamp
 // }
 
+/*
+===============================================================================
+
+	Decal pool
+
+	Decals are allocated in slabs of DECAL_POOL_SLAB_SIZE. Vertexes and indexes
+	of all decals of a slab are stored in one contiguous block each, assigned
+	to the decals when the slab is created. Slabs are kept until shutdown,
+	unused decals are linked through nextDecal.
+
+===============================================================================
+*/
+
+static const int DECAL_POOL_SLAB_SIZE = 128;
+
+typedef struct {
+	idRenderModelDecal *	decals;
+	idDrawVert *			verts;
+	glIndex_t *				indexes;
+} decalSlab_t;
+
+class idRenderModelDecalPool {
+public:
+							idRenderModelDecalPool( void ) : freeList( NULL ), numUsed( 0 ) {}
+							~idRenderModelDecalPool( void ) { Shutdown(); }
+
+	void					Shutdown( void );
+
+	idList<decalSlab_t>		slabs;
+	idRenderModelDecal *	freeList;
+	int						numUsed;
+};
+
+static idRenderModelDecalPool decalPool;
+
+/*
+==================
+idRenderModelDecalPool::Shutdown
+==================
+*/
+void idRenderModelDecalPool::Shutdown( void ) {
+	for ( int i = 0; i < slabs.Num(); i++ ) {
+		delete[] slabs[i].decals;
+		Mem_Free16( slabs[i].verts );
+		Mem_Free16( slabs[i].indexes );
+	}
+	slabs.ClearFree();
+	freeList = NULL;
+	numUsed = 0;
+}
+
 /*
 ==================
 idRenderModelDecal::idRenderModelDecal
@@ -37,9 +88,8 @@ idRenderModelDecal::idRenderModelDecal
 */
 idRenderModelDecal::idRenderModelDecal( void ) {
 	memset( &tri, 0, sizeof( tri ) );
-	tri.verts = ( idDrawVert* )Mem_Alloc16( MAX_DECAL_VERTS * sizeof( idDrawVert ) );
-	tri.indexes = ( glIndex_t* )Mem_Alloc16( MAX_DECAL_INDEXES * sizeof( glIndex_t ) );
 	material = NULL;
+	expireTime = INT_MAX;
 	nextDecal = NULL;
 }
 
@@ -49,26 +99,63 @@ idRenderModelDecal::~idRenderModelDecal
 ==================
 */
 idRenderModelDecal::~idRenderModelDecal( void ) {
-	Mem_Free16( tri.indexes );
-	Mem_Free16( tri.verts );
+	// vertexes and indexes belong to the slab
 }
 
 /*
 ==================
-idRenderModelDecal::idRenderModelDecal
+idRenderModelDecal::Alloc
 ==================
 */
 idRenderModelDecal *idRenderModelDecal::Alloc( void ) {
-	return new idRenderModelDecal;
+	if ( !decalPool.freeList ) {
+		decalSlab_t &slab = decalPool.slabs.Alloc();
+		slab.decals = new idRenderModelDecal[DECAL_POOL_SLAB_SIZE];
+		slab.verts = ( idDrawVert * )Mem_Alloc16( DECAL_POOL_SLAB_SIZE * MAX_DECAL_VERTS * sizeof( idDrawVert ) );
+		slab.indexes = ( glIndex_t * )Mem_Alloc16( DECAL_POOL_SLAB_SIZE * MAX_DECAL_INDEXES * sizeof( glIndex_t ) );
+		for ( int i = DECAL_POOL_SLAB_SIZE - 1; i >= 0; i-- ) {
+			idRenderModelDecal *decal = &slab.decals[i];
+			decal->tri.verts = slab.verts + i * MAX_DECAL_VERTS;
+			decal->tri.indexes = slab.indexes + i * MAX_DECAL_INDEXES;
+			decal->nextDecal = decalPool.freeList;
+			decalPool.freeList = decal;
+		}
+	}
+
+	idRenderModelDecal *decal = decalPool.freeList;
+	decalPool.freeList = decal->nextDecal;
+	decalPool.numUsed++;
+	tr.pc.c_decalsCreated++;
+
+	decal->material = NULL;
+	decal->tri.numVerts = 0;
+	decal->tri.numIndexes = 0;
+	decal->expireTime = INT_MAX;
+	decal->nextDecal = NULL;
+	return decal;
 }
 
 /*
 ==================
-idRenderModelDecal::idRenderModelDecal
+idRenderModelDecal::Free
 ==================
 */
 void idRenderModelDecal::Free( idRenderModelDecal *decal ) {
-	delete decal;
+	decal->material = NULL;
+	decal->nextDecal = decalPool.freeList;
+	decalPool.freeList = decal;
+	decalPool.numUsed--;
+}
+
+/*
+==================
+idRenderModelDecal::GetPoolStats
+==================
+*/
+void idRenderModelDecal::GetPoolStats( int &numUsed, int &numAllocated, int &numBytes ) {
+	numUsed = decalPool.numUsed;
+	numAllocated = decalPool.slabs.Num() * DECAL_POOL_SLAB_SIZE;
+	numBytes = numAllocated * ( sizeof( idRenderModelDecal ) + MAX_DECAL_VERTS * sizeof( idDrawVert ) + MAX_DECAL_INDEXES * sizeof( glIndex_t ) );
 }
 
 /*
@@ -211,6 +298,7 @@ void idRenderModelDecal::AddWinding( const idWinding &w, const idMaterial *decal
 		// add to this decal
 		decalInfo = material->GetDecalInfo();
 		invFadeDepth = -1.0f / fadeDepth;
+		expireTime = idMath::Imin( expireTime, startTime + decalInfo.stayTime + decalInfo.fadeTime );
 
 		for ( i = 0; i < w.GetNumPoints(); i++ ) {
 			fade = fadePlanes[0].Distance( w[i].ToVec3() ) * invFadeDepth;
@@ -397,11 +485,17 @@ idRenderModelDecal *idRenderModelDecal::RemoveFadedDecals( idRenderModelDecal *d
 		Free( decals );
 		return nextDecal;
 	}
-	
+
+	// no triangle faded away yet
+	if ( time < decals->expireTime ) {
+		return decals;
+	}
+
 	decalInfo = decals->material->GetDecalInfo();
 	minTime = time - ( decalInfo.stayTime + decalInfo.fadeTime );
 
 	newNumIndexes = 0;
+	decals->expireTime = INT_MAX;
 	for ( i = 0; i < decals->tri.numIndexes; i += 3 ) {
 		if ( decals->indexStartTime[i] > minTime ) {
 			// keep this triangle
@@ -412,6 +506,7 @@ idRenderModelDecal *idRenderModelDecal::RemoveFadedDecals( idRenderModelDecal *d
 				}
 			}
 			newNumIndexes += 3;
+			decals->expireTime = idMath::Imin( decals->expireTime, decals->indexStartTime[i] + decalInfo.stayTime + decalInfo.fadeTime );
 		}
 	}
 
@@ -419,6 +514,7 @@ idRenderModelDecal *idRenderModelDecal::RemoveFadedDecals( idRenderModelDecal *d
 	if ( newNumIndexes == 0 ) {
 		nextDecal = decals->nextDecal;
 		Free( decals );
+		tr.pc.c_decalsExpired++;
 		return nextDecal;
 	}
 
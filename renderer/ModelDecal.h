@@ -25,8 +25,9 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 	one that receives lighting, because no interactions are generated
 	for these lightweight surfaces.
 
-	FIXME:	Decals on models in portalled off areas do not get freed
-			until the area becomes visible again.
+	All decals come from a global pool of slabs with fixed-size vertex
+	and index storage, and faded decals of all entities are removed
+	once per frame (see idRenderWorldLocal::FreeFadedDecals).
 
 ===============================================================================
 */
@@ -55,6 +56,9 @@ public:
 	static idRenderModelDecal *	Alloc( void );
 	static void					Free( idRenderModelDecal *decal );
 
+								// Returns number of decals in use and allocated, and bytes of pool memory.
+	static void					GetPoolStats( int &numUsed, int &numAllocated, int &numBytes );
+
 								// Creates decal projection info.
 	static bool					CreateProjectionInfo( decalProjectionInfo_t &info, const idFixedWinding &winding, const idVec3 &projectionOrigin, const bool parallel, const float fadeDepth, const idMaterial *material, const int startTime );
 
@@ -85,7 +89,8 @@ private:
 	srfTriangles_t				tri;
 	float						vertDepthFade[MAX_DECAL_VERTS];
 	int							indexStartTime[MAX_DECAL_INDEXES];
-	idRenderModelDecal *		nextDecal;
+	int							expireTime;			// earliest time when any triangle of this decal is faded away
+	idRenderModelDecal *		nextDecal;			// next decal in the chain, or in the free list of the pool
 
 								// Adds the winding triangles to the appropriate decal in the
 								// chain, creating a new one if necessary.
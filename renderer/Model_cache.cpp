@@ -0,0 +1,203 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "tr_local.h"
+#include "Model_local.h"
+
+/*
+===============================================================================
+
+	Processed model cache
+
+	Parsing ASE/LWO/MA/FLT files and running R_CleanupTriangles on their surfaces
+	(sil edges, tangents, dominant tris, etc.) is a large part of map load time.
+	When a static model is loaded from its source file, the cleaned up surfaces
+	are written to modelCache/<model name>.pmdl, and next time they are read
+	from there as long as:
+		the source file has the same timestamp,
+		model conversion cvars (r_mergeModelSurfaces, r_slop*) are the same,
+		every material still has the same properties which affect processing.
+
+	Deform bounds and surface areas are computed after loading, since they
+	depend on decls which can change independently of the model.
+
+===============================================================================
+*/
+
+static const int PROCESSED_MODEL_MAGIC = ( 'P' << 24 ) | ( 'M' << 16 ) | ( 'D' << 8 ) | 'L';
+static const int PROCESSED_MODEL_VERSION = 1;
+
+/*
+================
+R_ProcessedModelFileName
+================
+*/
+static idStr R_ProcessedModelFileName( const char *fileName ) {
+	idStr path = "modelCache/";
+	path += fileName;
+	path += ".pmdl";
+	return path;
+}
+
+/*
+================
+R_ProcessedModelSettings
+
+checksum of everything global which affects conversion of model files
+================
+*/
+static unsigned int R_ProcessedModelSettings( bool mergeSurfaces, float slopVertex, float slopTexCoord, float slopNormal ) {
+	idStr settings = va( "%d %d %d %d %d %g %g %g",
+		PROCESSED_MODEL_VERSION, ( int )sizeof( idDrawVert ), ( int )sizeof( silEdge_t ), ( int )sizeof( dominantTri_t ),
+		( int )mergeSurfaces, slopVertex, slopTexCoord, slopNormal
+	);
+	return MD4_BlockChecksum( settings.c_str(), settings.Length() );
+}
+
+/*
+================
+R_MaterialProcessingFlags
+
+properties of material which are used when model surfaces are converted and cleaned up
+================
+*/
+static int R_MaterialProcessingFlags( const idMaterial *material ) {
+	const char *renderBump = material->GetRenderBump();
+	int flags = 0;
+	flags |= ( material->IsDiscrete() ? 1 : 0 );
+	flags |= ( renderBump && renderBump[0] ? 2 : 0 );
+	flags |= ( material->ShouldCreateBackSides() ? 4 : 0 );
+	flags |= ( material->UseUnsmoothedTangents() ? 8 : 0 );
+	return flags;
+}
+
+/*
+================
+idRenderModelStatic::LoadProcessedModel
+
+returns false if there is no valid cache for this model
+================
+*/
+bool idRenderModelStatic::LoadProcessedModel( const char *fileName ) {
+	void *buffer = NULL;
+	int length = fileSystem->ReadFile( R_ProcessedModelFileName( fileName ), &buffer );
+	if ( !buffer ) {
+		return false;
+	}
+	// whole file is read at once, surfaces are copied from memory
+	idFile_Memory file( fileName, ( const char * )buffer, length );
+
+	int magic = 0, version = 0;
+	unsigned int settings = 0;
+	idStr sourceName;
+	ID_TIME_T sourceTime = 0;
+	int numSurfaces = -1;
+	file.ReadInt( magic );
+	file.ReadInt( version );
+	file.ReadUnsignedInt( settings );
+	file.ReadString( sourceName );
+	file.Read( &sourceTime, sizeof( sourceTime ) );
+	file.ReadInt( numSurfaces );
+
+	bool valid = (
+		magic == PROCESSED_MODEL_MAGIC && version == PROCESSED_MODEL_VERSION && numSurfaces >= 0 &&
+		settings == R_ProcessedModelSettings( r_mergeModelSurfaces.GetBool(), r_slopVertex.GetFloat(), r_slopTexCoord.GetFloat(), r_slopNormal.GetFloat() )
+	);
+	if ( valid ) {
+		ID_TIME_T currentTime = FILE_NOT_FOUND_TIMESTAMP;
+		fileSystem->ReadFile( sourceName, NULL, &currentTime );
+		valid = ( currentTime != FILE_NOT_FOUND_TIMESTAMP && currentTime == sourceTime );
+	}
+	if ( valid && sourceName.Icmp( fileName ) != 0 ) {
+		// loaded from fallback (ASE <-> LWO), so requested file must still be missing
+		ID_TIME_T requestedTime = FILE_NOT_FOUND_TIMESTAMP;
+		fileSystem->ReadFile( fileName, NULL, &requestedTime );
+		valid = ( requestedTime == FILE_NOT_FOUND_TIMESTAMP );
+	}
+
+	for ( int i = 0; valid && i < numSurfaces; i++ ) {
+		modelSurface_t surf;
+		idStr materialName;
+		int flags = -1;
+		file.ReadInt( surf.id );
+		file.ReadString( materialName );
+		file.ReadInt( flags );
+
+		surf.material = declManager->FindMaterial( materialName );
+		if ( !surf.material || R_MaterialProcessingFlags( surf.material ) != flags ) {
+			valid = false;
+			break;
+		}
+		surf.geometry = R_ReadStaticTriSurf( &file );
+		if ( !surf.geometry ) {
+			valid = false;
+			break;
+		}
+		surfaces.Append( surf );
+	}
+	fileSystem->FreeFile( buffer );
+
+	if ( !valid ) {
+		for ( int i = 0; i < surfaces.Num(); i++ ) {
+			R_ReallyFreeStaticTriSurf( surfaces[i].geometry );
+		}
+		surfaces.Clear();
+		return false;
+	}
+
+	name = sourceName;
+	timeStamp = sourceTime;
+	return true;
+}
+
+/*
+================
+idRenderModelStatic::WriteProcessedModel
+
+must be called right after CleanupSurfaces
+================
+*/
+void idRenderModelStatic::WriteProcessedModel( const char *fileName ) {
+	ID_TIME_T sourceTime = FILE_NOT_FOUND_TIMESTAMP;
+	fileSystem->ReadFile( name, NULL, &sourceTime );
+	if ( sourceTime == FILE_NOT_FOUND_TIMESTAMP ) {
+		return;
+	}
+
+	idFile *file = fileSystem->OpenFileWrite( R_ProcessedModelFileName( fileName ) );
+	if ( !file ) {
+		return;
+	}
+
+	file->WriteInt( PROCESSED_MODEL_MAGIC );
+	file->WriteInt( PROCESSED_MODEL_VERSION );
+	file->WriteUnsignedInt( R_ProcessedModelSettings( r_mergeModelSurfaces.GetBool(), r_slopVertex.GetFloat(), r_slopTexCoord.GetFloat(), r_slopNormal.GetFloat() ) );
+	file->WriteString( name );
+	file->Write( &sourceTime, sizeof( sourceTime ) );
+	file->WriteInt( surfaces.Num() );
+
+	for ( int i = 0; i < surfaces.Num(); i++ ) {
+		const modelSurface_t &surf = surfaces[i];
+		file->WriteInt( surf.id );
+		file->WriteString( surf.material->GetName() );
+		file->WriteInt( R_MaterialProcessingFlags( surf.material ) );
+		R_WriteStaticTriSurf( file, surf.geometry );
+	}
+
+	fileSystem->CloseFile( file );
+}
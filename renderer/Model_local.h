@@ -80,6 +80,11 @@ public:
 	bool						LoadMA( const char *filename );
 	bool						LoadProxy( const char *filename );
 
+	bool						LoadProcessedModel( const char *fileName );
+	void						WriteProcessedModel( const char *fileName );
+	void						CleanupSurfaces();
+	void						FinishSurfaceBounds();
+
 	bool						ConvertASEToModelSurfaces( const struct aseModel_s *ase );
 	bool						ConvertLWOToModelSurfaces( const struct st_lwObject *lwo );
 	bool						ConvertMAToModelSurfaces (const struct maModel_s *ma );
@@ -115,6 +120,7 @@ protected:
 	static idCVar				r_slopVertex;			// merge xyz coordinates this far apart
 	static idCVar				r_slopTexCoord;			// merge texture coordinates this far apart
 	static idCVar				r_slopNormal;			// merge normals that dot less than this
+	static idCVar				r_useProcessedModelCache;	// load cleaned up surfaces from modelCache/
 };
 
 /*
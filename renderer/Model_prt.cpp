@@ -172,26 +172,7 @@ idRenderModel *idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 			R_AllocStaticTriSurfPlanes( surf->geometry, 6 * count );
 		}
 
-		int numVerts = 0;
-		idDrawVert *verts = surf->geometry->verts;
-
-		for ( int index = 0; index < stage->totalParticles; index++ ) {
-			idParticleData part;
-			int cycIdx;
-			if (!idParticle_EmitParticle(*stage, psEmit, index, part, cycIdx))
-				continue;
-
-			if (cutoffImage) {
-				float cutoff = idParticle_FetchCutoffTimeLinear(cutoffImage, psys.totalParticles, index, cycIdx);
-				if (part.frac > cutoff)
-					continue;
-			}
-
-			// if the particle doesn't get drawn because it is faded out or beyond a kill region, don't increment the verts
-			idDrawVert *ptr = verts + numVerts;
-			idParticle_CreateParticle(*stage, psys, part, ptr);
-			numVerts = ptr - verts;
-		}
+		int numVerts = idParticle_GenerateStage( stage, psys, psEmit, stage->totalParticles, nullptr, nullptr, cutoffImage, nullptr, surf->geometry->verts );
 
 		// numVerts must be a multiple of 4
 		assert( ( numVerts & 3 ) == 0 && numVerts <= 4 * count );
@@ -0,0 +1,604 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "qgl.h"
+#include "tr_local.h"
+
+/*
+===============================================================================
+
+	Null OpenGL implementation for headless mode (r_headless)
+
+	All GL function pointers are filled by glad from the loader below instead
+	of the driver. Draw calls, state changes and texture uploads do nothing,
+	while queries return values which let renderer initialization pass:
+	OpenGL 3.3 with S3TC, successfully compiled and linked shaders, complete
+	framebuffers, signaled fences.
+
+	Buffer objects are emulated in CPU memory, because the back end writes
+	vertex/uniform data through mapped pointers and reads the light gem back
+	from a pixel pack buffer. Everything read back from "GPU" is zeros.
+
+	Every function which is not implemented explicitly is bound to a single
+	stub returning zero. That relies on the caller cleaning up arguments,
+	which is true for x86-64 calling conventions but not for stdcall.
+
+	Only used from the back end thread, so nothing is synchronized.
+
+===============================================================================
+*/
+
+typedef struct {
+	byte *			data;
+	int				size;
+} nullBuffer_t;
+
+typedef struct {
+	GLenum			target;
+	GLuint			buffer;
+} nullBinding_t;
+
+static const int NULL_GL_MAX_BINDINGS = 16;
+
+static idList<nullBuffer_t>	nullBuffers;		// indexed by buffer name
+static nullBinding_t		nullBindings[NULL_GL_MAX_BINDINGS];
+static int					nullNumBindings;
+static GLuint				nullNextName;
+static GLint				nullViewport[4];
+static GLint				nullPackAlignment;
+
+static const char *NULL_GL_EXTENSIONS[] = {
+	"GL_EXT_texture_compression_s3tc",
+};
+
+/*
+================
+NullGL_Stub
+================
+*/
+static GLintptr APIENTRY NullGL_Stub() {
+	return 0;
+}
+
+/*
+================
+NullGL_BoundBuffer
+================
+*/
+static nullBuffer_t *NullGL_BoundBuffer( GLenum target ) {
+	for ( int i = 0; i < nullNumBindings; i++ ) {
+		if ( nullBindings[i].target == target ) {
+			GLuint name = nullBindings[i].buffer;
+			return ( name > 0 && name < ( GLuint )nullBuffers.Num() ) ? &nullBuffers[name] : NULL;
+		}
+	}
+	return NULL;
+}
+
+/*
+================
+NullGL_ResizeBuffer
+================
+*/
+static void NullGL_ResizeBuffer( nullBuffer_t *buf, GLsizeiptr size, const void *data ) {
+	if ( !buf ) {
+		return;
+	}
+	Mem_Free16( buf->data );
+	buf->size = ( int )size;
+	buf->data = ( byte * )Mem_Alloc16( idMath::Imax( buf->size, 16 ) );
+	if ( data ) {
+		memcpy( buf->data, data, buf->size );
+	} else {
+		memset( buf->data, 0, buf->size );
+	}
+}
+
+/*
+================
+NullGL_GetString
+================
+*/
+static const GLubyte * APIENTRY NullGL_GetString( GLenum name ) {
+	switch ( name ) {
+		case GL_VENDOR:						return ( const GLubyte * )"Null";
+		case GL_RENDERER:					return ( const GLubyte * )"Null (headless)";
+		case GL_VERSION:					return ( const GLubyte * )"3.3 Null";
+		case GL_SHADING_LANGUAGE_VERSION:	return ( const GLubyte * )"3.30";
+		case GL_EXTENSIONS:					return ( const GLubyte * )"GL_EXT_texture_compression_s3tc";
+	}
+	return ( const GLubyte * )"";
+}
+
+/*
+================
+NullGL_GetStringi
+================
+*/
+static const GLubyte * APIENTRY NullGL_GetStringi( GLenum name, GLuint index ) {
+	if ( name == GL_EXTENSIONS && index < sizeof( NULL_GL_EXTENSIONS ) / sizeof( NULL_GL_EXTENSIONS[0] ) ) {
+		return ( const GLubyte * )NULL_GL_EXTENSIONS[index];
+	}
+	return NULL;
+}
+
+/*
+================
+NullGL_GetIntegerv
+================
+*/
+static void APIENTRY NullGL_GetIntegerv( GLenum pname, GLint *data ) {
+	switch ( pname ) {
+		case GL_NUM_EXTENSIONS:
+			data[0] = sizeof( NULL_GL_EXTENSIONS ) / sizeof( NULL_GL_EXTENSIONS[0] );
+			break;
+		case GL_MAX_TEXTURE_SIZE:
+		case GL_MAX_RENDERBUFFER_SIZE:
+			data[0] = 16384;
+			break;
+		case GL_MAX_TEXTURE_IMAGE_UNITS:
+			data[0] = 32;
+			break;
+		case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+			data[0] = 192;
+			break;
+		case GL_MAX_VERTEX_ATTRIBS:
+			data[0] = 16;
+			break;
+		case GL_MAX_SAMPLES:
+			data[0] = 8;
+			break;
+		case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+			data[0] = 256;
+			break;
+		case GL_MAX_UNIFORM_BLOCK_SIZE:
+			data[0] = 65536;
+			break;
+		case GL_PACK_ALIGNMENT:
+			data[0] = nullPackAlignment;
+			break;
+		case GL_VIEWPORT:
+			memcpy( data, nullViewport, sizeof( nullViewport ) );
+			break;
+		case GL_SCISSOR_BOX:
+			memset( data, 0, 4 * sizeof( GLint ) );
+			break;
+		case GL_MAX_VIEWPORT_DIMS:
+			data[0] = data[1] = 16384;
+			break;
+		default:
+			data[0] = 0;
+			break;
+	}
+}
+
+/*
+================
+NullGL_GetFloatv
+================
+*/
+static void APIENTRY NullGL_GetFloatv( GLenum pname, GLfloat *data ) {
+	switch ( pname ) {
+		case GL_VIEWPORT:
+			for ( int i = 0; i < 4; i++ ) {
+				data[i] = nullViewport[i];
+			}
+			break;
+		case GL_DEPTH_RANGE:
+			data[0] = 0.0f;
+			data[1] = 1.0f;
+			break;
+		default:
+			data[0] = 0.0f;
+			break;
+	}
+}
+
+/*
+================
+NullGL_Viewport
+================
+*/
+static void APIENTRY NullGL_Viewport( GLint x, GLint y, GLsizei width, GLsizei height ) {
+	nullViewport[0] = x;
+	nullViewport[1] = y;
+	nullViewport[2] = width;
+	nullViewport[3] = height;
+}
+
+/*
+================
+NullGL_PixelStorei
+================
+*/
+static void APIENTRY NullGL_PixelStorei( GLenum pname, GLint param ) {
+	if ( pname == GL_PACK_ALIGNMENT ) {
+		nullPackAlignment = param;
+	}
+}
+
+/*
+================
+NullGL_GenNames
+
+textures, framebuffers, vertex arrays, etc.: only need unique names
+================
+*/
+static void APIENTRY NullGL_GenNames( GLsizei n, GLuint *names ) {
+	for ( int i = 0; i < n; i++ ) {
+		names[i] = ++nullNextName;
+	}
+}
+
+/*
+================
+NullGL_CreateObject
+================
+*/
+static GLuint APIENTRY NullGL_CreateObject() {
+	return ++nullNextName;
+}
+
+/*
+================
+NullGL_CreateShader
+================
+*/
+static GLuint APIENTRY NullGL_CreateShader( GLenum type ) {
+	return ++nullNextName;
+}
+
+/*
+================
+NullGL_GetShaderiv
+================
+*/
+static void APIENTRY NullGL_GetShaderiv( GLuint shader, GLenum pname, GLint *params ) {
+	switch ( pname ) {
+		case GL_COMPILE_STATUS:
+		case GL_LINK_STATUS:
+		case GL_VALIDATE_STATUS:
+			params[0] = GL_TRUE;
+			break;
+		default:
+			params[0] = 0;
+			break;
+	}
+}
+
+/*
+================
+NullGL_GetUniformBlockIndex
+================
+*/
+static GLuint APIENTRY NullGL_GetUniformBlockIndex( GLuint program, const GLchar *name ) {
+	return GL_INVALID_INDEX;
+}
+
+/*
+================
+NullGL_GetLocation
+================
+*/
+static GLint APIENTRY NullGL_GetLocation( GLuint program, const GLchar *name ) {
+	return -1;
+}
+
+/*
+================
+NullGL_CheckFramebufferStatus
+================
+*/
+static GLenum APIENTRY NullGL_CheckFramebufferStatus( GLenum target ) {
+	return GL_FRAMEBUFFER_COMPLETE;
+}
+
+/*
+================
+NullGL_FenceSync
+================
+*/
+static GLsync APIENTRY NullGL_FenceSync( GLenum condition, GLbitfield flags ) {
+	static int dummy;
+	return ( GLsync )&dummy;
+}
+
+/*
+================
+NullGL_ClientWaitSync
+================
+*/
+static GLenum APIENTRY NullGL_ClientWaitSync( GLsync sync, GLbitfield flags, GLuint64 timeout ) {
+	return GL_ALREADY_SIGNALED;
+}
+
+/*
+================
+NullGL_GenBuffers
+================
+*/
+static void APIENTRY NullGL_GenBuffers( GLsizei n, GLuint *names ) {
+	if ( nullBuffers.Num() == 0 ) {
+		// name 0 is never used
+		nullBuffers.Append( nullBuffer_t() );
+		memset( &nullBuffers[0], 0, sizeof( nullBuffer_t ) );
+	}
+	for ( int i = 0; i < n; i++ ) {
+		nullBuffer_t buf;
+		buf.data = NULL;
+		buf.size = 0;
+		names[i] = nullBuffers.Append( buf );
+	}
+}
+
+/*
+================
+NullGL_DeleteBuffers
+================
+*/
+static void APIENTRY NullGL_DeleteBuffers( GLsizei n, const GLuint *names ) {
+	for ( int i = 0; i < n; i++ ) {
+		GLuint name = names[i];
+		if ( name == 0 || name >= ( GLuint )nullBuffers.Num() ) {
+			continue;
+		}
+		Mem_Free16( nullBuffers[name].data );
+		nullBuffers[name].data = NULL;
+		nullBuffers[name].size = 0;
+		for ( int j = 0; j < nullNumBindings; j++ ) {
+			if ( nullBindings[j].buffer == name ) {
+				nullBindings[j].buffer = 0;
+			}
+		}
+	}
+}
+
+/*
+================
+NullGL_BindBuffer
+================
+*/
+static void APIENTRY NullGL_BindBuffer( GLenum target, GLuint buffer ) {
+	for ( int i = 0; i < nullNumBindings; i++ ) {
+		if ( nullBindings[i].target == target ) {
+			nullBindings[i].buffer = buffer;
+			return;
+		}
+	}
+	if ( nullNumBindings < NULL_GL_MAX_BINDINGS ) {
+		nullBindings[nullNumBindings].target = target;
+		nullBindings[nullNumBindings].buffer = buffer;
+		nullNumBindings++;
+	}
+}
+
+/*
+================
+NullGL_BindBufferBase
+================
+*/
+static void APIENTRY NullGL_BindBufferBase( GLenum target, GLuint index, GLuint buffer ) {
+	// indexed binding also changes the generic one
+	NullGL_BindBuffer( target, buffer );
+}
+
+/*
+================
+NullGL_BindBufferRange
+================
+*/
+static void APIENTRY NullGL_BindBufferRange( GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size ) {
+	NullGL_BindBuffer( target, buffer );
+}
+
+/*
+================
+NullGL_BufferData
+================
+*/
+static void APIENTRY NullGL_BufferData( GLenum target, GLsizeiptr size, const void *data, GLenum usage ) {
+	NullGL_ResizeBuffer( NullGL_BoundBuffer( target ), size, data );
+}
+
+/*
+================
+NullGL_BufferStorage
+================
+*/
+static void APIENTRY NullGL_BufferStorage( GLenum target, GLsizeiptr size, const void *data, GLbitfield flags ) {
+	NullGL_ResizeBuffer( NullGL_BoundBuffer( target ), size, data );
+}
+
+/*
+================
+NullGL_BufferSubData
+================
+*/
+static void APIENTRY NullGL_BufferSubData( GLenum target, GLintptr offset, GLsizeiptr size, const void *data ) {
+	nullBuffer_t *buf = NullGL_BoundBuffer( target );
+	if ( buf && data && offset >= 0 && offset + size <= buf->size ) {
+		memcpy( buf->data + offset, data, size );
+	}
+}
+
+/*
+================
+NullGL_GetBufferSubData
+================
+*/
+static void APIENTRY NullGL_GetBufferSubData( GLenum target, GLintptr offset, GLsizeiptr size, void *data ) {
+	nullBuffer_t *buf = NullGL_BoundBuffer( target );
+	if ( buf && offset >= 0 && offset + size <= buf->size ) {
+		memcpy( data, buf->data + offset, size );
+	} else {
+		memset( data, 0, size );
+	}
+}
+
+/*
+================
+NullGL_MapBuffer
+================
+*/
+static void * APIENTRY NullGL_MapBuffer( GLenum target, GLenum access ) {
+	nullBuffer_t *buf = NullGL_BoundBuffer( target );
+	return buf ? buf->data : NULL;
+}
+
+/*
+================
+NullGL_MapBufferRange
+================
+*/
+static void * APIENTRY NullGL_MapBufferRange( GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access ) {
+	nullBuffer_t *buf = NullGL_BoundBuffer( target );
+	if ( !buf || !buf->data || offset < 0 || offset + length > buf->size ) {
+		return NULL;
+	}
+	return buf->data + offset;
+}
+
+/*
+================
+NullGL_UnmapBuffer
+================
+*/
+static GLboolean APIENTRY NullGL_UnmapBuffer( GLenum target ) {
+	return GL_TRUE;
+}
+
+/*
+================
+NullGL_ReadPixels
+
+fills destination with zeros, so that callers never see uninitialized memory
+================
+*/
+static void APIENTRY NullGL_ReadPixels( GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void *pixels ) {
+	int components;
+	switch ( format ) {
+		case GL_RGBA: case GL_BGRA:	components = 4; break;
+		case GL_RGB: case GL_BGR:	components = 3; break;
+		case GL_RG:					components = 2; break;
+		default:					components = 1; break;
+	}
+	int componentSize;
+	switch ( type ) {
+		case GL_UNSIGNED_BYTE: case GL_BYTE:	componentSize = 1; break;
+		case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT:	componentSize = 2; break;
+		default:								componentSize = 4; break;
+	}
+	if ( type == GL_UNSIGNED_INT_24_8 ) {
+		components = 1;
+	}
+	int align = idMath::Imax( nullPackAlignment, 1 );
+	int rowSize = ( width * components * componentSize + align - 1 ) / align * align;
+	int size = rowSize * height;
+
+	nullBuffer_t *pack = NullGL_BoundBuffer( GL_PIXEL_PACK_BUFFER );
+	if ( pack ) {
+		// pixels is offset in pack buffer
+		GLintptr offset = ( GLintptr )pixels;
+		if ( offset >= 0 && offset + size <= pack->size ) {
+			memset( pack->data + offset, 0, size );
+		}
+	} else if ( pixels ) {
+		memset( pixels, 0, size );
+	}
+}
+
+/*
+================
+NullGL_GetProcAddress
+
+loader passed to glad
+================
+*/
+static void *NullGL_GetProcAddress( const char *name ) {
+	static const struct {
+		const char *	name;
+		void *			func;
+	} functions[] = {
+		{ "glGetString",				( void * )NullGL_GetString },
+		{ "glGetStringi",				( void * )NullGL_GetStringi },
+		{ "glGetIntegerv",				( void * )NullGL_GetIntegerv },
+		{ "glGetFloatv",				( void * )NullGL_GetFloatv },
+		{ "glViewport",					( void * )NullGL_Viewport },
+		{ "glPixelStorei",				( void * )NullGL_PixelStorei },
+		{ "glGenTextures",				( void * )NullGL_GenNames },
+		{ "glGenFramebuffers",			( void * )NullGL_GenNames },
+		{ "glGenRenderbuffers",			( void * )NullGL_GenNames },
+		{ "glGenVertexArrays",			( void * )NullGL_GenNames },
+		{ "glGenQueries",				( void * )NullGL_GenNames },
+		{ "glGenSamplers",				( void * )NullGL_GenNames },
+		{ "glCreateProgram",			( void * )NullGL_CreateObject },
+		{ "glCreateShader",				( void * )NullGL_CreateShader },
+		{ "glGetShaderiv",				( void * )NullGL_GetShaderiv },
+		{ "glGetProgramiv",				( void * )NullGL_GetShaderiv },
+		{ "glGetUniformBlockIndex",		( void * )NullGL_GetUniformBlockIndex },
+		{ "glGetUniformLocation",		( void * )NullGL_GetLocation },
+		{ "glGetAttribLocation",		( void * )NullGL_GetLocation },
+		{ "glCheckFramebufferStatus",	( void * )NullGL_CheckFramebufferStatus },
+		{ "glFenceSync",				( void * )NullGL_FenceSync },
+		{ "glClientWaitSync",			( void * )NullGL_ClientWaitSync },
+		{ "glGenBuffers",				( void * )NullGL_GenBuffers },
+		{ "glDeleteBuffers",			( void * )NullGL_DeleteBuffers },
+		{ "glBindBuffer",				( void * )NullGL_BindBuffer },
+		{ "glBindBufferBase",			( void * )NullGL_BindBufferBase },
+		{ "glBindBufferRange",			( void * )NullGL_BindBufferRange },
+		{ "glBufferData",				( void * )NullGL_BufferData },
+		{ "glBufferStorage",			( void * )NullGL_BufferStorage },
+		{ "glBufferSubData",			( void * )NullGL_BufferSubData },
+		{ "glGetBufferSubData",			( void * )NullGL_GetBufferSubData },
+		{ "glMapBuffer",				( void * )NullGL_MapBuffer },
+		{ "glMapBufferRange",			( void * )NullGL_MapBufferRange },
+		{ "glUnmapBuffer",				( void * )NullGL_UnmapBuffer },
+		{ "glReadPixels",				( void * )NullGL_ReadPixels },
+	};
+
+	for ( int i = 0; i < sizeof( functions ) / sizeof( functions[0] ); i++ ) {
+		if ( !strcmp( functions[i].name, name ) ) {
+			return functions[i].func;
+		}
+	}
+	return ( void * )NullGL_Stub;
+}
+
+/*
+================
+GLimp_LoadNullFunctions
+================
+*/
+void GLimp_LoadNullFunctions() {
+#if defined( _WIN32 ) && !defined( _WIN64 )
+	common->FatalError( "r_headless is not supported in 32-bit build" );
+#endif
+	for ( int i = 0; i < nullBuffers.Num(); i++ ) {
+		Mem_Free16( nullBuffers[i].data );
+	}
+	nullBuffers.Clear();
+	memset( nullBindings, 0, sizeof( nullBindings ) );
+	nullNumBindings = 0;
+	nullNextName = 0;
+	memset( nullViewport, 0, sizeof( nullViewport ) );
+	nullPackAlignment = 4;
+
+	if ( !gladLoadGLLoader( NullGL_GetProcAddress ) ) {
+		common->FatalError( "Failed to initialize null OpenGL functions" );
+	}
+}
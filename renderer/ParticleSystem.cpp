@@ -434,3 +434,126 @@ float idParticle_FetchCutoffTimeLinear(const idImage *image, int totalParticles,
 	float ratio = ((texel[0] * 256 + texel[1]) * 256 + texel[2]) * TWO_POWER_MINUS_24;
 	return ratio;
 }
+
+//===========================================================================
+
+idCVar r_particleParallelMin( "r_particleParallelMin", "4096", CVAR_RENDERER | CVAR_INTEGER, "particle stages with at least this many live particles are generated by parallel tasks, 0 = never" );
+
+//number of live particles generated by one task
+static const int PARTICLE_CHUNK_SIZE = 1024;
+
+//live particles of a stage, in SoA layout
+struct idParticleBatch {
+	int num;
+	int *index;
+	float *frac;
+	int *randomSeed;
+	//only for surface emitters, NULL for particle models (where origin is zero and axis is identity)
+	idVec3 *origin;
+	idMat3 *axis;
+};
+
+static void idParticle_CreateBatchRange(const idParticleStage *stage, const idPartSysData &psys, const idParticleBatch &batch, int begin, int end, idDrawVert *&emitter) {
+	idParticleData part;
+	part.origin.Zero();
+	part.axis.Identity();
+	for (int i = begin; i < end; i++) {
+		part.index = batch.index[i];
+		part.frac = batch.frac[i];
+		part.randomSeed = batch.randomSeed[i];
+		if (batch.origin) {
+			part.origin = batch.origin[i];
+			part.axis = batch.axis[i];
+		}
+		idParticle_CreateParticle(*stage, psys, part, emitter);
+	}
+}
+
+int idParticle_GenerateStage(
+	const idParticleStage *stage, const idPartSysData &psys, const idPartSysEmit &psEmit, int totalParticles,
+	const srfTriangles_t *tri, float *areas,
+	const idImage *cutoffImage, const idPartSysCutoffTextureInfo *cutoffInfo,
+	idDrawVert *verts
+) {
+	if (totalParticles <= 0)
+		return 0;
+
+	//gather live particles (emission is cheap compared to creating quads)
+	idParticleBatch batch;
+	batch.num = 0;
+	batch.index = (int *)R_FrameAlloc(totalParticles * sizeof(batch.index[0]));
+	batch.frac = (float *)R_FrameAlloc(totalParticles * sizeof(batch.frac[0]));
+	batch.randomSeed = (int *)R_FrameAlloc(totalParticles * sizeof(batch.randomSeed[0]));
+	batch.origin = nullptr;
+	batch.axis = nullptr;
+	if (tri) {
+		batch.origin = (idVec3 *)R_FrameAlloc(totalParticles * sizeof(batch.origin[0]));
+		batch.axis = (idMat3 *)R_FrameAlloc(totalParticles * sizeof(batch.axis[0]));
+	}
+
+	for (int index = 0; index < totalParticles; index++) {
+		idParticleData part;
+		int cycIdx;
+		if (!idParticle_EmitParticle(*stage, psEmit, index, part, cycIdx))
+			continue;
+
+		idVec2 texcoord;
+		if (tri) {
+			// locate the particle origin and axis somewhere on the surface
+			idParticle_EmitLocationOnSurface(*stage, tri, part, texcoord, areas);
+		}
+
+		if (cutoffImage) {
+			float cutoff;
+			if (stage->mapLayoutType == PML_TEXTURE) {
+				cutoff = idParticle_FetchCutoffTimeTexture(cutoffImage, *cutoffInfo, texcoord);
+			} else {
+				cutoff = idParticle_FetchCutoffTimeLinear(cutoffImage, totalParticles, index, cycIdx);
+			}
+			if (part.frac > cutoff)
+				continue;
+		}
+
+		int k = batch.num++;
+		batch.index[k] = part.index;
+		batch.frac[k] = part.frac;
+		batch.randomSeed[k] = part.randomSeed;
+		if (tri) {
+			batch.origin[k] = part.origin;
+			batch.axis[k] = part.axis;
+		}
+	}
+
+	int numChunks = (batch.num + PARTICLE_CHUNK_SIZE - 1) / PARTICLE_CHUNK_SIZE;
+	int parallelMin = r_particleParallelMin.GetInteger();
+	if (parallelMin <= 0 || batch.num < parallelMin || numChunks < 2) {
+		// if the particle doesn't get drawn because it is faded out or beyond a kill region, no verts are emitted
+		idDrawVert *emitter = verts;
+		idParticle_CreateBatchRange(stage, psys, batch, 0, batch.num, emitter);
+		return emitter - verts;
+	}
+
+	//every chunk is written at the place where it would start if no particle was killed
+	int maxVertsPerParticle = 4 * stage->NumQuadsPerParticle();
+	int *chunkVerts = (int *)R_FrameAlloc(numChunks * sizeof(chunkVerts[0]));
+	taskScheduler->ParallelFor(0, numChunks, [&](int begin, int end) {
+		for (int c = begin; c < end; c++) {
+			int first = c * PARTICLE_CHUNK_SIZE;
+			int last = idMath::Imin(first + PARTICLE_CHUNK_SIZE, batch.num);
+			idDrawVert *start = verts + first * maxVertsPerParticle;
+			idDrawVert *emitter = start;
+			idParticle_CreateBatchRange(stage, psys, batch, first, last, emitter);
+			chunkVerts[c] = emitter - start;
+		}
+	}, 1);
+
+	//pack chunks together in order
+	int numVerts = 0;
+	for (int c = 0; c < numChunks; c++) {
+		idDrawVert *start = verts + c * PARTICLE_CHUNK_SIZE * maxVertsPerParticle;
+		if (start != verts + numVerts)
+			memmove(verts + numVerts, start, chunkVerts[c] * sizeof(verts[0]));
+		numVerts += chunkVerts[c];
+	}
+	return numVerts;
+}
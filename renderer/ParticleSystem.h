@@ -122,3 +122,18 @@ void idParticle_PrepareCutoffMap(
 float idParticle_FetchCutoffTimeTexture(const idImage *image, const idPartSysCutoffTextureInfo &texinfo, idVec2 texcoord);
 //fetches cutoffTime from the image (with "mapLayout linear") using index of particle and its current cycle
 float idParticle_FetchCutoffTimeLinear(const idImage *image, int totalParticles, int index, int cycIdx);
+
+//---------------------------------------------------------------------------
+
+//generates quads of all particles of a stage into "verts", returns number of vertices written
+//result is exactly the same as calling idParticle_EmitParticle and idParticle_CreateParticle for every index in order:
+//live particles are gathered first, then large stages are split into chunks generated by parallel tasks
+//"tri" and "areas" specify surface emitter for particle deform (see idParticle_EmitLocationOnSurface), "tri" is NULL for particle model
+//"cutoffImage" and "cutoffInfo" are results of idParticle_PrepareCutoffMap ("cutoffImage" is NULL if there is no cutoff)
+//"verts" must have room for 4 * stage->NumQuadsPerParticle() * totalParticles vertices
+int idParticle_GenerateStage(
+	const idParticleStage *stage, const idPartSysData &psys, const idPartSysEmit &psEmit, int totalParticles,
+	const srfTriangles_t *tri, float *areas,
+	const idImage *cutoffImage, const idPartSysCutoffTextureInfo *cutoffInfo,
+	idDrawVert *verts
+);
@@ -87,6 +87,13 @@ static void R_PerformanceCounters( void ) {
 		common->Printf( "alloc:%i free:%i\n", tr.pc.c_alloc, tr.pc.c_free );
 	}
 
+	if ( r_showDecals.GetBool() ) {
+		int numUsed, numAllocated, numBytes;
+		idRenderModelDecal::GetPoolStats( numUsed, numAllocated, numBytes );
+		common->Printf( "decals:%i/%i pool:%i KB created:%i expired:%i time:%i usec\n",
+		                numUsed, numAllocated, numBytes >> 10, tr.pc.c_decalsCreated, tr.pc.c_decalsExpired, tr.pc.decalMicroseconds );
+	}
+
 	if ( r_showInteractions.GetBool() ) {
 		common->Printf( "createInteractions:%i createLightTris:%i createShadowVolumes:%i\n",
 		                tr.pc.c_createInteractions, tr.pc.c_createLightTris, tr.pc.c_createShadowVolumes );
@@ -195,7 +202,6 @@ static void R_ViewStatistics( viewDef_t &parms ) {
 }
 
 viewDef_t lockSurfView;
-int lockFrameReserve;
 
 /*
 =============
@@ -216,7 +222,7 @@ void	R_AddDrawViewCmd( viewDef_t &parms ) {
 	if ( parms.viewEntitys ) {
 		// save the command for r_lockSurfaces debugging
 		lockSurfView = *cmd->viewDef;
-		lockFrameReserve = frameData->frameMemoryAllocated;
+		R_LockFrameData();
 	}
 	tr.pc.c_numViews++;
 
@@ -251,7 +257,6 @@ void R_LockSurfaceScene( viewDef_t &parms ) {
 	cmd = (drawSurfsCommand_t*) R_GetCommandBuffer( sizeof( *cmd ) );
 	cmd->commandId = RC_DRAW_VIEW;
 	cmd->viewDef = &lockSurfView;
-	frameData->frameMemoryAllocated = lockFrameReserve;
 
 	// set the matrix for world space to eye space
 	R_SetViewMatrix( parms );
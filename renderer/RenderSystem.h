@@ -36,6 +36,7 @@ enum glVendor_t {
 // These are constant once the OpenGL subsystem is initialized.
 typedef struct glconfig_s {
 	bool				isInitialized;
+	bool				isHeadless;				// no window, GL calls go to null implementation
 
 	const char			*renderer_string;
 	const char			*vendor_string;
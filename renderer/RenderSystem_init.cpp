@@ -38,6 +38,7 @@ glconfig_t	glConfig;
 idCVar r_glDriver( "r_glDriver", "", CVAR_RENDERER, "\"opengl32.dll\", etc." );
 idCVar r_glDebugOutput( "r_glDebugOutput", "0", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "Enables GL debug messages and displays them on the console. Using a debug context may provide additional insight. 2 - enables synchronous processing (slower)" );
 idCVar r_glDebugContext( "r_glDebugContext", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "If enabled, create a GL debug context." );
+idCVar r_headless( "r_headless", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_INIT, "don't create window, run front end fully while all GL calls do nothing (for benchmarks and automated tests)" );
 idCVar r_useLightPortalFlow( "r_useLightPortalFlow", "1", CVAR_RENDERER | CVAR_BOOL, "use a more precise area reference determination" );
 idCVar r_multiSamples( "r_multiSamples", "0", CVAR_RENDERER | CVAR_ARCHIVE | CVAR_INTEGER, "number of antialiasing samples" );
 idCVar r_displayRefresh( "r_displayRefresh", "0", CVAR_RENDERER | CVAR_INTEGER | CVAR_NOCHEAT, "optional display refresh rate option for vid mode", 0.0f, 200.0f );
@@ -203,6 +204,7 @@ idCVar r_showTexturePolarity( "r_showTexturePolarity", "0", CVAR_RENDERER | CVAR
 idCVar r_showTangentSpace( "r_showTangentSpace", "0", CVAR_RENDERER | CVAR_INTEGER, "shade triangles by tangent space, 1 = use 1st tangent vector, 2 = use 2nd tangent vector, 3 = use normal vector", 0, 3, idCmdSystem::ArgCompletion_Integer<0, 3> );
 idCVar r_showDominantTri( "r_showDominantTri", "0", CVAR_RENDERER | CVAR_BOOL, "draw lines from vertexes to center of dominant triangles" );
 idCVar r_showAlloc( "r_showAlloc", "0", CVAR_RENDERER | CVAR_BOOL, "report alloc/free counts" );
+idCVar r_showDecals( "r_showDecals", "0", CVAR_RENDERER | CVAR_BOOL, "report decal count, pool memory and time spent on decals" );
 idCVar r_showTextureVectors( "r_showTextureVectors", "0", CVAR_RENDERER | CVAR_FLOAT, " if > 0 draw each triangles texture (tangent) vectors" );
 idCVar r_showOverDraw( "r_showOverDraw", "0", CVAR_RENDERER | CVAR_INTEGER, "1 = geometry overdraw, 2 = light interaction overdraw, 3 = geometry and light interaction overdraw", 0, 3, idCmdSystem::ArgCompletion_Integer<0, 3> );
 
@@ -307,10 +309,24 @@ void R_InitOpenGL( void ) {
 	tr.viewportOffset[0] = 0;
 	tr.viewportOffset[1] = 0;
 
+	glConfig.isHeadless = r_headless.GetBool();
+
 	//
 	// initialize OS specific portions of the renderSystem
 	//
-	for ( i = 0 ; i < 2 ; i++ ) {
+	if ( glConfig.isHeadless ) {
+		// no window: render resolution is only used for viewports and framebuffer sizes
+		if ( r_customWidth.GetInteger() <= 0 || r_customHeight.GetInteger() <= 0 ) {
+			r_customWidth.SetInteger( 800 );
+			r_customHeight.SetInteger( 600 );
+		}
+		glConfig.vidWidth = r_customWidth.GetInteger();
+		glConfig.vidHeight = r_customHeight.GetInteger();
+		glConfig.isFullscreen = false;
+		common->Printf( "Headless mode: using null OpenGL, %d x %d\n", glConfig.vidWidth, glConfig.vidHeight );
+		GLimp_LoadNullFunctions();
+	}
+	for ( i = 0 ; i < 2 && !glConfig.isHeadless ; i++ ) {
 		// set the parameters we are trying
 		if ( r_customWidth.GetInteger() <= 0 || r_customHeight.GetInteger() <= 0 ) {
 			bool ok = Sys_GetCurrentMonitorResolution( glConfig.vidWidth, glConfig.vidHeight );
@@ -353,8 +369,10 @@ void R_InitOpenGL( void ) {
 	}
 
 	// input and sound systems need to be tied to the new window
-	Sys_InitInput();
-	Sys_InitPadInput();
+	if ( !glConfig.isHeadless ) {
+		Sys_InitInput();
+		Sys_InitPadInput();
+	}
 	soundSystem->InitHW();
 
 	if ( glConfig.srgb = r_fboSRGB )
@@ -1605,7 +1623,9 @@ void R_VidRestart_f( const idCmdArgs &args ) {
 		parms.displayHz = r_displayRefresh.GetInteger();
 		parms.multiSamples = 0;
 		parms.stereo = false;
-		GLimp_SetScreenParms( parms );
+		if ( !glConfig.isHeadless ) {
+			GLimp_SetScreenParms( parms );
+		}
 	}
 
 	// make sure the regeneration doesn't use anything no longer valid
@@ -1734,6 +1754,8 @@ void R_InitCommands( void ) {
 	cmdSystem->AddCommand( "vid_restart", R_VidRestart_f, CMD_FL_RENDERER, "restarts renderSystem" );
 	cmdSystem->AddCommand( "listRenderEntityDefs", R_ListRenderEntityDefs_f, CMD_FL_RENDERER, "lists the entity defs" );
 	cmdSystem->AddCommand( "listRenderLightDefs", R_ListRenderLightDefs_f, CMD_FL_RENDERER, "lists the light defs" );
+	cmdSystem->AddCommand( "reportFrameMemory", R_ReportFrameMemory_f, CMD_FL_RENDERER, "prints frame memory usage per frame data and per thread arena" );
+	cmdSystem->AddCommand( "reportPortalFlow", R_ReportPortalFlow_f, CMD_FL_RENDERER, "prints portal flow timings and cache hits collected with r_portalFlowStats, then resets them" );
 	cmdSystem->AddCommand( "reloadSurface", R_ReloadSurface_f, CMD_FL_RENDERER, "reloads the decl and images for selected surface" );
 	cmdSystem->AddCommand( "overrideSurfaceMaterial", R_OverrideSurfaceMaterial_f, CMD_FL_RENDERER, "changes the material of the surface currently under cursor", idCmdSystem::ArgCompletion_Decl<DECL_MATERIAL> );
 	cmdSystem->AddCommand( "purgeImages", R_PurgeImages_f, CMD_FL_RENDERER, "deletes all currently loaded images" );
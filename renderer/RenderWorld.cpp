@@ -131,6 +131,12 @@ idRenderWorldLocal::idRenderWorldLocal() {
 	//doublePortals = NULL;
 	//numInterAreaPortals = 0;
 
+	portalFlowGeneration = 0;
+	portalFlowRecording = nullptr;
+	portalFlowFogged = false;
+
+	decalExpireFrame = -1;
+
 	interactionTable.Init();
 }
 
@@ -478,15 +484,19 @@ void idRenderWorldLocal::ProjectDecalOntoWorld( const idFixedWinding &winding, c
 	const idRenderModel *model;
 	idRenderEntityLocal *def;
 	decalProjectionInfo_t info, localInfo;
+	idFlexList<idRenderEntityLocal *, 64> defs;
 
 	if ( !idRenderModelDecal::CreateProjectionInfo( info, winding, projectionOrigin, parallel, fadeDepth, material, startTime ) ) {
 		return;
 	}
 
+	uint64_t decalStartTime = Sys_GetTimeMicroseconds();
+
 	// get the world areas touched by the projection volume
 	numAreas = BoundsInAreas( info.projectionBounds, areas, 10 );
 
-	// check all areas for models
+	// gather all models touched by the projection first,
+	// models in several of the areas must only get the decal once
 	for ( i = 0; i < numAreas; i++ ) {
 
 		area = &portalAreas[ areas[i] ];
@@ -513,16 +523,33 @@ void idRenderWorldLocal::ProjectDecalOntoWorld( const idFixedWinding &winding, c
 				continue;
 			}
 
-			// transform the bounding planes, fade planes and texture axis into local space
-			idRenderModelDecal::GlobalProjectionInfoToLocal( localInfo, info, def->parms.origin, def->parms.axis );
-			localInfo.force = ( def->parms.customShader != NULL );
-
-			if ( !def->decals ) {
-				def->decals = idRenderModelDecal::Alloc();
+			int k;
+			for ( k = 0; k < defs.Num(); k++ ) {
+				if ( defs[k] == def ) {
+					break;
+				}
+			}
+			if ( k == defs.Num() ) {
+				defs.AddGrow( def );
 			}
-			def->decals->CreateDecal( model, localInfo );
 		}
 	}
+
+	// clip the projection against all gathered models
+	for ( i = 0; i < defs.Num(); i++ ) {
+		def = defs[i];
+
+		// transform the bounding planes, fade planes and texture axis into local space
+		idRenderModelDecal::GlobalProjectionInfoToLocal( localInfo, info, def->parms.origin, def->parms.axis );
+		localInfo.force = ( def->parms.customShader != NULL );
+
+		if ( !def->decals ) {
+			def->decals = idRenderModelDecal::Alloc();
+		}
+		def->decals->CreateDecal( def->parms.hModel, localInfo );
+	}
+
+	tr.pc.decalMicroseconds += Sys_GetTimeMicroseconds() - decalStartTime;
 }
 
 /*
@@ -561,6 +588,8 @@ void idRenderWorldLocal::ProjectDecal( qhandle_t entityHandle, const idFixedWind
 		return;
 	}
 
+	uint64_t decalStartTime = Sys_GetTimeMicroseconds();
+
 	// transform the bounding planes, fade planes and texture axis into local space
 	idRenderModelDecal::GlobalProjectionInfoToLocal( localInfo, info, def->parms.origin, def->parms.axis );
 	localInfo.force = ( def->parms.customShader != NULL );
@@ -569,6 +598,8 @@ void idRenderWorldLocal::ProjectDecal( qhandle_t entityHandle, const idFixedWind
 		def->decals = idRenderModelDecal::Alloc();
 	}
 	def->decals->CreateDecal( model, localInfo );
+
+	tr.pc.decalMicroseconds += Sys_GetTimeMicroseconds() - decalStartTime;
 }
 
 /*
@@ -623,6 +654,32 @@ void idRenderWorldLocal::RemoveDecals( qhandle_t entityHandle ) {
 	R_FreeEntityDefOverlay( def );
 }
 
+/*
+====================
+idRenderWorldLocal::FreeFadedDecals
+
+Done for all entities in one pass, so that decals on models
+in areas which are not visible are freed too.
+====================
+*/
+void idRenderWorldLocal::FreeFadedDecals( int time ) {
+	if ( decalExpireFrame == tr.frameCount ) {
+		return;
+	}
+	decalExpireFrame = tr.frameCount;
+
+	uint64_t decalStartTime = Sys_GetTimeMicroseconds();
+
+	for ( int i = 0; i < entityDefs.Num(); i++ ) {
+		idRenderEntityLocal *def = entityDefs[i];
+		if ( def && def->decals ) {
+			R_FreeEntityDefFadedDecals( def, time );
+		}
+	}
+
+	tr.pc.decalMicroseconds += Sys_GetTimeMicroseconds() - decalStartTime;
+}
+
 /*
 ====================
 SetRenderView
@@ -721,6 +778,9 @@ void idRenderWorldLocal::RenderScene( const renderView_t &renderView ) {
 		r_useInteractionTable.ClearModified();
 	}
 
+	// remove decals that are completely faded away
+	FreeFadedDecals( renderView.time );
+
 	// save this world for use by some console commands
 	tr.primaryWorld = this;
 	tr.primaryRenderView = renderView;
@@ -30,6 +30,9 @@ void idRenderWorldLocal::FreeWorld() {
 	// this will free all the lightDefs and entityDefs
 	FreeDefs();
 
+	// cached flows reference areas of this map
+	FreePortalFlows();
+
 	// free all the portals and check light/model references
 	for ( auto &area: portalAreas ) {
 		// there shouldn't be any remaining lightRefs or entityRefs
@@ -581,6 +584,7 @@ void idRenderWorldLocal::ClearPortalStates() {
 	for ( i = 0 ; i < doublePortals.Num() ; i++ ) {
 		doublePortals[i].blockingBits = PS_BLOCK_NONE;
 	}
+	InvalidatePortalFlows();
 
 	// flood fill all area connections
 	for ( i = 0; i < portalAreas.Num(); i++ ) {
@@ -100,6 +100,8 @@ struct InterTableHashFunction {
 };
 
 //this table stores all interactions ever generated and still actual
+// Find may be called from several threads simultaneously,
+// but Add and Remove must not run concurrently with anything
 class idInteractionTable {
 public:
 	idInteractionTable();
@@ -119,6 +121,14 @@ private:
 	idHashMap<int, idInteraction*> SHT_table;
 };
 
+// entity which may need an interaction with a light, see GatherLightDefInteractions
+typedef struct {
+	idRenderEntityLocal *	entityDef;
+	idInteraction *			existing;		// already present in interaction table
+	bool					culled;			// reference bounds are outside light frustum
+	bool					needsViewed;	// only interacts if entity is in view
+} lightInteractionCandidate_t;
+
 class idRenderWorldLocal : public idRenderWorld {
 public:
 							idRenderWorldLocal();
@@ -144,6 +154,9 @@ public:
 	virtual void			ProjectOverlay( qhandle_t entityHandle, const idPlane localTextureAxis[2], const idMaterial *material );
 	virtual void			RemoveDecals( qhandle_t entityHandle );
 
+	// removes decals which are completely faded away from all entities, once per frame
+	void					FreeFadedDecals( int time );
+
 	virtual void			SetRenderView( const renderView_t *renderView );
 	virtual	void			RenderScene( const renderView_t &renderView );
 
@@ -203,6 +216,8 @@ public:
 	idList<idRenderEntityLocal*>	entityDefs;
 	idList<idRenderLightLocal*>		lightDefs;
 
+	int						decalExpireFrame;		// tr.frameCount of the last FreeFadedDecals
+
 	idBlockAlloc<areaReference_t, 1024> areaReferenceAllocator;
 	idBlockAlloc<idInteraction, 256>	interactionAllocator;
 
@@ -216,6 +231,12 @@ public:
 
 	bool					generateAllInteractionsCalled;
 
+	// recently computed view portal flows, see FlowViewThroughPortals
+	idList<struct portalFlowCacheEntry_s *> portalFlowCache;
+	int						portalFlowGeneration;	// incremented when any portal is opened / closed / fogged
+	idList<struct portalFlowVisit_s> *portalFlowRecording;
+	bool					portalFlowFogged;
+
 	//-----------------------
 	// RenderWorld_load.cpp
 
@@ -250,6 +271,10 @@ public:
 	void					BuildConnectedAreas_r( int areaNum );
 	void					BuildConnectedAreas( void );
 	void					FindViewLightsAndEntities( void );
+	struct portalFlowCacheEntry_s *FindPortalFlow( const struct portalFlowKey_s &key );
+	void					StorePortalFlow( const struct portalFlowKey_s &key, idList<struct portalFlowVisit_s> &visits );
+	void					InvalidatePortalFlows();
+	void					FreePortalFlows();
 
 	struct FloodShadowFrustumContext;
 	bool					FloodShadowFrustumThroughArea_r( FloodShadowFrustumContext &context, const idBounds &bounds ) const;
@@ -310,6 +335,8 @@ public:
 	//-------------------------------
 	// tr_light.c
 	void					CreateLightDefInteractions( idRenderLightLocal *ldef );
+	void					GatherLightDefInteractions( idRenderLightLocal *ldef, idList<lightInteractionCandidate_t> &candidates ) const;
+	void					CommitLightDefInteractions( idRenderLightLocal *ldef, const idList<lightInteractionCandidate_t> &candidates );
 };
 
 
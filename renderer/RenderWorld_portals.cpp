@@ -20,6 +20,8 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 
 idCVar r_useLightAreaCulling( "r_useLightAreaCulling", "1", CVAR_RENDERER | CVAR_BOOL, "0 = off, 1 = on" );
 idCVar r_singleModelName( "r_singleModelName", "", CVAR_RENDERER, "filter entities by model name, e.g. 'models/darkmod/nature/flowers/flowers_patch_01.ase'" );
+idCVar r_usePortalFlowCache( "r_usePortalFlowCache", "1", CVAR_RENDERER | CVAR_BOOL, "reuse portal flow of recent views with identical camera when no portal changed" );
+idCVar r_portalFlowStats( "r_portalFlowStats", "0", CVAR_RENDERER | CVAR_BOOL, "measure CPU time of portal flow per view, see reportPortalFlow (e.g. during timeDemo)" );
 
 /*
 
@@ -50,6 +52,46 @@ typedef struct portalStack_s {
 	// positive side is outside the visible frustum
 } portalStack_t;
 
+/*
+portal flow of a view depends only on the camera, on portal geometry
+and on open/closed/fogged state of portals. Standing player, remote cameras and
+mirrors often produce exactly the same view many frames in a row: in such case
+we only replay the recorded area visits (culling entities and lights against
+the stored portal planes), skipping winding clipping and fog checks.
+The key must match exactly: a merely "close" camera can see different portals.
+*/
+const int MAX_PORTAL_FLOW_CACHE = 8;
+
+typedef struct portalFlowKey_s {
+	int			generation;
+	int			areaNum;
+	idVec3		origin;
+	int			numPlanes;
+	idPlane		planes[6];
+	idScreenRect scissor;
+	idScreenRect viewport;
+	float		modelViewMatrix[16];
+	float		projectionMatrix[16];
+} portalFlowKey_t;
+
+typedef struct portalFlowVisit_s {
+	int				areaNum;
+	portalStack_t	ps;		// next and p are not valid
+} portalFlowVisit_t;
+
+typedef struct portalFlowCacheEntry_s {
+	portalFlowKey_t				key;
+	idList<portalFlowVisit_t>	visits;
+	int							lastUsedFrame;
+} portalFlowCacheEntry_t;
+
+static struct {
+	int			views;
+	int			hits;
+	uint64_t	totalMicroseconds;
+	uint64_t	maxMicroseconds;
+} portalFlowStats;
+
 
 //====================================================================
 
@@ -158,6 +200,14 @@ void idRenderWorldLocal::FloodViewThroughArea_r( const idVec3 origin, int areaNu
 		portalAreas[areaNum].areaScreenRect.Union( ps->rect );
 	}
 
+	if ( portalFlowRecording ) {
+		portalFlowVisit_t &visit = portalFlowRecording->Alloc();
+		visit.areaNum = areaNum;
+		visit.ps = *ps;
+		visit.ps.p = nullptr;
+		visit.ps.next = nullptr;
+	}
+
 	// go through all the portals
 	for ( auto p : area.areaPortals ) {
 		// an enclosing door may have sealed the portal off
@@ -212,6 +262,11 @@ void idRenderWorldLocal::FloodViewThroughArea_r( const idVec3 origin, int areaNu
 			continue;	// portal not visible
 		}
 
+		// fog density is evaluated from light shader registers, which may change anytime
+		if ( p->doublePortal->fogLight ) {
+			portalFlowFogged = true;
+		}
+
 		// see if it is fogged out
 		if ( PortalIsFoggedOut( p ) ) {
 			continue;
@@ -304,16 +359,149 @@ void idRenderWorldLocal::FlowViewThroughPortals( const idVec3 origin, int numPla
 			AddAreaRefs( i, &ps );
 		}
 	} else {
+		uint64_t startTime = r_portalFlowStats.GetBool() ? Sys_GetTimeMicroseconds() : 0;
 
 		for ( auto &a : portalAreas ) {
 			a.areaScreenRect.Clear();
 		}
 
-		// flood out through portals, setting area viewCount
-		FloodViewThroughArea_r( origin, tr.viewDef->areaNum, &ps );
+		// r_showPortals needs per-portal marks which are not recorded
+		bool useCache = r_usePortalFlowCache.GetBool() && !r_showPortals && numPlanes <= 6;
+		portalFlowKey_t key;
+		portalFlowCacheEntry_t *cached = nullptr;
+		if ( useCache ) {
+			memset( &key, 0, sizeof( key ) );
+			key.generation = portalFlowGeneration;
+			key.areaNum = tr.viewDef->areaNum;
+			key.origin = origin;
+			key.numPlanes = numPlanes;
+			for ( i = 0; i < numPlanes; i++ ) {
+				key.planes[i] = planes[i];
+			}
+			key.scissor = tr.viewDef->scissor;
+			key.viewport = tr.viewDef->viewport;
+			memcpy( key.modelViewMatrix, tr.viewDef->worldSpace.modelViewMatrix, sizeof( key.modelViewMatrix ) );
+			memcpy( key.projectionMatrix, tr.viewDef->projectionMatrix, sizeof( key.projectionMatrix ) );
+			cached = FindPortalFlow( key );
+		}
+
+		if ( cached ) {
+			// replay: entities and lights still need to be culled, but the portal stacks are known
+			for ( const portalFlowVisit_t &visit : cached->visits ) {
+				AddAreaRefs( visit.areaNum, &visit.ps );
+				idScreenRect &areaRect = portalAreas[visit.areaNum].areaScreenRect;
+				if ( areaRect.IsEmpty() ) {
+					areaRect = visit.ps.rect;
+				} else {
+					areaRect.Union( visit.ps.rect );
+				}
+			}
+			portalFlowStats.hits++;
+		} else {
+			idList<portalFlowVisit_t> visits;
+			if ( useCache ) {
+				portalFlowRecording = &visits;
+				portalFlowFogged = false;
+			}
+
+			// flood out through portals, setting area viewCount
+			FloodViewThroughArea_r( origin, tr.viewDef->areaNum, &ps );
+
+			if ( useCache ) {
+				portalFlowRecording = nullptr;
+				if ( !portalFlowFogged ) {
+					StorePortalFlow( key, visits );
+				}
+			}
+		}
+
+		if ( r_portalFlowStats.GetBool() ) {
+			uint64_t elapsed = Sys_GetTimeMicroseconds() - startTime;
+			portalFlowStats.views++;
+			portalFlowStats.totalMicroseconds += elapsed;
+			if ( elapsed > portalFlowStats.maxMicroseconds ) {
+				portalFlowStats.maxMicroseconds = elapsed;
+			}
+		}
 	}
 }
 
+/*
+=======================
+idRenderWorldLocal::FindPortalFlow
+=======================
+*/
+struct portalFlowCacheEntry_s *idRenderWorldLocal::FindPortalFlow( const struct portalFlowKey_s &key ) {
+	for ( portalFlowCacheEntry_t *entry : portalFlowCache ) {
+		if ( memcmp( &entry->key, &key, sizeof( key ) ) == 0 ) {
+			entry->lastUsedFrame = tr.frameCount;
+			return entry;
+		}
+	}
+	return nullptr;
+}
+
+/*
+=======================
+idRenderWorldLocal::StorePortalFlow
+=======================
+*/
+void idRenderWorldLocal::StorePortalFlow( const struct portalFlowKey_s &key, idList<struct portalFlowVisit_s> &visits ) {
+	portalFlowCacheEntry_t *entry = nullptr;
+
+	if ( portalFlowCache.Num() < MAX_PORTAL_FLOW_CACHE ) {
+		entry = new portalFlowCacheEntry_t;
+		portalFlowCache.Append( entry );
+	} else {
+		// evict least recently used view
+		entry = portalFlowCache[0];
+		for ( portalFlowCacheEntry_t *e : portalFlowCache ) {
+			if ( e->lastUsedFrame < entry->lastUsedFrame ) {
+				entry = e;
+			}
+		}
+	}
+	entry->key = key;
+	entry->visits.Swap( visits );
+	entry->lastUsedFrame = tr.frameCount;
+}
+
+/*
+=======================
+idRenderWorldLocal::InvalidatePortalFlows
+
+Must be called whenever portal blocking or fogging changes
+=======================
+*/
+void idRenderWorldLocal::InvalidatePortalFlows() {
+	portalFlowGeneration++;
+}
+
+/*
+=======================
+idRenderWorldLocal::FreePortalFlows
+=======================
+*/
+void idRenderWorldLocal::FreePortalFlows() {
+	portalFlowCache.DeleteContents( true );
+	portalFlowGeneration++;
+}
+
+/*
+=======================
+R_ReportPortalFlow_f
+=======================
+*/
+void R_ReportPortalFlow_f( const idCmdArgs &args ) {
+	if ( !r_portalFlowStats.GetBool() ) {
+		common->Printf( "Set r_portalFlowStats 1 to collect statistics (e.g. before timeDemo)\n" );
+	}
+	int views = idMath::Imax( portalFlowStats.views, 1 );
+	common->Printf( "Portal flow: %d views, %d cache hits (%.1f%%)\n", portalFlowStats.views, portalFlowStats.hits, 100.0 * portalFlowStats.hits / views );
+	common->Printf( "  CPU time per view: avg %.1f us, max %d us\n", double( portalFlowStats.totalMicroseconds ) / views, int( portalFlowStats.maxMicroseconds ) );
+	memset( &portalFlowStats, 0, sizeof( portalFlowStats ) );
+}
+
 //==================================================================================================
 
 
@@ -703,10 +891,6 @@ void idRenderWorldLocal::AddAreaEntityRefs( int areaNum, const portalStack_t *ps
 		if ( r_singleEntity.GetInteger() == -2 && strcmp( r_singleModelName.GetString(), entity->parms.hModel->Name() ) )
 			continue;
 
-		// remove decals that are completely faded away
-		if( entity->decals )
-			R_FreeEntityDefFadedDecals( entity, tr.viewDef->renderView.time );
-
 		// check for completely suppressing the model
 		if ( !r_skipSuppress.GetBool() ) {
 			// nbohr1more: #4379 lightgem culling
@@ -1104,6 +1288,7 @@ void idRenderWorldLocal::SetPortalState( qhandle_t portal, int blockTypes ) {
 		return;
 	}
 	doublePortals[portal - 1].blockingBits = blockTypes;
+	InvalidatePortalFlows();
 
 	// leave the connectedAreaGroup the same on one side,
 	// then flood fill from the other side with a new number for each changed attribute
@@ -76,6 +76,10 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 // Note: no requirements are checked here, run GLimp_CheckRequiredFeatures afterwards.
 void GLimp_LoadFunctions(bool inContext = true);
 
+// Fills all GL function pointers with null implementation (NullGL.cpp), used when r_headless is set.
+// No window and no context are needed.
+void GLimp_LoadNullFunctions();
+
 // Check and load all optional extensions.
 // Fills extensions flags in glConfig and loads optional function pointers.
 void GLimp_CheckRequiredFeatures();
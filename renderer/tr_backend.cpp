@@ -22,6 +22,7 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 #include "backend/RenderBackend.h"
 #include "BloomStage.h"
 #include "FrameBufferManager.h"
+#include "ImageStreamer.h"
 
 backEndState_t	backEnd;
 idCVarBool image_showBackgroundLoads( "image_showBackgroundLoads", "0", CVAR_RENDERER, "1 = print outstanding background loads" );
@@ -768,8 +769,8 @@ const void	RB_SwapBuffers( const void *data ) {
 	}
 	RB_LogComment( "***************** RB_SwapBuffers *****************\n" );
 
-	// don't flip if drawing to front buffer
-	if ( !r_frontBuffer.GetBool() ) {
+	// don't flip if drawing to front buffer or if there is no window
+	if ( !r_frontBuffer.GetBool() && !glConfig.isHeadless ) {
 		GLimp_SwapBuffers();
 	}
 }
@@ -898,6 +899,7 @@ void RB_ExecuteBackEndCommands( const emptyCommand_t *cmds ) {
 		backEnd.c_copyDepthBuffer = 0;
 	}
 
+	imageStreamer.CollectLoadCounters();
 	if ( image_showBackgroundLoads && backEnd.pc.textureLoads ) {
 		common->Printf( "%i/%i loads in %i/%i ms\n", backEnd.pc.textureLoads, backEnd.pc.textureBackgroundLoads, backEnd.pc.textureLoadTime, backEnd.pc.textureUploadTime );
 	}
@@ -937,33 +937,7 @@ static void R_ParticleDeform( drawSurf_t *surf, bool useArea ) {
 		tri->bounds = surf->frontendGeo->bounds;	// TODO: it seems this value has absolutely no effect
 		tri->numVerts = 0;
 
-		for ( int index = 0 ; index < totalParticles ; index++ ) {
-			idParticleData part;
-			int cycIdx;
-			if (!idParticle_EmitParticle(*stage, psEmit, index, part, cycIdx))
-				continue;
-
-			// locate the particle origin and axis somewhere on the surface
-			idVec2 texcoord;
-			idParticle_EmitLocationOnSurface(*stage, srcTri, part, texcoord, triAreas);
-
-			if (cutoffImage) {
-				float cutoff;
-				if (stage->mapLayoutType == PML_TEXTURE) {
-					cutoff = idParticle_FetchCutoffTimeTexture(cutoffImage, cutoffInfo, texcoord);
-				} else {
-					cutoff = idParticle_FetchCutoffTimeLinear(cutoffImage, totalParticles, index, cycIdx);
-				}
-				if ( part.frac > cutoff )
-					continue;
-			}
-
-			// if the particle doesn't get drawn because it is faded out or beyond a kill region,
-			// don't increment the verts
-			idDrawVert *ptr = tri->verts + tri->numVerts;
-			idParticle_CreateParticle(*stage, psys, part, ptr);
-			tri->numVerts = ptr - tri->verts;
-		}
+		tri->numVerts = idParticle_GenerateStage( stage, psys, psEmit, totalParticles, srcTri, triAreas, cutoffImage, &cutoffInfo, tri->verts );
 
 		if ( tri->numVerts > 0 ) {
 			// build the index list
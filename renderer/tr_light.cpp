@@ -23,6 +23,7 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 
 idCVar r_maxShadowMapLight( "r_maxShadowMapLight", "1000", CVAR_ARCHIVE | CVAR_RENDERER, "lights bigger than this will be force-sent to stencil" );
 idCVar r_useParallelAddModels( "r_useParallelAddModels", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "parallelize R_AddModelSurfaces in frontend using jobs" );
+idCVar r_useParallelAddLights( "r_useParallelAddLights", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "parallelize light-entity interaction culling of R_AddLightSurfaces in frontend using jobs" );
 idCVarBool r_useClipPlaneCulling( "r_useClipPlaneCulling", "1", CVAR_RENDERER, "cull surfaces behind mirrors" );
 
 /*
@@ -407,6 +408,22 @@ Both shadow and light surfaces have been generated.  Either or both surfaces may
 =================
 */
 void idRenderWorldLocal::CreateLightDefInteractions( idRenderLightLocal *ldef ) {
+	idList<lightInteractionCandidate_t> candidates;
+	GatherLightDefInteractions( ldef, candidates );
+	CommitLightDefInteractions( ldef, candidates );
+}
+
+/*
+=================
+idRenderWorldLocal::GatherLightDefInteractions
+
+First half of CreateLightDefInteractions: finds the entities the light may touch and
+culls their reference bounds against the light frustum.
+Does not modify anything, so it can run for several lights in parallel.
+=================
+*/
+void idRenderWorldLocal::GatherLightDefInteractions( idRenderLightLocal *ldef, idList<lightInteractionCandidate_t> &candidates ) const {
+	TRACE_CPU_SCOPE_TEXT( "GatherLightDefInteractions", GetTraceLabel( ldef->parms ) )
 
 	bool lightCastsShadows = ldef->lightShader->LightCastsShadows();
 
@@ -421,22 +438,23 @@ void idRenderWorldLocal::CreateLightDefInteractions( idRenderLightLocal *ldef )
 			// but we don't want to instantiate dynamic models yet, so we can't check that on
 			// most things
 
+			// whether entity is viewed can change while interactions of other lights are committed,
+			// so the check itself is postponed until CommitLightDefInteractions
+			bool needsViewed = false;
 			if ( tr.viewDef ) {
 				// if the entity isn't viewed and light has now shadows, skip
 				if ( !lightCastsShadows ) {
-					if ( edef->viewCount != tr.viewCount ) {
-						continue;
-					}
+					needsViewed = true;
 				}
 				// if the entity isn't viewed and shadow is suppressed, skip
 				if ( edef->parms.suppressShadowInViewID && edef->parms.suppressShadowInViewID == tr.viewDef->renderView.viewID ) {
-					if ( !r_skipSuppress.GetBool() && edef->viewCount != tr.viewCount ) {
-						continue;
+					if ( !r_skipSuppress.GetBool() ) {
+						needsViewed = true;
 					}
 				}
 				if ( edef->parms.suppressShadowInLightID && edef->parms.suppressShadowInLightID == ldef->parms.lightId ) {
-					if ( !r_skipSuppress.GetBool() && edef->viewCount != tr.viewCount ) {
-						continue;
+					if ( !r_skipSuppress.GetBool() ) {
+						needsViewed = true;
 					}
 				}
 			}
@@ -450,22 +468,19 @@ void idRenderWorldLocal::CreateLightDefInteractions( idRenderLightLocal *ldef )
 			if ( r_singleEntity.GetInteger() >= 0 && r_singleEntity.GetInteger() != edef->index ) {
 				continue;
 			}
-			
+
+			lightInteractionCandidate_t &cand = candidates.Alloc();
+			cand.entityDef = edef;
+			cand.needsViewed = needsViewed;
+			cand.culled = false;
+
 			// if any of the edef's interaction match this light, we don't
 			// need to consider it. 
-			idInteraction *inter = interactionTable.Find(ldef, edef);
-			if ( inter ) {
-				// if this entity wasn't in view already, the scissor rect will be empty,
-				// so it will only be used for shadow casting
-				if ( !inter->IsEmpty() ) {
-					R_SetEntityDefViewEntity( edef );
-				}
+			cand.existing = interactionTable.Find( ldef, edef );
+			if ( cand.existing ) {
 				continue;
 			}
 
-			// create a new interaction, but don't do any work other than bbox to frustum culling
-			inter = idInteraction::AllocAndLink( edef, ldef );
-
 			// do a check of the entity reference bounds against the light frustum,
 			// trying to avoid creating a viewEntity if it hasn't been already
 			float	modelMatrix[16];
@@ -477,16 +492,53 @@ void idRenderWorldLocal::CreateLightDefInteractions( idRenderLightLocal *ldef )
 				m = modelMatrix;
 			}
 
-			if ( R_CullLocalBox( edef->referenceBounds, m, 6, ldef->frustum ) ) {
-				inter->MakeEmpty();
-				continue;
-			}
+			cand.culled = R_CullLocalBox( edef->referenceBounds, m, 6, ldef->frustum );
+		}
+	}
+}
+
+/*
+=================
+idRenderWorldLocal::CommitLightDefInteractions
+
+Second half of CreateLightDefInteractions: creates the interactions and viewEntities.
+Must be called serially, in the same order of lights as before parallelization.
+=================
+*/
+void idRenderWorldLocal::CommitLightDefInteractions( idRenderLightLocal *ldef, const idList<lightInteractionCandidate_t> &candidates ) {
+	for ( const lightInteractionCandidate_t &cand : candidates ) {
+		idRenderEntityLocal *edef = cand.entityDef;
 
-			// we will do a more precise per-surface check when we are checking the entity
+		if ( cand.needsViewed && edef->viewCount != tr.viewCount ) {
+			continue;
+		}
+
+		idInteraction *inter = cand.existing;
+		if ( !inter ) {
+			// entity may be referenced from several areas touched by the light
+			inter = interactionTable.Find( ldef, edef );
+		}
+		if ( inter ) {
 			// if this entity wasn't in view already, the scissor rect will be empty,
 			// so it will only be used for shadow casting
-			R_SetEntityDefViewEntity( edef );
+			if ( !inter->IsEmpty() ) {
+				R_SetEntityDefViewEntity( edef );
+			}
+			continue;
+		}
+
+		// create a new interaction, but don't do any work other than bbox to frustum culling
+		inter = idInteraction::AllocAndLink( edef, ldef );
+
+		if ( cand.culled ) {
+			inter->MakeEmpty();
+			continue;
 		}
+
+		// we will do a more precise per-surface check when we are checking the entity
+		// if this entity wasn't in view already, the scissor rect will be empty,
+		// so it will only be used for shadow casting
+		R_SetEntityDefViewEntity( edef );
 	}
 }
 
@@ -817,6 +869,17 @@ Create any new interactions needed between the viewLights
 and the viewEntitys due to game movement
 =================
 */
+typedef struct {
+	idRenderLightLocal *light;
+	idList<lightInteractionCandidate_t> candidates;
+} lightInteractionJob_t;
+
+static void R_GatherLightInteractions( lightInteractionJob_t *job ) {
+	job->light->world->GatherLightDefInteractions( job->light, job->candidates );
+}
+
+REGISTER_PARALLEL_JOB( R_GatherLightInteractions, "R_GatherLightInteractions" );
+
 void R_AddLightSurfaces( void ) {
 	TRACE_CPU_SCOPE( "R_AddLightSurfaces" );
 	
@@ -824,6 +887,10 @@ void R_AddLightSurfaces( void ) {
 	idRenderLightLocal	*light;
 	viewLight_t			**ptr;
 
+	// with parallel mode, interactions are created after all lights are processed
+	bool parallel = r_useParallelAddLights.GetBool();
+	idList<lightInteractionJob_t> lightJobs;
+
 	// go through each visible light, possibly removing some from the list
 	ptr = &tr.viewDef->viewLights;
 	while ( *ptr ) {
@@ -918,7 +985,11 @@ void R_AddLightSurfaces( void ) {
 		// create interactions with all entities the light may touch, and add viewEntities
 		// that may cast shadows, even if they aren't directly visible.  Any real work
 		// will be deferred until we walk through the viewEntities
-		tr.viewDef->renderWorld->CreateLightDefInteractions( light );
+		if ( parallel ) {
+			lightJobs.Alloc().light = light;
+		} else {
+			tr.viewDef->renderWorld->CreateLightDefInteractions( light );
+		}
 		tr.pc.c_viewLights++;
 
 		// fog lights will need to draw the light frustum triangles, so make sure they
@@ -955,6 +1026,20 @@ void R_AddLightSurfaces( void ) {
 			vLight->globalShadows = surf;
 		}
 	}
+
+	if ( lightJobs.Num() ) {
+		// culling entities against light frustums is independent for each light
+		for ( lightInteractionJob_t &job : lightJobs ) {
+			tr.frontEndJobList->AddJob( (jobRun_t)R_GatherLightInteractions, &job );
+		}
+		tr.frontEndJobList->Submit();
+		tr.frontEndJobList->Wait();
+
+		// but interactions and viewEntities are shared, so they are created serially in light order
+		for ( lightInteractionJob_t &job : lightJobs ) {
+			tr.viewDef->renderWorld->CommitLightDefInteractions( job.light, job.candidates );
+		}
+	}
 }
 
 //===============================================================================================================
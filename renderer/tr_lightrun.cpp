@@ -838,6 +838,7 @@ void R_CreateLightDefFogPortals( idRenderLightLocal *ldef ) {
 				dp->fogLight = ldef;
 				dp->nextFoggedPortal = ldef->foggedPortals;
 				ldef->foggedPortals = dp;
+				ldef->world->InvalidatePortalFlows();
 			}
 		}
 	}
@@ -855,6 +856,9 @@ void R_FreeLightDefDerivedData( idRenderLightLocal *ldef ) {
 
 	// remove any portal fog references
 	doublePortal_t *dp = ldef->foggedPortals;
+	if ( dp ) {
+		ldef->world->InvalidatePortalFlows();
+	}
 	while ( dp ) {
 		dp->fogLight = NULL;
 		dp = dp->nextFoggedPortal;
@@ -612,10 +612,8 @@ const int	INITIAL_DRAWSURFS =			0x4000;
 // be discontinuous with the existing memory
 typedef struct frameMemoryBlock_s {
 	struct frameMemoryBlock_s *next;
-	int		size;
-	int		used;
-	int		poop;		// so that base is 16 byte aligned
-	byte	base[4];	// dynamically allocated as [size]
+	int		size;		// usable bytes starting at base
+	byte	*base;		// aligned to FRAME_ALLOC_ALIGNMENT, points into the same allocation
 } frameMemoryBlock_t;
 
 // all of the information needed by the back end must be
@@ -623,9 +621,11 @@ typedef struct frameMemoryBlock_s {
 // duplicated so the front and back end can run in parallel
 // on an SMP machine
 typedef struct {
-	std::atomic<int>	frameMemoryAllocated;
-	std::atomic<int>	frameMemoryUsed;
-	byte				*frameMemory;
+	std::atomic<int>	frameMemoryAllocated;	// bytes of all blocks handed out to thread arenas
+	frameMemoryBlock_t	*memoryBlocks;			// recycled on R_ToggleSmpFrame
+	frameMemoryBlock_t	*lockedMemoryBlocks;	// kept alive for r_lockSurfaces
+	idSysMutex			memoryBlocksMutex;
+	int					generation;				// incremented every time the frame is reused
 
 	srfTriangles_t 		*firstDeferredFreeTriSurf;
 	srfTriangles_t 		*lastDeferredFreeTriSurf;
@@ -685,6 +685,8 @@ typedef struct {
 	int		c_tangentIndexes;		// R_DeriveTangents()
 	int		c_entityUpdates, c_lightUpdates, c_entityReferences, c_lightReferences;
 	int		c_guiSurfs, c_noshadowSurfs;
+	int		c_decalsCreated, c_decalsExpired;
+	int		decalMicroseconds;		// time spent projecting and expiring decals
 	int		frontEndMsec;			// sum of time in all RE_RenderScene's in a frame
 	int		frontEndMsecLast;		// time in last RE_RenderScene
 } performanceCounters_t;
@@ -1039,6 +1041,7 @@ extern idCVar r_showSurfaces;			// report surface/light/shadow counts
 extern idCVar r_showPrimitives;			// report vertex/index/draw counts
 extern idCVar r_showMultiLight;			// 
 extern idCVarInt r_showPortals;			// draw portal outlines in color based on passed / not passed
+extern idCVar r_showDecals;			// report decal count, memory and time
 extern idCVar r_showAlloc;				// report alloc/free counts
 extern idCVar r_showSkel;				// draw the skeleton when model animates
 extern idCVar r_showOverDraw;			// show overdraw
@@ -1335,6 +1338,7 @@ LIGHT
 
 void R_ListRenderLightDefs_f( const idCmdArgs &args );
 void R_ListRenderEntityDefs_f( const idCmdArgs &args );
+void R_ReportPortalFlow_f( const idCmdArgs &args );
 
 bool R_IssueEntityDefCallback( idRenderEntityLocal *def );
 idRenderModel *R_EntityDefDynamicModel( idRenderEntityLocal *def );
@@ -1575,6 +1579,10 @@ void				R_DeriveFacePlanes( srfTriangles_t *tri );		// also called by renderbump
 void				R_CleanupTriangles( srfTriangles_t *tri, bool createNormals, bool identifySilEdges, bool useUnsmoothedTangents );
 void				R_ReverseTriangles( srfTriangles_t *tri );
 
+// processed model cache: surface after R_CleanupTriangles with all derived data
+void				R_WriteStaticTriSurf( idFile *file, const srfTriangles_t *tri );
+srfTriangles_t 		*R_ReadStaticTriSurf( idFile *file );
+
 // Only deals with vertexes and indexes, not silhouettes, planes, etc.
 // Does NOT perform a cleanup triangles, so there may be duplicated verts in the result.
 srfTriangles_t 		*R_MergeSurfaceList( const srfTriangles_t **surfaces, int numSurfaces );
@@ -1645,6 +1653,8 @@ void R_ToggleSmpFrame( void );
 void *R_FrameAlloc( int bytes );
 void *R_ClearedFrameAlloc( int bytes );
 void R_FrameFree( void *data );
+void R_LockFrameData( void );
+void R_ReportFrameMemory_f( const idCmdArgs &args );
 
 void *R_StaticAlloc( int bytes );		// just malloc with error checking
 void *R_ClearedStaticAlloc( int bytes );	// with memset
@@ -26,13 +26,49 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 
 static const unsigned int NUM_FRAME_DATA = 2;
 static const unsigned int FRAME_ALLOC_ALIGNMENT = 128;
-static const unsigned int MAX_FRAME_MEMORY = 64 * 1024 * 1024;	// larger so that we can noclip on PC for dev purposes
+static const int MAX_FRAME_ARENAS = 64;
+
+idCVar r_frameMemoryBlockSize( "r_frameMemoryBlockSize", "2", CVAR_RENDERER | CVAR_INTEGER, "size of blocks (in MB) which threads take frame memory from", 1, 4 );
 
 frameData_t		smpFrameData[NUM_FRAME_DATA];
 frameData_t 	*frameData;
 frameData_t		*backendFrameData;
 unsigned int	smpFrame;
 
+/*
+every thread allocates frame memory from its own arena, which is a bump allocator
+inside a block taken from the frame data. Blocks are taken from the shared pool on demand,
+and go back to it when the frame data is reused in R_ToggleSmpFrame.
+So threads don't contend on a single atomic counter, and frame memory is never exhausted.
+*/
+typedef struct alignas( 64 ) {
+	std::atomic<int>	frameBytes[NUM_FRAME_DATA];	// allocated since the frame data was reused
+	int					lastFrameBytes;
+	int					peakFrameBytes;
+	uintptr_t			threadId;
+	char				name[32];					// tracy plot name
+} frameArenaStats_t;
+
+typedef struct {
+	frameData_t			*frame;
+	int					generation;
+	byte				*current;
+	byte				*end;
+	frameArenaStats_t	*stats;
+} frameArena_t;
+
+static thread_local frameArena_t frameArena;
+static frameArenaStats_t	frameArenaStats[MAX_FRAME_ARENAS];
+static std::atomic<int>		numFrameArenas;
+
+static idSysMutex			frameMemoryPoolMutex;
+static frameMemoryBlock_t	*frameMemoryPool;			// free blocks of standard size
+static int					frameMemoryPoolBlocks;
+static std::atomic<int>		frameMemoryTotalBytes;		// in all existing blocks
+static int					frameMemoryPeakBytes;		// max allocated by one frame
+static int					frameMemoryGeneration;
+static frameData_t			*lockedFrameData;			// contains surfaces saved for r_lockSurfaces
+
 /*
 ======================
 idScreenRect::Clear
@@ -161,6 +197,145 @@ void R_ShowColoredScreenRect( const idScreenRect &rect, int colorIndex ) {
 	}
 }
 
+/*
+====================
+R_FrameMemoryBlockSize
+====================
+*/
+static int R_FrameMemoryBlockSize( void ) {
+	return r_frameMemoryBlockSize.GetInteger() << 20;
+}
+
+/*
+====================
+R_AllocFrameMemoryBlock
+====================
+*/
+static frameMemoryBlock_t *R_AllocFrameMemoryBlock( int size ) {
+	byte *mem = ( byte * )Mem_Alloc16( sizeof( frameMemoryBlock_t ) + FRAME_ALLOC_ALIGNMENT + size );
+	if ( !mem ) {
+		common->FatalError( "R_AllocFrameMemoryBlock failed on %i bytes", size );
+	}
+	frameMemoryBlock_t *block = ( frameMemoryBlock_t * )mem;
+	block->next = NULL;
+	block->size = size;
+	uintptr_t base = ( uintptr_t )( mem + sizeof( frameMemoryBlock_t ) );
+	block->base = ( byte * )( ( base + FRAME_ALLOC_ALIGNMENT - 1 ) & ~( uintptr_t )( FRAME_ALLOC_ALIGNMENT - 1 ) );
+	frameMemoryTotalBytes += size;
+	return block;
+}
+
+/*
+====================
+R_ReleaseFrameMemoryBlocks
+
+Returns blocks of standard size to the pool, frees the others.
+====================
+*/
+static void R_ReleaseFrameMemoryBlocks( frameMemoryBlock_t *blocks ) {
+	int blockSize = R_FrameMemoryBlockSize();
+	idScopedCriticalSection lock( frameMemoryPoolMutex );
+	while ( blocks ) {
+		frameMemoryBlock_t *next = blocks->next;
+		if ( blocks->size == blockSize ) {
+			blocks->next = frameMemoryPool;
+			frameMemoryPool = blocks;
+			frameMemoryPoolBlocks++;
+		} else {
+			frameMemoryTotalBytes -= blocks->size;
+			Mem_Free16( blocks );
+		}
+		blocks = next;
+	}
+}
+
+/*
+====================
+R_TakeFrameMemoryBlock
+
+Allocations larger than half of a block get a dedicated block.
+====================
+*/
+static frameMemoryBlock_t *R_TakeFrameMemoryBlock( frameData_t *frame, int bytes, int blockSize ) {
+	frameMemoryBlock_t *block = NULL;
+	if ( bytes > blockSize / 2 ) {
+		block = R_AllocFrameMemoryBlock( bytes );
+	} else {
+		{
+			idScopedCriticalSection lock( frameMemoryPoolMutex );
+			while ( frameMemoryPool && !block ) {
+				block = frameMemoryPool;
+				frameMemoryPool = block->next;
+				frameMemoryPoolBlocks--;
+				// pooled before r_frameMemoryBlockSize was changed
+				if ( block->size != blockSize ) {
+					frameMemoryTotalBytes -= block->size;
+					Mem_Free16( block );
+					block = NULL;
+				}
+			}
+		}
+		if ( !block ) {
+			block = R_AllocFrameMemoryBlock( blockSize );
+		}
+	}
+
+	idScopedCriticalSection lock( frame->memoryBlocksMutex );
+	block->next = frame->memoryBlocks;
+	frame->memoryBlocks = block;
+	frame->frameMemoryAllocated += block->size;
+	return block;
+}
+
+/*
+====================
+R_RecycleFrameMemory
+====================
+*/
+static void R_RecycleFrameMemory( frameData_t *frame ) {
+	frameMemoryBlock_t *blocks = frame->memoryBlocks;
+	frame->memoryBlocks = NULL;
+
+	if ( r_lockSurfaces.GetBool() && frame == lockedFrameData ) {
+		// keep surfaces of the locked view alive until r_lockSurfaces is disabled
+		if ( !frame->lockedMemoryBlocks ) {
+			frame->lockedMemoryBlocks = blocks;
+			blocks = NULL;
+		}
+	} else if ( frame->lockedMemoryBlocks ) {
+		R_ReleaseFrameMemoryBlocks( frame->lockedMemoryBlocks );
+		frame->lockedMemoryBlocks = NULL;
+	}
+	R_ReleaseFrameMemoryBlocks( blocks );
+
+	frame->frameMemoryAllocated = 0;
+	// invalidates all thread arenas pointing into this frame
+	frame->generation = ++frameMemoryGeneration;
+}
+
+/*
+====================
+R_PublishFrameMemoryStats
+====================
+*/
+static void R_PublishFrameMemoryStats( frameData_t *frame ) {
+	int frameIndex = frame - smpFrameData;
+	int allocated = frame->frameMemoryAllocated;
+	if ( allocated > frameMemoryPeakBytes ) {
+		frameMemoryPeakBytes = allocated;
+	}
+	TRACE_PLOT_BYTES( "frameMemory", allocated );
+	TRACE_PLOT_BYTES( "frameMemoryPeak", frameMemoryPeakBytes );
+
+	int num = idMath::Imin( numFrameArenas.load(), MAX_FRAME_ARENAS );
+	for ( int i = 0; i < num; i++ ) {
+		frameArenaStats_t &stats = frameArenaStats[i];
+		stats.lastFrameBytes = stats.frameBytes[frameIndex].exchange( 0, std::memory_order_relaxed );
+		stats.peakFrameBytes = idMath::Imax( stats.peakFrameBytes, stats.lastFrameBytes );
+		TRACE_PLOT_BYTES( stats.name, stats.lastFrameBytes );
+	}
+}
+
 /*
 ====================
 R_ToggleSmpFrame
@@ -171,6 +346,7 @@ void R_ToggleSmpFrame( void ) {
 	if ( frameData->frameMemoryAllocated > frameData->memoryHighwater ) {
 		frameData->memoryHighwater = frameData->frameMemoryAllocated;
 	}
+	R_PublishFrameMemoryStats( frameData );
 
 	// switch to the next frame
 	smpFrame++;
@@ -179,13 +355,7 @@ void R_ToggleSmpFrame( void ) {
 
 	// reset the memory allocation
 	R_FreeDeferredTriSurfs( frameData );
-
-	// RB: 64 bit fixes, changed unsigned int to uintptr_t
-	const uintptr_t bytesNeededForAlignment = FRAME_ALLOC_ALIGNMENT - ( ( uintptr_t )frameData->frameMemory & ( FRAME_ALLOC_ALIGNMENT - 1 ) );
-	// RB end
-
-	frameData->frameMemoryAllocated = bytesNeededForAlignment;
-	frameData->frameMemoryUsed = 0;
+	R_RecycleFrameMemory( frameData );
 
 	R_ClearCommandChain( frameData );
 }
@@ -204,9 +374,23 @@ void R_ShutdownFrameData( void ) {
 	R_FreeDeferredTriSurfs( frameData );
 	frameData = NULL;
 	for ( int i = 0; i < NUM_FRAME_DATA; i++ ) {
-		Mem_Free16( smpFrameData[i].frameMemory );
-		smpFrameData[i].frameMemory = NULL;
+		R_ReleaseFrameMemoryBlocks( smpFrameData[i].memoryBlocks );
+		R_ReleaseFrameMemoryBlocks( smpFrameData[i].lockedMemoryBlocks );
+		smpFrameData[i].memoryBlocks = NULL;
+		smpFrameData[i].lockedMemoryBlocks = NULL;
+		smpFrameData[i].frameMemoryAllocated = 0;
+		smpFrameData[i].generation = ++frameMemoryGeneration;
+	}
+	lockedFrameData = NULL;
+
+	idScopedCriticalSection lock( frameMemoryPoolMutex );
+	while ( frameMemoryPool ) {
+		frameMemoryBlock_t *next = frameMemoryPool->next;
+		frameMemoryTotalBytes -= frameMemoryPool->size;
+		Mem_Free16( frameMemoryPool );
+		frameMemoryPool = next;
 	}
+	frameMemoryPoolBlocks = 0;
 }
 
 /*
@@ -217,10 +401,6 @@ R_InitFrameData
 void R_InitFrameData( void ) {
 	R_ShutdownFrameData();
 
-	for ( int i = 0; i < NUM_FRAME_DATA; i++ ) {
-		smpFrameData[i].frameMemory = ( byte * )Mem_Alloc16( MAX_FRAME_MEMORY );
-	}
-
 	// must be set before calling R_ToggleSmpFrame()
 	frameData = &smpFrameData[0];
 	backendFrameData = &smpFrameData[1];
@@ -229,6 +409,41 @@ void R_InitFrameData( void ) {
 	R_ClearCommandChain( backendFrameData );
 }
 
+/*
+=====================
+R_LockFrameData
+
+Called when a view is saved for r_lockSurfaces:
+the memory of current frame must survive as long as the lock is active.
+=====================
+*/
+void R_LockFrameData( void ) {
+	lockedFrameData = frameData;
+}
+
+/*
+=====================
+R_ReportFrameMemory_f
+=====================
+*/
+void R_ReportFrameMemory_f( const idCmdArgs &args ) {
+	common->Printf( "Frame memory: %d KB in blocks, %d free blocks of %d KB, peak per frame %d KB\n",
+		frameMemoryTotalBytes.load() >> 10, frameMemoryPoolBlocks, R_FrameMemoryBlockSize() >> 10, frameMemoryPeakBytes >> 10
+	);
+	for ( int i = 0; i < NUM_FRAME_DATA; i++ ) {
+		common->Printf( "  frame data %d: %d KB allocated, highwater %d KB%s\n", i,
+			smpFrameData[i].frameMemoryAllocated.load() >> 10, smpFrameData[i].memoryHighwater >> 10,
+			smpFrameData[i].lockedMemoryBlocks ? " (locked surfaces)" : ""
+		);
+	}
+	common->Printf( "  %-24s %18s %12s %12s\n", "arena", "thread id", "last frame", "peak" );
+	int num = idMath::Imin( numFrameArenas.load(), MAX_FRAME_ARENAS );
+	for ( int i = 0; i < num; i++ ) {
+		const frameArenaStats_t &stats = frameArenaStats[i];
+		common->Printf( "  %-24s %18llx %9d KB %9d KB\n", stats.name, ( unsigned long long )stats.threadId, stats.lastFrameBytes >> 10, stats.peakFrameBytes >> 10 );
+	}
+}
+
 /*
 =================
 R_StaticAlloc
@@ -301,14 +516,37 @@ Should part of this be inlined in a macro?
 void *R_FrameAlloc( int bytes ) {
 	bytes = ( bytes + FRAME_ALLOC_ALIGNMENT - 1 ) & ~( FRAME_ALLOC_ALIGNMENT - 1 );
 
-	// thread safe add
-	int	end = frameData->frameMemoryAllocated += bytes;
-
-	if ( end > MAX_FRAME_MEMORY ) {
-		idLib::Error( "R_FrameAlloc ran out of memory. bytes = %d, end = %d, highWaterAllocated = %d\n", bytes, end, frameData->memoryHighwater );
+	frameArena_t &arena = frameArena;
+	if ( !arena.stats ) {
+		// first allocation on this thread
+		int idx = idMath::Imin( numFrameArenas++, MAX_FRAME_ARENAS - 1 );
+		arena.stats = &frameArenaStats[idx];
+		if ( !arena.stats->name[0] ) {
+			arena.stats->threadId = Sys_GetCurrentThreadID();
+			idStr::snPrintf( arena.stats->name, sizeof( arena.stats->name ), "frameMemory:thread%d", idx );
+		}
+	}
+	if ( arena.frame != frameData || arena.generation != frameData->generation ) {
+		// frame data was switched or reused since last allocation
+		arena.frame = frameData;
+		arena.generation = frameData->generation;
+		arena.current = arena.end = NULL;
+	}
+	arena.stats->frameBytes[frameData - smpFrameData].fetch_add( bytes, std::memory_order_relaxed );
+
+	if ( arena.end - arena.current < bytes ) {
+		int blockSize = R_FrameMemoryBlockSize();
+		frameMemoryBlock_t *block = R_TakeFrameMemoryBlock( frameData, bytes, blockSize );
+		if ( bytes > blockSize / 2 ) {
+			// dedicated block, keep using the current one for small allocations
+			return block->base;
+		}
+		arena.current = block->base;
+		arena.end = block->base + block->size;
 	}
-	byte *ptr = frameData->frameMemory + end - bytes;
 
+	byte *ptr = arena.current;
+	arena.current += bytes;
 	return ptr;
 }
 
@@ -2017,6 +2017,130 @@ void R_CleanupTriangles( srfTriangles_t *tri, bool createNormals, bool identifyS
 	}
 }
 
+/*
+=================
+R_WriteStaticTriSurf
+
+Writes surface after R_CleanupTriangles: geometry and all the data derived from it.
+Arrays are written as raw memory, so the result is only valid on the same platform.
+=================
+*/
+void R_WriteStaticTriSurf( idFile *file, const srfTriangles_t *tri ) {
+	file->WriteVec3( tri->bounds[0] );
+	file->WriteVec3( tri->bounds[1] );
+	file->WriteBool( tri->generateNormals );
+	file->WriteBool( tri->tangentsCalculated );
+	file->WriteBool( tri->facePlanesCalculated );
+	file->WriteBool( tri->perfectHull );
+	file->WriteInt( tri->numVerts );
+	file->WriteInt( tri->numIndexes );
+	file->WriteInt( tri->numMirroredVerts );
+	file->WriteInt( tri->numDupVerts );
+	file->WriteInt( tri->numSilEdges );
+	file->WriteBool( tri->silIndexes != NULL );
+	file->WriteBool( tri->facePlanes != NULL );
+	file->WriteBool( tri->dominantTris != NULL );
+
+	file->Write( tri->verts, tri->numVerts * sizeof( tri->verts[0] ) );
+	file->Write( tri->indexes, tri->numIndexes * sizeof( tri->indexes[0] ) );
+	if ( tri->silIndexes ) {
+		file->Write( tri->silIndexes, tri->numIndexes * sizeof( tri->silIndexes[0] ) );
+	}
+	if ( tri->facePlanes ) {
+		file->Write( tri->facePlanes, tri->numIndexes / 3 * sizeof( tri->facePlanes[0] ) );
+	}
+	if ( tri->dominantTris ) {
+		file->Write( tri->dominantTris, tri->numVerts * sizeof( tri->dominantTris[0] ) );
+	}
+	file->Write( tri->mirroredVerts, tri->numMirroredVerts * sizeof( tri->mirroredVerts[0] ) );
+	file->Write( tri->dupVerts, tri->numDupVerts * 2 * sizeof( tri->dupVerts[0] ) );
+	file->Write( tri->silEdges, tri->numSilEdges * sizeof( tri->silEdges[0] ) );
+}
+
+/*
+=================
+R_ReadStaticTriSurf
+
+Reads surface written by R_WriteStaticTriSurf, returns NULL if data is truncated or broken.
+=================
+*/
+srfTriangles_t *R_ReadStaticTriSurf( idFile *file ) {
+	srfTriangles_t *tri = R_AllocStaticTriSurf();
+	bool hasSilIndexes = false, hasFacePlanes = false, hasDominantTris = false;
+
+	file->ReadVec3( tri->bounds[0] );
+	file->ReadVec3( tri->bounds[1] );
+	file->ReadBool( tri->generateNormals );
+	file->ReadBool( tri->tangentsCalculated );
+	file->ReadBool( tri->facePlanesCalculated );
+	file->ReadBool( tri->perfectHull );
+	file->ReadInt( tri->numVerts );
+	file->ReadInt( tri->numIndexes );
+	file->ReadInt( tri->numMirroredVerts );
+	file->ReadInt( tri->numDupVerts );
+	file->ReadInt( tri->numSilEdges );
+	file->ReadBool( hasSilIndexes );
+	file->ReadBool( hasFacePlanes );
+	file->ReadBool( hasDominantTris );
+
+	// make sure counts are sane before allocating anything
+	int remaining = file->Length() - file->Tell();
+	if ( tri->numVerts < 0 || tri->numIndexes < 0 || tri->numIndexes % 3 != 0 ||
+		tri->numMirroredVerts < 0 || tri->numMirroredVerts > tri->numVerts ||
+		tri->numDupVerts < 0 || tri->numSilEdges < 0 ||
+		(int64)tri->numVerts * (int)sizeof( tri->verts[0] ) + (int64)tri->numIndexes * (int)sizeof( tri->indexes[0] ) > remaining ) {
+		tri->numVerts = tri->numIndexes = tri->numMirroredVerts = tri->numDupVerts = tri->numSilEdges = 0;
+		R_ReallyFreeStaticTriSurf( tri );
+		return NULL;
+	}
+
+	int expected = 0, read = 0;
+	R_AllocStaticTriSurfVerts( tri, tri->numVerts );
+	expected += tri->numVerts * sizeof( tri->verts[0] );
+	read += file->Read( tri->verts, tri->numVerts * sizeof( tri->verts[0] ) );
+
+	R_AllocStaticTriSurfIndexes( tri, tri->numIndexes );
+	expected += tri->numIndexes * sizeof( tri->indexes[0] );
+	read += file->Read( tri->indexes, tri->numIndexes * sizeof( tri->indexes[0] ) );
+
+	if ( hasSilIndexes ) {
+		tri->silIndexes = triSilIndexAllocator.Alloc( tri->numIndexes );
+		expected += tri->numIndexes * sizeof( tri->silIndexes[0] );
+		read += file->Read( tri->silIndexes, tri->numIndexes * sizeof( tri->silIndexes[0] ) );
+	}
+	if ( hasFacePlanes ) {
+		R_AllocStaticTriSurfPlanes( tri, tri->numIndexes );
+		expected += tri->numIndexes / 3 * sizeof( tri->facePlanes[0] );
+		read += file->Read( tri->facePlanes, tri->numIndexes / 3 * sizeof( tri->facePlanes[0] ) );
+	}
+	if ( hasDominantTris ) {
+		tri->dominantTris = triDominantTrisAllocator.Alloc( tri->numVerts );
+		expected += tri->numVerts * sizeof( tri->dominantTris[0] );
+		read += file->Read( tri->dominantTris, tri->numVerts * sizeof( tri->dominantTris[0] ) );
+	}
+	if ( tri->numMirroredVerts ) {
+		tri->mirroredVerts = triMirroredVertAllocator.Alloc( tri->numMirroredVerts );
+		expected += tri->numMirroredVerts * sizeof( tri->mirroredVerts[0] );
+		read += file->Read( tri->mirroredVerts, tri->numMirroredVerts * sizeof( tri->mirroredVerts[0] ) );
+	}
+	if ( tri->numDupVerts ) {
+		tri->dupVerts = triDupVertAllocator.Alloc( tri->numDupVerts * 2 );
+		expected += tri->numDupVerts * 2 * sizeof( tri->dupVerts[0] );
+		read += file->Read( tri->dupVerts, tri->numDupVerts * 2 * sizeof( tri->dupVerts[0] ) );
+	}
+	if ( tri->numSilEdges ) {
+		tri->silEdges = triSilEdgeAllocator.Alloc( tri->numSilEdges );
+		expected += tri->numSilEdges * sizeof( tri->silEdges[0] );
+		read += file->Read( tri->silEdges, tri->numSilEdges * sizeof( tri->silEdges[0] ) );
+	}
+
+	if ( read != expected ) {
+		R_ReallyFreeStaticTriSurf( tri );
+		return NULL;
+	}
+	return tri;
+}
+
 /*
 ===================================================================================
 
@@ -0,0 +1,251 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "CompiledGui.h"
+
+static const int COMPILED_GUI_MAGIC = ( 'G' << 24 ) | ( 'U' << 16 ) | ( 'I' << 8 ) | 'B';
+static const int COMPILED_GUI_VERSION = 1;
+
+/*
+================
+idCompiledGui::idCompiledGui
+================
+*/
+idCompiledGui::idCompiledGui() {
+	definesChecksum = 0;
+}
+
+/*
+================
+idCompiledGui::CachePath
+================
+*/
+idStr idCompiledGui::CachePath( const char *qpath ) {
+	idStr path = "generated/";
+	path += qpath;
+	path.SetFileExtension( "guib" );
+	return path;
+}
+
+/*
+================
+idCompiledGui::DefinesChecksum
+================
+*/
+unsigned int idCompiledGui::DefinesChecksum( const idDict &presetDefines ) {
+	idStr all;
+	for ( int i = 0; i < presetDefines.GetNumKeyVals(); i++ ) {
+		const idKeyValue *kv = presetDefines.GetKeyVal( i );
+		all += kv->GetKey() + " " + kv->GetValue() + "\n";
+	}
+	return MD5_BlockChecksum( all.c_str(), all.Length() );
+}
+
+/*
+================
+idCompiledGui::FileChecksum
+================
+*/
+bool idCompiledGui::FileChecksum( const char *name, unsigned int &checksum ) {
+	void *buffer;
+	int length = fileSystem->ReadFile( name, &buffer );
+	if ( length < 0 || !buffer ) {
+		return false;
+	}
+	checksum = MD5_BlockChecksum( buffer, length );
+	fileSystem->FreeFile( buffer );
+	return true;
+}
+
+/*
+================
+idCompiledGui::Compile
+================
+*/
+bool idCompiledGui::Compile( const char *qpath, const idDict &presetDefines ) {
+	sources.Clear();
+	tokens.Clear();
+	defines.Clear();
+
+	idParser src( GUI_PARSER_FLAGS );
+	src.LoadFile( qpath );
+	if ( !src.IsLoaded() ) {
+		return false;
+	}
+
+	for ( int i = 0; i < presetDefines.GetNumKeyVals(); i++ ) {
+		const idKeyValue *kv = presetDefines.GetKeyVal( i );
+		idStr line = kv->GetKey() + " " + kv->GetValue();
+		src.AddDefine( line.c_str() );
+	}
+	definesChecksum = DefinesChecksum( presetDefines );
+
+	idToken token;
+	while ( src.ReadToken( &token ) ) {
+		// whitespace pointers are invalid as soon as the source is freed
+		token.ClearTokenWhiteSpace();
+		token.linesCrossed = 0;
+		token.flags = 0;
+		tokens.Append( token );
+	}
+
+	// make custom defines by mapper visible in C++
+	idStrList defNames = src.GetAllDefineNames();
+	for ( int i = 0; i < defNames.Num(); i++ ) {
+		const char *name = defNames[i];
+		idStr value = src.GetDefineValueString( name );
+		defines.Set( name, value );
+	}
+
+	idStrList files = src.GetIncludedFiles();
+	files.Insert( qpath, 0 );
+	for ( int i = 0; i < files.Num(); i++ ) {
+		sourceFile_t &sf = sources.Alloc();
+		sf.name = files[i];
+		if ( !FileChecksum( sf.name, sf.checksum ) ) {
+			// should not happen, but never cache something we cannot validate
+			sources.Clear();
+			break;
+		}
+	}
+
+	return true;
+}
+
+/*
+================
+idCompiledGui::WriteCache
+================
+*/
+void idCompiledGui::WriteCache( const char *qpath ) const {
+	if ( sources.Num() == 0 ) {
+		return;
+	}
+
+	idFile_Memory mem( qpath );
+	mem.SetGranularity( 64 * 1024 );
+
+	mem.WriteInt( COMPILED_GUI_MAGIC );
+	mem.WriteInt( COMPILED_GUI_VERSION );
+	mem.WriteUnsignedInt( definesChecksum );
+
+	mem.WriteInt( sources.Num() );
+	for ( int i = 0; i < sources.Num(); i++ ) {
+		mem.WriteString( sources[i].name );
+		mem.WriteUnsignedInt( sources[i].checksum );
+	}
+
+	mem.WriteInt( defines.GetNumKeyVals() );
+	for ( int i = 0; i < defines.GetNumKeyVals(); i++ ) {
+		const idKeyValue *kv = defines.GetKeyVal( i );
+		mem.WriteString( kv->GetKey() );
+		mem.WriteString( kv->GetValue() );
+	}
+
+	mem.WriteInt( tokens.Num() );
+	for ( int i = 0; i < tokens.Num(); i++ ) {
+		const idToken &token = tokens[i];
+		mem.WriteString( token );
+		mem.WriteUnsignedChar( token.type );
+		// number values are recomputed from text on demand
+		mem.WriteInt( token.subtype & ~TT_VALUESVALID );
+		mem.WriteInt( token.line );
+	}
+
+	idStr path = CachePath( qpath );
+	idFile *f = fileSystem->OpenFileWrite( path );
+	if ( !f ) {
+		common->Warning( "Could not write compiled gui %s", path.c_str() );
+		return;
+	}
+	f->Write( mem.GetDataPtr(), mem.Length() );
+	fileSystem->CloseFile( f );
+}
+
+/*
+================
+idCompiledGui::LoadCache
+================
+*/
+bool idCompiledGui::LoadCache( const char *qpath, const idDict &presetDefines ) {
+	sources.Clear();
+	tokens.Clear();
+	defines.Clear();
+
+	idStr path = CachePath( qpath );
+	void *buffer;
+	int length = fileSystem->ReadFile( path, &buffer );
+	if ( length <= 0 || !buffer ) {
+		return false;
+	}
+	idFile_Memory mem( path, (const char *)buffer, length );
+
+	bool valid = false;
+	int magic = 0, version = 0, num = 0;
+	mem.ReadInt( magic );
+	mem.ReadInt( version );
+	mem.ReadUnsignedInt( definesChecksum );
+	if ( magic == COMPILED_GUI_MAGIC && version == COMPILED_GUI_VERSION && definesChecksum == DefinesChecksum( presetDefines ) ) {
+		valid = true;
+		mem.ReadInt( num );
+		sources.SetNum( num );
+		for ( int i = 0; i < num && valid; i++ ) {
+			unsigned int actual;
+			mem.ReadString( sources[i].name );
+			mem.ReadUnsignedInt( sources[i].checksum );
+			// any edit of the gui or its includes invalidates the cache
+			if ( !FileChecksum( sources[i].name, actual ) || actual != sources[i].checksum ) {
+				valid = false;
+			}
+		}
+	}
+
+	if ( valid ) {
+		idStr key, value;
+		mem.ReadInt( num );
+		for ( int i = 0; i < num; i++ ) {
+			mem.ReadString( key );
+			mem.ReadString( value );
+			defines.Set( key, value );
+		}
+
+		mem.ReadInt( num );
+		tokens.SetNum( num );
+		for ( int i = 0; i < num; i++ ) {
+			idToken &token = tokens[i];
+			unsigned char type;
+			mem.ReadString( token );
+			mem.ReadUnsignedChar( type );
+			mem.ReadInt( token.subtype );
+			mem.ReadInt( token.line );
+			token.type = type;
+			token.linesCrossed = 0;
+			token.flags = 0;
+			token.ClearTokenWhiteSpace();
+		}
+		valid = ( mem.Tell() == length );
+	}
+
+	fileSystem->FreeFile( buffer );
+	if ( !valid ) {
+		sources.Clear();
+		tokens.Clear();
+		defines.Clear();
+	}
+	return valid;
+}
@@ -0,0 +1,67 @@
+/*****************************************************************************
+The Dark Mod GPL Source Code
+
+This file is part of the The Dark Mod Source Code, originally based
+on the Doom 3 GPL Source Code as published in 2011.
+
+The Dark Mod Source Code is free software: you can redistribute it
+and/or modify it under the terms of the GNU General Public License as
+published by the Free Software Foundation, either version 3 of the License,
+or (at your option) any later version. For details, see LICENSE.TXT.
+
+Project: The Dark Mod (http://www.thedarkmod.com/)
+
+******************************************************************************/
+
+#ifndef __COMPILEDGUI_H__
+#define __COMPILEDGUI_H__
+
+/*
+===============================================================================
+
+	Compiled GUI
+
+	Preprocessed token stream of a .gui file (all #includes, #defines and
+	$eval directives already resolved) which is stored in a binary cache
+	under "generated/". Replaying it through idParser::LoadPrecompiledTokens
+	skips lexing and preprocessing entirely on subsequent loads.
+
+	The cache is validated against the checksums of the source file, every
+	file it included and the preset defines passed by the game code.
+
+===============================================================================
+*/
+
+const int GUI_PARSER_FLAGS = LEXFL_NOFATALERRORS | LEXFL_NOSTRINGCONCAT | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_ALLOWBACKSLASHSTRINGCONCAT;
+
+class idCompiledGui {
+public:
+							idCompiledGui();
+
+							// preprocess the text source into token stream
+	bool					Compile( const char *qpath, const idDict &presetDefines );
+							// load token stream from cache, returns false if it is missing or outdated
+	bool					LoadCache( const char *qpath, const idDict &presetDefines );
+	void					WriteCache( const char *qpath ) const;
+
+	const idList<idToken> &	GetTokens() const { return tokens; }
+	const idDict &			GetDefines() const { return defines; }
+
+	static idStr			CachePath( const char *qpath );
+
+private:
+	struct sourceFile_t {
+		idStr				name;
+		unsigned int		checksum;
+	};
+
+	static unsigned int		DefinesChecksum( const idDict &presetDefines );
+	static bool				FileChecksum( const char *name, unsigned int &checksum );
+
+	idList<sourceFile_t>	sources;
+	unsigned int			definesChecksum;
+	idList<idToken>			tokens;
+	idDict					defines;		// custom defines made visible to C++ code
+};
+
+#endif /* !__COMPILEDGUI_H__ */
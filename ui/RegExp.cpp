@@ -27,18 +27,18 @@ int idRegister::REGCOUNT[NUMTYPES] = {4, 1, 1, 1, 0, 2, 3, 4};
 
 /*
 ====================
-idRegister::SetToRegs
+idRegister::ReadVar
+
+Reads current value of the variable, returns false if it is not bound to registers
 ====================
 */
-void idRegister::SetToRegs( float *registers ) {
-	int i;
-	idVec4 v;
+bool idRegister::ReadVar( idVec4 &v ) {
 	idVec2 v2;
 	idVec3 v3;
 	idRectangle rect;
 
 	if ( !enabled || var == NULL || ( var && ( var->GetDict() || !var->GetEval() ) ) ) {
-		return;
+		return false;
 	}
 
 	switch( type ) {
@@ -77,11 +77,25 @@ void idRegister::SetToRegs( float *registers ) {
 			break;
 		}
 		default: {
-			common->FatalError( "idRegister::SetToRegs: bad reg type" );
+			common->FatalError( "idRegister::ReadVar: bad reg type" );
 			break;
 		}
 	}
-	for ( i = 0; i < regCount; i++ ) {
+	return true;
+}
+
+/*
+====================
+idRegister::SetToRegs
+====================
+*/
+void idRegister::SetToRegs( float *registers ) {
+	idVec4 v;
+
+	if ( !ReadVar( v ) ) {
+		return;
+	}
+	for ( int i = 0; i < regCount; i++ ) {
 		registers[ regs[ i ] ] = v[i];
 	}
 }
@@ -304,6 +318,36 @@ void idRegisterList::SetToRegs( float *registers ) {
 	}
 }
 
+/*
+====================
+idRegisterList::AppendValues
+====================
+*/
+void idRegisterList::AppendValues( idList<float> &values ) {
+	idVec4 v;
+	for ( int i = 0; i < regs.Num(); i++ ) {
+		if ( regs[i]->ReadVar( v ) ) {
+			for ( int j = 0; j < regs[i]->regCount; j++ ) {
+				values.Append( v[j] );
+			}
+		}
+	}
+}
+
+/*
+====================
+idRegisterList::ContainsVar
+====================
+*/
+bool idRegisterList::ContainsVar( const idWinVar *var ) const {
+	for ( int i = 0; i < regs.Num(); i++ ) {
+		if ( regs[i]->var == var ) {
+			return true;
+		}
+	}
+	return false;
+}
+
 /*
 ====================
 idRegisterList::FindReg
@@ -34,6 +34,7 @@ public:
 	unsigned short		regs[4];
 	idWinVar *			var;
 
+	bool				ReadVar( idVec4 &v );
 	void				SetToRegs( float *registers );
 	void				GetFromRegs( float *registers );
 	void				CopyRegs( idRegister *src );
@@ -75,6 +76,8 @@ public:
 	idRegister *		FindReg( const char *name );
 	void				SetToRegs( float *registers );
 	void				GetFromRegs( float *registers );
+	void				AppendValues( idList<float> &values );
+	bool				ContainsVar( const idWinVar *var ) const;
 	void				Reset();
 	void				ReadFromDemoFile( idDemoFile *f );
 	void				WriteToDemoFile( idDemoFile *f );
@@ -22,10 +22,13 @@ Project: The Dark Mod (http://www.thedarkmod.com/)
 #include "DeviceContext.h"
 #include "Window.h"
 #include "UserInterfaceLocal.h"
+#include "CompiledGui.h"
 #include "../sound/snd_local.h"
 
 extern idCVar r_skipGuiShaders;		// 1 = don't render any gui elements on surfaces
 
+idCVar gui_compiledCache( "gui_compiledCache", "1", CVAR_GUI | CVAR_BOOL, "Store preprocessed guis in binary cache (generated/guis/*.guib) and load them from there when the sources did not change" );
+
 idUserInterfaceManagerLocal	uiManagerLocal;
 idUserInterfaceManager *	uiManager = &uiManagerLocal;
 
@@ -290,20 +293,35 @@ bool idUserInterfaceLocal::InitFromFile( const char *qpath, bool rebuild ) {
 	source = qpath;
 	state.Set( "text", "Test Text!" );
 
-	idParser src( LEXFL_NOFATALERRORS | LEXFL_NOSTRINGCONCAT | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_ALLOWBACKSLASHSTRINGCONCAT );
-
 	//Load the timestamp so reload guis will work correctly
 	fileSystem->ReadFile(qpath, NULL, &timeStamp);
 
-	src.LoadFile( qpath );
+	idParser src( GUI_PARSER_FLAGS );
+	idCompiledGui compiled;
 
-	if ( src.IsLoaded() ) {
+	if ( com_editors & EDITOR_GUI ) {
+		// gui editor tracks source text markers, so it needs the real lexer
+		src.LoadFile( qpath );
 		for (int i = 0; i < presetDefines.GetNumKeyVals(); i++) {
 			const idKeyValue *kv = presetDefines.GetKeyVal(i);
 			idStr line = kv->GetKey() + " " + kv->GetValue();
 			src.AddDefine(line.c_str());
 		}
+	} else {
+		// try the compiled token stream first, fall back to preprocessing the text source
+		bool compiledOk = gui_compiledCache.GetBool() && compiled.LoadCache( qpath, presetDefines );
+		if ( !compiledOk ) {
+			compiledOk = compiled.Compile( qpath, presetDefines );
+			if ( compiledOk && gui_compiledCache.GetBool() ) {
+				compiled.WriteCache( qpath );
+			}
+		}
+		if ( compiledOk ) {
+			src.LoadPrecompiledTokens( compiled.GetTokens(), qpath );
+		}
+	}
 
+	if ( src.IsLoaded() ) {
 		idToken token;
 		while( src.ReadToken( &token ) ) {
 			if ( idStr::Icmp( token, "windowDef" ) == 0 ) {
@@ -319,11 +337,15 @@ bool idUserInterfaceLocal::InitFromFile( const char *qpath, bool rebuild ) {
 		state.Set( "name", qpath );
 
 		//stgatilov: make custom defines by mapper visible in C++
-		idStrList defNames = src.GetAllDefineNames();
-		for (int i = 0; i < defNames.Num(); i++) {
-			const char *name = defNames[i];
-			idStr value = src.GetDefineValueString(name);
-			defines.Set(name, value);
+		if ( com_editors & EDITOR_GUI ) {
+			idStrList defNames = src.GetAllDefineNames();
+			for (int i = 0; i < defNames.Num(); i++) {
+				const char *name = defNames[i];
+				idStr value = src.GetDefineValueString(name);
+				defines.Set(name, value);
+			}
+		} else {
+			defines.Copy( compiled.GetDefines() );
 		}
 	} else {
 		desktop->SetDC( &uiManagerLocal.dc );
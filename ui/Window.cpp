@@ -41,6 +41,7 @@ bool idWindow::registerIsTemporary[MAX_EXPRESSION_REGISTERS];		// statics to ass
 
 idCVar idWindow::gui_debug( "gui_debug", "0", CVAR_GUI | CVAR_BOOL, "" );
 idCVar idWindow::gui_edit( "gui_edit", "0", CVAR_GUI | CVAR_BOOL, "" );
+idCVar idWindow::gui_dirtyEval( "gui_dirtyEval", "1", CVAR_GUI | CVAR_BOOL, "Skip re-evaluating window expressions when none of their input variables changed" );
 
 extern idCVar r_skipGuiShaders;		// 1 = don't render any gui elements on surfaces
 
@@ -132,6 +133,9 @@ void idWindow::CommonInit() {
 	parent = NULL;
 	saveOps = NULL;
 	saveRegs = NULL;
+	evalDeps = EVALDEPS_UNKNOWN;
+	evalDepsNumOps = -1;
+	evalInputsValid = false;
 	timeLine = -1;
 	textShadow = 0;
 	hover = false;
@@ -1097,17 +1101,41 @@ idWindow::EvalRegs
 float idWindow::EvalRegs(int test, bool force) {
 	static float regs[MAX_EXPRESSION_REGISTERS];
 	static idWindow *lastEval = NULL;
+	static idList<float> inputs;
 
 	if (!force && test >= 0 && test < MAX_EXPRESSION_REGISTERS && lastEval == this) {
 		return regs[test];
 	}
 
+	bool trackInputs = expressionRegisters.Num() && gui_dirtyEval.GetBool();
+	if (trackInputs) {
+		if (evalDepsNumOps != ops.Num()) {
+			// ops are appended while parsing
+			evalDeps = ComputeEvalDeps();
+			evalDepsNumOps = ops.Num();
+			evalInputsValid = false;
+		}
+		trackInputs = (evalDeps == EVALDEPS_INPUTS);
+	}
+
+	if (trackInputs && !force && test < 0 && evalInputsValid) {
+		// nothing to do if all inputs have same values as after last evaluation
+		GatherRegisterInputs(inputs);
+		if (inputs.Num() == evalInputs.Num() && memcmp(inputs.Ptr(), evalInputs.Ptr(), inputs.MemoryUsed()) == 0) {
+			return 0.0;
+		}
+	}
+
 	lastEval = this;
 
 	if (expressionRegisters.Num()) {
 		regList.SetToRegs(regs);
 		EvaluateRegisters(regs);
 		regList.GetFromRegs(regs);
+		if (trackInputs) {
+			GatherRegisterInputs(evalInputs);
+		}
+		evalInputsValid = trackInputs;
 	}
 
 	if (test >= 0 && test < MAX_EXPRESSION_REGISTERS) {
@@ -1117,6 +1145,93 @@ float idWindow::EvalRegs(int test, bool force) {
 	return 0.0;
 }
 
+/*
+================
+idWindow::ComputeEvalDeps
+
+Checks whether result of EvaluateRegisters is fully determined by values of input variables
+================
+*/
+int idWindow::ComputeEvalDeps() {
+	for (int i = 0; i < ops.Num(); i++) {
+		const wexpOp_t &op = ops[i];
+		if (op.b == -2) {
+			continue;
+		}
+		switch (op.opType) {
+		case WOP_TYPE_VAR:
+			if (op.b > WEXP_REG_TIME) {
+				// vector component selected by expression
+				return EVALDEPS_ALWAYS;
+			}
+			// fall through
+		case WOP_TYPE_VARS:
+		case WOP_TYPE_VARF:
+		case WOP_TYPE_VARI:
+		case WOP_TYPE_VARB:
+			if (op.a && regList.ContainsVar((idWinVar*)op.a)) {
+				// reads own output: result can change without any input changing
+				return EVALDEPS_ALWAYS;
+			}
+			break;
+		case WOP_TYPE_TABLE:
+			if (op.b == WEXP_REG_TIME) {
+				return EVALDEPS_ALWAYS;
+			}
+			break;
+		case WOP_TYPE_COND:
+			if (op.a == WEXP_REG_TIME || op.b == WEXP_REG_TIME || op.d == WEXP_REG_TIME) {
+				return EVALDEPS_ALWAYS;
+			}
+			break;
+		default:
+			if (op.a == WEXP_REG_TIME || op.b == WEXP_REG_TIME) {
+				return EVALDEPS_ALWAYS;
+			}
+			break;
+		}
+	}
+	return EVALDEPS_INPUTS;
+}
+
+/*
+================
+idWindow::GatherRegisterInputs
+
+Collects values of everything EvaluateRegisters reads, including the bound variables
+================
+*/
+void idWindow::GatherRegisterInputs(idList<float> &inputs) {
+	inputs.SetNum(0, false);
+	regList.AppendValues(inputs);
+
+	for (int i = 0; i < ops.Num(); i++) {
+		const wexpOp_t &op = ops[i];
+		if (op.b == -2 || !op.a) {
+			continue;
+		}
+		switch (op.opType) {
+		case WOP_TYPE_VAR:
+			inputs.Append(((idWinVar*)(op.a))->x());
+			break;
+		case WOP_TYPE_VARS:
+			inputs.Append(atof(((idWinStr*)(op.a))->c_str()));
+			break;
+		case WOP_TYPE_VARF:
+			inputs.Append(*(idWinFloat*)(op.a));
+			break;
+		case WOP_TYPE_VARI:
+			inputs.Append(*(idWinInt*)(op.a));
+			break;
+		case WOP_TYPE_VARB:
+			inputs.Append(*(idWinBool*)(op.a));
+			break;
+		default:
+			break;
+		}
+	}
+}
+
 /*
 ================
 idWindow::DrawBackground
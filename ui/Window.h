@@ -347,6 +347,8 @@ protected:
 	intptr_t ParseTerm( idParser *src, idWinVar *var = NULL, intptr_t component = 0 );
 	intptr_t ParseExpressionPriority( idParser *src, int priority, idWinVar *var = NULL, intptr_t component = 0 );
 	void EvaluateRegisters(float *registers);
+	int ComputeEvalDeps();
+	void GatherRegisterInputs(idList<float> &inputs);
 	void SaveExpressionParseState();
 	void RestoreExpressionParseState();
 	void ParseBracedExpression(idParser *src);
@@ -437,6 +439,18 @@ protected:
 
 	idRegisterList regList;
 
+	//dirty tracking for EvalRegs: values of all register inputs at the end of last evaluation
+	enum {
+		EVALDEPS_UNKNOWN,		// not computed yet or ops changed
+		EVALDEPS_INPUTS,		// result depends only on input variables
+		EVALDEPS_ALWAYS			// depends on time or reads its own outputs: evaluate every time
+	};
+	int evalDeps;
+	int evalDepsNumOps;
+	bool evalInputsValid;
+	idList<float> evalInputs;
+	static idCVar gui_dirtyEval;
+
 	idWinBool	hideCursor;
 
 	//stgatilov: pool of source filename strings referenced in idGuiScript elements